@@ -67,6 +67,16 @@ elif [ "$CHECKER_TYPE" == "DSN18MinorCPU" ] || [ "$CHECKER_TYPE" == "DSN18Ex5LIT
     CHECKOPTION+=(--lslSize=192)
 fi
 
+# FORKSWEEP=<file> restores once and runs every config in the file (see
+# --forkSweep in configs/common/Options.py) as a forked child. The children
+# would all try to open the remote GDB listener, so it is turned off then.
+FORKOPTION=()
+LISTENEROPTION=()
+if [ "${FORKSWEEP:-}" != "" ]; then
+    FORKOPTION=(--forkSweep="$FORKSWEEP")
+    LISTENEROPTION=(--listener-mode=off)
+fi
+
 APPOUT=app.out
 APPERR=app.err
 NUMPROC=$(echo $BINA | grep -o ";" | wc -l)
@@ -79,7 +89,7 @@ MEMSIZE="$((16 + 16 * NUMPROC))GB"
 
 $BASE/build/ARM/gem5.opt \
     --outdir ${OUTPUTM5OUT}/${OUTPREFIX} \
-    --redirect-stdout --redirect-stderr \
+    --redirect-stdout --redirect-stderr "${LISTENEROPTION[@]}" \
     $BASE/configs/example/se.py \
     --output="$APPOUT" --errout="$APPERR" \
     -n "$((NUM_O3 + NUM_O3 * NUM_CHECKERS))"  --num-main-cores="$NUM_O3" \
@@ -89,5 +99,13 @@ $BASE/build/ARM/gem5.opt \
     --pl2sl3cache --l3_extraNoCLat="$NOCLAT" \
     "${MAXINSTSOPTION[@]}" --mem-size="$MEMSIZE" \
     "${CPTRESTOREARGS[@]}" \
-    "${CHECKOPTION[@]}" && \
-cp ${OUTPUTM5OUT}/${OUTPREFIX}/stats.txt $OUTPUT/${OUTPREFIX}_stats.txt
+    "${CHECKOPTION[@]}" "${FORKOPTION[@]}" || exit 1
+if [ "${FORKSWEEP:-}" != "" ]; then
+    for stats in ${OUTPUTM5OUT}/${OUTPREFIX}/*/stats.txt
+    do
+        FORKNAME=$(basename $(dirname $stats))
+        cp $stats $OUTPUT/${OUTPREFIX}_${FORKNAME}_stats.txt
+    done
+else
+    cp ${OUTPUTM5OUT}/${OUTPREFIX}/stats.txt $OUTPUT/${OUTPREFIX}_stats.txt
+fi
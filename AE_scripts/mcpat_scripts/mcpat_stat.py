@@ -1,6 +1,7 @@
 import sys
 import argparse
 import math
+import re
 
 parser = argparse.ArgumentParser(description='Collect statistics')
 parser.add_argument('--statFile', type=str, action='store',required=True,
@@ -9,6 +10,9 @@ parser.add_argument('--templateFile', type=str, action='store',required=True,
                     help='the name of the input template file')
 parser.add_argument('--numCores', type=int, action='store',required=True,
                     help='number of cores')
+parser.add_argument('--numCpu1Checkers', type=int, action='store', default=0,
+                    help='last checkers that are the main core type '
+                    '(--num-cpu1-checkers), modelled as core0 is')
 
 grep_stats_key = [
     "system.switch_cpus0.numCycles",
@@ -228,7 +232,10 @@ grep_stats_key = [
     "system.l3.ReadCleanReq.misses::total",
     "system.l3.ReadExReq.misses::total",
     "system.l3.WritebackDirty.misss::total",
-    "system.membus.pktCount::total"
+    "system.membus.pktCount::total",
+    "system.voting.reruns",
+    "system.voting.heterogeneousReruns",
+    "system.voting.rerunInsts"
     ]
 
 calc_stats_key = {
@@ -271,7 +278,9 @@ LLC_numAccess = "stats_value[\"system.l3.ReadCleanReq.accesses::total\"] + stats
 LSL_numPackts = "math.ceil((" + L1D_numAccess + ") / 4) * LSL_message_size"
 LLC_numResponses = "(" + LLC_numAccess + ") * LLC_response_size"
 NOC_numAccess_Baseline = "(" + LLC_numAccess + ") + (" + LLC_numResponses + ")"
-NOC_numAccess_Checked = "(" + NOC_numAccess_Baseline + ") + (" + LSL_numPackts + ")"
+# A vote re-executes a segment on another checker, which needs the log again
+LSL_rerunShare = "(stats_value[\"system.voting.rerunInsts\"] / max(1, stats_value[\"system.switch_cpus0.commit.committedInstType_0::total\"]))"
+NOC_numAccess_Checked = "(" + NOC_numAccess_Baseline + ") + (" + LSL_numPackts + ") * (1 + " + LSL_rerunShare + ")"
 
 args = parser.parse_args()
 num_cores = args.numCores
@@ -311,6 +320,34 @@ with open(args.statFile,'r') as f:
             print(stat_key + " not found, using " + str(0) + " as default", file=sys.stderr)
             stats_value[stat_key] = 0
 
+# Voting re-executions run on whichever checker took them, so they are
+# already in that core's stats; only the core type of the checkers
+# that are the main core's type has to be fixed in the template
+num_checkers = num_cores - 1
+cpu1_checkers = [i for i in range(1, num_cores)
+                 if args.numCpu1Checkers and
+                 (i - 1) % num_checkers >= num_checkers - args.numCpu1Checkers]
+if stats_value["system.voting.reruns"]:
+    print("voting: %d re-executions, %d on a new core type, %d instructions; "
+          "cores %s modelled as core0" %
+          (stats_value["system.voting.reruns"],
+           stats_value["system.voting.heterogeneousReruns"],
+           stats_value["system.voting.rerunInsts"],
+           cpu1_checkers), file=sys.stderr)
+    if stats_value["system.voting.heterogeneousReruns"] and not cpu1_checkers:
+        print("voting: heterogeneous re-executions but no --numCpu1Checkers, "
+              "main core type checkers are charged as the checker type",
+              file=sys.stderr)
+
+def core_block(lines, core):
+    """First and one past the last line of system.coreN in the template"""
+    start = next(i for i, l in enumerate(lines)
+                 if '<component id="system.core%d"' % core in l)
+    indent = lines[start][:len(lines[start]) - len(lines[start].lstrip())]
+    end = next(i for i in range(start + 1, len(lines))
+               if lines[i].startswith(indent + "</component>"))
+    return start, end + 1
+
 # Get appropriate value for NOC number of accesses
 NOC_numAccess = ""
 if "X2" in args.statFile or "A510" in args.statFile:
@@ -321,7 +358,18 @@ assert NOC_numAccess != "", "Could not determine the noc number of accesses"
 
 # Calculate stats not in file
 with open(args.templateFile,'r') as f:
-    for line in f:
+    template = f.readlines()
+    # Main core type checkers run at the main core clock, so they are a copy
+    # of core0 with their own stats
+    main_start, main_end = core_block(template, 0)
+    for core in cpu1_checkers:
+        start, end = core_block(template, core)
+        template[start:end] = [
+            re.sub(r'\bcpu0\b', "cpu%d" % core,
+                   re.sub(r'\bswitch_cpus0\b', "switch_cpus%d" % core,
+                          re.sub(r'\bcore0\b', "core%d" % core, l)))
+            for l in template[main_start:main_end]]
+    for line in template:
         outline = line
         found_in_calc = False
         # Calculate statistics if needed
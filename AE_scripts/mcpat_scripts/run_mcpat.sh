@@ -4,6 +4,8 @@ INSTATDIR=${BASE}/simresults/1000000000
 OUTXMLDIR=${DIRPREFIX}/mcpat_xml
 OUTSTATDIR=${BASE}/simresults/mcpat_stat
 MCPATDIR=${BASE}/mcpat/
+# Checkers of the main core type, as the runs used --num-cpu1-checkers
+NUMCPU1CHECKERS=${NUMCPU1CHECKERS:-0}
 BENCHMARKS=(bwaves gcc mcf xalancbmk deepsjeng leela exchange2 xz cactuBSSN lbm wrf cam4 pop2 imagick nab fotonik3d roms x264 perlbench omnetpp)
 CONFIGS=(baseline_1_3GHz checkedNoC_1_1_3GHz_3000MHz_X2 checkedNoC_1_1_3GHz_2700MHz_X2 checkedNoC_1_2_3GHz_1500MHz_X2 checkedNoC_1_2_3GHz_1350MHz_X2 checkedNoC_1_4_3GHz_2000MHz_A510 checkedNoC_1_4_3GHz_1800MHz_A510 checkedNoC_1_4_3GHz_1600MHz_A510 checkedNoC_1_4_3GHz_1400MHz_A510)
 
@@ -24,7 +26,7 @@ do
         elif [ "${CONFIG}" == "checkedNoC_1_4_3GHz_2000MHz_A510" ] || [ "${CONFIG}" == "checkedNoC_1_4_3GHz_1800MHz_A510" ] || [ "${CONFIG}" == "checkedNoC_1_4_3GHz_1600MHz_A510" ] || [ "${CONFIG}" == "checkedNoC_1_4_3GHz_1400MHz_A510" ]; then
             NUMCORES=5
         fi
-        python3 ${DIRPREFIX}/mcpat_stat.py --statFile ${INSTATDIR}/${BENCH}_${CONFIG}_stats.txt --templateFile ${DIRPREFIX}/ARM_${CONFIG}.xml --numCores ${NUMCORES} > ${OUTXMLDIR}/${BENCH}_${CONFIG}.xml && \
+        python3 ${DIRPREFIX}/mcpat_stat.py --statFile ${INSTATDIR}/${BENCH}_${CONFIG}_stats.txt --templateFile ${DIRPREFIX}/ARM_${CONFIG}.xml --numCores ${NUMCORES} --numCpu1Checkers ${NUMCPU1CHECKERS} > ${OUTXMLDIR}/${BENCH}_${CONFIG}.xml && \
         ${MCPATDIR}/mcpat -infile ${OUTXMLDIR}/${BENCH}_${CONFIG}.xml -print_level 1 > ${OUTSTATDIR}/${BENCH}_${CONFIG}.txt
     done
 done
@@ -27,7 +27,17 @@ parser.add_argument('--num_mains', type=int, action='store', default=None,
                     help="""Number of main cores.""")
 parser.add_argument('--num_checkers_per_main', type=int, action='store', default=None, 
                     help="""Number of checker cores per main core.""")
+parser.add_argument('--lslNoCStats', type=str, action='store', default=None,
+                    help="""stats.txt of a run of each benchmark with
+                        --lslNoC=crossbar or mesh, with {benchmark} in place
+                        of the benchmark name, to validate the model against.""")
+parser.add_argument('--lslNoCTolerance', type=float, action='store', default=0.25,
+                    help="""Relative difference in LSL flits between the model
+                        and --lslNoCStats above which a benchmark is flagged.""")
 
+# These match the defaults of se.py --lslNoC{Clock,Width,PacketBits}, so the
+# estimates here can be checked against a run with --lslNoC=crossbar or mesh,
+# see --lslNoCStats
 LSLEntryWidth = 128 # Size of LSL entry in bits (average)
 LSLMsgWidth = 512 # Size of LSL data per push in bits
 respMsgWidth = 512 # Size of LLC response data per response in bits
@@ -429,6 +439,44 @@ for benchmark in benchmarks:
                 stats[benchmark]["delta_avgDelay_m" + str(i)] = stats[benchmark]["check_avgDelay_m" + str(i)] - stats[benchmark]["base_avgDelay_m" + str(i)]
             stats[benchmark]["delta_avgDelay"] = math.ceil(math.pow(math.prod([stats[benchmark]["delta_avgDelay_m" + str(i)] for i in range(args.num_mains)]), 1/args.num_mains)) # ceil of geomean of all cores
 
+def parse_noc_stats(filename):
+    # Sum the per main core entries of the system.lslNoC vectors
+    noc = {"packets": 0, "flits": 0, "contentionCycles": 0}
+    with open(filename,'r') as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) < 2 or not fields[0].startswith("system.lslNoC."):
+                continue
+            name, _, index = fields[0][len("system.lslNoC."):].partition("::")
+            if name in noc and index not in ["total", ""]:
+                noc[name] += eval(fields[1])
+    return noc
+
+# Validate the model against --lslNoC runs, on stderr to keep the output file
+if args.lslNoCStats:
+    print("benchmark,model_flits,sim_flits,flit_error,model_wait,sim_wait", file=sys.stderr)
+    for benchmark in benchmarks:
+        try:
+            noc = parse_noc_stats(args.lslNoCStats.format(benchmark=benchmark))
+        except FileNotFoundError:
+            print(benchmark + ": no --lslNoC stats", file=sys.stderr)
+            continue
+        # The model counts LSL traffic in flits, see LSLPKT
+        model_flits = math.fsum([stats[benchmark]["LSLPKT_m" + str(i)] for i in range(args.num_mains)])
+        flit_error = (noc["flits"] - model_flits) / max(model_flits, 1)
+        # M/M/1 waiting time of the LSL flits alone on a main core's
+        # injection link, against the measured contention per packet, both in
+        # main core cycles
+        load = stats[benchmark]["LSLPKT"] / stats[benchmark]["numCycles_checked"]
+        model_wait = load / (service_rate * (service_rate - load)) if load < service_rate else math.inf
+        sim_wait = noc["contentionCycles"] / max(noc["packets"], 1) / service_rate
+        print(",".join([benchmark, str(round(model_flits)), str(noc["flits"]),
+                        "%.3f" % flit_error, "%.3f" % model_wait, "%.3f" % sim_wait]),
+              file=sys.stderr)
+        if abs(flit_error) > args.lslNoCTolerance:
+            print(benchmark + ": LSL flits differ by " + "%.0f%%" % (100 * flit_error) +
+                  " between the model and --lslNoC, check LSLEntryWidth and LSLMsgWidth", file=sys.stderr)
+
 # Generate NocLat output file
 for benchmark in benchmarks:
     if benchmark in ["bc", "bfs", "cc", "pr"]:
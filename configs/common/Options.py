@@ -200,6 +200,10 @@ def addCommonOptions(parser):
                         help="type of cpu to run with")
     parser.add_argument("--num-main-cores", type=int, default=1)
     parser.add_argument("--num-cpu2-main-cores", type=int, default=0)
+    parser.add_argument("--num-cpu1-checkers", type=int, default=0,
+                        help="Last checkers of each main core that are "
+                        "--cpu-type rather than --cpu2-type, for "
+                        "heterogeneous --checkerVoters")
     parser.add_argument("--LargeCapacityDcache", action="store_true", default=False)
     parser.add_argument("--highAssocDcache", action="store_true", default=False)
     parser.add_argument("--blocking", action="store_true", default=False)
@@ -208,9 +212,41 @@ def addCommonOptions(parser):
     parser.add_argument("--stored", action="store_true", default=False)
     parser.add_argument("--extraSlot", action="store", type=int, default=0)
     parser.add_argument("--hashed", action="store_true", default=False)
+    parser.add_argument("--hashEngine", default="sha256",
+                        choices=["sha256", "crc64", "xxh64"],
+                        help="Segment digest used with --hashed")
+    parser.add_argument("--hashLatency", action="store", type=int, default=0,
+                        help="Checker cycles per 512-bit digest block "
+                        "(0 = engine default)")
     parser.add_argument("--sleepguard", action="store_true", default=False)
     parser.add_argument("--opportunistic", action="store_true", default=False)
     parser.add_argument("--samplePeriod", action="store", type=int, default=0)
+    parser.add_argument("--samplePolicy", default="periodic",
+                        choices=["periodic", "random", "coverage"],
+                        help="Which --samplePeriod intervals are checked: "
+                        "one per period, at random, or driven by PC and "
+                        "phase coverage")
+    parser.add_argument("--sampleBudget", action="store", type=float,
+                        default=0.1,
+                        help="Fraction of the instructions the random and "
+                        "coverage --samplePolicy check")
+    parser.add_argument("--sampleCoverage", action="store", type=float,
+                        default=0.99,
+                        help="Check the next interval when less of one ran "
+                        "at verified PCs (--samplePolicy=coverage)")
+    parser.add_argument("--samplePhaseThreshold", action="store", type=float,
+                        default=0.5,
+                        help="Signature distance to every checked phase "
+                        "above which an interval is a new phase (0-2)")
+    parser.add_argument("--sampleExplore", action="store", type=float,
+                        default=0.02,
+                        help="Chance of checking an interval with no other "
+                        "reason to (--samplePolicy=coverage)")
+    parser.add_argument("--coverageDump", default="none",
+                        choices=["none", "csv", "binary"],
+                        help="At every stats dump, append the PC and static "
+                        "instruction coverage gained since the last one to "
+                        "coverage.csv or coverage.bin")
     parser.add_argument("--victim", action="store_true", default=False)
     parser.add_argument("--hardErrorCore", action="store", type=int, default=0, 
                         help="Bitmap of which main core has induced error")
@@ -226,10 +262,92 @@ def addCommonOptions(parser):
     parser.add_argument("--floatOpErrRate", action="store", type=float, default=0.0)
     parser.add_argument("--intOpErrRate", action="store", type=float, default=0.0)
     parser.add_argument("--ALUOpErrRate", action="store", type=float, default=0.0)
+    parser.add_argument("--injectionSeed", action="store", type=int,
+                        default=258958529,
+                        help="Seed of the per-core error injection streams")
+    parser.add_argument("--injectionPlan", default="",
+                        help="injection_plan.txt of an earlier run to replay "
+                        "its injections exactly")
     parser.add_argument("--AIMDoff", action="store_true", default=False)
     parser.add_argument("--cptTimeout", action="store", type=int, default=5000)
+    parser.add_argument("--cptPolicy", default="aimd",
+                        choices=["aimd", "model"],
+                        help="How the checkpoint timeout adapts, ignored "
+                        "with --AIMDoff")
     parser.add_argument("--lslSize", action="store", type=int, default=4096)
     parser.add_argument("--minorCommitBypass", action="store_true", default=False)
+    parser.add_argument("--checkerPool", default="static",
+                        choices=["static", "shared"],
+                        help="Whether main cores with no free checker can "
+                        "take over idle checkers of other main cores; "
+                        "shared needs a single event queue")
+    parser.add_argument("--stealPolicy", default="nearest",
+                        choices=["nearest", "eager", "richest"],
+                        help="Which idle checker is taken with "
+                        "--checkerPool=shared")
+    parser.add_argument("--checkerVoters", action="store", type=int,
+                        default=1,
+                        help="Checkers that vote on a segment with the main "
+                        "core; one disagreeing no longer rolls back if the "
+                        "others outvote it")
+    parser.add_argument("--functionalCheckers", action="store_true",
+                        help="Check segments functionally, charging an "
+                        "analytic latency instead of ticking the Minor "
+                        "checker pipelines; for coverage studies. Every "
+                        "checker has to be a MinorCPU")
+    parser.add_argument("--functionalCheckerIPC", action="store",
+                        type=float, default=1.0,
+                        help="IPC of functional checkers, from the "
+                        "functionalCheckerIPC line of delays.txt")
+    parser.add_argument("--functionalCheckerWakeup", action="store",
+                        type=int, default=0,
+                        help="Checker cycles from wakeup to first commit of "
+                        "functional checkers, from the same line")
+    parser.add_argument("--lslNoC", default="ideal",
+                        choices=["ideal", "crossbar", "mesh"],
+                        help="Interconnect loadstorelog entries take to the "
+                        "checkers; ideal makes them visible at once")
+    parser.add_argument("--lslNoCClock", default="2GHz",
+                        help="Clock of the --lslNoC interconnect")
+    parser.add_argument("--lslNoCWidth", action="store", type=int,
+                        default=256, help="--lslNoC link width in bits")
+    parser.add_argument("--lslNoCPacketBits", action="store", type=int,
+                        default=512,
+                        help="Entry bits pushed per --lslNoC packet")
+    parser.add_argument("--lslNoCHopCycles", action="store", type=int,
+                        default=1,
+                        help="--lslNoC cycles per router and link")
+    parser.add_argument("--lslNoCQueue", action="store", type=int,
+                        default=4,
+                        help="Packets a main core can queue for --lslNoC "
+                        "injection before it stops committing")
+    parser.add_argument("--lslNoCMeshCols", action="store", type=int,
+                        default=0,
+                        help="Columns of the --lslNoC=mesh (0 = square)")
+    parser.add_argument("--lslCompressor", default="none",
+                        choices=["none", "bdi", "fpc", "cpack"],
+                        help="Model loadstorelog entries compressed with "
+                        "address deltas, zero elision and this compressor "
+                        "for their data, in the log size and on the NoC")
+    parser.add_argument("--lslStreamDepth", action="store", type=int,
+                        default=0,
+                        help="Entries a checker-side stream buffer fetches "
+                        "ahead of checker loads, waking blocked checkers "
+                        "only when their entry arrives (0 = none)")
+    parser.add_argument("--lslStreamLatency", action="store", type=int,
+                        default=2,
+                        help="Checker cycles an entry takes to reach the "
+                        "--lslStreamDepth buffer")
+    parser.add_argument("--forkSweep", default=None,
+                        help="After instantiating (and restoring), fork one "
+                        "copy-on-write child per line of this file. Each "
+                        "line is whitespace-separated key=value overrides "
+                        "of cpu2_clock, cptTimeout, lslSize and the "
+                        "*ErrRate options, plus name= for the child's "
+                        "output directory under the parent's")
+    parser.add_argument("--forkJobs", action="store", type=int, default=0,
+                        help="Children of --forkSweep run at once "
+                        "(0 = one per host core)")
     parser.add_argument("--list-bp-types",
                         action=ListBp, nargs=0,
                         help="List available branch predictor types")
@@ -245,6 +363,9 @@ def addCommonOptions(parser):
     parser.add_argument("--indirect-bp-type", default=None,
                         choices=ObjectList.indirect_bp_list.get_names(),
                         help="type of indirect branch predictor to run with")
+    parser.add_argument("--l2TLBAssoc", action="store", type=int, default=0,
+                        help="Ways of the hashed set-associative shared L2 "
+                        "TLB; 0 keeps it fully associative")
 
     parser.add_argument("--list-rp-types",
                         action=ListRP, nargs=0,
@@ -398,6 +519,18 @@ def addCommonOptions(parser):
                         help="restore from checkpoint <N>")
     parser.add_argument("--checkpoint-at-end", action="store_true",
                         help="take a checkpoint at end of run")
+    parser.add_argument("--pmem-cpt-format", default="gzip",
+                        choices=["gzip", "chunked"],
+                        help="format of the physical memory in checkpoints "
+                        "taken; chunked is sparse, parallel and restored "
+                        "lazily")
+    parser.add_argument("--pmem-cpt-threads", action="store", type=int,
+                        default=1,
+                        help="host threads used for chunked memory "
+                        "checkpoints (0 = all)")
+    parser.add_argument("--pmem-eager-restore", action="store_true",
+                        help="restore chunked memory checkpoints up front "
+                        "instead of on first touch")
     parser.add_argument(
         "--work-begin-checkpoint-count", action="store", type=int,
         help="checkpoint at specified work begin count")
@@ -37,6 +37,7 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import os
 import sys
 from os import getcwd
 from os.path import join as joinpath
@@ -115,6 +116,16 @@ def setCPU2Class(options):
 
     return (TmpClass, test_mem_mode, CPUClass)
 
+def isCpu1Checker(options, i):
+    """Whether cpu i is a checker of the --cpu-type rather than the
+       --cpu2-type, i.e. one of the last --num-cpu1-checkers checkers of
+       its main core.
+    """
+
+    nm = options.num_main_cores
+    cpm = max(1, (options.num_cpus - nm) // max(1, nm))
+    return i >= nm and (i - nm) % cpm >= cpm - options.num_cpu1_checkers
+
 def setMemClass(options):
     """Returns a memory controller class."""
 
@@ -451,6 +462,111 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
             exit_event = m5.simulate(maxtick - m5.curTick())
             return exit_event
 
+# Error rates in the order System.retuneChecking takes them
+errRateNames = ["loadstoreErrRate", "TCStateErrRate", "UniversalOpErrRate",
+                "floatOpErrRate", "intOpErrRate", "ALUOpErrRate"]
+
+def parseForkSweep(options):
+    """Returns one dict of option overrides per --forkSweep config."""
+    keys = ["name", "cpu2_clock", "cptTimeout", "lslSize"] + errRateNames
+    sweep = []
+    with open(options.forkSweep) as f:
+        for lineno, line in enumerate(f, 1):
+            delta = {}
+            for item in line.split("#", 1)[0].split():
+                key, sep, value = item.partition("=")
+                if not sep or key not in keys:
+                    fatal("%s:%d: bad fork sweep setting '%s', expected "
+                          "key=value with key one of %s",
+                          options.forkSweep, lineno, item, ", ".join(keys))
+                delta[key] = value
+            if delta:
+                delta.setdefault("name", "fork%d" % len(sweep))
+                sweep.append(delta)
+    if not sweep:
+        fatal("No configs in %s", options.forkSweep)
+    names = [delta["name"] for delta in sweep]
+    if len(set(names)) != len(names):
+        fatal("Fork sweep configs in %s need distinct names",
+              options.forkSweep)
+    return sweep
+
+def forkSweepClocks(options, sweep):
+    """Returns the checker clocks of a sweep, fastest first. They are the
+       DVFS levels of cpu2_clk_domain that each child picks from."""
+    clocks = {}
+    for delta in [vars(options)] + sweep:
+        if "cpu2_clock" in delta:
+            freq = m5.util.convert.toFrequency(delta["cpu2_clock"])
+            clocks.setdefault(freq, delta["cpu2_clock"])
+    return [clocks[freq] for freq in sorted(clocks, reverse=True)]
+
+def reapForkSweep(running, failed):
+    pid, status = os.wait()
+    name = running.pop(pid)
+    if status != 0:
+        print("Fork sweep config %s failed with status %#x" % (name, status))
+        failed.append(name)
+
+def forkSweep(options, testsys):
+    """Forks one child per --forkSweep config. They share the instantiated
+       and restored simulator copy-on-write and each run on their own with
+       the config applied and a subdirectory of the output directory.
+       Returns False in the children and True in the parent, once every
+       child has exited."""
+    if not m5.listenersDisabled():
+        fatal("--forkSweep needs listeners disabled (--listener-mode=off)")
+    sweep = parseForkSweep(options)
+    freqs = [m5.util.convert.toFrequency(c)
+             for c in forkSweepClocks(options, sweep)]
+
+    # Fault in a lazily restored memory image once, not in every child
+    testsys.getCCObject().finishMemoryRestore()
+
+    jobs = options.forkJobs if options.forkJobs > 0 else os.cpu_count()
+    running = {}
+    failed = []
+    for delta in sweep:
+        while len(running) >= jobs:
+            reapForkSweep(running, failed)
+        pid = m5.fork(joinpath("%(parent)s", delta["name"]))
+        if pid == 0:
+            applyForkDelta(options, testsys, delta, freqs)
+            return False
+        print("Fork sweep config %s running as pid %d" % (delta["name"], pid))
+        running[pid] = delta["name"]
+    while running:
+        reapForkSweep(running, failed)
+
+    if failed:
+        fatal("Fork sweep configs failed: %s", ", ".join(failed))
+    return True
+
+def applyForkDelta(options, testsys, delta, freqs):
+    # The parent's redirected output would otherwise interleave
+    if m5.options.redirect_stdout:
+        fd = os.open(joinpath(m5.options.outdir, m5.options.stdout_file),
+                     os.O_WRONLY | os.O_CREAT | os.O_TRUNC)
+        os.dup2(fd, sys.stdout.fileno())
+        if not m5.options.redirect_stderr:
+            os.dup2(fd, sys.stderr.fileno())
+    if m5.options.redirect_stderr:
+        fd = os.open(joinpath(m5.options.outdir, m5.options.stderr_file),
+                     os.O_WRONLY | os.O_CREAT | os.O_TRUNC)
+        os.dup2(fd, sys.stderr.fileno())
+
+    for key, value in delta.items():
+        if key != "name":
+            setattr(options, key, type(getattr(options, key))(value))
+    print("Fork sweep config %s: %s" % (delta["name"], " ".join(
+        "%s=%s" % (key, getattr(options, key)) for key in
+        ["cpu2_clock", "cptTimeout", "lslSize"] + errRateNames)))
+
+    testsys.cpu2_clk_domain.getCCObject().setPerfLevel(freqs.index(
+        m5.util.convert.toFrequency(options.cpu2_clock)))
+    testsys.getCCObject().retuneChecking(options.cptTimeout, options.lslSize,
+        [getattr(options, name) for name in errRateNames])
+
 def run(options, root, testsys, cpu_class, cpu2_class):
     if options.checkpoint_dir:
         cptdir = options.checkpoint_dir
@@ -492,9 +608,9 @@ def run(options, root, testsys, cpu_class, cpu2_class):
 
     if cpu_class:
         if cpu_class != AtomicSimpleCPU:
-            switch_cpus = [cpu_class(switched_out=True, cpu_id=i,isChecked=options.checked,isStored=options.stored,isSleepGuarded=options.sleepguard,canContinueUnchecked=options.opportunistic,samplePeriod=options.samplePeriod) for i in range(0,nm-nm2)] + [cpu2_class(switched_out=True, cpu_id=i,isChecked=options.checked,isStored=options.stored,isSleepGuarded=options.sleepguard,canContinueUnchecked=options.opportunistic,samplePeriod=options.samplePeriod) for i in range(nm-nm2,nm)] + [cpu2_class(switched_out=True,isChecked=False,isStored=False,isChecker=options.checked or options.stored, cpu_id=i) for i in range(nm,np)]
+            switch_cpus = [cpu_class(switched_out=True, cpu_id=i,isChecked=options.checked,isStored=options.stored,isSleepGuarded=options.sleepguard,canContinueUnchecked=options.opportunistic,samplePeriod=options.samplePeriod) for i in range(0,nm-nm2)] + [cpu2_class(switched_out=True, cpu_id=i,isChecked=options.checked,isStored=options.stored,isSleepGuarded=options.sleepguard,canContinueUnchecked=options.opportunistic,samplePeriod=options.samplePeriod) for i in range(nm-nm2,nm)] + [(cpu_class if isCpu1Checker(options, i) else cpu2_class)(switched_out=True,isChecked=False,isStored=False,isChecker=options.checked or options.stored, cpu_id=i) for i in range(nm,np)]
         else :
-            switch_cpus = [cpu_class(switched_out=True, cpu_id=i) for i in range(0,nm)] + [cpu2_class(switched_out=True, cpu_id=i) for i in range(nm,np)]
+            switch_cpus = [cpu_class(switched_out=True, cpu_id=i) for i in range(0,nm)] + [(cpu_class if isCpu1Checker(options, i) else cpu2_class)(switched_out=True, cpu_id=i) for i in range(nm,np)]
 
         for i in range(np):
             if options.fast_forward:
@@ -654,6 +770,10 @@ def run(options, root, testsys, cpu_class, cpu2_class):
     if options.initialize_only:
         return
 
+    # With --forkSweep only the children go on to simulate
+    if options.forkSweep and forkSweep(options, testsys):
+        return
+
     # Handle the max tick settings now that tick frequency was resolved
     # during system instantiation
     # NOTE: the maxtick variable here is in absolute ticks, so it must
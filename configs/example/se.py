@@ -175,6 +175,10 @@ if args.smt and args.num_cpus > 1:
 np = args.num_cpus
 nm = args.num_main_cores
 nm2 = args.num_cpu2_main_cores
+# The last --num-cpu1-checkers checkers of each main core are CPUClass, for
+# heterogeneous voting
+def is_cpu1_checker(i):
+    return Simulation.isCpu1Checker(args, i)
 mp0_path = multiprocesses[0].executable
 if CPUClass != AtomicSimpleCPU:
     system = System(cpu = \
@@ -182,7 +186,7 @@ if CPUClass != AtomicSimpleCPU:
                 for i in range(0,nm-nm2)] + \
             [CPUClass2(cpu_id=i,isChecked=args.checked,isStored=args.stored,isSleepGuarded=args.sleepguard,canContinueUnchecked=args.opportunistic,samplePeriod=args.samplePeriod,fake_reqs_enabled=args.fake_reqs) \
                 for i in range(nm-nm2,nm)] + \
-            [CPUClass2(cpu_id=i,isChecked=False,isStored=False,isChecker=args.checked or args.stored,fake_reqs_enabled=args.fake_reqs) \
+            [(CPUClass if is_cpu1_checker(i) else CPUClass2)(cpu_id=i,isChecked=False,isStored=False,isChecker=args.checked or args.stored,fake_reqs_enabled=args.fake_reqs) \
                 for i in range(nm,np)], \
             mem_mode = test_mem_mode,
             mem_ranges = [AddrRange(args.mem_size)],
@@ -191,6 +195,8 @@ if CPUClass != AtomicSimpleCPU:
             num_checkers = (np - nm),
             extra_slot_per_checker = args.extraSlot,
             hashed = args.hashed,
+            hashEngine = args.hashEngine,
+            hashLatency = args.hashLatency,
             hardErrorCore = args.hardErrorCore,
             hardErrorStuckAt = args.hardErrorStuckAt,
             hardErrorInjectionType = args.hardErrorInjectionType,
@@ -203,10 +209,35 @@ if CPUClass != AtomicSimpleCPU:
             floatOpErrRate = args.floatOpErrRate,
             intOpErrRate = args.intOpErrRate,
             ALUOpErrRate = args.ALUOpErrRate,
+            injectionSeed = args.injectionSeed,
+            injectionPlan = args.injectionPlan,
             AIMDoff = args.AIMDoff,
             cptTimeout = args.cptTimeout,
+            cptPolicy = args.cptPolicy,
             lslSize = args.lslSize,
-            minorCommitBypass = args.minorCommitBypass
+            minorCommitBypass = args.minorCommitBypass,
+            checkerPool = args.checkerPool,
+            stealPolicy = args.stealPolicy,
+            checkerVoters = args.checkerVoters,
+            functionalCheckers = args.functionalCheckers,
+            functionalCheckerIPC = args.functionalCheckerIPC,
+            functionalCheckerWakeup = args.functionalCheckerWakeup,
+            lslNoC = args.lslNoC,
+            lslNoCClock = args.lslNoCClock,
+            lslNoCWidth = args.lslNoCWidth,
+            lslNoCPacketBits = args.lslNoCPacketBits,
+            lslNoCHopCycles = args.lslNoCHopCycles,
+            lslNoCQueue = args.lslNoCQueue,
+            lslNoCMeshCols = args.lslNoCMeshCols,
+            lslStreamDepth = args.lslStreamDepth,
+            lslStreamLatency = args.lslStreamLatency,
+            samplePolicy = args.samplePolicy,
+            sampleInterval = args.samplePeriod,
+            sampleBudget = args.sampleBudget,
+            sampleCoverage = args.sampleCoverage,
+            samplePhaseThreshold = args.samplePhaseThreshold,
+            sampleExplore = args.sampleExplore,
+            coverageDump = args.coverageDump
             )
 else:
     system = System(cpu = [CPUClass(cpu_id=i) for i in range(0,nm)] + [CPUClass2(cpu_id=i) for i in range(nm,np)],
@@ -216,9 +247,17 @@ else:
                 num_mains = nm,
                 num_checkers = (np - nm))
 
+if args.lslCompressor != "none":
+    system.lslCompressor = {"bdi": BDI, "fpc": FPC,
+                            "cpack": CPack}[args.lslCompressor]()
+
 if numThreads > 1:
     system.multi_thread = True
 
+system.pmem_cpt_format = args.pmem_cpt_format
+system.pmem_cpt_threads = args.pmem_cpt_threads
+system.pmem_lazy_restore = not args.pmem_eager_restore
+
 # Create a top-level voltage domain
 system.voltage_domain = VoltageDomain(voltage = args.sys_voltage)
 
@@ -238,6 +277,14 @@ system.cpu2_clk_domain = SrcClockDomain(clock = args.cpu2_clock,
                                        voltage_domain =
                                        system.cpu_voltage_domain)
 
+if args.forkSweep:
+    # Every checker clock of the sweep is a DVFS level of the domain
+    checker_clocks = Simulation.forkSweepClocks(args,
+        Simulation.parseForkSweep(args))
+    system.cpu2_clk_domain.clock = checker_clocks
+    system.cpu2_clk_domain.init_perf_level = \
+        checker_clocks.index(args.cpu2_clock)
+
 # If elastic tracing is enabled, then configure the cpu and attach the elastic
 # trace probe
 if args.elastic_trace_en:
@@ -251,6 +298,10 @@ for cpu in system.cpu:
 for i in range(0,nm-nm2):
     system.cpu[i].clk_domain = system.cpu_clk_domain
 
+for i in range(nm,np):
+    if is_cpu1_checker(i):
+        system.cpu[i].clk_domain = system.cpu_clk_domain
+
 if ObjectList.is_kvm_cpu(CPUClass) or ObjectList.is_kvm_cpu(FutureClass):
     if buildEnv['TARGET_ISA'] == 'x86':
         system.kvm_vm = KvmVM()
@@ -297,6 +348,9 @@ for i in range(np):
             ObjectList.indirect_bp_list.get(args.indirect_bp_type)
         system.cpu[i].branchPred.indirectBranchPred = indirectBPClass()
 
+    if args.l2TLBAssoc:
+        system.cpu[i].mmu.l2_shared.assoc = args.l2TLBAssoc
+
     system.cpu[i].createThreads()
 
 if args.ruby:
@@ -329,5 +383,6 @@ if args.wait_gdb:
     system.workload.wait_for_remote_gdb = True
 
 root = Root(full_system = False, system = system)
+
 Simulation.setWorkCountOptions(system, args)
 Simulation.run(args, root, system, FutureClass, Future2Class)
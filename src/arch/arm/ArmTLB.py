@@ -39,6 +39,7 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.proxy import *
 from m5.objects.BaseTLB import BaseTLB
+from m5.objects.ReplacementPolicies import *
 
 class ArmLookupLevel(Enum):
     vals = [ "L0", "L1", "L2", "L3" ]
@@ -49,6 +50,11 @@ class ArmTLB(BaseTLB):
     cxx_header = "arch/arm/tlb.hh"
     sys = Param.System(Parent.any, "system object parameter")
     size = Param.Int(64, "TLB size")
+    assoc = Param.Int(0, "TLB associativity, 0 for a fully associative "
+        "TLB searched in MRU order. Otherwise entries are indexed by a hash "
+        "of their page number and size")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of a set associative TLB")
     is_stage2 = Param.Bool(False, "Is this a stage 2 TLB?")
 
     partial_levels = VectorParam.ArmLookupLevel([],
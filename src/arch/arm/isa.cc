@@ -37,6 +37,8 @@
 
 #include "arch/arm/isa.hh"
 
+#include <algorithm>
+
 #include "arch/arm/decoder.hh"
 #include "arch/arm/faults.hh"
 #include "arch/arm/htm.hh"
@@ -51,7 +53,9 @@
 #include "base/cprintf.hh"
 #include "cpu/base.hh"
 #include "cpu/checker/cpu.hh"
+#include "cpu/dirty_regs.hh"
 #include "cpu/reg_class.hh"
+#include "cpu/thread_context.hh"
 #include "debug/Arm.hh"
 #include "debug/CCRegs.hh"
 #include "debug/FloatRegs.hh"
@@ -136,12 +140,128 @@ ISA::ISA(const Params &p) : BaseISA(p), system(NULL),
     selfDebug = new SelfDebug();
     initializeMiscRegMetadata();
     preUnflattenMiscReg();
+    initMiscRegReaders();
 
     clear();
 }
 
 std::vector<struct ISA::MiscRegLUTEntry> ISA::lookUpMiscReg(NUM_MISCREGS);
 
+std::vector<std::vector<RegIndex>> ISA::miscRegReaders;
+
+/* Every index flattenMiscIndex() can turn reg into, whatever the state */
+static void
+miscFlatCandidates(int reg, std::vector<int> &flat)
+{
+    if (reg == MISCREG_SPSR) {
+        for (int r : {MISCREG_SPSR, MISCREG_SPSR_EL1, MISCREG_SPSR_EL2,
+                      MISCREG_SPSR_EL3, MISCREG_SPSR_FIQ, MISCREG_SPSR_IRQ,
+                      MISCREG_SPSR_SVC, MISCREG_SPSR_MON, MISCREG_SPSR_ABT,
+                      MISCREG_SPSR_HYP, MISCREG_SPSR_UND})
+            flat.push_back(r);
+    } else if (miscRegInfo[reg][MISCREG_MUTEX]) {
+        switch (reg) {
+          case MISCREG_PRRR_MAIR0:
+          case MISCREG_PRRR_MAIR0_NS:
+          case MISCREG_PRRR_MAIR0_S:
+            miscFlatCandidates(MISCREG_MAIR0 + reg - MISCREG_PRRR_MAIR0,
+                               flat);
+            miscFlatCandidates(MISCREG_PRRR + reg - MISCREG_PRRR_MAIR0,
+                               flat);
+            break;
+          case MISCREG_NMRR_MAIR1:
+          case MISCREG_NMRR_MAIR1_NS:
+          case MISCREG_NMRR_MAIR1_S:
+            miscFlatCandidates(MISCREG_MAIR1 + reg - MISCREG_NMRR_MAIR1,
+                               flat);
+            miscFlatCandidates(MISCREG_NMRR + reg - MISCREG_NMRR_MAIR1,
+                               flat);
+            break;
+          case MISCREG_PMXEVTYPER_PMCCFILTR:
+            miscFlatCandidates(MISCREG_PMCCFILTR, flat);
+            miscFlatCandidates(MISCREG_PMXEVTYPER, flat);
+            break;
+          default:
+            flat.push_back(reg);
+            break;
+        }
+    } else if (miscRegInfo[reg][MISCREG_BANKED] ||
+               miscRegInfo[reg][MISCREG_BANKED64]) {
+        flat.push_back(reg + 1);
+        flat.push_back(reg + 2);
+    } else {
+        flat.push_back(reg);
+    }
+}
+
+void
+ISA::initMiscRegReaders()
+{
+    if (!miscRegReaders.empty())
+        return;
+    miscRegReaders.resize(NUM_MISCREGS);
+
+    // Add the slots getMiscIndices() can map reg to, and return whether
+    // which of them it picks depends on the state
+    auto slots = [](int reg, std::vector<int> &out) {
+        std::vector<int> flat;
+        miscFlatCandidates(reg, flat);
+        bool varies = flat.size() > 1;
+        for (int f : flat) {
+            const auto &lut = lookUpMiscReg[f];
+            if (lut.lower == 0) {
+                out.push_back(f);
+                continue;
+            }
+            for (int half : {lut.lower, lut.upper}) {
+                if (!half)
+                    continue;
+                out.push_back(half);
+                if (miscRegInfo[half][MISCREG_BANKED_CHILD]) {
+                    out.push_back(half + 1);
+                    varies = true;
+                }
+            }
+        }
+        return varies;
+    };
+
+    std::vector<RegIndex> state_readers;
+    std::vector<int> out;
+    for (int reg = 0; reg < NUM_MISCREGS; reg++) {
+        out.clear();
+        if (slots(reg, out))
+            state_readers.push_back(reg);
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        for (int s : out)
+            miscRegReaders[s].push_back(reg);
+    }
+
+    // What flattenMiscIndex() and inSecureState() look at
+    std::vector<int> state{MISCREG_CPSR, MISCREG_SCR, MISCREG_PMSELR};
+    slots(MISCREG_TTBCR, state);
+    for (int s : state) {
+        auto &readers = miscRegReaders[s];
+        readers.insert(readers.end(), state_readers.begin(),
+                       state_readers.end());
+        std::sort(readers.begin(), readers.end());
+        readers.erase(std::unique(readers.begin(), readers.end()),
+                      readers.end());
+    }
+}
+
+void
+ISA::writeMiscSlot(int slot, RegVal val)
+{
+    if (miscRegs[slot] == val)
+        return;
+    miscRegs[slot] = val;
+    DirtyRegs *dirty = tc ? tc->getDirtyRegs() : nullptr;
+    if (dirty)
+        dirty->mark(MiscRegClass, miscRegReaders[slot]);
+}
+
 void
 ISA::clear()
 {
@@ -1096,12 +1216,12 @@ ISA::setMiscRegNoEffect(int misc_reg, RegVal val)
 
     auto v = (val & ~reg.wi()) | reg.rao();
     if (upper > 0) {
-        miscRegs[lower] = bits(v, 31, 0);
-        miscRegs[upper] = bits(v, 63, 32);
+        writeMiscSlot(lower, bits(v, 31, 0));
+        writeMiscSlot(upper, bits(v, 63, 32));
         DPRINTF(MiscRegs, "Writing MiscReg %s (%d %d:%d) : %#x\n",
                 miscRegName[misc_reg], misc_reg, lower, upper, v);
     } else {
-        miscRegs[lower] = v;
+        writeMiscSlot(lower, v);
         DPRINTF(MiscRegs, "Writing MiscReg %s (%d %d) : %#x\n",
                 miscRegName[misc_reg], misc_reg, lower, v);
     }
@@ -1679,7 +1799,7 @@ ISA::setMiscReg(int misc_reg, RegVal val)
                 SCTLR new_sctlr = newVal;
                 new_sctlr.nmfi =  ((bool)sctlr.nmfi) &&
                     !release->has(ArmExtension::VIRTUALIZATION);
-                miscRegs[sctlr_idx] = (RegVal)new_sctlr;
+                writeMiscSlot(sctlr_idx, (RegVal)new_sctlr);
                 getMMUPtr(tc)->invalidateMiscReg();
             }
           case MISCREG_MIDR:
@@ -569,6 +569,21 @@ namespace ArmISA
         RegVal miscRegs[NUM_MISCREGS];
         const RegId *intRegMap;
 
+        /**
+         * For each miscRegs[] slot, the misc registers whose
+         * readMiscRegNoEffect() can return it through banking, muxing or
+         * the SPSR mode mapping. Registers whose mapping depends on the
+         * state are also readers of the CPSR, SCR, TTBCR and PMSELR slots.
+         */
+        static std::vector<std::vector<RegIndex>> miscRegReaders;
+        static void initMiscRegReaders();
+
+        /**
+         * Write a miscRegs[] slot, and if it changed mark every register
+         * that reads it in the thread's DirtyRegs.
+         */
+        void writeMiscSlot(int slot, RegVal val);
+
         void
         updateRegMap(CPSR cpsr)
         {
@@ -270,10 +270,11 @@ MMU::translateSe(const RequestPtr &req, ThreadContext *tc, Mode mode,
     
 	if(tc->contextId() >= NUMBEROFMAINCORES && loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU){
 //	        return std::make_shared<GenericPageTableFault>(vaddr_tainted);
-		int MainCore = (tc->contextId()- NUMBEROFMAINCORES)/NUMBEROFCHECKERCORESPERCORE;
-		Process *np = loadstorelogentry::allCPUMeta[MainCore].baseCPU->getContext(0)->getProcessPtr();
-		p->pTable = np->pTable;
-		p->memState = np->memState;
+		// With a shared checker pool this need not be the main core the
+		// checker shares a Process with, so translate with the main
+		// core's page table rather than copying it over
+		int MainCore = loadstorelogentry::getMainID(tc->contextId());
+		p = loadstorelogentry::allCPUMeta[MainCore].baseCPU->getContext(0)->getProcessPtr();
 	}
 
     if (!p->pTable->translate(vaddr, paddr))
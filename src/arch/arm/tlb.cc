@@ -40,6 +40,7 @@
 
 #include "arch/arm/tlb.hh"
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -47,6 +48,8 @@
 #include "arch/arm/table_walker.hh"
 #include "arch/arm/tlbi_op.hh"
 #include "arch/arm/utility.hh"
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "cpu/thread_context.hh"
 #include "debug/TLB.hh"
@@ -61,6 +64,9 @@ using namespace ArmISA;
 TLB::TLB(const ArmTLBParams &p)
     : BaseTLB(p), table(new TlbEntry[p.size]), size(p.size),
       isStage2(p.is_stage2),
+      assoc(p.assoc), setBits(0),
+      replacementPolicy(p.replacement_policy),
+      pageShifts(0),
       _walkCache(false),
       tableWalker(nullptr),
       stats(*this), rangeMRU(1), vmid(0)
@@ -88,6 +94,26 @@ TLB::TLB(const ArmTLBParams &p)
             partialLevels[lookup_lvl] = false;
         }
     }
+
+    if (assoc) {
+        fatal_if(assoc < 0 || size % assoc,
+                 "%s: size %d is not a multiple of assoc %d\n",
+                 name(), size, assoc);
+        const int sets = size / assoc;
+        fatal_if(!isPowerOf2(sets),
+                 "%s: %d sets is not a power of 2\n", name(), sets);
+        setBits = floorLog2(sets);
+
+        // Not a cache of a main core, so no checkpoint aware replacement
+        replacementPolicy->cpuID = -1;
+        replacementPolicy->setUseVanillaReplacement();
+        ways.resize(size);
+        for (int x = 0; x < size; x++) {
+            ways[x].setPosition(x / assoc, x % assoc);
+            ways[x].replacementData = replacementPolicy->instantiateEntry();
+        }
+        candidates.resize(assoc);
+    }
 }
 
 TLB::~TLB()
@@ -105,19 +131,21 @@ TLB::setTableWalker(TableWalker *table_walker)
 TlbEntry*
 TLB::match(const Lookup &lookup_data)
 {
-    // Vector of TLB entry candidates.
-    // Only one of them will be assigned to retval and will
-    // be returned to the MMU (in case of a hit)
-    // The vector has one entry per lookup level as it stores
+    if (assoc)
+        return matchSet(lookup_data);
+
+    // Index of the TLB entry candidates, or -1.
+    // Only one of them will be returned to the MMU (in case of a hit)
+    // The array has one entry per lookup level as it stores
     // both complete and partial matches
-    std::vector<std::pair<int, const TlbEntry*>> hits{
-        LookupLevel::Num_ArmLookupLevel, {0, nullptr}};
+    std::array<int, LookupLevel::Num_ArmLookupLevel> hits;
+    hits.fill(-1);
 
     int x = 0;
     while (x < size) {
         if (table[x].match(lookup_data)) {
             const TlbEntry &entry = table[x];
-            hits[entry.lookupLevel] = std::make_pair(x, &entry);
+            hits[entry.lookupLevel] = x;
 
             // This is a complete translation, no need to loop further
             if (!entry.partial)
@@ -130,8 +158,8 @@ TLB::match(const Lookup &lookup_data)
     // request, starting from the highest lookup level (complete
     // translation) and iterating backwards (using reverse iterators)
     for (auto it = hits.rbegin(); it != hits.rend(); it++) {
-        const auto& [idx, entry] = *it;
-        if (!entry) {
+        const int idx = *it;
+        if (idx < 0) {
             // No match for the current LookupLevel
             continue;
         }
@@ -140,7 +168,7 @@ TLB::match(const Lookup &lookup_data)
         // We only move the hit entry ahead when the position is higher
         // than rangeMRU
         if (idx > rangeMRU && !lookup_data.functional) {
-            TlbEntry tmp_entry = *entry;
+            TlbEntry tmp_entry = table[idx];
             for (int i = idx; i > 0; i--)
                 table[i] = table[i - 1];
             table[0] = tmp_entry;
@@ -153,6 +181,68 @@ TLB::match(const Lookup &lookup_data)
     return nullptr;
 }
 
+int
+TLB::setOf(Addr vpn, int N) const
+{
+    if (!setBits)
+        return 0;
+    // Fibonacci hashing of the page number and size, so that pages of
+    // different sizes covering the same address use different sets
+    return (((uint64_t)vpn << 6 | N) * 0x9e3779b97f4a7c15ULL) >>
+           (64 - setBits);
+}
+
+TlbEntry*
+TLB::matchSet(const Lookup &lookup_data)
+{
+    std::array<TlbEntry*, LookupLevel::Num_ArmLookupLevel> hits{};
+
+    // Search the set of the looked up address for every page size in use.
+    // An entry is only matched in the set of its own page size.
+    bool complete = false;
+    for (uint64_t shifts = pageShifts; shifts && !complete;
+         shifts &= shifts - 1) {
+        const int n = ctz64(shifts);
+        TlbEntry *set = &table[setOf(lookup_data.va >> n, n) * assoc];
+        for (int w = 0; w < assoc; w++) {
+            TlbEntry &entry = set[w];
+            if (entry.N == n && entry.match(lookup_data)) {
+                hits[entry.lookupLevel] = &entry;
+                if (!entry.partial) {
+                    complete = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // The highest lookup level (complete translation) wins
+    for (auto it = hits.rbegin(); it != hits.rend(); it++) {
+        if (!*it)
+            continue;
+        if (!lookup_data.functional)
+            replacementPolicy->touch(ways[*it - table].replacementData);
+        return *it;
+    }
+
+    return nullptr;
+}
+
+TlbEntry*
+TLB::findVictim(const TlbEntry &entry)
+{
+    const int base = setOf(entry.vpn, entry.N) * assoc;
+    for (int w = 0; w < assoc; w++) {
+        // Flushes do not invalidate the replacement data, so free entries
+        // are taken before the policy is asked
+        if (!table[base + w].valid)
+            return &table[base + w];
+        candidates[w] = &ways[base + w];
+    }
+    ReplaceableEntry *victim = replacementPolicy->getVictim(candidates);
+    return &table[base + victim->getWay()];
+}
+
 TlbEntry*
 TLB::lookup(const Lookup &lookup_data)
 {
@@ -248,19 +338,26 @@ TLB::insert(TlbEntry &entry)
             entry.ap, static_cast<uint8_t>(entry.domain), entry.ns, entry.nstid,
             entry.isHyp);
 
-    if (table[size - 1].valid)
+    TlbEntry *victim = assoc ? findVictim(entry) : &table[size - 1];
+    if (victim->valid)
         DPRINTF(TLB, " - Replacing Valid entry %#x, asn %d vmn %d ppn %#x "
                 "size: %#x ap:%d ns:%d nstid:%d g:%d isHyp:%d el: %d\n",
-                table[size-1].vpn << table[size-1].N, table[size-1].asid,
-                table[size-1].vmid, table[size-1].pfn << table[size-1].N,
-                table[size-1].size, table[size-1].ap, table[size-1].ns,
-                table[size-1].nstid, table[size-1].global, table[size-1].isHyp,
-                table[size-1].el);
-
-    // inserting to MRU position and evicting the LRU one
-    for (int i = size - 1; i > 0; --i)
-        table[i] = table[i-1];
-    table[0] = entry;
+                victim->vpn << victim->N, victim->asid,
+                victim->vmid, victim->pfn << victim->N,
+                victim->size, victim->ap, victim->ns,
+                victim->nstid, victim->global, victim->isHyp,
+                victim->el);
+
+    if (assoc) {
+        *victim = entry;
+        pageShifts |= 1ULL << entry.N;
+        replacementPolicy->reset(ways[victim - table].replacementData);
+    } else {
+        // inserting to MRU position and evicting the LRU one
+        for (int i = size - 1; i > 0; --i)
+            table[i] = table[i-1];
+        table[0] = entry;
+    }
 
     stats.inserts++;
     ppRefills->notify(1);
@@ -310,6 +407,7 @@ TLB::flushAll()
         }
         ++x;
     }
+    pageShifts = 0;
 
     stats.flushTlb++;
 }
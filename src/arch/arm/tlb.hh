@@ -48,6 +48,7 @@
 #include "arch/generic/tlb.hh"
 #include "base/statistics.hh"
 #include "enums/TypeTLB.hh"
+#include "mem/cache/replacement_policies/base.hh"
 #include "mem/request.hh"
 #include "params/ArmTLB.hh"
 #include "sim/probe/pmu.hh"
@@ -123,6 +124,32 @@ class TLB : public BaseTLB
     /** Indicates this TLB caches IPA->PA translations */
     bool isStage2;
 
+    /**
+     * Associativity. 0 if the table is fully associative and kept in
+     * MRU order; otherwise it holds size / assoc sets of assoc entries,
+     * and an entry is indexed by a hash of its virtual page number and
+     * page size, so a lookup only searches one set per page size.
+     */
+    int assoc;
+
+    /** log2 of the number of sets of a set associative TLB */
+    int setBits;
+
+    /** Replacement policy of a set associative TLB */
+    replacement_policy::Base *replacementPolicy;
+
+    /** Set, way and replacement data of each entry of the table */
+    std::vector<ReplaceableEntry> ways;
+
+    /** Victim candidates, reused so that inserting does not allocate */
+    ReplacementCandidates candidates;
+
+    /**
+     * Bit N is set if the table may hold a valid entry with N page
+     * offset bits, so lookups only hash the page sizes in use
+     */
+    uint64_t pageShifts;
+
     /**
      * Hash map containing one entry per lookup level
      * The TLB is caching partial translations from the key lookup level
@@ -336,6 +363,16 @@ class TLB : public BaseTLB
     /** Helper function looking up for a matching TLB entry
      * Does not update stats; see lookup method instead */
     TlbEntry *match(const Lookup &lookup_data);
+
+    /** Set associative version of match */
+    TlbEntry *matchSet(const Lookup &lookup_data);
+
+    /** Set of a set associative TLB holding the page vpn of an entry
+     * with N page offset bits */
+    int setOf(Addr vpn, int N) const;
+
+    /** Entry of a set associative TLB that entry should replace */
+    TlbEntry *findVictim(const TlbEntry &entry);
 };
 
 } // namespace ArmISA
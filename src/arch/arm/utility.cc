@@ -185,9 +185,7 @@ getMPIDR(ArmSystem *arm_sys, ThreadContext *tc)
     assert((0 <= tc->cpuId()) && (tc->cpuId() < 256));
 
 
-    int realCPU = ((tc->contextId() - NUMBEROFMAINCORES) / NUMBEROFCHECKERCORESPERCORE);
-
-    tc = tc->contextId() < NUMBEROFMAINCORES ? tc : loadstorelogentry::allCPUMeta[realCPU].baseCPU->getContext(0);
+    tc = tc->contextId() < NUMBEROFMAINCORES ? tc : loadstorelogentry::allCPUMeta[loadstorelogentry::getMainID(tc->contextId())].baseCPU->getContext(0);
 
     assert(tc->socketId() < 65536);
 
@@ -154,7 +154,8 @@ BaseCPU::BaseCPU(const Params &p, bool is_checker)
       enterPwrGatingEvent([this]{ enterPwrGating(); }, name()), 
       commitBlocked(false), finUnblock(this), checkerWakeupEvent(this), committedInstrs(0),
       loadstorelogSeqNum(1), loadstorelogLastCommitSeqNum(0), 
-      havingASleep(false), sleepGuardOn(false), _isChecker(p.isChecker)
+      havingASleep(false), sleepGuardOn(false), _isChecker(p.isChecker),
+      lslStats(this)
 {
     // if Python did not provide a valid ID, do it here
     if (_cpuId == -1 ) {
@@ -292,6 +293,9 @@ BaseCPU::mwaitAtomic(ThreadID tid, ThreadContext *tc, BaseMMU *mmu)
 void
 BaseCPU::init()
 {
+    if (isChecker() && !_switchedOut)
+        loadstorelogentry::checkFunctionalChecker(this);
+
     // Set up instruction-count-based termination events, if any. This needs
     // to happen after threadContexts has been constructed.
     if (params().max_insts_any_thread != 0) {
@@ -403,6 +407,60 @@ BaseCPUStats::BaseCPUStats(statistics::Group *parent)
 {
 }
 
+BaseCPU::
+LoadStoreLogStats::LoadStoreLogStats(BaseCPU *cpu)
+    : statistics::Group(cpu, "loadstorelog"),
+      ADD_STAT(cptLenTicks, statistics::units::Tick::get(),
+               "Checkpoint length"),
+      ADD_STAT(cptLenInsts, statistics::units::Count::get(),
+               "Instructions committed per checkpoint"),
+      ADD_STAT(lengthToFirstLSL, statistics::units::Count::get(),
+               "Instructions committed before the first loadstorelog entry "
+               "of a checkpoint"),
+      ADD_STAT(lengthFromLastLSL, statistics::units::Count::get(),
+               "Instructions committed after the last loadstorelog entry "
+               "of a checkpoint"),
+      ADD_STAT(cptTimeout, statistics::units::Count::get(),
+               "Checkpoint timeout chosen by the checkpoint length policy"),
+      ADD_STAT(blockedLines, statistics::units::Count::get(),
+               "Uncommitted L1 lines when taking a checkpoint"),
+      ADD_STAT(lslDelay, statistics::units::Tick::get(),
+               "Delay between logging an access and the checker reading it"),
+      ADD_STAT(checkerCptLen, statistics::units::Cycle::get(),
+               "Checker cycles from wake up to validating a checkpoint"),
+      ADD_STAT(firstFetchToCommit, statistics::units::Cycle::get(),
+               "Checker cycles from first fetch to first commit of a "
+               "checkpoint"),
+      ADD_STAT(segmentsChecked, statistics::units::Count::get(),
+               "Segments validated by the checker"),
+      ADD_STAT(foreignSegments, statistics::units::Count::get(),
+               "Segments validated for a main core other than the "
+               "checker's home"),
+      ADD_STAT(checkerBusyCycles, statistics::units::Cycle::get(),
+               "Checker cycles from wake up to validating, summed over "
+               "segments"),
+      ADD_STAT(checkerUtilization, statistics::units::Ratio::get(),
+               "Fraction of cycles the checker spent on a segment",
+               checkerBusyCycles / cpu->baseStats.numCycles)
+{
+    using namespace statistics;
+
+    // Most cores only ever fill one of the two halves
+    cptLenTicks.init(50).flags(pdf | nozero);
+    cptLenInsts.init(50).flags(pdf | nozero);
+    lengthToFirstLSL.init(50).flags(pdf | nozero);
+    lengthFromLastLSL.init(50).flags(pdf | nozero);
+    cptTimeout.init(50).flags(pdf | nozero);
+    blockedLines.init(0).flags(pdf | nozero);
+    lslDelay.init(50).flags(pdf | nozero);
+    checkerCptLen.init(50).flags(pdf | nozero);
+    firstFetchToCommit.init(50).flags(pdf | nozero);
+    segmentsChecked.flags(nozero);
+    foreignSegments.flags(nozero);
+    checkerBusyCycles.flags(nozero);
+    checkerUtilization.flags(nozero);
+}
+
 void
 BaseCPU::regStats()
 {
@@ -715,6 +715,37 @@ public:
     virtual bool sampledCheck() const { return false; }
     virtual bool shouldStartSample(uint64_t currCommittedInsts) const { return false; }
     virtual void updateLastSample(uint64_t currCommittedInsts) {}
+
+    // Histograms kept by loadstorelogentry on behalf of this core, the
+    // first group for main cores and the second for checkers
+    struct LoadStoreLogStats : public statistics::Group
+    {
+        LoadStoreLogStats(BaseCPU *cpu);
+        // Checkpoint length in ticks and in committed instructions
+        statistics::Histogram cptLenTicks;
+        statistics::Histogram cptLenInsts;
+        // Committed instructions before the first and after the last
+        // loadstorelog entry of each checkpoint
+        statistics::Histogram lengthToFirstLSL;
+        statistics::Histogram lengthFromLastLSL;
+        // Checkpoint timeout chosen at each checkpoint (AIMD on)
+        statistics::Histogram cptTimeout;
+        // Uncommitted L1 lines when taking a checkpoint
+        statistics::SparseHistogram blockedLines;
+
+        // Ticks from the main core logging an access to the checker reading
+        statistics::Histogram lslDelay;
+        // Cycles from waking up to validating a checkpoint
+        statistics::Histogram checkerCptLen;
+        // Cycles from the first fetch to the first commit of a checkpoint
+        statistics::Histogram firstFetchToCommit;
+        // Segments validated, those of a main core other than the checker's
+        // home (--checkerPool=shared), and the cycles spent on them
+        statistics::Scalar segmentsChecked;
+        statistics::Scalar foreignSegments;
+        statistics::Scalar checkerBusyCycles;
+        statistics::Formula checkerUtilization;
+    } lslStats;
 };
 
 } // namespace gem5
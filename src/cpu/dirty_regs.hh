@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_DIRTY_REGS_HH__
+#define __CPU_DIRTY_REGS_HH__
+
+#include <array>
+#include <vector>
+
+#include "cpu/reg_class.hh"
+
+namespace gem5
+{
+
+/* Set of architectural registers written since the last time the consumer
+ * (the loadstorelog miniContext snapshots) cleared it. Indices are flattened
+ * register indices. Marking is O(1) and the set can be walked in O(dirty),
+ * so a snapshot only needs to go back to the thread context for registers
+ * that actually changed. Starts out (and can be reset to) "everything dirty"
+ * for when the state is replaced wholesale. Misc registers are marked by
+ * the ISA for every index that reads the storage written, so banked and
+ * aliased views are covered too.
+ */
+class DirtyRegs
+{
+    struct ClassSet
+    {
+        std::vector<bool> mask;
+        std::vector<RegIndex> list;
+    };
+
+    std::array<ClassSet, MiscRegClass + 1> sets;
+    bool all = true;
+
+  public:
+    void
+    mark(RegClassType cls, RegIndex idx)
+    {
+        if (all || cls == InvalidRegClass)
+            return;
+        ClassSet &s = sets[cls];
+        if (idx >= s.mask.size())
+            s.mask.resize(idx + 1, false);
+        if (!s.mask[idx]) {
+            s.mask[idx] = true;
+            s.list.push_back(idx);
+        }
+    }
+
+    void mark(const RegId &reg) { mark(reg.classValue(), reg.index()); }
+
+    void
+    mark(RegClassType cls, const std::vector<RegIndex> &idxs)
+    {
+        for (RegIndex idx : idxs)
+            mark(cls, idx);
+    }
+
+    void markAll() { all = true; }
+
+    bool allDirty() const { return all; }
+
+    const std::vector<RegIndex> &
+    dirty(RegClassType cls) const
+    {
+        return sets[cls].list;
+    }
+
+    void
+    clear()
+    {
+        all = false;
+        for (ClassSet &s : sets) {
+            for (RegIndex idx : s.list)
+                s.mask[idx] = false;
+            s.list.clear();
+        }
+    }
+};
+
+} // namespace gem5
+
+#endif // __CPU_DIRTY_REGS_HH__
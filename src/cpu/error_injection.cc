@@ -12,29 +12,24 @@
 namespace gem5 {
 
 using namespace TheISA;
-int errorinjection::numberOfErroneousWrites = 0;
-int errorinjection::numberOfErroneousReads = 0;
-int errorinjection::numberOfErroneousArchStates = 0;
-int errorinjection::numberOfErroneousTCStates = 0;
-int errorinjection::numberOfErroneousOpClass = 0;
-std::vector<uint64_t> errorinjection::lapses(0,0);
-std::vector<bool> errorinjection::hasInjectedError(1,false);
-std::vector<bool> errorinjection::unchangedInjectedError(1,false);
+std::atomic<int> errorinjection::numberOfErroneousWrites = 0;
+std::atomic<int> errorinjection::numberOfErroneousReads = 0;
+std::atomic<int> errorinjection::numberOfErroneousArchStates = 0;
+std::atomic<int> errorinjection::numberOfErroneousTCStates = 0;
+std::atomic<int> errorinjection::numberOfErroneousOpClass = 0;
+std::vector<std::vector<uint64_t>> errorinjection::lapses;
+std::vector<uint8_t> errorinjection::hasInjectedError(1,false);
+std::vector<uint8_t> errorinjection::unchangedInjectedError(1,false);
 
 unsigned errorinjection::seed = 258958529; // std::chrono::system_clock::now().time_since_epoch().count();
-std::default_random_engine generator(errorinjection::seed);
-std::uniform_int_distribution<int> distrib64(0,63);
-std::uniform_int_distribution<int> distrib32(0,31);
-std::independent_bits_engine<std::default_random_engine, 64, uint64_t> indepGenerator64(errorinjection::seed);
-std::independent_bits_engine<std::default_random_engine, 32, uint32_t> indepGenerator32(errorinjection::seed);
-std::uniform_real_distribution<double> disdouble;
+injectionschedule errorinjection::schedule;
 
 
-int errorinjection::undetectedErrors = 0;
-int errorinjection::falsePositives = 0;
-int errorinjection::cptOnlyUnchangedInjections = 0;
-uint64_t errorinjection::unchangedInjections = 0;
-uint64_t errorinjection::changedInjections = 0;
+std::atomic<int> errorinjection::undetectedErrors = 0;
+std::atomic<int> errorinjection::falsePositives = 0;
+std::atomic<int> errorinjection::cptOnlyUnchangedInjections = 0;
+std::atomic<uint64_t> errorinjection::unchangedInjections = 0;
+std::atomic<uint64_t> errorinjection::changedInjections = 0;
 
 double errorinjection::loadstoreErrRate = 0;
 double errorinjection::TCStateErrRate = 0;
@@ -61,6 +56,12 @@ void errorinjection::setErrRates(std::vector<double> errRates) {
     ALUOpErrRate = errRates[5];
 }
 
+void errorinjection::initSchedule(unsigned s, const std::string &plan, int streams) {
+    seed = s;
+    schedule.init(seed, streams, plan);
+    lapses.assign(streams, {});
+}
+
 bool checkBitSet(unsigned x, unsigned nthBit) {
     return ((1 << nthBit) & x) != 0;
 }
@@ -131,9 +132,14 @@ int getNumTargetFU(int mainCPUID) {
     return numTargetFU;
 }
 
-int roll_dice(int size) {
+// Main cores have the first streams, then the checkers
+int checker_stream(int checkerID) {
+  return NUMBEROFMAINCORES + checkerID;
+}
+
+int roll_dice(int stream, int size) {
   std::uniform_int_distribution<int> distrib(0,size-1);
-  return distrib(generator);
+  return distrib(errorinjection::schedule.payload(stream));
 }
 
 template <class T>
@@ -142,20 +148,20 @@ T compromise_uint(T x, int idx_bit) {
 }
 
 template <class T>
-T compromise_uint(T x) {
-  return compromise_uint(x, roll_dice(8*sizeof(T)));
+T compromise_uint(int stream, T x) {
+  return compromise_uint(x, roll_dice(stream, 8*sizeof(T)));
 }
 
-uint64_t compromise_uint64(uint64_t x) {
-  return compromise_uint<uint64_t>(x, distrib64(generator));
+uint64_t compromise_uint64(int stream, uint64_t x) {
+  return compromise_uint<uint64_t>(stream, x);
 }
-uint32_t compromise_uint32(uint32_t x) {
-  return compromise_uint<uint32_t>(x, distrib32(generator));
+uint32_t compromise_uint32(int stream, uint32_t x) {
+  return compromise_uint<uint32_t>(stream, x);
 }
 
 template <class T>
-void compromise_array_pos(T* x, int pos) {
-  int idx_bit = roll_dice(8*sizeof(T));
+void compromise_array_pos(int stream, T* x, int pos) {
+  int idx_bit = roll_dice(stream, 8*sizeof(T));
   x[pos] ^= ((T)1<<idx_bit);
 }
 
@@ -165,52 +171,37 @@ T stuckAt_uint(T x, int idx_bit, bool stuckAt1) {
   return ((x & (~((T)1<<idx_bit))) | (stuckAtVal<<idx_bit));
 }
 
-#define SET_NEXT_ERROR_INJECTION(id, error_rate)                             \
-      std::geometric_distribution<int64_t> distributionError(1.0/error_rate);    \
-      nextErrorInjection[id] = 1 + distributionError(generator);             \
- //     std::cout << "Voltage: " << loadstorelogentry::voltage[0] << " Error rate: " << UNIVERSAL_ERRORRATE << " Next error: " << nextErrorInjection[id] << "\n"; 
-
-#define PREPARE_DISTRIBUTION(id, domain_size, error_rate)      		         \
-      static std::vector<int64_t> nextErrorInjection(domain_size,-1);                     \
-      static std::vector<int64_t> actualDelay(domain_size,0);                        \
-      if(nextErrorInjection.size() != domain_size) { nextErrorInjection.resize(domain_size); actualDelay.resize(domain_size);  } \
-      if (nextErrorInjection[0]==-1 || errordetection::voltage_reset[id])    \
-        for (int i = 0; i < domain_size; i++) {                              \
-          SET_NEXT_ERROR_INJECTION(i, error_rate)                            \
-        }                                                                    \
-      errordetection::voltage_reset[id] = false;							 \
-      actualDelay[id]++;                                                     \
-      /*nextErrorInjection[id] += errorinjection::hasInjectedError[checkerID]; //commented out to allow multiple errors per checkpoint */\
-      if (--nextErrorInjection[id]>0) return;                                \
-      assert(nextErrorInjection[id]==0);                                     \
+// The rate only changes with the voltage (PARADVFS), in which case the next
+// injection is drawn again; otherwise setting it is a compare.
+#define PREPARE_DISTRIBUTION(stream, cls, error_rate)                        \
+      errorinjection::schedule.setRate(stream, cls, 1.0/(error_rate));       \
+      if (!errorinjection::schedule.fire(stream, cls)) return;               \
       errorinjection::hasInjectedError[checkerID] = true;                    \
-      SET_NEXT_ERROR_INJECTION(id, error_rate)                               \
-      assert(nextErrorInjection[id]>=0);                                     \
-      errorinjection::lapses.push_back(actualDelay[id]);                     \
-      actualDelay[id] = 0;                                                   \
+      errorinjection::lapses.at(stream).push_back(                           \
+          errorinjection::schedule.lastLapse(stream, cls));
 
-#define _If_SHOULD_INJECT_ERROR_MAIN(error_rate)                         \
+#define _If_SHOULD_INJECT_ERROR_MAIN(cls, error_rate)                    \
       int checkerID = loadstorelogentry::mainCPUMeta[cpuID].current_segment_to_fill; \
-      PREPARE_DISTRIBUTION(cpuID, NUMBEROFMAINCORES, error_rate)
+      PREPARE_DISTRIBUTION(cpuID, cls, error_rate)
 
-#define _If_SHOULD_INJECT_ERROR_CHECKER(error_rate) \
-      PREPARE_DISTRIBUTION(checkerID, (NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE), error_rate)
+#define _If_SHOULD_INJECT_ERROR_CHECKER(cls, error_rate) \
+      PREPARE_DISTRIBUTION(checker_stream(checkerID), cls, error_rate)
 
 
 
 #ifdef DEBUG_ERRROR_INJECTION
-#define IF_SHOULD_INJECT_ERROR_MAIN(error_rate, name) \
-      _If_SHOULD_INJECT_ERROR_MAIN(error_rate)        \
+#define IF_SHOULD_INJECT_ERROR_MAIN(cls, error_rate, name) \
+      _If_SHOULD_INJECT_ERROR_MAIN(cls, error_rate)   \
       std::cout << " < Injected error for checker core " << checkerID << " at time " << loadstorelogentry::mainCPUMeta[cpuID].timestamp << " on " << name << std::endl;
-#define IF_SHOULD_INJECT_ERROR_CHECKER(error_rate, name) \
-      _If_SHOULD_INJECT_ERROR_CHECKER(error_rate)        \
+#define IF_SHOULD_INJECT_ERROR_CHECKER(cls, error_rate, name) \
+      _If_SHOULD_INJECT_ERROR_CHECKER(cls, error_rate)   \
       std::cout << " < Injected error for checker core " << checkerID << " at local time " << loadstorelogentry::checkerCPUMeta[checkerID].timestamps << " (global time: " << loadstorelogentry::mainCPUMeta[checkerID/NUMBEROFCHECKERCORESPERCORE].timestamp << ") on " << name << std::endl;
 #else
-#define IF_SHOULD_INJECT_ERROR_MAIN(error_rate, name) \
-       _If_SHOULD_INJECT_ERROR_MAIN(error_rate)
+#define IF_SHOULD_INJECT_ERROR_MAIN(cls, error_rate, name) \
+       _If_SHOULD_INJECT_ERROR_MAIN(cls, error_rate)
 
-#define IF_SHOULD_INJECT_ERROR_CHECKER(error_rate, name) \
-       _If_SHOULD_INJECT_ERROR_CHECKER(error_rate)
+#define IF_SHOULD_INJECT_ERROR_CHECKER(cls, error_rate, name) \
+       _If_SHOULD_INJECT_ERROR_CHECKER(cls, error_rate)
 
 #endif
 
@@ -223,7 +214,7 @@ void compromise_loadstorelogentry(int cpuID, void* ll) {
 
   loadstorelogentry* l = (loadstorelogentry*)ll;
   if (!l->load) return;
-  IF_SHOULD_INJECT_ERROR_MAIN(LOADSTORE_ERRORRATE, (l->load?"load":"store"));
+  IF_SHOULD_INJECT_ERROR_MAIN(injectionschedule::LoadStore, LOADSTORE_ERRORRATE, (l->load?"load":"store"));
 
   // if (l->load) errorinjection::numberOfErroneousReads++;
   // else         errorinjection::numberOfErroneousWrites++;
@@ -233,7 +224,8 @@ void compromise_loadstorelogentry(int cpuID, void* ll) {
     #ifdef DEBUG_ERRROR_INJECTION
     std::cout << "Compromised empty data!" << std::endl;
     #endif
-    l->data.push_back(1);
+    const uint8_t one = 1;
+    l->data.assign(&one, 1, loadstorelogentry::nextSlab(cpuID));
   } else {
     // static int i = 0;
     // int idx = 0;
@@ -244,17 +236,17 @@ void compromise_loadstorelogentry(int cpuID, void* ll) {
     // ++i;
     // Try 1 3 7 0 on bitcount
 
-    int idx_data = roll_dice(l->data.size());
-    compromise_array_pos<uint8_t>(l->data.data(), idx_data);
+    int idx_data = roll_dice(cpuID, l->data.size());
+    compromise_array_pos<uint8_t>(cpuID, l->data.data(), idx_data);
   }
 #endif
 }
 
 
-void corrupt_value_reg(ThreadContext* tc, regSafeEntry e) {
+void corrupt_value_reg(int stream, ThreadContext* tc, regSafeEntry e) {
   switch(e.reg_class) {
     case IntRegClass:
-      tc->setIntRegFlat(e.idx, compromise_uint64(e.value));
+      tc->setIntRegFlat(e.idx, compromise_uint64(stream, e.value));
     break;
 /*
     case VecRegClass:
@@ -262,11 +254,11 @@ void corrupt_value_reg(ThreadContext* tc, regSafeEntry e) {
     break;
 */
     case CCRegClass:
-      tc->setCCReg(e.idx, compromise_uint64(e.value));
+      tc->setCCReg(e.idx, compromise_uint64(stream, e.value));
     break;
 
     case MiscRegClass:
-      tc->setMiscRegNoEffect(e.idx, compromise_uint64(e.value));
+      tc->setMiscRegNoEffect(e.idx, compromise_uint64(stream, e.value));
     break;
 
     default:
@@ -337,12 +329,13 @@ void compromise_thread_context_state(int checkerID, int reg_type, int idx) {
 
 //TODO: Lionel's implementation only compromises reg_type 2. Not sure why...
 
-  IF_SHOULD_INJECT_ERROR_CHECKER(TCSTATE_ERRORRATE, "tc state")
+  IF_SHOULD_INJECT_ERROR_CHECKER(injectionschedule::TCState, TCSTATE_ERRORRATE, "tc state")
 
   errorinjection::numberOfErroneousTCStates++;
   ThreadContext* tc = loadstorelogentry::allCPUMeta[checkerID+NUMBEROFMAINCORES].baseCPU->getContext(0);
 
-  if (reg_type==-1) reg_type = roll_dice(4); // will be roll_dice(5) when fixed
+  int stream = checker_stream(checkerID);
+  if (reg_type==-1) reg_type = roll_dice(stream, 4); // will be roll_dice(5) when fixed
   switch (reg_type) {
  /*   case 0: {
 
@@ -361,10 +354,10 @@ void compromise_thread_context_state(int checkerID, int reg_type, int idx) {
 */
     case 2: {
 #ifdef ISA_HAS_CC_REGS
-      if (idx==-1) idx = roll_dice(NumCCRegs);
+      if (idx==-1) idx = roll_dice(stream, NumCCRegs);
       CCRegClass x =  tc->getReg(idx);
       RegId reg(CCRegClass, idx);
-      tc->setReg(reg,  compromise_uint64(x)));
+      tc->setReg(reg,  compromise_uint64(stream, x)));
 #endif
     }
     break;
@@ -513,8 +506,8 @@ bool modify_value_vecReg(ThreadContext* tc, RegClassType reg_class, uint64_t idx
     return changed;
 }
 
-void randomise_value_reg(ThreadContext* tc, RegClassType reg_class, uint64_t idx) {
-  modify_value_reg(tc, reg_class, idx, indepGenerator64());
+void randomise_value_reg(int stream, ThreadContext* tc, RegClassType reg_class, uint64_t idx) {
+  modify_value_reg(tc, reg_class, idx, errorinjection::schedule.payload(stream)());
 }
 
 bool stuckAt_reg(ThreadContext* tc, RegClassType reg_class, uint64_t idx, uint64_t orig_val, int idx_bit, bool stuckAt1) {
@@ -690,9 +683,13 @@ bool injectFUdestError(int checkerID) {
       && loadstorelogentry::checkerCPUMeta[checkerID].timestamps > 10; // do not inject error on the first 10 checkpoints
 }
 
-bool shouldInjectError(double errRate) {
-  double rand_val = disdouble(generator);
-  return (rand_val > 0) && (rand_val < errRate);
+bool shouldInjectError(int checkerID) {
+  int stream = checker_stream(checkerID);
+  if (!errorinjection::schedule.hasRate(stream, injectionschedule::FUdest)) {
+    errorinjection::schedule.setRate(stream, injectionschedule::FUdest,
+        errorinjection::UniversalOpErrRate/getNumTargetFU(checkerID/NUMBEROFCHECKERCORESPERCORE));
+  }
+  return errorinjection::schedule.fire(stream, injectionschedule::FUdest);
 }
 
 void stuckAt_stats(int checkerID, bool changed) {
@@ -714,7 +711,7 @@ bool stuckAt_instruction_result(int checkerID, StaticInstPtr staticInst, ThreadC
     assert(checkerID < NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
     assert(injectFUdestError(checkerID));
     bool error_inserted = false;
-    if (shouldInjectError(errorinjection::UniversalOpErrRate/getNumTargetFU(checkerID/NUMBEROFCHECKERCORESPERCORE))) {
+    if (shouldInjectError(checkerID)) {
         bool modified = false;
         for (regSafeEntry e : *before_instr) {
             if (e.reg_class == VecRegClass || e.reg_class == VecPredRegClass) {
@@ -837,7 +834,7 @@ bool stuckAt_instruction_result(int checkerID, StaticInstPtr staticInst, ThreadC
 bool stuckAt_instruction_result_o3(int checkerID, o3::DynInstPtr inst, regSafe* before_instr, int idx_bit, bool stuckAt1) {
     assert(injectFUdestError(checkerID));
     bool error_inserted = false;
-    if (shouldInjectError(errorinjection::UniversalOpErrRate/getNumTargetFU(checkerID/NUMBEROFCHECKERCORESPERCORE))) {
+    if (shouldInjectError(checkerID)) {
         bool modified = false;
         for (regSafeEntry e : *before_instr) {
             uint64_t newValue;
@@ -881,7 +878,7 @@ void compromise_instruction_result(int checkerID, StaticInstPtr staticInst, Thre
   OpClass opclass = staticInst->opClass();
   if (!(OPCLASS_TARGET)) return;
 
-  IF_SHOULD_INJECT_ERROR_CHECKER(OPCLASS_ERRORRATE, "op class")
+  IF_SHOULD_INJECT_ERROR_CHECKER(injectionschedule::OpClass, OPCLASS_ERRORRATE, "op class")
 
   bool modified = false;
   for (regSafeEntry e : *before_instr) {
@@ -895,12 +892,11 @@ void compromise_instruction_result(int checkerID, StaticInstPtr staticInst, Thre
   if (modified) {
     errorinjection::numberOfErroneousOpClass++;
     for (regSafeEntry e : *before_instr) {
-      randomise_value_reg(tc, e.reg_class, e.idx);
+      randomise_value_reg(checker_stream(checkerID), tc, e.reg_class, e.idx);
     }
   } else {
-    nextErrorInjection.at(checkerID) = 1;
-    actualDelay.at(checkerID) = errorinjection::lapses.back();
-    errorinjection::lapses.pop_back();
+    errorinjection::schedule.retry(checker_stream(checkerID), injectionschedule::OpClass);
+    errorinjection::lapses.at(checker_stream(checkerID)).pop_back();
     errorinjection::hasInjectedError.at(checkerID) = false;
 #ifdef DEBUG_ERRROR_INJECTION
     std::cout << " --> cancelled (no modified register)" << std::endl;
@@ -1,12 +1,14 @@
 #ifndef ERROR_INJECTION_H
 #define ERROR_INJECTION_H
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <map>
 #include <random>
 #include <set>
 
+#include "cpu/injection_schedule.hh"
 #include "cpu/reg_class.hh"
 #include "cpu/thread_context.hh"
 #include "mem/cache/loadstorelogentry.hh"
@@ -69,19 +71,21 @@ public:
     enum hardErrStructTypes{
         None, FUdest, LSLentry, RF
     };
-    static std::vector<bool> hasInjectedError;//[NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE];
-    static std::vector<bool> unchangedInjectedError;
-    static int numberOfErroneousWrites;
-    static int numberOfErroneousReads;
-    static int numberOfErroneousArchStates;
-    static int numberOfErroneousTCStates;
-    static int numberOfErroneousOpClass;
-
-    static int undetectedErrors;
-    static int falsePositives;
-    static int cptOnlyUnchangedInjections;
-    static uint64_t unchangedInjections;
-    static uint64_t changedInjections;
+    // One byte per checker rather than std::vector<bool>, so that checkers
+    // simulated on different threads never share a word
+    static std::vector<uint8_t> hasInjectedError;//[NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE];
+    static std::vector<uint8_t> unchangedInjectedError;
+    static std::atomic<int> numberOfErroneousWrites;
+    static std::atomic<int> numberOfErroneousReads;
+    static std::atomic<int> numberOfErroneousArchStates;
+    static std::atomic<int> numberOfErroneousTCStates;
+    static std::atomic<int> numberOfErroneousOpClass;
+
+    static std::atomic<int> undetectedErrors;
+    static std::atomic<int> falsePositives;
+    static std::atomic<int> cptOnlyUnchangedInjections;
+    static std::atomic<uint64_t> unchangedInjections;
+    static std::atomic<uint64_t> changedInjections;
 
     static double loadstoreErrRate;
     static double TCStateErrRate;
@@ -97,14 +101,17 @@ public:
     static std::map<OpClass, std::set<std::string>> multiDestOpClasses;
     static std::map<OpClass, std::set<std::string>> destRegOpClasses;
 
-    static std::vector<uint64_t> lapses;
+    /* Lapses of the injections made, per injection stream. A stream is
+     * only driven from its core's event queue, so needs no lock */
+    static std::vector<std::vector<uint64_t>> lapses;
 
     static unsigned seed;
-    static std::default_random_engine generator;
+    static injectionschedule schedule;
 
     static bool exitOnErr;
 
     static void setErrRates(std::vector<double> errRates);
+    static void initSchedule(unsigned seed, const std::string &plan, int streams);
     static void setHardErr(unsigned errBit, unsigned errStID, 
         std::string errStType, unsigned stuckAt, unsigned errMain, 
         unsigned numMains, unsigned numCheckersPerMain, bool exit_on_error);
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/injection_schedule.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+static const char *errclassNames[] = {
+    "loadstore", "tcstate", "opclass", "fudest"
+};
+
+void
+injectionschedule::init(unsigned seed, int n, const std::string &plan)
+{
+    static_assert(sizeof(errclassNames) / sizeof(errclassNames[0]) ==
+                  NumClasses);
+
+    streams = std::vector<stream>(n);
+    for (int s = 0; s < n; s++) {
+        for (int c = 0; c < NumClasses; c++) {
+            std::seed_seq seq{seed, (unsigned)s, (unsigned)c};
+            streams[s].counters[c].engine.seed(seq);
+        }
+        std::seed_seq seq{seed, (unsigned)s, (unsigned)NumClasses};
+        streams[s].payload.seed(seq);
+    }
+
+    replaying = !plan.empty();
+    if (!replaying)
+        return;
+
+    std::ifstream in(plan);
+    fatal_if(!in, "Can't open injection plan %s\n", plan);
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream ls(line);
+        int s;
+        std::string name;
+        uint64_t event;
+        fatal_if(!(ls >> s >> name >> event),
+                 "%s:%d: expected \"stream class event\"\n", plan, lineNo);
+        fatal_if(s < 0 || s >= n, "%s:%d: no stream %d in this system\n",
+                 plan, lineNo, s);
+        auto it = std::find(std::begin(errclassNames),
+                            std::end(errclassNames), name);
+        fatal_if(it == std::end(errclassNames),
+                 "%s:%d: unknown error class %s\n", plan, lineNo, name);
+        streams[s].counters[it - std::begin(errclassNames)].plan
+            .push_back(event);
+    }
+    for (stream &st : streams) {
+        for (counter &k : st.counters)
+            std::sort(k.plan.begin(), k.plan.end());
+    }
+}
+
+void
+injectionschedule::draw(counter &k)
+{
+    if (replaying) {
+        k.next = never;
+        // Entries at or before the current event have been overtaken by a
+        // retry and can't be honoured any more
+        while (!k.plan.empty() && k.plan.front() <= k.events)
+            k.plan.pop_front();
+        if (!k.plan.empty()) {
+            k.next = k.plan.front();
+            k.plan.pop_front();
+        }
+    } else if (k.p <= 0) {
+        k.next = never;
+    } else if (k.p >= 1) {
+        k.next = k.events + 1;
+    } else {
+        std::geometric_distribution<uint64_t> distance(k.p);
+        k.next = k.events + 1 + distance(k.engine);
+    }
+}
+
+void
+injectionschedule::setRate(int s, errclass c, double p)
+{
+    counter &k = streams[s].counters[c];
+    if (k.p == p)
+        return;
+    // A plan says where the injections are whatever the rate
+    bool first = k.p < 0;
+    k.p = p;
+    if (first || !replaying)
+        draw(k);
+}
+
+void
+injectionschedule::fired(counter &k)
+{
+    k.prevFire = k.lastFire;
+    k.lastFire = k.events;
+    k.injected.push_back(k.events);
+    draw(k);
+}
+
+void
+injectionschedule::retry(int s, errclass c)
+{
+    counter &k = streams[s].counters[c];
+    k.injected.pop_back();
+    k.lastFire = k.prevFire;
+    if (replaying && k.next != never)
+        k.plan.push_front(k.next);
+    k.next = k.events + 1;
+}
+
+bool
+injectionschedule::empty() const
+{
+    for (const stream &st : streams) {
+        for (const counter &k : st.counters) {
+            if (!k.injected.empty())
+                return false;
+        }
+    }
+    return true;
+}
+
+void
+injectionschedule::dumpPlan(std::ostream &os) const
+{
+    os << "# stream class event\n";
+    for (int s = 0; s < streams.size(); s++) {
+        for (int c = 0; c < NumClasses; c++) {
+            for (uint64_t event : streams[s].counters[c].injected)
+                os << s << " " << errclassNames[c] << " " << event << "\n";
+        }
+    }
+}
+
+}
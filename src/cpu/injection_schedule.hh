@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_INJECTION_SCHEDULE_HH__
+#define __CPU_INJECTION_SCHEDULE_HH__
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace gem5
+{
+
+/* Decides which events (checked instructions, log entries...) get an error
+ * injected. Rather than rolling a die on every event, the distance to the
+ * next injection is drawn up front from a geometric distribution, so the
+ * common case is a counter bump and compare.
+ *
+ * There is one stream per core (main cores by context id, then checkers),
+ * each with its own engines seeded from the injection seed and the stream,
+ * so what gets injected on a core doesn't depend on how the other cores
+ * are interleaved or on how many host threads simulate them. A stream is
+ * only touched from the event queue of its own core, so none of this is
+ * locked.
+ *
+ * Every injection is recorded as (stream, class, event number) and can be
+ * written out as a plan; a plan given back replaces the draws, so a run can
+ * be replayed injection for injection.
+ */
+class injectionschedule
+{
+  public:
+    enum errclass
+    {
+        LoadStore,
+        TCState,
+        OpClass,
+        FUdest,
+        NumClasses
+    };
+
+    void init(unsigned seed, int streams, const std::string &plan);
+
+    bool
+    hasRate(int stream, errclass c) const
+    {
+        return streams[stream].counters[c].p >= 0;
+    }
+
+    /* p is the chance of any one event being injected. Setting the rate a
+     * stream already has is a no-op, otherwise the next injection is drawn
+     * again at the new rate. */
+    void setRate(int stream, errclass c, double p);
+
+    /* Count one event of class c on the stream, true if it is to have an
+     * error injected */
+    bool
+    fire(int stream, errclass c)
+    {
+        counter &k = streams[stream].counters[c];
+        if (++k.events < k.next)
+            return false;
+        fired(k);
+        return true;
+    }
+
+    /* The last injection found nothing to corrupt; move it to the next event
+     * and forget it was ever made */
+    void retry(int stream, errclass c);
+
+    /* Events between the last two injections */
+    uint64_t
+    lastLapse(int stream, errclass c) const
+    {
+        const counter &k = streams[stream].counters[c];
+        return k.lastFire - k.prevFire;
+    }
+
+    /* For the payload of an injection: which entry, which bit... */
+    std::mt19937_64 &payload(int stream) { return streams[stream].payload; }
+
+    bool empty() const;
+    void dumpPlan(std::ostream &os) const;
+
+  private:
+    static constexpr uint64_t never = std::numeric_limits<uint64_t>::max();
+
+    struct counter
+    {
+        uint64_t events = 0;
+        uint64_t next = never;
+        uint64_t lastFire = 0;
+        uint64_t prevFire = 0;
+        double p = -1;
+        std::mt19937_64 engine;
+        // Event numbers still to inject at when replaying a plan
+        std::deque<uint64_t> plan;
+        // Event numbers injected at so far
+        std::vector<uint64_t> injected;
+    };
+
+    // Streams of different cores live on different lines
+    struct alignas(64) stream
+    {
+        counter counters[NumClasses];
+        std::mt19937_64 payload;
+    };
+
+    void fired(counter &k);
+    void draw(counter &k);
+
+    std::vector<stream> streams;
+    bool replaying = false;
+};
+
+}
+#endif
@@ -148,6 +148,12 @@ MinorCPU::wakeup(ThreadID tid)
     DPRINTF(Drain, "[tid:%d] MinorCPU wakeup\n", tid);
     assert(tid < numThreads);
 
+    // The pipeline stays drained while the segment is checked functionally
+    if (isChecker() && loadstorelogentry::functional) {
+        loadstorelogentry::functional->wakeup(this);
+        return;
+    }
+
     if (threads[tid]->status() == ThreadContext::Suspended) {
         threads[tid]->activate();
         drainResume();
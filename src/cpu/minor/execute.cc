@@ -1160,7 +1160,7 @@ bool suspended = false;
         }
         //std::cout << "Checker PC (end of instruction): " << cpu.getContext(0)->pcState() << " ; Inst is " << inst->staticInst->getName() << " ; committed instructions: " << cpu.committedInstrs << std::endl;
 
-        assert(!loadstorelogentry::checkerCPUMeta[id].aboutToValidate);
+        assert(!loadstorelogentry::checkerCPUMeta[id].segment.validating());
         if (loadstorelogentry::useHash && inst->staticInst->isMemRef()) {
             loadstorelogentry l(
                 inst->staticInst->isLoad(),
@@ -1170,10 +1170,12 @@ bool suspended = false;
                 (inst->staticInst->isStoreConditional() ?
                     inst->extraData : 0), // Not sure that this will be updated correctly yet since it is set on completeAcc and we just initiateAcc in this function
                 curTick(),inst->pc->instAddr(),
-                inst->staticInst->getName(),
+                loadstorelogentry::internInstName(
+                    inst->staticInst->getMnemonic()),
                 0, // not used anyway 
                 inst->pc->microPC(),
-                inst->id.loadstorelogSeqNum
+                inst->id.loadstorelogSeqNum,
+                &loadstorelogentry::checkerCPUMeta[id].checkedOverflow
             );
             loadstorelogentry::checkerCPUMeta[id].calcCheckedHash(l);
         }
@@ -1183,7 +1185,7 @@ bool suspended = false;
                 loadstorelogentry l;
                 loadstorelogentry::checkerCPUMeta[id].calcCheckedHash(l);
             }
-            loadstorelogentry::checkerCPUMeta[id].aboutToValidate = true;
+            loadstorelogentry::checkerCPUMeta[id].segment.beginValidate();
             assert(loadstorelogentry::checkerCPUMeta[id].checkerLastCommitTick == 0); // Should happen only once
             assert(loadstorelogentry::checkerCPUMeta[id].checkerStartCommitTick > 0); // Should have been set
             loadstorelogentry::checkerCPUMeta[id].checkerLastCommitTick = curTick();
@@ -1262,8 +1264,8 @@ Execute::commit(ThreadID thread_id, bool only_commit_microops, bool discard,
         && (cpu.isChecker() ? 
             (!cpu.sleepGuardOn
              && cpu.committedInstrs + 1 <
-                loadstorelogentry::checkerCPUMeta[cpu.getContext(0)->contextId()-NUMBEROFMAINCORES]
-                    .currentCommittedInstructions) : true)
+                loadstorelogentry::checkerCommitBound(
+                    cpu.getContext(0)->contextId()-NUMBEROFMAINCORES)) : true)
         )
     {
         if (only_commit_microops) {
@@ -1639,8 +1641,8 @@ Execute::commit(ThreadID thread_id, bool only_commit_microops, bool discard,
         && (cpu.isChecker() &&
             !(!cpu.sleepGuardOn
              && cpu.committedInstrs + 1 <
-                loadstorelogentry::checkerCPUMeta[cpu.getContext(0)->contextId()-NUMBEROFMAINCORES]
-                    .currentCommittedInstructions))) {
+                loadstorelogentry::checkerCommitBound(
+                    cpu.getContext(0)->contextId()-NUMBEROFMAINCORES)))) {
         loadstorelogentry::checkerCPUMeta[cpu.getContext(0)->contextId()-NUMBEROFMAINCORES].checkerLSLStallCycles++;
     }
 }
@@ -178,7 +178,7 @@ Fetch1::fetchLine(ThreadID tid)
         "%s addr: 0x%x pc: %s line_offset: %d request_size: %d\n",
         request_id, aligned_pc, thread.fetchAddr, line_offset, request_size);
     if (cpu.isChecker()) {
-        int realID = (cpu.threads[tid]->getTC()->contextId() - NUMBEROFMAINCORES) / NUMBEROFCHECKERCORESPERCORE;
+        int realID = loadstorelogentry::getMainID(cpu.threads[tid]->getTC()->contextId());
         request->request->setContext(loadstorelogentry::allCPUMeta[realID].baseCPU->getContext(0)->contextId());
         if (loadstorelogentry::checkerCPUMeta[
             cpu.threads[tid]->getTC()->contextId() - NUMBEROFMAINCORES]
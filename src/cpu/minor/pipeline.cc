@@ -127,8 +127,7 @@ void
 Pipeline::evaluate()
 {
     if (cpu.isChecker()) {
-        int mainCPUID = (cpu.getContext(0)->contextId() - NUMBEROFMAINCORES) / NUMBEROFCHECKERCORESPERCORE;
-        if(!loadstorelogentry::mainCPUMeta[mainCPUID].ready) {
+        if(!loadstorelogentry::isMainReady(cpu.getContext(0)->contextId())) {
             //printf("draining %d\n",cpu.getContext(0)->contextId());
             drain();
         }
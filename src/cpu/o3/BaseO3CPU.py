@@ -54,6 +54,9 @@ class SMTQueuePolicy(ScopedEnum):
 class CommitPolicy(ScopedEnum):
     vals = [ 'RoundRobin', 'OldestReady' ]
 
+class IQScheduler(ScopedEnum):
+    vals = [ 'DependencyGraph', 'WakeupMatrix' ]
+
 class BaseO3CPU(BaseCPU):
     type = 'BaseO3CPU'
     cxx_class = 'gem5::o3::CPU'
@@ -151,6 +154,9 @@ class BaseO3CPU(BaseCPU):
     # most ISAs don't use condition-code regs, so default is 0
     numPhysCCRegs = Param.Unsigned(0, "Number of physical cc registers")
     numIQEntries = Param.Unsigned(64, "Number of instruction queue entries")
+    iqScheduler = Param.IQScheduler('DependencyGraph',
+        "IQ wakeup and select: dependency lists and ready queues, or bit "
+        "matrices, which scale better to large IQs and issue the same")
     numROBEntries = Param.Unsigned(192, "Number of reorder buffer entries")
 
     smtNumFetchingThreads = Param.Unsigned(1, "SMT Number of Fetching Threads")
@@ -931,7 +931,7 @@ Commit::commit()
 
         for (int x=0; x<NUMBEROFMAINCORES; x++) {
 			//Forces a commit if another core is waiting on us, for synchronisation purposes.
-            if (loadstorelogentry::mainCPUMeta[x].should_cache_wait[cpuID] == loadstorelogentry::mainCPUMeta[cpuID].timestamp  && !loadstorelogentry::checkerCPUMeta[loadstorelogentry::mainCPUMeta[cpuID].current_segment_to_fill].segmentFree)
+            if (loadstorelogentry::mainCPUMeta[x].should_cache_wait[cpuID] == loadstorelogentry::mainCPUMeta[cpuID].timestamp  && !loadstorelogentry::checkerCPUMeta[loadstorelogentry::mainCPUMeta[cpuID].current_segment_to_fill].segment.free())
             {
                 shouldCommit = true;
                 break;
@@ -1013,8 +1013,7 @@ Commit::commitInsts()
     while (num_committed < commitWidth) {
         if (cpu->isChecker() &&
             (cpu->committedInstrs + 1 >=
-             loadstorelogentry::checkerCPUMeta[cpu->checkerID()]
-                 .currentCommittedInstructions))
+             loadstorelogentry::checkerCommitBound(cpu->checkerID())))
         {
             // Do not commit any more instructions, we will be ahead of main if
             // we do, and main may take a checkpoint before catching up to us
@@ -1041,7 +1040,7 @@ Commit::commitInsts()
                     !loadstorelogentry::checkerCPUMeta
                          [loadstorelogentry::mainCPUMeta[cpuID]
                               .current_segment_to_fill]
-                             .segmentFree)
+                             .segment.free())
                 {
                     if (cpu->committedInstrs <
                             loadstorelogentry::mainCPUMeta[cpuID].timeout &&
@@ -1065,7 +1064,7 @@ Commit::commitInsts()
                     !loadstorelogentry::checkerCPUMeta
                          [loadstorelogentry::mainCPUMeta[cpuID]
                               .current_segment_to_fill]
-                             .segmentFree)
+                             .segment.free())
                 {
                     // printf("early commit on %d for %d committed %ld current
                     // %ld need %ld\n", cpuID, x,
@@ -1252,7 +1251,7 @@ Commit::commitInsts()
                 // Collect stats on static instructions that are being checked
                 if (!cpu->isChecker() && !cpu->isDraining()) { // main core
                     auto insert_result = loadstorelogentry::addMainPC(
-                        cpuID, oldPc, head_inst->staticInst->getName());
+                        cpuID, oldPc, head_inst->staticInst->getMnemonic());
                     if (insert_result.second) { // new PC recorded
                         cpu->cpuStats.committedPCs[tid]++;
                     }
@@ -1263,13 +1262,17 @@ Commit::commitInsts()
                             cpu->cpuStats.checkedCommittedPCs[tid]++;
                         }
                     }
+                    if (loadstorelogentry::sampler && cpu->sampledCheck()) {
+                        loadstorelogentry::sampler->observe(cpuID, oldPc,
+                            insert_result.first->checked > 0,
+                            cpu->isChecked());
+                    }
                 }
                 //parallel checker unit log code:
 
                 if (head_inst->isMemRef() && !cpu->isChecker() &&
                     (cpu->isChecked() || cpu->isStored()) &&
-                    !loadstorelogentry::mainCPUMeta[cpuID]
-                         .waiting_to_checkpoint &&
+                    !loadstorelogentry::ring(cpuID).publishing() &&
                     !cpu->isDraining())
                 {
                     done_write =
@@ -1280,6 +1283,9 @@ Commit::commitInsts()
                         // std::string str;
                         // head_inst->dump(str);
                         // std::cerr << str << " committedInstrs " << cpu->committedInstrs << std::endl;
+                        lslslab* slab = &loadstorelogentry::checkerCPUMeta[
+                            cpu->getContext(0)->contextId() - NUMBEROFMAINCORES
+                        ].checkedOverflow;
                         loadstorelogentry l(
                             head_inst->isLoad(),
                             head_inst->isStoreConditional(),
@@ -1288,19 +1294,20 @@ Commit::commitInsts()
                             (head_inst->isStoreConditional() ?
                                 head_inst->extraData : 0),
                             curTick(),oldPc,
-                            head_inst->staticInst->getName(),
+                            loadstorelogentry::internInstName(
+                                head_inst->staticInst->getMnemonic()),
                             head_inst->memReqFlags, 
                             head_inst->pcState().microPC(), 
-                            head_inst->getLdstlogSeqNum()
+                            head_inst->getLdstlogSeqNum(),
+                            slab
                         );
                         if (!head_inst->isLoad() && !head_inst->memData) {
                             if (!head_inst->logentrydata.size()) {
                                 // std::cout << "!$! Store instruction with no data (of size " << (int)head_inst->effSize << ") at time " << loadstorelogentry::timestamp[cpuID] << " -> ";
                                 // head_inst->dump();
                                 l.data.clear();
-                                l.data.resize(0, 0);
                             } else {
-                                l.data.assign(head_inst->logentrydata.data(), &(head_inst->logentrydata.data()[head_inst->effSize]));
+                                l.data.assign(head_inst->logentrydata.data(), head_inst->effSize, slab);
                             }
                         }
                         loadstorelogentry::checkerCPUMeta[
@@ -1347,7 +1354,7 @@ Commit::commitInsts()
                     if (!cpu->isDraining()) {
                         assert(!loadstorelogentry::checkerCPUMeta
                                     [cpu->checkerID()]
-                                        .aboutToValidate);
+                                        .segment.validating());
 
                         if ((cpu->committedInstrs >=
                              loadstorelogentry::checkerCPUMeta
@@ -1376,7 +1383,7 @@ Commit::commitInsts()
                             // loadstorelogentry::committedInstructions[cpu->checkerID()]
                             // << " : About to validate" << std::endl;
                             loadstorelogentry::checkerCPUMeta[cpu->checkerID()]
-                                .aboutToValidate = true;
+                                .segment.beginValidate();
                             // Should happen only once
                             assert(loadstorelogentry::checkerCPUMeta[
                                 cpu->checkerID()].checkerLastCommitTick == 0);
@@ -1498,23 +1505,7 @@ Commit::commitInsts()
                                 assert(false);
                                 cpu->cpuStats.numOtherCpts[head_inst->threadNumber]++;
                             }
-                            if (done_write ||
-                                cpu->committedInstrs >=
-                                    loadstorelogentry::mainCPUMeta[cpuID]
-                                        .timeout)
-                            {
-                                loadstorelogentry::mainCPUMeta[cpuID].timeout =
-                                    std::min(
-                                        loadstorelogentry::mainCPUMeta[cpuID]
-                                                .timeout +
-                                            5,
-                                        TIMEOUT);
-
-                                if (AIMD)
-                                    loadstorelogentry::addToAIMDHisto(
-                                        loadstorelogentry::mainCPUMeta[cpuID]
-                                            .timeout);
-                            }
+                            loadstorelogentry::cptTaken(cpu, done_write);
 
                             loadstorelogentry::mainDoCheckpoint(cpu,
                                                                 wasSyscall);
@@ -1535,17 +1526,20 @@ Commit::commitInsts()
                                 .current_entry = 0;
                             loadstorelogentry::mainCPUMeta[cpuID]
                                 .current_size = 0;
-                            loadstorelogentry::mainCPUMeta[cpuID]
-                                .waiting_to_checkpoint = true;
+                            loadstorelogentry::ring(cpuID)
+                                .setPublishing(true);
                             // added to avoid copy_main_registers_to_checker 
                             // assertion failure
                             int checkerCoreId =
                                 loadstorelogentry::mainCPUMeta[cpuID]
                                     .current_segment_to_fill +
                                 NUMBEROFMAINCORES;
-                            loadstorelogentry::checkerCPUMeta[
-                                checkerCoreId-NUMBEROFMAINCORES]
-                                    .segmentFree = false;
+                            auto &segmeta = loadstorelogentry::checkerCPUMeta[
+                                checkerCoreId-NUMBEROFMAINCORES];
+                            if (segmeta.segment.free()) {
+                                loadstorelogentry::ring(cpuID).produce(
+                                    segmeta.segment, segmeta.timestamps);
+                            }
                             loadstorelogentry::updateMainComparisonContexts(
                                 cpu);
                             // added to avoid copy_main_registers_to_checker 
@@ -1763,10 +1757,12 @@ Commit::commitHead(const DynInstPtr &head_inst, unsigned inst_num)
                 tid, head_inst->seqNum, head_inst->pcState());
     }
 
-    // Update the commit rename map
+    // Update the commit rename map, and note the architectural registers
+    // that changed for the next miniContext snapshot
     for (int i = 0; i < head_inst->numDestRegs(); i++) {
         renameMap[tid]->setEntry(head_inst->flattenedDestIdx(i),
                                  head_inst->renamedDestIdx(i));
+        thread[tid]->dirtyRegs.mark(head_inst->flattenedDestIdx(i));
     }
 
     // hardware transactional memory
@@ -1000,7 +1000,12 @@ CPU::addToLoadStoreLog(DynInstPtr head_inst, Addr oldPc, bool wasSyscall) {
                         // std::cout << "Extra value: " << secondaryData << "\n";
                     }
 
-                    loadstorelogentry l (head_inst->isLoad(),head_inst->isStoreConditional(),head_inst->effAddr,head_inst->memData,head_inst->effSize,secondaryData,curTick(),oldPc,head_inst->staticInst->getName(),head_inst->memReqFlags, head_inst->pcState().microPC(), head_inst->getLdstlogSeqNum());
+                    // Fill the next log entry in place, no copy on do_write.
+                    // The shard stays locked until do_write publishes it.
+                    loadstorelogentry::ShardGuard lslGuard(cpuID);
+                    loadstorelogentry& l = loadstorelogentry::nextEntry(cpuID);
+                    lslslab* slab = loadstorelogentry::nextSlab(cpuID);
+                    l.set(head_inst->isLoad(),head_inst->isStoreConditional(),head_inst->effAddr,head_inst->memData,head_inst->effSize,secondaryData,curTick(),oldPc,loadstorelogentry::internInstName(head_inst->staticInst->getMnemonic()),head_inst->memReqFlags, head_inst->pcState().microPC(), head_inst->getLdstlogSeqNum(), slab);
                     if(!head_inst->isLoad() && !head_inst->memData) { // Swap instructions are isAtomic but not isLoad
                         /* This means that the write has not been propagated to
                          * memory yet. The logentrydata field has been added to
@@ -1012,11 +1017,10 @@ CPU::addToLoadStoreLog(DynInstPtr head_inst, Addr oldPc, bool wasSyscall) {
                             // std::cout << "!$! Store instruction with no data (of size " << (int)head_inst->effSize << ") at time " << loadstorelogentry::timestamp[cpuID] << " -> ";
                             // head_inst->dump();
                             l.data.clear();
-                            l.data.resize(0, 0);
-                            done_write = loadstorelogentry::do_write(l,cpuID,false, 
+                            done_write = loadstorelogentry::do_write(cpuID,false, 
                                                                      head_inst->pcState().microPC() > 0, committedInstrs); // Is at least the second micro-op
                         } else {
-                            l.data.assign(head_inst->logentrydata.data(), &(head_inst->logentrydata.data()[head_inst->effSize]));
+                            l.data.assign(head_inst->logentrydata.data(), head_inst->effSize, slab);
 #ifdef LOADSTORE_ERRORRATE
                             if(!(wasSyscall || loadstorelogentry::checkerCPUMeta[loadstorelogentry::mainCPUMeta[cpuID].current_segment_to_fill].hasSyscall))compromise_loadstorelogentry(cpuID, &l);
 
@@ -1025,7 +1029,7 @@ CPU::addToLoadStoreLog(DynInstPtr head_inst, Addr oldPc, bool wasSyscall) {
                             bool newline = false;
                             Fault read = readMem(head_inst->effAddr, oldData, head_inst->effSize, head_inst->pcState().instAddr(), head_inst->memReqFlags, newline);
                             assert(read == NoFault);
-                            l.oldData.assign(oldData, &(oldData[head_inst->effSize]));
+                            l.oldData.assign(oldData, head_inst->effSize, slab);
 #ifdef ROLLBACK_DEBUG
                             std::cout<< "Writing over " << head_inst->effAddr  << " data ";
                             for (auto i: oldData)
@@ -1054,7 +1058,7 @@ CPU::addToLoadStoreLog(DynInstPtr head_inst, Addr oldPc, bool wasSyscall) {
 			        }
 			    }
 
-                            done_write = loadstorelogentry::do_write(l,cpuID,newline, 
+                            done_write = loadstorelogentry::do_write(cpuID,newline, 
                                                                      head_inst->pcState().microPC() > 0, committedInstrs); // Is at least the second micro-op
                             if (head_inst->isAtomic()) { // Swap instructions
                                 cpuStats.numLSLSwapEntries[head_inst->threadNumber]++;
@@ -1068,7 +1072,7 @@ CPU::addToLoadStoreLog(DynInstPtr head_inst, Addr oldPc, bool wasSyscall) {
 
                         if(!head_inst->isLoad()) { // Swap instructions are isAtomic but not isLoad
                             assert(head_inst->oldData.data());
-                            l.oldData.assign(head_inst->oldData.data(), &(head_inst->oldData.data()[head_inst->effSize]));
+                            l.oldData.assign(head_inst->oldData.data(), head_inst->effSize, slab);
 #ifdef ROLLBACK_DEBUG
                             std::cout<< "Writing over (2) " << head_inst->effAddr  << " data ";
                             for (auto i: head_inst->oldData)
@@ -1098,7 +1102,7 @@ CPU::addToLoadStoreLog(DynInstPtr head_inst, Addr oldPc, bool wasSyscall) {
 			    }
                         }
 
-                        done_write = loadstorelogentry::do_write(l,cpuID,head_inst->newline, 
+                        done_write = loadstorelogentry::do_write(cpuID,head_inst->newline, 
                                                                      head_inst->pcState().microPC() > 0, committedInstrs); // Is at least the second micro-op
                         if (head_inst->isLoad()) {
                             cpuStats.numLSLLoadEntries[head_inst->threadNumber]++;
@@ -1578,6 +1582,7 @@ CPU::readMiscReg(int misc_reg, ThreadID tid)
 void
 CPU::setMiscRegNoEffect(int misc_reg, RegVal val, ThreadID tid)
 {
+    thread[tid]->dirtyRegs.mark(MiscRegClass, misc_reg);
     isa[tid]->setMiscRegNoEffect(misc_reg, val);
 }
 
@@ -1585,6 +1590,7 @@ void
 CPU::setMiscReg(int misc_reg, RegVal val, ThreadID tid)
 {
     cpuStats.miscRegfileWrites++;
+    thread[tid]->dirtyRegs.mark(MiscRegClass, misc_reg);
     isa[tid]->setMiscReg(misc_reg, val);
 }
 
@@ -1725,6 +1731,7 @@ CPU::getArchReg(const RegId &reg, void *val, ThreadID tid)
 void *
 CPU::getWritableArchReg(const RegId &reg, ThreadID tid)
 {
+    thread[tid]->dirtyRegs.mark(reg);
     PhysRegIdPtr phys_reg = commitRenameMap[tid].lookup(reg);
     return regFile.getWritableReg(phys_reg);
 }
@@ -1732,6 +1739,7 @@ CPU::getWritableArchReg(const RegId &reg, ThreadID tid)
 void
 CPU::setArchReg(const RegId &reg, RegVal val, ThreadID tid)
 {
+    thread[tid]->dirtyRegs.mark(reg);
     PhysRegIdPtr phys_reg = commitRenameMap[tid].lookup(reg);
     regFile.setReg(phys_reg, val);
 }
@@ -1739,6 +1747,7 @@ CPU::setArchReg(const RegId &reg, RegVal val, ThreadID tid)
 void
 CPU::setArchReg(const RegId &reg, const void *val, ThreadID tid)
 {
+    thread[tid]->dirtyRegs.mark(reg);
     PhysRegIdPtr phys_reg = commitRenameMap[tid].lookup(reg);
     regFile.setReg(phys_reg, val);
 }
@@ -1779,7 +1788,7 @@ CPU::instDone(ThreadID tid, const DynInstPtr &inst)
         thread[tid]->threadStats.numInsts++;
         cpuStats.committedInsts[tid]++;
         if (!isChecker()) {
-            auto insert_result = loadstorelogentry::addMainStaticInst(getContext(0)->contextId(), inst->staticInst->getName());
+            auto insert_result = loadstorelogentry::addMainStaticInst(getContext(0)->contextId(), inst->staticInst->getMnemonic());
             if (insert_result.second) {
                 cpuStats.committedStaticInsts[tid]++;
             }
@@ -2080,7 +2089,12 @@ CPU::sampledCheck() const
 bool 
 CPU::shouldStartSample(uint64_t currCommittedInsts) const 
 {
-    bool shouldStart = sampledCheck() && ((currCommittedInsts / _sampledCheck) > lastSample);
+    // The sampling engine picks the intervals, if there is one
+    bool shouldStart = sampledCheck() &&
+        (loadstorelogentry::sampler ?
+         loadstorelogentry::sampler->pending(
+             threadContexts[0]->contextId()) :
+         (currCommittedInsts / _sampledCheck) > lastSample);
     if (shouldStart) {
         std::cout << "shouldStart at "  << currCommittedInsts << " committedInsts" << std::endl;
     }
@@ -2092,6 +2106,8 @@ CPU::updateLastSample(uint64_t currCommittedInsts)
 {
     assert(sampledCheck());
     lastSample = currCommittedInsts / _sampledCheck;
+    if (loadstorelogentry::sampler)
+        loadstorelogentry::sampler->started(threadContexts[0]->contextId());
 }
 /*
 void
@@ -1624,7 +1624,7 @@ Fetch::pipelineIcacheAccesses(ThreadID tid)
         assert(!(cpu->isChecker() && // Is checker core
             !loadstorelogentry::checkerCPUMeta[
             cpu->thread[tid]->getTC()->contextId() - NUMBEROFMAINCORES]
-            .segmentFree &&
+            .segment.free() &&
             loadstorelogentry::checkerCPUMeta[
             cpu->thread[tid]->getTC()->contextId() - NUMBEROFMAINCORES]
             .checkerStartWakeupTick > 0 &&
@@ -1650,7 +1650,7 @@ Fetch::pipelineIcacheAccesses(ThreadID tid)
         assert(!(cpu->isChecker() && // Is checker core
             !loadstorelogentry::checkerCPUMeta[
             cpu->thread[tid]->getTC()->contextId() - NUMBEROFMAINCORES]
-            .segmentFree &&
+            .segment.free() &&
             loadstorelogentry::checkerCPUMeta[
             cpu->thread[tid]->getTC()->contextId() - NUMBEROFMAINCORES]
             .checkerStartWakeupTick > 0 &&
@@ -89,6 +89,10 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
     : cpu(cpu_ptr),
       iewStage(iew_ptr),
       fuPool(params.fuPool),
+      instPool(params.numROBEntries + params.LQEntries + params.SQEntries),
+      nonSpecInsts(params.numIQEntries),
+      listOrderPool(Num_OpClasses + 1),
+      useWakeupMatrix(params.iqScheduler == IQScheduler::WakeupMatrix),
       iqPolicy(params.smtIQPolicy),
       numThreads(params.numThreads),
       numEntries(params.numIQEntries),
@@ -99,6 +103,14 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
 {
     assert(fuPool);
 
+    for (ThreadID tid = 0; tid < MaxThreads; tid++)
+        instList[tid].setPool(&instPool);
+    instsToExecute.setPool(&instPool);
+    deferredMemInsts.setPool(&instPool);
+    blockedMemInsts.setPool(&instPool);
+    retryMemInsts.setPool(&instPool);
+    listOrder.setPool(&listOrderPool);
+
     const auto &reg_classes = params.isa[0]->regClasses();
     // Set the number of total physical registers
     // As the vector registers have two addressing modes, they are added twice
@@ -114,6 +126,10 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
     //dependency graph.
     dependGraph.resize(numPhysRegs);
 
+    // Consumers wait in the matrix instead, the graph still holds producers
+    if (useWakeupMatrix)
+        wakeupMatrix.resize(numPhysRegs, Num_OpClasses, numEntries);
+
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
 
@@ -420,6 +436,8 @@ InstructionQueue::resetState()
         queueOnList[i] = false;
         readyIt[i] = listOrder.end();
     }
+    if (useWakeupMatrix)
+        wakeupMatrix.reset();
     nonSpecInsts.clear();
     listOrder.clear();
     deferredMemInsts.clear();
@@ -452,6 +470,7 @@ bool
 InstructionQueue::isDrained() const
 {
     bool drained = dependGraph.empty() &&
+                   (!useWakeupMatrix || wakeupMatrix.empty()) &&
                    instsToExecute.empty() &&
                    wbOutstanding == 0;
     for (ThreadID tid = 0; tid < numThreads; ++tid)
@@ -464,6 +483,7 @@ void
 InstructionQueue::drainSanityCheck() const
 {
     assert(dependGraph.empty());
+    assert(!useWakeupMatrix || wakeupMatrix.empty());
     assert(instsToExecute.empty());
     for (ThreadID tid = 0; tid < numThreads; ++tid)
         memDepUnit[tid].drainSanityCheck();
@@ -545,7 +565,7 @@ InstructionQueue::isFull(ThreadID tid)
 bool
 InstructionQueue::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
+    if (!listOrder.empty() || (useWakeupMatrix && wakeupMatrix.anyReady())) {
         return true;
     }
 
@@ -618,7 +638,7 @@ InstructionQueue::insertNonSpec(const DynInstPtr &new_inst)
 
     assert(new_inst);
 
-    nonSpecInsts[new_inst->seqNum] = new_inst;
+    nonSpecInsts.insert(new_inst->seqNum, new_inst);
 
     DPRINTF(IQ, "Adding non-speculative instruction [sn:%llu] PC %s "
             "to the IQ.\n",
@@ -765,6 +785,26 @@ InstructionQueue::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
+    int total_issued = useWakeupMatrix ?
+        issueFromWakeupMatrix(i2e_info) : issueFromReadyQueues(i2e_info);
+
+    iqStats.numIssuedDist.sample(total_issued);
+    iqStats.instsIssued+= total_issued;
+
+    // If we issued any instructions, tell the CPU we had activity.
+    // @todo If the way deferred memory instructions are handeled due to
+    // translation changes then the deferredMemInsts condition should be
+    // removed from the code below.
+    if (total_issued || !retryMemInsts.empty() || !deferredMemInsts.empty()) {
+        cpu->activityThisCycle();
+    } else {
+        DPRINTF(IQ, "Not able to schedule any instructions.\n");
+    }
+}
+
+int
+InstructionQueue::issueFromReadyQueues(IssueStruct *i2e_info)
+{
     // Have iterator to head of the list
     // While I haven't exceeded bandwidth or reached the end of the list,
     // Try to get a FU that can do what this op needs.
@@ -811,60 +851,7 @@ InstructionQueue::scheduleReadyInsts()
             continue;
         }
 
-        int idx = FUPool::NoCapableFU;
-        Cycles op_latency = Cycles(1);
-        ThreadID tid = issuing_inst->threadNumber;
-
-        if (op_class != No_OpClass) {
-            idx = fuPool->getUnit(op_class);
-            if (issuing_inst->isFloating()) {
-                iqIOStats.fpAluAccesses++;
-            } else if (issuing_inst->isVector()) {
-                iqIOStats.vecAluAccesses++;
-            } else {
-                iqIOStats.intAluAccesses++;
-            }
-            if (idx > FUPool::NoFreeFU) {
-                op_latency = fuPool->getOpLatency(op_class);
-            }
-        }
-
-        // If we have an instruction that doesn't require a FU, or a
-        // valid FU, then schedule for execution.
-        if (idx != FUPool::NoFreeFU) {
-            if (op_latency == Cycles(1)) {
-                i2e_info->size++;
-                instsToExecute.push_back(issuing_inst);
-
-                // Add the FU onto the list of FU's to be freed next
-                // cycle if we used one.
-                if (idx >= 0)
-                    fuPool->freeUnitNextCycle(idx);
-            } else {
-                bool pipelined = fuPool->isPipelined(op_class);
-                // Generate completion event for the FU
-                ++wbOutstanding;
-                FUCompletion *execution = new FUCompletion(issuing_inst,
-                                                           idx, this);
-
-                cpu->schedule(execution,
-                              cpu->clockEdge(Cycles(op_latency - 1)));
-
-                if (!pipelined) {
-                    // If FU isn't pipelined, then it must be freed
-                    // upon the execution completing.
-                    execution->setFreeFU();
-                } else {
-                    // Add the FU onto the list of FU's to be freed next cycle.
-                    fuPool->freeUnitNextCycle(idx);
-                }
-            }
-
-            DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
-                    "[sn:%llu]\n",
-                    tid, issuing_inst->pcState(),
-                    issuing_inst->seqNum);
-
+        if (issueToFU(issuing_inst, i2e_info)) {
             readyInsts[op_class].pop();
 
             if (!readyInsts[op_class].empty()) {
@@ -874,47 +861,144 @@ InstructionQueue::scheduleReadyInsts()
                 queueOnList[op_class] = false;
             }
 
-            issuing_inst->setIssued();
             ++total_issued;
 
-#if TRACING_ON
-            issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
-#endif
+            listOrder.erase(order_it++);
+        } else {
+            ++order_it;
+        }
+    }
 
-            if (issuing_inst->firstIssue == -1)
-                issuing_inst->firstIssue = curTick();
+    return total_issued;
+}
 
-            if (!issuing_inst->isMemRef()) {
-                // Memory instructions can not be freed from the IQ until they
-                // complete.
-                ++freeEntries;
-                count[tid]--;
-                issuing_inst->clearInIQ();
-            } else {
-                memDepUnit[tid].issue(issuing_inst);
-            }
+int
+InstructionQueue::issueFromWakeupMatrix(IssueStruct *i2e_info)
+{
+    // The oldest ready instruction of the op classes not yet found to have
+    // no free FU this cycle, as the age order list gives above.
+    int total_issued = 0;
+    int slot;
 
-            listOrder.erase(order_it++);
-            iqStats.statIssuedInstType[tid][op_class]++;
+    wakeupMatrix.beginSelect();
+
+    while (total_issued < totalWidth &&
+           (slot = wakeupMatrix.selectOldest()) >= 0) {
+        DynInstPtr issuing_inst = wakeupMatrix.inst(slot);
+
+        if (issuing_inst->isFloating()) {
+            iqIOStats.fpInstQueueReads++;
+        } else if (issuing_inst->isVector()) {
+            iqIOStats.vecInstQueueReads++;
         } else {
-            iqStats.statFuBusy[op_class]++;
-            iqStats.fuBusy[tid]++;
-            ++order_it;
+            iqIOStats.intInstQueueReads++;
+        }
+
+        if (issuing_inst->isSquashed()) {
+            wakeupMatrix.remove(slot);
+
+            ++iqStats.squashedInstsIssued;
+
+            continue;
+        }
+
+        if (issueToFU(issuing_inst, i2e_info)) {
+            wakeupMatrix.remove(slot);
+            ++total_issued;
+        } else {
+            wakeupMatrix.block(wakeupMatrix.opClass(slot));
         }
     }
 
-    iqStats.numIssuedDist.sample(total_issued);
-    iqStats.instsIssued+= total_issued;
+    return total_issued;
+}
 
-    // If we issued any instructions, tell the CPU we had activity.
-    // @todo If the way deferred memory instructions are handeled due to
-    // translation changes then the deferredMemInsts condition should be
-    // removed from the code below.
-    if (total_issued || !retryMemInsts.empty() || !deferredMemInsts.empty()) {
-        cpu->activityThisCycle();
+bool
+InstructionQueue::issueToFU(const DynInstPtr &issuing_inst,
+                            IssueStruct *i2e_info)
+{
+    OpClass op_class = issuing_inst->opClass();
+    int idx = FUPool::NoCapableFU;
+    Cycles op_latency = Cycles(1);
+    ThreadID tid = issuing_inst->threadNumber;
+
+    if (op_class != No_OpClass) {
+        idx = fuPool->getUnit(op_class);
+        if (issuing_inst->isFloating()) {
+            iqIOStats.fpAluAccesses++;
+        } else if (issuing_inst->isVector()) {
+            iqIOStats.vecAluAccesses++;
+        } else {
+            iqIOStats.intAluAccesses++;
+        }
+        if (idx > FUPool::NoFreeFU) {
+            op_latency = fuPool->getOpLatency(op_class);
+        }
+    }
+
+    if (idx == FUPool::NoFreeFU) {
+        iqStats.statFuBusy[op_class]++;
+        iqStats.fuBusy[tid]++;
+        return false;
+    }
+
+    // We have an instruction that doesn't require a FU, or a
+    // valid FU, so schedule for execution.
+    if (op_latency == Cycles(1)) {
+        i2e_info->size++;
+        instsToExecute.push_back(issuing_inst);
+
+        // Add the FU onto the list of FU's to be freed next
+        // cycle if we used one.
+        if (idx >= 0)
+            fuPool->freeUnitNextCycle(idx);
     } else {
-        DPRINTF(IQ, "Not able to schedule any instructions.\n");
+        bool pipelined = fuPool->isPipelined(op_class);
+        // Generate completion event for the FU
+        ++wbOutstanding;
+        FUCompletion *execution = new FUCompletion(issuing_inst,
+                                                   idx, this);
+
+        cpu->schedule(execution,
+                      cpu->clockEdge(Cycles(op_latency - 1)));
+
+        if (!pipelined) {
+            // If FU isn't pipelined, then it must be freed
+            // upon the execution completing.
+            execution->setFreeFU();
+        } else {
+            // Add the FU onto the list of FU's to be freed next cycle.
+            fuPool->freeUnitNextCycle(idx);
+        }
     }
+
+    DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
+            "[sn:%llu]\n",
+            tid, issuing_inst->pcState(),
+            issuing_inst->seqNum);
+
+    issuing_inst->setIssued();
+
+#if TRACING_ON
+    issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
+#endif
+
+    if (issuing_inst->firstIssue == -1)
+        issuing_inst->firstIssue = curTick();
+
+    if (!issuing_inst->isMemRef()) {
+        // Memory instructions can not be freed from the IQ until they
+        // complete.
+        ++freeEntries;
+        count[tid]--;
+        issuing_inst->clearInIQ();
+    } else {
+        memDepUnit[tid].issue(issuing_inst);
+    }
+
+    iqStats.statIssuedInstType[tid][op_class]++;
+
+    return true;
 }
 
 void
@@ -923,25 +1007,25 @@ InstructionQueue::scheduleNonSpec(const InstSeqNum &inst)
     DPRINTF(IQ, "Marking nonspeculative instruction [sn:%llu] as ready "
             "to execute.\n", inst);
 
-    NonSpecMapIt inst_it = nonSpecInsts.find(inst);
+    DynInstPtr *inst_it = nonSpecInsts.find(inst);
 
-    assert(inst_it != nonSpecInsts.end());
+    assert(inst_it);
 
-    ThreadID tid = (*inst_it).second->threadNumber;
+    DynInstPtr ns_inst = std::move(*inst_it);
 
-    (*inst_it).second->setAtCommit();
+    nonSpecInsts.erase(inst);
 
-    (*inst_it).second->setCanIssue();
+    ThreadID tid = ns_inst->threadNumber;
 
-    if (!(*inst_it).second->isMemRef()) {
-        addIfReady((*inst_it).second);
-    } else {
-        memDepUnit[tid].nonSpecInstReady((*inst_it).second);
-    }
+    ns_inst->setAtCommit();
 
-    (*inst_it).second = NULL;
+    ns_inst->setCanIssue();
 
-    nonSpecInsts.erase(inst_it);
+    if (!ns_inst->isMemRef()) {
+        addIfReady(ns_inst);
+    } else {
+        memDepUnit[tid].nonSpecInstReady(ns_inst);
+    }
 }
 
 void
@@ -1032,28 +1116,61 @@ InstructionQueue::wakeDependents(const DynInstPtr &completed_inst)
 
         //Go through the dependency chain, marking the registers as
         //ready within the waiting instructions.
-        DynInstPtr dep_inst = dependGraph.pop(dest_reg->flatIndex());
+        if (useWakeupMatrix) {
+            const RegIndex reg = dest_reg->flatIndex();
+
+            // The matrix has one bit for a register an instruction reads
+            // more than once, so wake each of its sources reading it, as
+            // they each have a node in the dependency chain.
+            wakeupMatrix.wake(reg, [&](const DynInstPtr &dep_inst) {
+                for (int src_reg_idx = 0;
+                     src_reg_idx < dep_inst->numSrcRegs();
+                     src_reg_idx++) {
+                    PhysRegIdPtr src_reg =
+                        dep_inst->renamedSrcIdx(src_reg_idx);
+                    if (dep_inst->readySrcIdx(src_reg_idx) ||
+                        src_reg->isFixedMapping() ||
+                        src_reg->flatIndex() != reg) {
+                        continue;
+                    }
+
+                    DPRINTF(IQ, "Waking up a dependent instruction, "
+                            "[sn:%llu] PC %s.\n", dep_inst->seqNum,
+                            dep_inst->pcState());
+
+                    dep_inst->markSrcRegReady();
+
+                    addIfReady(dep_inst);
+
+                    ++dependents;
+                }
+            });
+        } else {
+            DynInstPtr dep_inst = dependGraph.pop(dest_reg->flatIndex());
 
-        while (dep_inst) {
-            DPRINTF(IQ, "Waking up a dependent instruction, [sn:%llu] "
-                    "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
+            while (dep_inst) {
+                DPRINTF(IQ, "Waking up a dependent instruction, [sn:%llu] "
+                        "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
 
-            // Might want to give more information to the instruction
-            // so that it knows which of its source registers is
-            // ready.  However that would mean that the dependency
-            // graph entries would need to hold the src_reg_idx.
-            dep_inst->markSrcRegReady();
+                // Might want to give more information to the instruction
+                // so that it knows which of its source registers is
+                // ready.  However that would mean that the dependency
+                // graph entries would need to hold the src_reg_idx.
+                dep_inst->markSrcRegReady();
 
-            addIfReady(dep_inst);
+                addIfReady(dep_inst);
 
-            dep_inst = dependGraph.pop(dest_reg->flatIndex());
+                dep_inst = dependGraph.pop(dest_reg->flatIndex());
 
-            ++dependents;
+                ++dependents;
+            }
         }
 
         // Reset the head node now that all of its dependents have
         // been woken up.
         assert(dependGraph.empty(dest_reg->flatIndex()));
+        assert(!useWakeupMatrix ||
+               wakeupMatrix.empty(dest_reg->flatIndex()));
         dependGraph.clearInst(dest_reg->flatIndex());
 
         // Mark the scoreboard as having that register ready.
@@ -1067,6 +1184,23 @@ InstructionQueue::addReadyMemInst(const DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
+    addToReadyQueue(ready_inst);
+
+    DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
+            "the ready list, PC %s opclass:%i [sn:%llu].\n",
+            ready_inst->pcState(), op_class, ready_inst->seqNum);
+}
+
+void
+InstructionQueue::addToReadyQueue(const DynInstPtr &ready_inst)
+{
+    OpClass op_class = ready_inst->opClass();
+
+    if (useWakeupMatrix) {
+        wakeupMatrix.ready(ready_inst, op_class);
+        return;
+    }
+
     readyInsts[op_class].push(ready_inst);
 
     // Will need to reorder the list if either a queue is not on the list,
@@ -1078,10 +1212,6 @@ InstructionQueue::addReadyMemInst(const DynInstPtr &ready_inst)
         listOrder.erase(readyIt[op_class]);
         addToOrderList(op_class);
     }
-
-    DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
-            "the ready list, PC %s opclass:%i [sn:%llu].\n",
-            ready_inst->pcState(), op_class, ready_inst->seqNum);
 }
 
 void
@@ -1250,8 +1380,19 @@ InstructionQueue::doSquash(ThreadID tid)
 
                     if (!squashed_inst->readySrcIdx(src_reg_idx) &&
                         !src_reg->isFixedMapping()) {
-                        dependGraph.remove(src_reg->flatIndex(),
-                                           squashed_inst);
+                        if (useWakeupMatrix) {
+                            // Sources reading the same register share
+                            // one bit
+                            int slot = wakeupMatrix.find(
+                                src_reg->flatIndex(), squashed_inst);
+                            if (slot >= 0) {
+                                wakeupMatrix.unwait(src_reg->flatIndex(),
+                                                    slot);
+                            }
+                        } else {
+                            dependGraph.remove(src_reg->flatIndex(),
+                                               squashed_inst);
+                        }
                     }
 
                     ++iqStats.squashedOperandsExamined;
@@ -1259,13 +1400,13 @@ InstructionQueue::doSquash(ThreadID tid)
 
             } else if (!squashed_inst->isStoreConditional() ||
                        !squashed_inst->isCompleted()) {
-                NonSpecMapIt ns_inst_it =
+                DynInstPtr *ns_inst_it =
                     nonSpecInsts.find(squashed_inst->seqNum);
 
                 // we remove non-speculative instructions from
                 // nonSpecInsts already when they are ready, and so we
                 // cannot always expect to find them
-                if (ns_inst_it == nonSpecInsts.end()) {
+                if (!ns_inst_it) {
                     // loads that became ready but stalled on a
                     // blocked cache are alreayd removed from
                     // nonSpecInsts, and have not faulted
@@ -1273,9 +1414,7 @@ InstructionQueue::doSquash(ThreadID tid)
                            squashed_inst->isMemRef());
                 } else {
 
-                    (*ns_inst_it).second = NULL;
-
-                    nonSpecInsts.erase(ns_inst_it);
+                    nonSpecInsts.erase(squashed_inst->seqNum);
 
                     ++iqStats.squashedNonSpecRemoved;
                 }
@@ -1315,6 +1454,8 @@ InstructionQueue::doSquash(ThreadID tid)
                 continue;
             }
             assert(dependGraph.empty(dest_reg->flatIndex()));
+            assert(!useWakeupMatrix ||
+                   wakeupMatrix.empty(dest_reg->flatIndex()));
             dependGraph.clearInst(dest_reg->flatIndex());
         }
         instList[tid].erase(squash_it--);
@@ -1336,6 +1477,8 @@ InstructionQueue::addToDependents(const DynInstPtr &new_inst)
     // them to the dependency list if they are not ready.
     int8_t total_src_regs = new_inst->numSrcRegs();
     bool return_val = false;
+    // Wakeup matrix slot, for the first source that has to wait
+    int slot = -1;
 
     for (int src_reg_idx = 0;
          src_reg_idx < total_src_regs;
@@ -1357,7 +1500,13 @@ InstructionQueue::addToDependents(const DynInstPtr &new_inst)
                         new_inst->pcState(), src_reg->index(),
                         src_reg->className());
 
-                dependGraph.insert(src_reg->flatIndex(), new_inst);
+                if (useWakeupMatrix) {
+                    if (slot < 0)
+                        slot = wakeupMatrix.allocate(new_inst);
+                    wakeupMatrix.wait(src_reg->flatIndex(), slot);
+                } else {
+                    dependGraph.insert(src_reg->flatIndex(), new_inst);
+                }
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1397,7 +1546,9 @@ InstructionQueue::addToProducers(const DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg->flatIndex())) {
+        if (!dependGraph.empty(dest_reg->flatIndex()) ||
+            (useWakeupMatrix &&
+             !wakeupMatrix.empty(dest_reg->flatIndex()))) {
             dependGraph.dump();
             panic("Dependency graph %i (%s) (flat: %i) not empty!",
                   dest_reg->index(), dest_reg->className(),
@@ -1436,17 +1587,7 @@ InstructionQueue::addIfReady(const DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%llu].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        addToReadyQueue(inst);
     }
 }
 
@@ -1460,23 +1601,19 @@ void
 InstructionQueue::dumpLists()
 {
     for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        cprintf("Ready list %i size: %i\n", i, useWakeupMatrix ?
+                wakeupMatrix.numReadyOf(i) : readyInsts[i].size());
 
         cprintf("\n");
     }
 
     cprintf("Non speculative list size: %i\n", nonSpecInsts.size());
 
-    NonSpecMapIt non_spec_it = nonSpecInsts.begin();
-    NonSpecMapIt non_spec_end_it = nonSpecInsts.end();
-
     cprintf("Non speculative list: ");
 
-    while (non_spec_it != non_spec_end_it) {
-        cprintf("%s [sn:%llu]", (*non_spec_it).second->pcState(),
-                (*non_spec_it).second->seqNum);
-        ++non_spec_it;
-    }
+    nonSpecInsts.forEach([](InstSeqNum seq, const DynInstPtr &inst) {
+        cprintf("%s [sn:%llu]", inst->pcState(), seq);
+    });
 
     cprintf("\n");
 
@@ -55,9 +55,13 @@
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/mem_dep_unit.hh"
+#include "cpu/o3/pool_list.hh"
+#include "cpu/o3/seq_num_ring.hh"
 #include "cpu/o3/store_set.hh"
+#include "cpu/o3/wakeup_matrix.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
+#include "enums/IQScheduler.hh"
 #include "enums/SMTQueuePolicy.hh"
 #include "sim/eventq.hh"
 
@@ -99,7 +103,7 @@ class InstructionQueue
 {
   public:
     // Typedef of iterator through the list of instructions.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename PoolList<DynInstPtr>::iterator ListIt;
 
     /** FU completion event class. */
     class FUCompletion : public Event
@@ -281,6 +285,24 @@ class InstructionQueue
     /** Does the actual squashing. */
     void doSquash(ThreadID tid);
 
+    /** Issues the oldest ready instructions from the ready queues, up to
+     *  the issue width, returning how many issued.
+     */
+    int issueFromReadyQueues(IssueStruct *i2e_info);
+
+    /** Issues the oldest ready instructions from the wakeup matrix, in the
+     *  same order as issueFromReadyQueues().
+     */
+    int issueFromWakeupMatrix(IssueStruct *i2e_info);
+
+    /** Sends an instruction to an FU of its op class, if one is free.
+     *  Returns whether it issued.
+     */
+    bool issueToFU(const DynInstPtr &issuing_inst, IssueStruct *i2e_info);
+
+    /** Moves an instruction to the ready queue of its op class. */
+    void addToReadyQueue(const DynInstPtr &ready_inst);
+
     /////////////////////////
     // Various pointers
     /////////////////////////
@@ -317,24 +339,30 @@ class InstructionQueue
     // Instruction lists, ready queues, and ordering
     //////////////////////////////////////
 
+    /** Nodes of the instruction lists below, preallocated for every
+     *  instruction in flight (ROB, LQ and SQ entries).  Must be declared
+     *  before the lists, which give their nodes back on destruction.
+     */
+    NodePool<DynInstPtr> instPool;
+
     /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[MaxThreads];
+    PoolList<DynInstPtr> instList[MaxThreads];
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    PoolList<DynInstPtr> instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
      */
-    std::list<DynInstPtr> deferredMemInsts;
+    PoolList<DynInstPtr> deferredMemInsts;
 
     /** List of instructions that have been cache blocked. */
-    std::list<DynInstPtr> blockedMemInsts;
+    PoolList<DynInstPtr> blockedMemInsts;
 
     /** List of instructions that were cache blocked, but a retry has been seen
      * since, so they can now be retried. May fail again go on the blocked list.
      */
-    std::list<DynInstPtr> retryMemInsts;
+    PoolList<DynInstPtr> retryMemInsts;
 
     /**
      * Struct for comparing entries to be added to the priority queue.
@@ -361,11 +389,9 @@ class InstructionQueue
      *  have the key be a part of the value (the sequence number is stored
      *  inside of DynInst), when these instructions are woken up only
      *  the sequence number will be available.  Thus it is most efficient to be
-     *  able to search by the sequence number alone.
+     *  able to search by the sequence number alone.  Sized for a full IQ.
      */
-    std::map<InstSeqNum, DynInstPtr> nonSpecInsts;
-
-    typedef std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
+    SeqNumRing<DynInstPtr> nonSpecInsts;
 
     /** Entry for the list age ordering by op class. */
     struct ListOrderEntry
@@ -376,14 +402,15 @@ class InstructionQueue
 
     /** List that contains the age order of the oldest instruction of each
      *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
+     *  among op classes.  Its nodes, one per op class and the one
+     *  moveToYoungerInst() inserts before erasing, are reused every time
+     *  the position changes due to an instruction issuing.
      */
-    std::list<ListOrderEntry> listOrder;
+    NodePool<ListOrderEntry> listOrderPool;
+
+    PoolList<ListOrderEntry> listOrder;
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    typedef typename PoolList<ListOrderEntry>::iterator ListOrderIt;
 
     /** Tracks if each ready queue is on the age order list. */
     bool queueOnList[Num_OpClasses];
@@ -404,6 +431,13 @@ class InstructionQueue
 
     DependencyGraph<DynInstPtr> dependGraph;
 
+    /** Replaces the dependency graph and ready queues above with
+     *  iqScheduler = 'WakeupMatrix'.
+     */
+    bool useWakeupMatrix;
+
+    WakeupMatrix<DynInstPtr> wakeupMatrix;
+
     //////////////////////////////////////
     // Various parameters
     //////////////////////////////////////
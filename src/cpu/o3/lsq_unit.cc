@@ -270,6 +270,9 @@ LSQUnit::resetState()
     stalled = false;
 
     cacheBlockMask = ~(cpu->cacheLineSize() - 1);
+
+    // The SQ is empty, whether starting or taking over
+    storeFilter.init(storeQueue.capacity(), cpu->cacheLineSize());
 }
 
 std::string
@@ -297,6 +300,18 @@ LSQUnit::LSQUnitStats::LSQUnitStats(statistics::Group *parent)
                "Number of stores squashed"),
       ADD_STAT(rescheduledLoads, statistics::units::Count::get(),
                "Number of loads that were rescheduled"),
+      ADD_STAT(storeSearches, statistics::units::Count::get(),
+               "Number of loads that checked the store filter before "
+               "searching for stores to forward from"),
+      ADD_STAT(storeSearchesSkipped, statistics::units::Count::get(),
+               "Number of store searches skipped because the store filter "
+               "missed"),
+      ADD_STAT(storeSearchHits, statistics::units::Count::get(),
+               "Number of store searches that found an overlapping store"),
+      ADD_STAT(storeSearchHitRatio, statistics::units::Ratio::get(),
+               "Fraction of the store searches the filter let through that "
+               "found an overlapping store",
+               storeSearchHits / (storeSearches - storeSearchesSkipped)),
       ADD_STAT(blockedByCache, statistics::units::Count::get(),
                "Number of times an access to memory failed due to the cache "
                "being blocked"),
@@ -1140,6 +1155,7 @@ LSQUnit::squash(const InstSeqNum &squashed_num)
         // Must delete request now that it wasn't handed off to
         // memory.  This is quite ugly.  @todo: Figure out the proper
         // place to really handle request deletes.
+        unfilterStore(storeQueue.back());
         storeQueue.back().clear();
 
         storeQueue.pop_back();
@@ -1264,6 +1280,7 @@ LSQUnit::completeStore(typename StoreQueue::iterator store_idx)
     DynInstPtr store_inst = store_idx->instruction();
     if (store_idx == storeQueue.begin()) {
         do {
+            unfilterStore(storeQueue.front());
             storeQueue.front().clear();
             storeQueue.pop_front();
         } while (storeQueue.front().completed() &&
@@ -1589,8 +1606,22 @@ LSQUnit::read(LSQRequest *request, ssize_t load_idx)
     // Check the SQ for any previous stores that might lead to forwarding
     auto store_it = load_inst->sqIt;
     assert (store_it >= storeWBIt);
+    // Checkers never forward, and access the loadstorelog instead. Other
+    // loads only search when the store filter says a store may overlap;
+    // every forwarding or partial case overlaps, unless the load is empty.
+    bool search = store_it != storeWBIt && !load_inst->isDataPrefetch() &&
+        !cpu->isChecker();
+    if (search) {
+        ++stats.storeSearches;
+        if (request->mainReq()->getSize() != 0 &&
+            !storeFilter.mayOverlap(request->mainReq()->getVaddr(),
+                                    request->mainReq()->getSize())) {
+            search = false;
+            ++stats.storeSearchesSkipped;
+        }
+    }
     // End once we've reached the top of the LSQ
-    while (store_it != storeWBIt && !load_inst->isDataPrefetch()) {
+    while (search && store_it != storeWBIt) {
         // Move the index to one younger
         store_it--;
         assert(store_it->valid());
@@ -1658,6 +1689,10 @@ LSQUnit::read(LSQRequest *request, ssize_t load_idx)
                 coverage = AddrRangeCoverage::NoAddrRangeCoverage;
             }
 
+            // Either case ends the search
+            if (coverage != AddrRangeCoverage::NoAddrRangeCoverage)
+                ++stats.storeSearchHits;
+
             if (coverage == AddrRangeCoverage::FullAddrRangeCoverage) {
                 // Get shift amount for offset into the store's data.
                 int shift_amt = request->mainReq()->getVaddr() -
@@ -1842,6 +1877,7 @@ LSQUnit::write(LSQRequest *request, uint8_t *data, ssize_t store_idx)
     storeQueue[store_idx].setRequest(request);
     unsigned size = request->_size;
     storeQueue[store_idx].size() = size;
+    filterStore(storeQueue[store_idx]);
     bool store_no_data =
         request->mainReq()->getFlags() & Request::STORE_NO_DATA;
     storeQueue[store_idx].isAllZeros() = store_no_data;
@@ -1872,6 +1908,27 @@ LSQUnit::write(LSQRequest *request, uint8_t *data, ssize_t store_idx)
     return NoFault;
 }
 
+void
+LSQUnit::filterStore(SQEntry &entry)
+{
+    unfilterStore(entry);
+    // Matches the range read() compares loads against
+    if (entry.size()) {
+        entry.filterAddr() = entry.instruction()->effAddr;
+        entry.filterSize() = entry.size();
+        storeFilter.add(entry.filterAddr(), entry.filterSize());
+    }
+}
+
+void
+LSQUnit::unfilterStore(SQEntry &entry)
+{
+    if (entry.filterSize()) {
+        storeFilter.remove(entry.filterAddr(), entry.filterSize());
+        entry.filterSize() = 0;
+    }
+}
+
 InstSeqNum
 LSQUnit::getLoadHeadSeqNum()
 {
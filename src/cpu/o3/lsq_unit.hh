@@ -43,14 +43,17 @@
 #define __CPU_O3_LSQ_UNIT_HH__
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <map>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "arch/generic/debugfaults.hh"
 #include "arch/generic/vec_reg.hh"
 #include "base/circular_queue.hh"
+#include "base/intmath.hh"
 #include "config/the_isa.hh"
 #include "cpu/base.hh"
 #include "cpu/inst_seq.hh"
@@ -163,6 +166,9 @@ class LSQUnit
          * style instructs (ARM DC ZVA; ALPHA WH64)
          */
         bool _isAllZeros = false;
+        /** The address range this store has in the store filter, if any. */
+        Addr _filterAddr = 0;
+        uint32_t _filterSize = 0;
 
       public:
         static constexpr size_t DataSize = sizeof(_data);
@@ -179,6 +185,7 @@ class LSQUnit
         {
             LSQEntry::clear();
             _canWB = _completed = _committed = _isAllZeros = false;
+            _filterSize = 0;
         }
 
         /** Member accessors. */
@@ -191,12 +198,88 @@ class LSQUnit
         const bool& committed() const { return _committed; }
         bool& isAllZeros() { return _isAllZeros; }
         const bool& isAllZeros() const { return _isAllZeros; }
+        Addr& filterAddr() { return _filterAddr; }
+        uint32_t& filterSize() { return _filterSize; }
         char* data() { return _data; }
         const char* data() const { return _data; }
         /** @} */
     };
     using LQEntry = LSQEntry;
 
+    /** Counting filter of the cache lines written by the stores in the SQ.
+     * Loads that touch no line in it cannot overlap any of those stores,
+     * so they skip the store-to-load forwarding search. Lines are hashed
+     * into counters, which can only give false hits, so the stores a load
+     * forwards from or stalls on are the same as with the full search.
+     */
+    class StoreFilter
+    {
+      private:
+        std::vector<uint16_t> counts;
+        unsigned indexBits = 0;
+        unsigned lineBits = 0;
+
+        size_t
+        index(Addr line) const
+        {
+            return (line * 0x9e3779b97f4a7c15ULL) >> (64 - indexBits);
+        }
+
+        template <class F>
+        void
+        forEachLine(Addr addr, unsigned size, F f) const
+        {
+            Addr last = (addr + size - 1) >> lineBits;
+            for (Addr line = addr >> lineBits; line <= last; line++)
+                f(index(line));
+        }
+
+      public:
+        /** Sizes the filter for sq_entries stores, emptying it. */
+        void
+        init(unsigned sq_entries, unsigned line_size)
+        {
+            indexBits = ceilLog2(std::max(4 * sq_entries, 64u));
+            lineBits = floorLog2(line_size);
+            counts.assign(size_t(1) << indexBits, 0);
+        }
+
+        void
+        clear()
+        {
+            std::fill(counts.begin(), counts.end(), 0);
+        }
+
+        void
+        add(Addr addr, unsigned size)
+        {
+            forEachLine(addr, size, [this](size_t i) {
+                assert(counts[i] != UINT16_MAX);
+                counts[i]++;
+            });
+        }
+
+        void
+        remove(Addr addr, unsigned size)
+        {
+            forEachLine(addr, size, [this](size_t i) {
+                assert(counts[i]);
+                counts[i]--;
+            });
+        }
+
+        /** False if no store in the filter can overlap the range. */
+        bool
+        mayOverlap(Addr addr, unsigned size) const
+        {
+            bool hit = false;
+            forEachLine(addr, size, [this, &hit](size_t i) {
+                hit = hit || counts[i];
+            });
+            return hit;
+        }
+    };
+
     /** Coverage of one address range with another */
     enum class AddrRangeCoverage
     {
@@ -480,6 +563,16 @@ class LSQUnit
     /** Address Mask for a cache block (e.g. ~(cache_block_size-1)) */
     Addr cacheBlockMask;
 
+    /** Lines written by the stores in the SQ. */
+    StoreFilter storeFilter;
+
+    /** Adds the store's address range to the store filter, replacing the
+     * one from an earlier execution. */
+    void filterStore(SQEntry &entry);
+
+    /** Removes the store from the store filter, before it leaves the SQ. */
+    void unfilterStore(SQEntry &entry);
+
     /** Wire to read information from the issue stage time queue. */
     typename TimeBuffer<IssueStruct>::wire fromIssue;
 
@@ -542,6 +635,20 @@ class LSQUnit
         /** Number of loads that were rescheduled. */
         statistics::Scalar rescheduledLoads;
 
+        /** Loads that checked the store filter before searching the SQ
+         * for stores to forward from. */
+        statistics::Scalar storeSearches;
+
+        /** Of those, loads the filter let skip the search. */
+        statistics::Scalar storeSearchesSkipped;
+
+        /** Searches that found a store overlapping the load. */
+        statistics::Scalar storeSearchHits;
+
+        /** Fraction of the searches the filter let through that found an
+         * overlapping store. */
+        statistics::Formula storeSearchHitRatio;
+
         /** Number of times the LSQ is blocked due to the cache. */
         statistics::Scalar blockedByCache;
 
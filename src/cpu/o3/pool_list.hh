@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_POOL_LIST_HH__
+#define __CPU_O3_POOL_LIST_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/* Links of a PoolList node. The list head is a bare link, so end() is a
+ * real node and iterators can step back from it like std::list's. */
+struct PoolLink
+{
+    PoolLink *prev;
+    PoolLink *next;
+};
+
+/* Nodes shared by the PoolLists of one structure, allocated up front for
+ * its capacity. Pushing onto a list takes a node off the free list instead
+ * of going to the heap; the pool only grows, by another capacity worth of
+ * nodes, if its estimate was short. Lists sharing a pool can splice nodes
+ * between each other without copying. */
+template <class T>
+class NodePool
+{
+  public:
+    struct Node : PoolLink
+    {
+        T value;
+    };
+
+    explicit NodePool(size_t capacity = 0) { reserve(capacity); }
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    /* Allocates at least capacity nodes, keeping any already allocated */
+    void
+    reserve(size_t capacity)
+    {
+        if (capacity > allocated)
+            grow(capacity - allocated);
+    }
+
+    size_t capacity() const { return allocated; }
+
+    Node *
+    get()
+    {
+        if (!freeNodes)
+            grow(allocated ? allocated : 16);
+        Node *n = freeNodes;
+        freeNodes = static_cast<Node *>(n->next);
+        return n;
+    }
+
+    /* n's value must already have been released */
+    void
+    put(Node *n)
+    {
+        n->next = freeNodes;
+        freeNodes = n;
+    }
+
+  private:
+    void
+    grow(size_t n)
+    {
+        chunks.emplace_back(new Node[n]);
+        Node *chunk = chunks.back().get();
+        for (size_t i = 0; i < n; i++)
+            put(&chunk[i]);
+        allocated += n;
+    }
+
+    std::vector<std::unique_ptr<Node[]>> chunks;
+    Node *freeNodes = nullptr;
+    size_t allocated = 0;
+};
+
+/* Circular doubly linked list with the interface of the std::list uses in
+ * the O3 queues, whose nodes come from a NodePool. Values stay in the free
+ * nodes after being popped only until they are released, so a DynInstPtr
+ * does not keep an instruction alive once it leaves the list. */
+template <class T>
+class PoolList
+{
+  public:
+    typedef NodePool<T> Pool;
+    typedef typename Pool::Node Node;
+
+    template <class V, class L>
+    class Iterator
+    {
+      public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef V *pointer;
+        typedef V &reference;
+
+        Iterator() : link(nullptr) {}
+        explicit Iterator(L *l) : link(l) {}
+        /* iterator to const_iterator */
+        template <class V2, class L2>
+        Iterator(const Iterator<V2, L2> &o) : link(o.link) {}
+
+        reference
+        operator*() const
+        {
+            return static_cast<typename std::conditional<
+                std::is_const<V>::value, const Node, Node>::type *>(
+                    link)->value;
+        }
+        pointer operator->() const { return &**this; }
+
+        Iterator &operator++() { link = link->next; return *this; }
+        Iterator &operator--() { link = link->prev; return *this; }
+        Iterator operator++(int) { Iterator r = *this; ++*this; return r; }
+        Iterator operator--(int) { Iterator r = *this; --*this; return r; }
+
+        template <class V2, class L2>
+        bool
+        operator==(const Iterator<V2, L2> &o) const
+        {
+            return link == o.link;
+        }
+        template <class V2, class L2>
+        bool
+        operator!=(const Iterator<V2, L2> &o) const
+        {
+            return link != o.link;
+        }
+
+      private:
+        template <class, class> friend class Iterator;
+        friend class PoolList;
+
+        L *link;
+    };
+
+    typedef Iterator<T, PoolLink> iterator;
+    typedef Iterator<const T, const PoolLink> const_iterator;
+
+    explicit PoolList(Pool *_pool = nullptr) : pool(_pool)
+    {
+        head.prev = head.next = &head;
+    }
+
+    PoolList(const PoolList &) = delete;
+    PoolList &operator=(const PoolList &) = delete;
+
+    ~PoolList() { clear(); }
+
+    /* Lists in arrays are given their pool after construction */
+    void
+    setPool(Pool *_pool)
+    {
+        assert(empty());
+        pool = _pool;
+    }
+
+    iterator begin() { return iterator(head.next); }
+    iterator end() { return iterator(&head); }
+    const_iterator begin() const { return const_iterator(head.next); }
+    const_iterator end() const { return const_iterator(&head); }
+
+    bool empty() const { return head.next == &head; }
+    size_t size() const { return count; }
+
+    T &front() { assert(!empty()); return *begin(); }
+    T &back() { assert(!empty()); return *std::prev(end()); }
+    const T &front() const { assert(!empty()); return *begin(); }
+    const T &back() const { assert(!empty()); return *std::prev(end()); }
+
+    template <class V>
+    iterator
+    insert(iterator pos, V &&v)
+    {
+        Node *n = pool->get();
+        n->value = std::forward<V>(v);
+        link(pos.link, n);
+        count++;
+        return iterator(n);
+    }
+
+    template <class V>
+    void push_back(V &&v) { insert(end(), std::forward<V>(v)); }
+    template <class V>
+    void push_front(V &&v) { insert(begin(), std::forward<V>(v)); }
+
+    iterator
+    erase(iterator pos)
+    {
+        assert(pos != end());
+        PoolLink *next = pos.link->next;
+        unlink(pos.link);
+        release(static_cast<Node *>(pos.link));
+        count--;
+        return iterator(next);
+    }
+
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(std::prev(end())); }
+
+    void
+    clear()
+    {
+        while (!empty())
+            pop_front();
+    }
+
+    /* Moves all of other in front of pos. The lists must share a pool. */
+    void
+    splice(iterator pos, PoolList &other)
+    {
+        assert(pool == other.pool);
+        if (other.empty())
+            return;
+        PoolLink *first = other.head.next;
+        PoolLink *last = other.head.prev;
+        other.head.prev = other.head.next = &other.head;
+        first->prev = pos.link->prev;
+        pos.link->prev->next = first;
+        last->next = pos.link;
+        pos.link->prev = last;
+        count += other.count;
+        other.count = 0;
+    }
+
+  private:
+    static void
+    link(PoolLink *pos, PoolLink *n)
+    {
+        n->prev = pos->prev;
+        n->next = pos;
+        pos->prev->next = n;
+        pos->prev = n;
+    }
+
+    static void
+    unlink(PoolLink *n)
+    {
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+    }
+
+    void
+    release(Node *n)
+    {
+        n->value = T();
+        pool->put(n);
+    }
+
+    Pool *pool;
+    PoolLink head;
+    size_t count = 0;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_POOL_LIST_HH__
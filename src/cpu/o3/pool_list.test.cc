@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "cpu/o3/pool_list.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+template <class T>
+void
+expectSame(const PoolList<T> &list, const std::list<T> &ref)
+{
+    ASSERT_EQ(list.size(), ref.size());
+    ASSERT_EQ(list.empty(), ref.empty());
+    auto it = list.begin();
+    for (const T &v : ref)
+        ASSERT_EQ(*it++, v);
+    EXPECT_TRUE(it == list.end());
+
+    // And walking back from end()
+    auto rit = list.end();
+    for (auto ref_it = ref.rbegin(); ref_it != ref.rend(); ++ref_it)
+        ASSERT_EQ(*--rit, *ref_it);
+    EXPECT_TRUE(rit == list.begin());
+}
+
+} // anonymous namespace
+
+/** Pushing past the pool's capacity grows it rather than failing */
+TEST(PoolListTest, PoolGrows)
+{
+    NodePool<int> pool(4);
+    EXPECT_EQ(pool.capacity(), 4);
+    PoolList<int> list(&pool);
+    for (int i = 0; i < 10; i++)
+        list.push_back(i);
+    EXPECT_GE(pool.capacity(), 10);
+    EXPECT_EQ(list.size(), 10);
+    EXPECT_EQ(list.front(), 0);
+    EXPECT_EQ(list.back(), 9);
+}
+
+/** Nodes come back to the pool, so a list that stays within the capacity
+ * never grows it */
+TEST(PoolListTest, NodesAreReused)
+{
+    NodePool<int> pool(8);
+    PoolList<int> list(&pool);
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 8; i++)
+            list.push_front(i);
+        list.clear();
+    }
+    EXPECT_EQ(pool.capacity(), 8);
+}
+
+/** A value is released as soon as it leaves the list, not when its node
+ * is reused */
+TEST(PoolListTest, ReleasesValues)
+{
+    NodePool<std::shared_ptr<int>> pool(4);
+    PoolList<std::shared_ptr<int>> list(&pool);
+    auto v = std::make_shared<int>(1);
+    list.push_back(v);
+    list.push_back(v);
+    EXPECT_EQ(v.use_count(), 3);
+    list.pop_front();
+    EXPECT_EQ(v.use_count(), 2);
+    list.erase(list.begin());
+    EXPECT_EQ(v.use_count(), 1);
+
+    {
+        PoolList<std::shared_ptr<int>> scoped(&pool);
+        scoped.push_back(v);
+        EXPECT_EQ(v.use_count(), 2);
+    }
+    EXPECT_EQ(v.use_count(), 1);
+}
+
+/** Splicing moves every node of the other list and leaves it empty */
+TEST(PoolListTest, Splice)
+{
+    NodePool<int> pool(8);
+    PoolList<int> a(&pool), b(&pool);
+    std::list<int> ref_a, ref_b;
+    for (int i = 0; i < 4; i++) {
+        a.push_back(i);
+        ref_a.push_back(i);
+        b.push_back(10 + i);
+        ref_b.push_back(10 + i);
+    }
+    a.splice(std::next(a.begin()), b);
+    ref_a.splice(std::next(ref_a.begin()), ref_b);
+    expectSame(a, ref_a);
+    expectSame(b, ref_b);
+
+    // Into an empty list and from an empty one
+    b.splice(b.end(), a);
+    ref_b.splice(ref_b.end(), ref_a);
+    expectSame(a, ref_a);
+    expectSame(b, ref_b);
+    b.splice(b.begin(), a);
+    expectSame(b, ref_b);
+}
+
+/** Random operations on lists sharing a pool match std::list */
+TEST(PoolListTest, MatchesStdList)
+{
+    const int num_lists = 4;
+    std::mt19937 rng(1);
+    NodePool<int> pool(16);
+    std::vector<std::unique_ptr<PoolList<int>>> lists;
+    std::vector<std::list<int>> refs(num_lists);
+    for (int l = 0; l < num_lists; l++) {
+        // As the O3 list arrays do
+        lists.emplace_back(new PoolList<int>());
+        lists.back()->setPool(&pool);
+    }
+
+    for (int step = 0; step < 50000; step++) {
+        int l = rng() % num_lists;
+        PoolList<int> &list = *lists[l];
+        std::list<int> &ref = refs[l];
+        int v = rng();
+        switch (rng() % 8) {
+          case 0:
+          case 1:
+            list.push_back(v);
+            ref.push_back(v);
+            break;
+          case 2:
+            list.push_front(v);
+            ref.push_front(v);
+            break;
+          case 3:
+            if (!ref.empty()) {
+                list.pop_front();
+                ref.pop_front();
+            }
+            break;
+          case 4:
+            if (!ref.empty()) {
+                list.pop_back();
+                ref.pop_back();
+            }
+            break;
+          case 5:
+            {
+                // Insert or erase in the middle, checking the iterator
+                // returned
+                size_t pos = rng() % (ref.size() + 1);
+                auto it = std::next(list.begin(), pos);
+                auto ref_it = std::next(ref.begin(), pos);
+                if (rng() % 2 || ref_it == ref.end()) {
+                    it = list.insert(it, v);
+                    ref_it = ref.insert(ref_it, v);
+                } else {
+                    it = list.erase(it);
+                    ref_it = ref.erase(ref_it);
+                }
+                ASSERT_EQ(std::distance(list.begin(), it),
+                          std::distance(ref.begin(), ref_it));
+            }
+            break;
+          case 6:
+            {
+                int o = rng() % num_lists;
+                if (o != l && rng() % 8 == 0) {
+                    size_t pos = rng() % (ref.size() + 1);
+                    list.splice(std::next(list.begin(), pos), *lists[o]);
+                    ref.splice(std::next(ref.begin(), pos), refs[o]);
+                }
+            }
+            break;
+          case 7:
+            if (rng() % 64 == 0) {
+                list.clear();
+                ref.clear();
+            }
+            break;
+        }
+        if (!ref.empty()) {
+            ASSERT_EQ(list.front(), ref.front());
+            ASSERT_EQ(list.back(), ref.back());
+        }
+        ASSERT_EQ(list.size(), ref.size());
+    }
+    for (int l = 0; l < num_lists; l++)
+        expectSame(*lists[l], refs[l]);
+}
@@ -60,11 +60,15 @@ ROB::ROB(CPU *_cpu, const BaseO3CPUParams &params)
     : robPolicy(params.smtROBPolicy),
       cpu(_cpu),
       numEntries(params.numROBEntries),
+      instPool(params.numROBEntries),
       squashWidth(params.squashWidth),
       numInstsInROB(0),
       numThreads(params.numThreads),
       stats(_cpu)
 {
+    for (ThreadID tid = 0; tid < MaxThreads; tid++)
+        instList[tid].setPool(&instPool);
+
     //Figure out rob policy
     if (robPolicy == SMTQueuePolicy::Dynamic) {
         //Set Max Entries to Total ROB Capacity
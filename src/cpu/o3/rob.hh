@@ -51,6 +51,7 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/limits.hh"
+#include "cpu/o3/pool_list.hh"
 #include "cpu/reg_class.hh"
 #include "enums/SMTQueuePolicy.hh"
 
@@ -73,7 +74,7 @@ class ROB
 {
   public:
     typedef std::pair<RegIndex, RegIndex> UnmapInfo;
-    typedef typename std::list<DynInstPtr>::iterator InstIt;
+    typedef typename PoolList<DynInstPtr>::iterator InstIt;
 
     /** Possible ROB statuses. */
     enum Status
@@ -286,8 +287,11 @@ class ROB
     /** Max Insts a Thread Can Have in the ROB */
     unsigned maxEntries[MaxThreads];
 
+    /** Nodes of the instruction lists, one per ROB entry */
+    NodePool<DynInstPtr> instPool;
+
     /** ROB List of Instructions */
-    std::list<DynInstPtr> instList[MaxThreads];
+    PoolList<DynInstPtr> instList[MaxThreads];
 
     /** Number of instructions that can be squashed in a single cycle. */
     unsigned squashWidth;
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_SEQ_NUM_RING_HH__
+#define __CPU_O3_SEQ_NUM_RING_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "cpu/inst_seq.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/* Map from sequence number to instruction for the few instructions of a
+ * structure that are looked up by sequence number, kept as a circular
+ * buffer in sequence number order. Instructions arrive in about that order
+ * and leave from the ends (oldest made ready by commit, youngest squashed),
+ * so inserting and erasing is O(1) in the common case and lookup is a
+ * binary search, with no node allocation. Erasing from the middle, as
+ * happens with SMT, leaves a hole that is dropped once it reaches an end,
+ * or compacted if the ring fills up. */
+template <class T>
+class SeqNumRing
+{
+  public:
+    explicit SeqNumRing(size_t capacity = 0) : slots(capacity) {}
+
+    SeqNumRing(const SeqNumRing &) = delete;
+    SeqNumRing &operator=(const SeqNumRing &) = delete;
+
+    /* Must be empty */
+    void
+    resize(size_t capacity)
+    {
+        assert(!live);
+        slots.assign(capacity, Slot());
+        first = used = 0;
+    }
+
+    size_t size() const { return live; }
+    bool empty() const { return !live; }
+
+    void
+    insert(InstSeqNum seq, const T &value)
+    {
+        if (used == slots.size())
+            makeRoom();
+
+        // Younger instructions of other threads may already be here
+        size_t i = used++;
+        for (; i > 0 && at(i - 1).seq > seq; i--)
+            at(i) = std::move(at(i - 1));
+        assert(i == 0 || at(i - 1).seq != seq);
+        at(i).seq = seq;
+        at(i).live = true;
+        at(i).value = value;
+        live++;
+    }
+
+    /* Null if seq is not in the ring */
+    T *
+    find(InstSeqNum seq)
+    {
+        size_t i = index(seq);
+        return i == used ? nullptr : &at(i).value;
+    }
+
+    /* seq must be in the ring */
+    void
+    erase(InstSeqNum seq)
+    {
+        size_t i = index(seq);
+        assert(i != used);
+        at(i).live = false;
+        at(i).value = T();
+        live--;
+        while (used && !at(0).live) {
+            first = (first + 1) % slots.size();
+            used--;
+        }
+        while (used && !at(used - 1).live)
+            used--;
+    }
+
+    void
+    clear()
+    {
+        for (size_t i = 0; i < used; i++)
+            at(i) = Slot();
+        first = used = live = 0;
+    }
+
+    /* Calls f(seq, value) for each instruction, oldest first */
+    template <class F>
+    void
+    forEach(F f) const
+    {
+        for (size_t i = 0; i < used; i++) {
+            const Slot &s = slots[(first + i) % slots.size()];
+            if (s.live)
+                f(s.seq, s.value);
+        }
+    }
+
+  private:
+    struct Slot
+    {
+        InstSeqNum seq = 0;
+        bool live = false;
+        T value = T();
+    };
+
+    Slot &at(size_t i) { return slots[(first + i) % slots.size()]; }
+
+    /* Position of seq from the oldest slot, used if it is not there */
+    size_t
+    index(InstSeqNum seq)
+    {
+        size_t lo = 0, hi = used;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (at(mid).seq < seq)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo == used || at(lo).seq != seq || !at(lo).live)
+            return used;
+        return lo;
+    }
+
+    /* Drops the holes, or doubles the ring if there are none */
+    void
+    makeRoom()
+    {
+        std::vector<Slot> compact;
+        compact.reserve(live == slots.size() ? 2 * live + 1 : slots.size());
+        for (size_t i = 0; i < used; i++) {
+            if (at(i).live)
+                compact.push_back(std::move(at(i)));
+        }
+        compact.resize(compact.capacity());
+        slots.swap(compact);
+        first = 0;
+        used = live;
+    }
+
+    std::vector<Slot> slots;
+    // Index of the oldest slot, and slots from there on in use
+    size_t first = 0;
+    size_t used = 0;
+    size_t live = 0;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_SEQ_NUM_RING_HH__
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "cpu/o3/seq_num_ring.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+void
+expectSame(const SeqNumRing<int> &ring, const std::map<InstSeqNum, int> &ref)
+{
+    ASSERT_EQ(ring.size(), ref.size());
+    ASSERT_EQ(ring.empty(), ref.empty());
+    auto it = ref.begin();
+    ring.forEach([&](InstSeqNum seq, int value) {
+        ASSERT_TRUE(it != ref.end());
+        EXPECT_EQ(seq, it->first);
+        EXPECT_EQ(value, it->second);
+        ++it;
+    });
+    EXPECT_TRUE(it == ref.end());
+}
+
+} // anonymous namespace
+
+/** In order inserts and erases from both ends */
+TEST(SeqNumRingTest, Ends)
+{
+    SeqNumRing<int> ring(4);
+    for (InstSeqNum seq = 1; seq <= 4; seq++)
+        ring.insert(seq, seq * 10);
+    EXPECT_EQ(ring.size(), 4);
+    ASSERT_NE(ring.find(3), nullptr);
+    EXPECT_EQ(*ring.find(3), 30);
+    EXPECT_EQ(ring.find(5), nullptr);
+
+    ring.erase(1);
+    ring.erase(4);
+    EXPECT_EQ(ring.find(1), nullptr);
+    EXPECT_EQ(ring.find(4), nullptr);
+    EXPECT_EQ(ring.size(), 2);
+
+    // Wraps around the freed slots without growing
+    ring.insert(5, 50);
+    ring.insert(6, 60);
+    std::vector<InstSeqNum> seqs;
+    ring.forEach([&](InstSeqNum seq, int) { seqs.push_back(seq); });
+    EXPECT_EQ(seqs, (std::vector<InstSeqNum>{2, 3, 5, 6}));
+}
+
+/** A hole in the middle is skipped, and dropped once it reaches an end */
+TEST(SeqNumRingTest, Holes)
+{
+    SeqNumRing<int> ring(8);
+    for (InstSeqNum seq = 1; seq <= 5; seq++)
+        ring.insert(seq, seq);
+    ring.erase(3);
+    EXPECT_EQ(ring.find(3), nullptr);
+    EXPECT_EQ(ring.size(), 4);
+    ring.erase(1);
+    ring.erase(2);
+    EXPECT_EQ(ring.size(), 2);
+    ASSERT_NE(ring.find(4), nullptr);
+    EXPECT_EQ(*ring.find(4), 4);
+}
+
+/** Filling the ring compacts the holes, or grows it if there are none */
+TEST(SeqNumRingTest, MakeRoom)
+{
+    SeqNumRing<int> ring(4);
+    for (InstSeqNum seq = 1; seq <= 4; seq++)
+        ring.insert(seq, seq);
+    ring.erase(2);
+    ring.insert(5, 5);
+    ring.insert(6, 6);
+    ring.insert(7, 7);
+    std::vector<InstSeqNum> seqs;
+    ring.forEach([&](InstSeqNum seq, int) { seqs.push_back(seq); });
+    EXPECT_EQ(seqs, (std::vector<InstSeqNum>{1, 3, 4, 5, 6, 7}));
+
+    SeqNumRing<int> unsized;
+    unsized.insert(1, 1);
+    EXPECT_EQ(unsized.size(), 1);
+}
+
+/** A value is released as soon as it is erased */
+TEST(SeqNumRingTest, ReleasesValues)
+{
+    SeqNumRing<std::shared_ptr<int>> ring(4);
+    auto v = std::make_shared<int>(1);
+    ring.insert(1, v);
+    ring.insert(2, v);
+    EXPECT_EQ(v.use_count(), 3);
+    ring.erase(2);
+    EXPECT_EQ(v.use_count(), 2);
+    ring.clear();
+    EXPECT_EQ(v.use_count(), 1);
+    EXPECT_TRUE(ring.empty());
+}
+
+/** Random inserts, mostly in order but with some older sequence numbers as
+ * with SMT, and erases from the ends and the middle match std::map */
+TEST(SeqNumRingTest, MatchesStdMap)
+{
+    std::mt19937 rng(1);
+    SeqNumRing<int> ring(16);
+    std::map<InstSeqNum, int> ref;
+    // Sequence numbers handed out but not yet inserted
+    std::vector<InstSeqNum> pending;
+    InstSeqNum next_seq = 1;
+
+    for (int step = 0; step < 50000; step++) {
+        switch (rng() % 6) {
+          case 0:
+          case 1:
+            {
+                InstSeqNum seq;
+                if (!pending.empty() && rng() % 4 == 0) {
+                    size_t i = rng() % pending.size();
+                    seq = pending[i];
+                    pending.erase(pending.begin() + i);
+                } else {
+                    if (rng() % 8 == 0)
+                        pending.push_back(next_seq++);
+                    seq = next_seq++;
+                }
+                int v = rng();
+                ring.insert(seq, v);
+                ref[seq] = v;
+            }
+            break;
+          case 2:
+            if (!ref.empty()) {
+                ring.erase(ref.begin()->first);
+                ref.erase(ref.begin());
+            }
+            break;
+          case 3:
+            if (!ref.empty()) {
+                ring.erase(std::prev(ref.end())->first);
+                ref.erase(std::prev(ref.end()));
+            }
+            break;
+          case 4:
+            if (!ref.empty() && rng() % 4 == 0) {
+                auto it = std::next(ref.begin(), rng() % ref.size());
+                ring.erase(it->first);
+                ref.erase(it);
+            }
+            break;
+          case 5:
+            {
+                InstSeqNum seq = rng() % (next_seq + 1);
+                auto it = ref.find(seq);
+                int *found = ring.find(seq);
+                if (it == ref.end()) {
+                    ASSERT_EQ(found, nullptr) << "seq " << seq;
+                } else {
+                    ASSERT_NE(found, nullptr) << "seq " << seq;
+                    ASSERT_EQ(*found, it->second);
+                }
+                if (rng() % 512 == 0) {
+                    ring.clear();
+                    ref.clear();
+                }
+            }
+            break;
+        }
+        ASSERT_EQ(ring.size(), ref.size());
+        if (step % 1000 == 0)
+            expectSame(ring, ref);
+    }
+    expectSame(ring, ref);
+}
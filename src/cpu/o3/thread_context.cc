@@ -141,6 +141,7 @@ ThreadContext::copyArchRegs(gem5::ThreadContext *tc)
     thread->noSquashFromTC = true;
     getIsaPtr()->copyRegsFrom(tc);
     thread->noSquashFromTC = false;
+    thread->dirtyRegs.markAll();
 }
 
 void
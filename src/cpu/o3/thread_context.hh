@@ -106,6 +106,8 @@ class ThreadContext : public gem5::ThreadContext
 
     CheckerCPU *getCheckerCpuPtr() override { return NULL; }
 
+    DirtyRegs *getDirtyRegs() override { return &thread->dirtyRegs; }
+
     BaseISA *
     getIsaPtr() const override
     {
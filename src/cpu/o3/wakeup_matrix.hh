@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_WAKEUP_MATRIX_HH__
+#define __CPU_O3_WAKEUP_MATRIX_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/* Scheduler for the IQ with iqScheduler = 'WakeupMatrix', in place of the
+ * DependencyGraph and the per op class ready queues. Instructions waiting
+ * on registers, and ready instructions, each hold a slot. Each physical
+ * register has a row of bits over the slots waiting on it, so a register
+ * wakes its consumers by walking the bits set in its row. Each op class
+ * has a row of bits over the ready slots, and select picks the oldest
+ * ready slot by sequence number among the op classes whose FUs are not
+ * busy this cycle. That is the order the ready queues issue in, so the
+ * two schedulers issue the same instructions in the same cycles. An
+ * instruction made ready twice holds two ready slots, as it would be in a
+ * ready queue twice. Slots are allocated for the IQ size, and the matrix
+ * only grows if squashed instructions still waiting to be dropped by
+ * select fill it up. */
+template <class DynInstPtr>
+class WakeupMatrix
+{
+  public:
+    WakeupMatrix() = default;
+
+    WakeupMatrix(const WakeupMatrix &) = delete;
+    WakeupMatrix &operator=(const WakeupMatrix &) = delete;
+
+    /* Must call prior to use */
+    void
+    resize(int num_regs, int num_classes, size_t num_slots)
+    {
+        numRegs = num_regs;
+        numClasses = num_classes;
+        slots.clear();
+        freeSlots.clear();
+        words = 0;
+        grow(num_slots);
+    }
+
+    /* Drops every waiting and ready instruction. Does nothing before
+     * resize(), as there is nothing to drop. */
+    void
+    reset()
+    {
+        if (!words)
+            return;
+        size_t num_slots = slots.size();
+        slots.clear();
+        freeSlots.clear();
+        words = 0;
+        grow(num_slots);
+    }
+
+    /* Slot for new_inst to wait on registers with, from wait() */
+    int
+    allocate(const DynInstPtr &new_inst)
+    {
+        if (freeSlots.empty())
+            grow(slots.size());
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        slots[slot].inst = new_inst;
+        slots[slot].seq = new_inst->seqNum;
+        return slot;
+    }
+
+    /* slot waits on reg. Waiting on a register twice takes one bit. */
+    void
+    wait(RegIndex reg, int slot)
+    {
+        uint64_t &word = waitRow(reg)[slot / 64];
+        uint64_t bit = 1ULL << (slot % 64);
+        if (!(word & bit)) {
+            word |= bit;
+            if (!slots[slot].waits++)
+                waitingSlots++;
+        }
+    }
+
+    /* Slot of inst waiting on reg, -1 if none */
+    int
+    find(RegIndex reg, const DynInstPtr &inst) const
+    {
+        const uint64_t *row = waitRow(reg);
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t bits = row[w]; bits; bits &= bits - 1) {
+                int slot = w * 64 + ctz64(bits);
+                if (slots[slot].inst == inst)
+                    return slot;
+            }
+        }
+        return -1;
+    }
+
+    /* slot no longer waits on reg, and is freed if it waits on nothing */
+    void
+    unwait(RegIndex reg, int slot)
+    {
+        uint64_t &word = waitRow(reg)[slot / 64];
+        uint64_t bit = 1ULL << (slot % 64);
+        assert(word & bit);
+        word &= ~bit;
+        if (!--slots[slot].waits) {
+            waitingSlots--;
+            free(slot);
+        }
+    }
+
+    /* Calls f(inst) for each instruction waiting on reg, which no longer
+     * does. Slots waiting on nothing else are freed first, so f can make
+     * the instruction ready. */
+    template <class F>
+    void
+    wake(RegIndex reg, F f)
+    {
+        // f may grow the matrix, so the row is not held across calls
+        for (size_t w = 0; w < words; w++) {
+            uint64_t bits = waitRow(reg)[w];
+            waitRow(reg)[w] = 0;
+            for (; bits; bits &= bits - 1) {
+                int slot = w * 64 + ctz64(bits);
+                DynInstPtr inst = slots[slot].inst;
+                if (!--slots[slot].waits) {
+                    waitingSlots--;
+                    free(slot);
+                }
+                f(inst);
+            }
+        }
+    }
+
+    /* Checks if there are any instructions waiting on reg */
+    bool
+    empty(RegIndex reg) const
+    {
+        const uint64_t *row = waitRow(reg);
+        for (size_t w = 0; w < words; w++) {
+            if (row[w])
+                return false;
+        }
+        return true;
+    }
+
+    /* Checks if no instruction is waiting on any register */
+    bool empty() const { return !waitingSlots; }
+
+    /* ready_inst can issue to an FU of op_class */
+    void
+    ready(const DynInstPtr &ready_inst, int op_class)
+    {
+        int slot = allocate(ready_inst);
+        slots[slot].opClass = op_class;
+        uint64_t bit = 1ULL << (slot % 64);
+        readyRow(op_class)[slot / 64] |= bit;
+        readySlots[slot / 64] |= bit;
+        numReady++;
+    }
+
+    bool anyReady() const { return numReady; }
+
+    size_t
+    numReadyOf(int op_class) const
+    {
+        size_t n = 0;
+        for (size_t w = 0; w < words; w++)
+            n += popCount(readyRow(op_class)[w]);
+        return n;
+    }
+
+    /* Starts selecting this cycle's instructions, from every op class */
+    void
+    beginSelect()
+    {
+        candidates = readySlots;
+    }
+
+    /* Oldest ready slot among the op classes not blocked since
+     * beginSelect(), -1 if none */
+    int
+    selectOldest() const
+    {
+        int oldest = -1;
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t bits = candidates[w]; bits; bits &= bits - 1) {
+                int slot = w * 64 + ctz64(bits);
+                if (oldest < 0 || slots[slot].seq < slots[oldest].seq)
+                    oldest = slot;
+            }
+        }
+        return oldest;
+    }
+
+    /* No more instructions of op_class are selected until beginSelect() */
+    void
+    block(int op_class)
+    {
+        const uint64_t *row = readyRow(op_class);
+        for (size_t w = 0; w < words; w++)
+            candidates[w] &= ~row[w];
+    }
+
+    /* The ready slot is issued, or dropped, and freed */
+    void
+    remove(int slot)
+    {
+        uint64_t bit = 1ULL << (slot % 64);
+        assert(readySlots[slot / 64] & bit);
+        readyRow(slots[slot].opClass)[slot / 64] &= ~bit;
+        readySlots[slot / 64] &= ~bit;
+        candidates[slot / 64] &= ~bit;
+        numReady--;
+        free(slot);
+    }
+
+    const DynInstPtr &inst(int slot) const { return slots[slot].inst; }
+    int opClass(int slot) const { return slots[slot].opClass; }
+
+  private:
+    struct Slot
+    {
+        DynInstPtr inst = nullptr;
+        InstSeqNum seq = 0;
+        int opClass = 0;
+        // Registers the slot waits on
+        int waits = 0;
+    };
+
+    // Rows are empty before resize(), when the IQ does not use the matrix
+    uint64_t *waitRow(RegIndex reg) { return waitBits.data() + reg * words; }
+    const uint64_t *
+    waitRow(RegIndex reg) const
+    {
+        return waitBits.data() + reg * words;
+    }
+    uint64_t *
+    readyRow(int op_class)
+    {
+        return readyBits.data() + op_class * words;
+    }
+    const uint64_t *
+    readyRow(int op_class) const
+    {
+        return readyBits.data() + op_class * words;
+    }
+
+    void
+    free(int slot)
+    {
+        slots[slot] = Slot();
+        freeSlots.push_back(slot);
+    }
+
+    /* Adds n slots, at least one word's worth, keeping the bits set */
+    void
+    grow(size_t n)
+    {
+        size_t old_slots = slots.size();
+        size_t old_words = words;
+        slots.resize(old_slots + std::max<size_t>(n, 64));
+        words = (slots.size() + 63) / 64;
+        slots.resize(words * 64);
+
+        widen(waitBits, numRegs, old_words);
+        widen(readyBits, numClasses, old_words);
+        readySlots.resize(words, 0);
+        candidates.resize(words, 0);
+        if (!old_words)
+            numReady = waitingSlots = 0;
+
+        // Lowest slots first
+        for (size_t slot = slots.size(); slot-- > old_slots;)
+            freeSlots.push_back(slot);
+    }
+
+    void
+    widen(std::vector<uint64_t> &rows, int num_rows, size_t old_words)
+    {
+        std::vector<uint64_t> wide(num_rows * words, 0);
+        for (int r = 0; r < num_rows; r++) {
+            for (size_t w = 0; w < old_words; w++)
+                wide[r * words + w] = rows[r * old_words + w];
+        }
+        rows.swap(wide);
+    }
+
+    int numRegs = 0;
+    int numClasses = 0;
+
+    std::vector<Slot> slots;
+    std::vector<int> freeSlots;
+    // 64 bit words in a row of slots
+    size_t words = 0;
+
+    // A row of slots per register, then per op class
+    std::vector<uint64_t> waitBits;
+    std::vector<uint64_t> readyBits;
+    std::vector<uint64_t> readySlots;
+    // Ready slots of the op classes select has not blocked
+    std::vector<uint64_t> candidates;
+
+    size_t numReady = 0;
+    size_t waitingSlots = 0;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_WAKEUP_MATRIX_HH__
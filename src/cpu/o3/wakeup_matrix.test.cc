@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "cpu/o3/wakeup_matrix.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+struct FakeInst
+{
+    InstSeqNum seqNum;
+    bool squashed = false;
+
+    FakeInst(InstSeqNum seq) : seqNum(seq) {}
+};
+
+typedef std::shared_ptr<FakeInst> FakeInstPtr;
+
+/** The per op class ready queues and the age order list the IQ issues
+ * from without the wakeup matrix, as in InstructionQueue::
+ * addToReadyQueue() and issueFromReadyQueues() */
+class ReadyQueues
+{
+  public:
+    explicit ReadyQueues(int num_classes)
+        : readyInsts(num_classes), readyIt(num_classes),
+          queueOnList(num_classes, false)
+    {}
+
+    void
+    ready(const FakeInstPtr &inst, int op_class)
+    {
+        readyInsts[op_class].push(inst);
+        if (!queueOnList[op_class]) {
+            addToOrderList(op_class);
+        } else if (readyInsts[op_class].top()->seqNum <
+                   readyIt[op_class]->oldestInst) {
+            listOrder.erase(readyIt[op_class]);
+            addToOrderList(op_class);
+        }
+    }
+
+    template <class FU>
+    std::vector<InstSeqNum>
+    issue(int width, FU issue_to_fu)
+    {
+        std::vector<InstSeqNum> issued;
+        auto order_it = listOrder.begin();
+        while ((int)issued.size() < width && order_it != listOrder.end()) {
+            int op_class = order_it->queueType;
+            FakeInstPtr inst = readyInsts[op_class].top();
+            if (inst->squashed || issue_to_fu(op_class)) {
+                if (!inst->squashed)
+                    issued.push_back(inst->seqNum);
+                readyInsts[op_class].pop();
+                if (!readyInsts[op_class].empty())
+                    moveToYoungerInst(order_it);
+                else
+                    queueOnList[op_class] = false;
+                listOrder.erase(order_it++);
+            } else {
+                ++order_it;
+            }
+        }
+        return issued;
+    }
+
+    bool empty() const { return listOrder.empty(); }
+
+  private:
+    struct Entry
+    {
+        int queueType;
+        InstSeqNum oldestInst;
+    };
+
+    struct Older
+    {
+        bool
+        operator()(const FakeInstPtr &a, const FakeInstPtr &b) const
+        {
+            return a->seqNum > b->seqNum;
+        }
+    };
+
+    void
+    addToOrderList(int op_class)
+    {
+        Entry entry{op_class, readyInsts[op_class].top()->seqNum};
+        auto it = listOrder.begin();
+        while (it != listOrder.end() && it->oldestInst <= entry.oldestInst)
+            ++it;
+        readyIt[op_class] = listOrder.insert(it, entry);
+        queueOnList[op_class] = true;
+    }
+
+    void
+    moveToYoungerInst(std::list<Entry>::iterator it)
+    {
+        int op_class = it->queueType;
+        Entry entry{op_class, readyInsts[op_class].top()->seqNum};
+        auto next_it = std::next(it);
+        while (next_it != listOrder.end() &&
+               next_it->oldestInst < entry.oldestInst)
+            ++next_it;
+        readyIt[op_class] = listOrder.insert(next_it, entry);
+    }
+
+    std::vector<std::priority_queue<FakeInstPtr, std::vector<FakeInstPtr>,
+                                    Older>> readyInsts;
+    std::list<Entry> listOrder;
+    std::vector<std::list<Entry>::iterator> readyIt;
+    std::vector<bool> queueOnList;
+};
+
+/** Select as in InstructionQueue::issueFromWakeupMatrix() */
+template <class FU>
+std::vector<InstSeqNum>
+issueFromMatrix(WakeupMatrix<FakeInstPtr> &matrix, int width,
+                FU issue_to_fu)
+{
+    std::vector<InstSeqNum> issued;
+    int slot;
+    matrix.beginSelect();
+    while ((int)issued.size() < width &&
+           (slot = matrix.selectOldest()) >= 0) {
+        FakeInstPtr inst = matrix.inst(slot);
+        if (inst->squashed) {
+            matrix.remove(slot);
+        } else if (issue_to_fu(matrix.opClass(slot))) {
+            issued.push_back(inst->seqNum);
+            matrix.remove(slot);
+        } else {
+            matrix.block(matrix.opClass(slot));
+        }
+    }
+    return issued;
+}
+
+} // anonymous namespace
+
+/** Resetting a matrix that was never sized, as an IQ that does not use it
+ * does, leaves it empty for every register */
+TEST(WakeupMatrixTest, UnsizedIsEmpty)
+{
+    WakeupMatrix<FakeInstPtr> matrix;
+    matrix.reset();
+    EXPECT_TRUE(matrix.empty());
+    EXPECT_FALSE(matrix.anyReady());
+    for (RegIndex reg = 0; reg < 128; reg++)
+        EXPECT_TRUE(matrix.empty(reg));
+}
+
+/** Waking a register calls back once for each instruction waiting on it,
+ * and frees the slots that wait on nothing else */
+TEST(WakeupMatrixTest, WaitAndWake)
+{
+    WakeupMatrix<FakeInstPtr> matrix;
+    matrix.resize(8, 2, 4);
+
+    auto a = std::make_shared<FakeInst>(1);
+    auto b = std::make_shared<FakeInst>(2);
+    int slot_a = matrix.allocate(a);
+    int slot_b = matrix.allocate(b);
+    matrix.wait(3, slot_a);
+    matrix.wait(3, slot_a);
+    matrix.wait(3, slot_b);
+    matrix.wait(5, slot_b);
+    EXPECT_FALSE(matrix.empty());
+    EXPECT_EQ(matrix.find(5, b), slot_b);
+    EXPECT_EQ(matrix.find(5, a), -1);
+
+    std::vector<InstSeqNum> woken;
+    matrix.wake(3, [&](const FakeInstPtr &inst) {
+        woken.push_back(inst->seqNum);
+    });
+    std::sort(woken.begin(), woken.end());
+    EXPECT_EQ(woken, (std::vector<InstSeqNum>{1, 2}));
+    EXPECT_TRUE(matrix.empty(3));
+    EXPECT_FALSE(matrix.empty());
+
+    matrix.unwait(5, slot_b);
+    EXPECT_TRUE(matrix.empty(5));
+    EXPECT_TRUE(matrix.empty());
+}
+
+/** Slots beyond those resize() allocated keep the bits already set */
+TEST(WakeupMatrixTest, Grow)
+{
+    WakeupMatrix<FakeInstPtr> matrix;
+    matrix.resize(4, 1, 1);
+
+    std::vector<FakeInstPtr> insts;
+    for (InstSeqNum seq = 1; seq <= 200; seq++) {
+        insts.push_back(std::make_shared<FakeInst>(seq));
+        matrix.wait(seq % 4, matrix.allocate(insts.back()));
+    }
+    for (RegIndex reg = 0; reg < 4; reg++) {
+        int woken = 0;
+        matrix.wake(reg, [&](const FakeInstPtr &inst) {
+            EXPECT_EQ(inst->seqNum % 4, reg);
+            woken++;
+        });
+        EXPECT_EQ(woken, 50);
+    }
+    EXPECT_TRUE(matrix.empty());
+}
+
+/** The matrix issues the same instructions, in the same order, as the
+ * ready queues and age order list, over random readiness, squashes and
+ * FU availability */
+TEST(WakeupMatrixTest, SelectMatchesReadyQueues)
+{
+    const int num_classes = 6;
+    const int width = 4;
+    std::mt19937 rng(1);
+
+    WakeupMatrix<FakeInstPtr> matrix;
+    matrix.resize(16, num_classes, 16);
+    ReadyQueues queues(num_classes);
+
+    std::vector<FakeInstPtr> pending;
+    InstSeqNum next_seq = 1;
+    for (int cycle = 0; cycle < 20000; cycle++) {
+        // Instructions become ready out of program order, some of them
+        // twice, and some are squashed while ready
+        for (int n = rng() % 6; n > 0; n--)
+            pending.push_back(std::make_shared<FakeInst>(next_seq++));
+        std::shuffle(pending.begin(), pending.end(), rng);
+        for (int n = rng() % 5; n > 0 && !pending.empty(); n--) {
+            FakeInstPtr inst = pending.back();
+            int op_class = inst->seqNum % num_classes;
+            int times = rng() % 16 ? 1 : 2;
+            for (int t = 0; t < times; t++) {
+                matrix.ready(inst, op_class);
+                queues.ready(inst, op_class);
+            }
+            if (rng() % 10 == 0)
+                inst->squashed = true;
+            pending.pop_back();
+        }
+
+        std::vector<int> free_fus(num_classes);
+        for (int &f : free_fus)
+            f = rng() % 3;
+        std::vector<int> matrix_fus = free_fus;
+        std::vector<int> queue_fus = free_fus;
+
+        auto from_matrix = issueFromMatrix(matrix, width,
+            [&](int op_class) { return matrix_fus[op_class]-- > 0; });
+        auto from_queues = queues.issue(width,
+            [&](int op_class) { return queue_fus[op_class]-- > 0; });
+        ASSERT_EQ(from_matrix, from_queues) << "cycle " << cycle;
+    }
+
+    // Drain both with every FU free
+    while (!queues.empty()) {
+        auto from_matrix = issueFromMatrix(matrix, width,
+            [](int) { return true; });
+        auto from_queues = queues.issue(width, [](int) { return true; });
+        ASSERT_EQ(from_matrix, from_queues);
+    }
+    EXPECT_FALSE(matrix.anyReady());
+}
@@ -167,6 +167,7 @@ void
 SimpleThread::copyArchRegs(ThreadContext *src_tc)
 {
     getIsaPtr()->copyRegsFrom(src_tc);
+    dirtyRegs.markAll();
 }
 
 // hardware transactional memory
@@ -210,6 +210,8 @@ class SimpleThread : public ThreadState, public ThreadContext
 
     BaseISA *getIsaPtr() const override { return isa; }
 
+    DirtyRegs *getDirtyRegs() override { return &dirtyRegs; }
+
     InstDecoder *getDecoderPtr() override { return decoder; }
 
     System *getSystemPtr() override { return system; }
@@ -250,6 +252,7 @@ class SimpleThread : public ThreadState, public ThreadContext
         for (auto &rf: regFiles)
             rf.clear();
         isa->clear();
+        dirtyRegs.markAll();
     }
 
     //
@@ -282,12 +285,14 @@ class SimpleThread : public ThreadState, public ThreadContext
     void
     setMiscRegNoEffect(RegIndex misc_reg, RegVal val) override
     {
+        dirtyRegs.mark(MiscRegClass, misc_reg);
         return isa->setMiscRegNoEffect(misc_reg, val);
     }
 
     void
     setMiscReg(RegIndex misc_reg, RegVal val) override
     {
+        dirtyRegs.mark(MiscRegClass, misc_reg);
         return isa->setMiscReg(misc_reg, val);
     }
 
@@ -381,6 +386,7 @@ class SimpleThread : public ThreadState, public ThreadContext
     {
         const RegId reg = flattenRegId(arch_reg);
         const RegIndex idx = reg.index();
+        dirtyRegs.mark(reg);
         auto &reg_file = regFiles[reg.classValue()];
 
         return reg_file.ptr(idx);
@@ -390,6 +396,7 @@ class SimpleThread : public ThreadState, public ThreadContext
     getWritableRegFlat(const RegId &reg) override
     {
         const RegIndex idx = reg.index();
+        dirtyRegs.mark(reg);
         auto &reg_file = regFiles[reg.classValue()];
 
         return reg_file.ptr(idx);
@@ -410,6 +417,7 @@ class SimpleThread : public ThreadState, public ThreadContext
 
         DPRINTFV(reg_class.debug(), "Setting %s register %s (%d) to %#x.\n",
                 reg.className(), reg_class.regName(arch_reg), idx, val);
+        dirtyRegs.mark(reg);
         reg_file.reg(idx) = val;
     }
 
@@ -426,6 +434,7 @@ class SimpleThread : public ThreadState, public ThreadContext
 
         DPRINTFV(reg_class.debug(), "Setting %s register %d to %#x.\n",
                 reg.className(), idx, val);
+        dirtyRegs.mark(reg);
         reg_file.reg(idx) = val;
     }
 
@@ -442,6 +451,7 @@ class SimpleThread : public ThreadState, public ThreadContext
         DPRINTFV(reg_class.debug(), "Setting %s register %s (%d) to %s.\n",
                 reg.className(), reg_class.regName(arch_reg), idx,
                 reg_class.valString(val));
+        dirtyRegs.mark(reg);
         reg_file.set(idx, val);
     }
 
@@ -455,6 +465,7 @@ class SimpleThread : public ThreadState, public ThreadContext
 
         DPRINTFV(reg_class.debug(), "Setting %s register %d to %s.\n",
                 reg.className(), idx, reg_class.valString(val));
+        dirtyRegs.mark(reg);
         reg_file.set(idx, val);
     }
 
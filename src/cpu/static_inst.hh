@@ -357,6 +357,10 @@ class StaticInst : public RefCounted, public StaticInstFlags
     /// Return name of machine instruction
     std::string getName() { return mnemonic; }
 
+    /// Return the mnemonic without copying it, the pointer is stable for
+    /// the lifetime of the instruction
+    const char *getMnemonic() const { return mnemonic; }
+
   protected:
     template<typename T>
     size_t
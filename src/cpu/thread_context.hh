@@ -67,6 +67,7 @@ class BaseCPU;
 class BaseMMU;
 class BaseTLB;
 class CheckerCPU;
+class DirtyRegs;
 class Checkpoint;
 class InstDecoder;
 class PortProxy;
@@ -144,6 +145,9 @@ class ThreadContext : public PCEventScope
 
     virtual BaseISA *getIsaPtr() const = 0;
 
+    /** Registers written since the last snapshot, if the model tracks them */
+    virtual DirtyRegs *getDirtyRegs() { return nullptr; }
+
     virtual InstDecoder *getDecoderPtr() = 0;
 
     virtual System *getSystemPtr() = 0;
@@ -60,6 +60,7 @@ void
 ThreadState::unserialize(CheckpointIn &cp)
 {
     UNSERIALIZE_ENUM(_status);
+    dirtyRegs.markAll();
 }
 
 ThreadState::ThreadStateStats::ThreadStateStats(BaseCPU *cpu,
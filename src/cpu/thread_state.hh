@@ -30,6 +30,7 @@
 #define __CPU_THREAD_STATE_HH__
 
 #include "cpu/base.hh"
+#include "cpu/dirty_regs.hh"
 #include "cpu/thread_context.hh"
 #include "sim/process.hh"
 
@@ -108,6 +109,10 @@ struct ThreadState : public Serializable
     /** The number of simulated loads committed prior to this run. */
     Counter startNumLoad;
 
+    /** Architectural registers written since the last miniContext
+     * snapshot of this thread. */
+    DirtyRegs dirtyRegs;
+
   protected:
     ThreadContext::Status _status;
 
@@ -64,7 +64,6 @@
 #include "params/WriteAllocator.hh"
 #include "sim/cur_tick.hh"
 #include "mem/cache/loadstorelogentry.hh"
-#include "mem/cache/tags/base_set_assoc.hh"
 
 namespace gem5
 {
@@ -120,7 +119,7 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
       useVanillaReplacement(p.useVanillaReplacement)
 {
 
-    if(canBlock)loadstorelogentry::initCacheSets(p.size/blk_size);
+    if(canBlock)loadstorelogentry::initCacheSets(p.size/blk_size, cpuID, this);
     // the MSHR queue has no reserve entries as we check the MSHR
     // queue on every single allocation, whereas the write queue has
     // as many reserve entries as we have MSHRs, since every MSHR may
@@ -1100,16 +1099,34 @@ int BaseCache::blockedEntries(int cpuid) {
     assert(cpuid >= 0 && cpuid < loadstorelogentry::mainCPUMeta.size());
     int blocked =0;
 
-    BaseSetAssoc* tagz = (BaseSetAssoc*) tags;
-    
-    for (CacheBlk& blk : tagz->blks) {
-        if (blk.timestamp > loadstorelogentry::mainCPUMeta[cpuid].committed_timestamp) blocked++;
+    // Only the buckets of checkpoints still in flight are past the
+    // committed timestamp.
+    for (auto it = blkTimestamps.upper_bound(
+             loadstorelogentry::mainCPUMeta[cpuid].committed_timestamp);
+         it != blkTimestamps.end(); it++) {
+        blocked += it->second;
     }
 
-    assert(blocked <= 512); //only designed for 32KB L1 at the moment.
     return blocked;
 }
 
+void
+BaseCache::setBlkTimestamp(CacheBlk *blk, uint64_t timestamp)
+{
+    // The temporary block is not part of the tag store
+    if (blk != tempBlock && blk->timestamp != timestamp) {
+        if (blk->timestamp) {
+            auto it = blkTimestamps.find(blk->timestamp);
+            assert(it != blkTimestamps.end() && it->second > 0);
+            if (--it->second == 0)
+                blkTimestamps.erase(it);
+        }
+        if (timestamp)
+            blkTimestamps[timestamp]++;
+    }
+    blk->timestamp = timestamp;
+}
+
 void
 BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
 {
@@ -1171,7 +1188,8 @@ BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
         if (canBlock && !isVictim)    {
             assert(cpuID >= 0 &&
                    cpuID < loadstorelogentry::mainCPUMeta.size());
-            blk->timestamp = loadstorelogentry::mainCPUMeta[cpuID].timestamp;
+            setBlkTimestamp(blk,
+                            loadstorelogentry::mainCPUMeta[cpuID].timestamp);
             //printf("writing at timestamp %ld\n", blk->timestamp);
         }
         // Always mark the line as dirty (and thus transition to the
@@ -1622,7 +1640,7 @@ BaseCache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
     assert(regenerateBlkAddr(blk) == addr);
 
     blk->setCoherenceBits(CacheBlk::ReadableBit);
-    blk->timestamp = canBlock ? pkt->timestamp : 0;
+    setBlkTimestamp(blk, canBlock ? pkt->timestamp : 0);
     // sanity check for whole-line writes, which should always be
     // marked as writable as part of the fill, and then later marked
     // dirty as part of satisfyRequest
@@ -1719,8 +1737,7 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     && canBlock && (isVictim || !hasVictim)) { //VICTIM CHANGE
         //send wait signal.
         // printf("blocking %ld on cache refill until %ld, currently %ld\n", cpuID, blk->timestamp, loadstorelogentry::committed_timestamp[cpuID]);
-        loadstorelogentry::mainCPUMeta[cpuID].timeout = std::max((loadstorelogentry::mainCPUMeta[cpuID].timeout)>>1,20);
-        //  printf("timeout set to %d",loadstorelogentry::timeout[cpuID]);
+        loadstorelogentry::cptEvictionBlock(cpuID);
         loadstorelogentry::mainCPUMeta[cpuID].should_cache_wait[cpuID] = victim->timestamp;
     }
 
@@ -48,6 +48,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <map>
 #include <string>
 
 #include "base/addr_range.hh"
@@ -1381,6 +1382,15 @@ class BaseCache : public ClockedObject
     bool hasVictim;
        bool canBlock;
     bool useVanillaReplacement;
+
+    /* Number of tag-store blocks carrying each non-zero loadstorelog
+     * timestamp. Kept up to date by setBlkTimestamp so blockedEntries only
+     * has to visit the timestamps of checkpoints that are still uncommitted,
+     * rather than every block in the cache. */
+    std::map<uint64_t, int> blkTimestamps;
+
+    /* Change blk->timestamp, keeping blkTimestamps in sync. */
+    void setBlkTimestamp(CacheBlk *blk, uint64_t timestamp);
 };
 
 /**
@@ -1329,13 +1329,7 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
                         // %ld\n", cpuID, cpuID2, blk->timestamp);
                         loadstorelogentry::mainCPUMeta[cpuID2]
                             .should_cache_wait[cpuID] = blk->timestamp;
-                        loadstorelogentry::mainCPUMeta[cpuID]
-                            .timeout = std::max(
-                            (loadstorelogentry::mainCPUMeta[cpuID].timeout) >>
-                                1,
-                            20);
-                        //   printf("timeout set to
-                        //   %d",loadstorelogentry::timeout[cpuID]);
+                        loadstorelogentry::cptEvictionBlock(cpuID);
                         // check current timestamp and issue early commit if
                         // necessary.
                     } else if (loadstorelogentry::isCheckerCore(cpuID2)) {
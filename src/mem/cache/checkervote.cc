@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/checkervote.hh"
+
+#include <iostream>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+checkervote::checkervote(statistics::Group *parent, unsigned _voters,
+                         int checkers)
+    : statistics::Group(parent, "voting"),
+      voters(_voters),
+      ADD_STAT(disagreements, statistics::units::Count::get(),
+               "Checker runs whose final state differed from the main "
+               "core's"),
+      ADD_STAT(reruns, statistics::units::Count::get(),
+               "Segments re-executed on another checker to vote"),
+      ADD_STAT(heterogeneousReruns, statistics::units::Count::get(),
+               "Of those, re-executions on a CPU model new to the vote"),
+      ADD_STAT(rerunInsts, statistics::units::Count::get(),
+               "Instructions re-executed to vote"),
+      ADD_STAT(mainOutvoted, statistics::units::Count::get(),
+               "Votes the main core lost, so it rolled back"),
+      ADD_STAT(checkersOutvoted, statistics::units::Count::get(),
+               "Checker runs outvoted by the main core and other checkers"),
+      ADD_STAT(rollbacksAvoided, statistics::units::Count::get(),
+               "Segments committed although a checker disagreed"),
+      ADD_STAT(outvotedByChecker, statistics::units::Count::get(),
+               "Times each checker core was found faulty"),
+      ADD_STAT(voteTicks, statistics::units::Tick::get(),
+               "Ticks from the first disagreement to the verdict")
+{
+    fatal_if(!voters, "--checkerVoters must be at least 1\n");
+    outvotedByChecker.init(checkers).flags(statistics::nozero);
+    voteTicks.init(0, 999999, 10000).flags(statistics::pdf |
+                                           statistics::nozero);
+}
+
+checkervote::verdict
+checkervote::cast(segmentvote &v, int checker, bool agrees, Tick now)
+{
+    v.voters.emplace_back(checker, agrees);
+    if (agrees) {
+        v.agree++;
+    } else if (v.disagree++ == 0) {
+        v.since = now;
+    }
+
+    // The main core votes for its own state
+    const unsigned majority = (voters + 1) / 2 + 1;
+    const unsigned left = voters - v.voters.size();
+    verdict r = Pending;
+    if (v.agree + 1 >= majority)
+        r = Commit;
+    else if (v.agree + 1 + left < majority)
+        r = Rollback;
+
+    // Segments every checker agreed on are the common case, and lock free
+    if (!v.disagree)
+        return r;
+    std::lock_guard<std::mutex> guard(lock);
+    if (!agrees)
+        ++disagreements;
+    if (r == Pending)
+        return r;
+    voteTicks.sample(now - v.since);
+    if (r == Rollback) {
+        if (v.voters.size() > 1)
+            ++mainOutvoted;
+        return r;
+    }
+    ++rollbacksAvoided;
+    for (const auto &c : v.voters) {
+        if (c.second)
+            continue;
+        ++checkersOutvoted;
+        ++outvotedByChecker[c.first];
+        std::cout << ">>> Checker " << c.first << " outvoted, "
+                  << v.agree << " of " << v.voters.size()
+                  << " checkers agree with the main core" << std::endl;
+    }
+    return r;
+}
+
+void
+checkervote::reran(uint64_t insts, bool heterogeneous)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    ++reruns;
+    if (heterogeneous)
+        ++heterogeneousReruns;
+    rerunInsts += insts;
+}
+
+}
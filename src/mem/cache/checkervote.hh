@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CHECKERVOTE_HH__
+#define __CHECKERVOTE_HH__
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/* How the checkers that executed a segment voted. It lives in the
+ * segment's CheckerCPUMeta so it follows the segment to the checker that
+ * re-executes it. */
+struct segmentvote
+{
+    // Checker cores that executed the segment, and whether each matched
+    // the main core, in order
+    std::vector<std::pair<int, bool>> voters;
+    unsigned agree = 0;
+    unsigned disagree = 0;
+    // Undecided, waiting for another checker to re-execute it
+    bool rerun = false;
+    // When the first checker disagreed
+    Tick since = 0;
+
+    bool
+    voted(int checker) const
+    {
+        for (const auto &v : voters) {
+            if (v.first == checker)
+                return true;
+        }
+        return false;
+    }
+
+    void
+    reset()
+    {
+        voters.clear();
+        agree = 0;
+        disagree = 0;
+        rerun = false;
+        since = 0;
+    }
+};
+
+/* N-modular checking with --checkerVoters. The main core and up to voters
+ * checkers vote on the final state of a segment, and it commits once a
+ * majority of them agrees with the main core. A segment only goes to
+ * another checker while the vote is undecided, which with two voters (TMR)
+ * is only when the first checker disagrees, so segments that check cleanly
+ * cost nothing extra. When the main core ends up in the minority it rolls
+ * back as before; when a checker does, that checker is reported as faulty
+ * and the rollback is skipped. With one voter every disagreement rolls
+ * back, as without voting. Calls are made under the shard lock of the
+ * segment's main core. */
+class checkervote : public statistics::Group
+{
+  public:
+    enum verdict { Pending, Commit, Rollback };
+
+    checkervote(statistics::Group *parent, unsigned voters, int checkers);
+
+    /* checker finished executing the segment of v */
+    verdict cast(segmentvote &v, int checker, bool agrees, Tick now);
+
+    /* A segment of insts instructions goes to another checker, of a CPU
+     * model none of its earlier voters had if heterogeneous */
+    void reran(uint64_t insts, bool heterogeneous);
+
+    const unsigned voters;
+
+  private:
+    // Main cores on different event queues share the stats
+    std::mutex lock;
+
+    statistics::Scalar disagreements;
+    statistics::Scalar reruns;
+    statistics::Scalar heterogeneousReruns;
+    statistics::Scalar rerunInsts;
+    statistics::Scalar mainOutvoted;
+    statistics::Scalar checkersOutvoted;
+    statistics::Scalar rollbacksAvoided;
+    statistics::Vector outvotedByChecker;
+    statistics::Distribution voteTicks;
+};
+
+}
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/coveragemap.hh"
+
+#include <algorithm>
+
+#include "mem/cache/loadstorelogentry.hh"
+
+namespace gem5
+{
+
+pccoverage::slot &
+pccoverage::lookup(Addr pc, bool &inserted)
+{
+    assert(pc != Empty);
+    if (2 * (used + 1) > slots.size())
+        grow();
+    const size_t mask = slots.size() - 1;
+    size_t i = index(pc);
+    while (slots[i].pc != pc && slots[i].pc != Empty)
+        i = (i + 1) & mask;
+    inserted = slots[i].pc == Empty;
+    if (inserted) {
+        slots[i].pc = pc;
+        used++;
+    }
+    return slots[i];
+}
+
+void
+pccoverage::grow()
+{
+    std::vector<slot> old(2 * slots.size(), slot{Empty, 0, {}});
+    old.swap(slots);
+    const size_t mask = slots.size() - 1;
+    for (const slot &s : old) {
+        if (s.pc == Empty)
+            continue;
+        size_t i = index(s.pc);
+        while (slots[i].pc != Empty)
+            i = (i + 1) & mask;
+        slots[i] = s;
+    }
+}
+
+std::vector<const pccoverage::slot *>
+pccoverage::sorted() const
+{
+    std::vector<const slot *> out;
+    out.reserve(used);
+    for (const slot &s : slots) {
+        if (s.pc != Empty)
+            out.push_back(&s);
+    }
+    std::sort(out.begin(), out.end(),
+              [](const slot *a, const slot *b) { return a->pc < b->pc; });
+    return out;
+}
+
+std::vector<pccoverage::slot *>
+pccoverage::changed()
+{
+    std::vector<slot *> out;
+    for (slot &s : slots) {
+        if (s.pc != Empty && s.counts.changed())
+            out.push_back(&s);
+    }
+    std::sort(out.begin(), out.end(),
+              [](const slot *a, const slot *b) { return a->pc < b->pc; });
+    return out;
+}
+
+uint32_t
+instcoverage::id(const char *mnemonic)
+{
+    auto it = ids.find(mnemonic);
+    if (it == ids.end()) {
+        it = ids.emplace(mnemonic,
+                         loadstorelogentry::internInstName(mnemonic)).first;
+    }
+    return it->second;
+}
+
+coveragecounts &
+instcoverage::lookup(const char *mnemonic, bool &inserted)
+{
+    uint32_t inst = id(mnemonic);
+    if (inst >= counts.size())
+        counts.resize(inst + 1);
+    coveragecounts &c = counts[inst];
+    inserted = c.encountered == 0;
+    return c;
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __COVERAGEMAP_HH__
+#define __COVERAGEMAP_HH__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/* How often a main core committed a PC or static instruction, and how
+ * often it did so while checked */
+struct coveragecounts
+{
+    uint32_t encountered = 0;
+    uint32_t checked = 0;
+    // Counts written out by the last incremental dump
+    uint32_t dumpedEncountered = 0;
+    uint32_t dumpedChecked = 0;
+
+    bool
+    changed() const
+    {
+        return encountered != dumpedEncountered ||
+               checked != dumpedChecked;
+    }
+};
+
+/* The PCs a main core committed. Looked up on every commit, so it is an
+ * open addressing table with linear probing, kept at most half full, rather
+ * than a node based map. A slot reference is valid until the next insert. */
+class pccoverage
+{
+  public:
+    struct slot
+    {
+        Addr pc;
+        // Interned name of the instruction first committed at pc
+        uint32_t instId;
+        coveragecounts counts;
+    };
+
+    pccoverage() : slots(InitialSlots, slot{Empty, 0, {}}) {}
+
+    /* The slot of pc, inserted with instId 0 if new */
+    slot &lookup(Addr pc, bool &inserted);
+
+    size_t size() const { return used; }
+
+    /* Occupied slots in PC order */
+    std::vector<const slot *> sorted() const;
+    std::vector<slot *> changed();
+
+  private:
+    static const size_t InitialSlots = 1024;
+    static const Addr Empty = ~(Addr)0;
+
+    size_t
+    index(Addr pc) const
+    {
+        return ((pc >> 1) * 0x9e3779b97f4a7c15ULL) & (slots.size() - 1);
+    }
+
+    void grow();
+
+    std::vector<slot> slots;
+    size_t used = 0;
+};
+
+/* The static instructions a main core committed, indexed by interned
+ * instruction id. Mnemonic pointers are resolved to ids through a cache of
+ * its own, so the shared intern table is only locked for a mnemonic this
+ * core has not committed before. */
+class instcoverage
+{
+  public:
+    coveragecounts &lookup(const char *mnemonic, bool &inserted);
+
+    /* Interned id of mnemonic, through the core's cache */
+    uint32_t id(const char *mnemonic);
+
+    const std::vector<coveragecounts> &byId() const { return counts; }
+    std::vector<coveragecounts> &byId() { return counts; }
+
+  private:
+    std::unordered_map<const char *, uint32_t> ids;
+    // Ids the core has not committed are left with zero counts
+    std::vector<coveragecounts> counts;
+};
+
+}
+#endif
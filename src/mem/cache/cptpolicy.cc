@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/cptpolicy.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+class aimdpolicy : public cptlengthpolicy
+{
+  public:
+    aimdpolicy(int max_timeout) : cptlengthpolicy(max_timeout) {}
+
+    const char *name() const override { return "aimd"; }
+
+    int
+    onCheckpoint(int timeout, const cptsample &s) override
+    {
+        if (s.lslFull || s.timedOut)
+            return std::min(timeout + 5, maxTimeout);
+        return timeout;
+    }
+
+    int
+    onEvictionBlock(int timeout) override
+    {
+        return std::max(timeout >> 1, minTimeout);
+    }
+};
+
+/* Each instruction in a segment of length L pays for
+ *  - the checkpoint itself, a fixed register copy plus the checker's
+ *    wake up and drain, which is what shows up as lag: (kCptCost + lag) / L
+ *  - eviction blocks, which hold the main core until the blocking segment
+ *    is validated, on average half a segment later: evictRate * L / 2
+ * so the best length is sqrt(2 * (kCptCost + lag) / evictRate), no longer
+ * than the log can hold at the current fill rate. The inputs are averaged
+ * over the last few checkpoints so they follow program phases, and the
+ * timeout only moves half way to the target each time, which is what stops
+ * AIMD's sawtooth on mismatched main/checker pairs.
+ */
+class modelpolicy : public cptlengthpolicy
+{
+  public:
+    modelpolicy(int max_timeout, int lsl_size)
+        : cptlengthpolicy(max_timeout), lslSize(lsl_size)
+    {}
+
+    const char *name() const override { return "model"; }
+
+    int
+    onCheckpoint(int timeout, const cptsample &s) override
+    {
+        uint64_t evicts = evictsThisSegment;
+        evictsThisSegment = 0;
+        if (s.insts == 0)
+            return timeout;
+
+        double rate = (double)evicts / s.insts;
+        double fill = (double)s.entries / s.insts;
+        if (!primed) {
+            evictRate = rate;
+            fillRate = fill;
+            primed = true;
+        } else {
+            evictRate += (rate - evictRate) * kWeight;
+            fillRate += (fill - fillRate) * kWeight;
+        }
+
+        double target = maxTimeout;
+        if (evictRate > 0)
+            target = std::sqrt(2 * (kCptCost + lag) / evictRate);
+        if (fillRate > 0)
+            target = std::min(target, lslSize / fillRate);
+        target = std::clamp(target, (double)minTimeout, (double)maxTimeout);
+
+        int next = timeout + (int)((target - timeout) / 2);
+        return std::clamp(next, minTimeout, maxTimeout);
+    }
+
+    int
+    onEvictionBlock(int timeout) override
+    {
+        // Accounted for at the next checkpoint rather than acted on now
+        evictsThisSegment++;
+        return timeout;
+    }
+
+    void
+    onValidate(uint64_t l) override
+    {
+        lag += ((double)l - lag) * kWeight;
+    }
+
+  private:
+    // Register copy on the main core, in instructions
+    static constexpr double kCptCost = 16;
+    static constexpr double kWeight = 1.0 / 8;
+
+    const int lslSize;
+
+    bool primed = false;
+    uint64_t evictsThisSegment = 0;
+    double evictRate = 0;
+    double fillRate = 0;
+    double lag = 0;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<cptlengthpolicy>
+cptlengthpolicy::create(const std::string &name, int maxTimeout, int lslSize)
+{
+    if (name == "aimd")
+        return std::make_unique<aimdpolicy>(maxTimeout);
+    if (name == "model")
+        return std::make_unique<modelpolicy>(maxTimeout, lslSize);
+    fatal("Unknown checkpoint length policy %s (aimd or model)\n", name);
+}
+
+}
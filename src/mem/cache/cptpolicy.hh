@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPTPOLICY_HH__
+#define __CPTPOLICY_HH__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace gem5
+{
+
+/* What a main core's segment looked like when it took a checkpoint */
+struct cptsample
+{
+    // Instructions committed and loadstorelog entries used in the segment
+    uint64_t insts;
+    uint64_t entries;
+    // Ended because the log filled up or because it reached the timeout
+    bool lslFull;
+    bool timedOut;
+};
+
+/* Decides the checkpoint timeout (in committed instructions) of one main
+ * core when AIMD is on; with --AIMDoff the timeout is fixed at cptTimeout.
+ * Selected with --cptPolicy:
+ *  aimd  - halve on every eviction block, add 5 on every checkpoint that
+ *          ended on the log or the timeout.
+ *  model - estimate the eviction-block rate, log fill rate and checker lag
+ *          of the current phase and pick the length that minimises the
+ *          per-instruction overhead they imply.
+ * Every call is made under the main core's loadstorelog shard lock.
+ */
+class cptlengthpolicy
+{
+  public:
+    virtual ~cptlengthpolicy() = default;
+
+    virtual const char *name() const = 0;
+
+    /* Each returns the new timeout given the current one */
+    virtual int onCheckpoint(int timeout, const cptsample &s) = 0;
+    virtual int onEvictionBlock(int timeout) = 0;
+
+    /* A checker validated a segment, lag instructions of which were still
+     * left to check when the main core published it */
+    virtual void onValidate(uint64_t lag) {}
+
+    static std::unique_ptr<cptlengthpolicy> create(const std::string &name,
+                                                   int maxTimeout,
+                                                   int lslSize);
+
+  protected:
+    cptlengthpolicy(int _maxTimeout) : maxTimeout(_maxTimeout) {}
+
+    // Smallest timeout an eviction block can bring AIMD down to
+    static const int minTimeout = 20;
+
+    const int maxTimeout;
+};
+
+}
+#endif
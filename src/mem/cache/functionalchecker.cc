@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/functionalchecker.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "arch/generic/decoder.hh"
+#include "arch/generic/mmu.hh"
+#include "base/logging.hh"
+#include "cpu/base.hh"
+#include "cpu/error_injection.hh"
+#include "cpu/exec_context.hh"
+#include "cpu/static_inst.hh"
+#include "cpu/thread_context.hh"
+#include "cpu/utils.hh"
+#include "mem/cache/loadstorelogentry.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "mem/translating_port_proxy.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+/* Executes the ops of a functional checker on its thread context. Its
+ * memory accesses are looked up in the loadstorelog, as the cache of a
+ * Minor checker would, and never reach memory. */
+class functionalcontext : public ExecContext
+{
+  public:
+    functionalcontext(BaseCPU *_cpu, ThreadContext *_tc, int _id)
+        : cpu(_cpu), tc(_tc), id(_id)
+    {}
+
+    /* Starts executing op si */
+    void
+    begin(const StaticInstPtr &si)
+    {
+        inst = si;
+        predicate = true;
+        memAccPredicate = true;
+        effAddr = 0;
+        effSize = 0;
+        memData.clear();
+    }
+
+    // An access the loadstorelog did not match, and why
+    bool mismatch = false;
+    std::string mismatchMsg;
+
+    // The op's access as the Minor LSQ records it for --hashed
+    Addr effAddr = 0;
+    unsigned effSize = 0;
+    std::vector<uint8_t> memData;
+
+    Fault
+    readMem(Addr addr, uint8_t *data, unsigned int size,
+            Request::Flags flags,
+            const std::vector<bool> &byte_enable) override
+    {
+        return access(addr, data, size, flags, BaseMMU::Read, nullptr,
+                      nullptr, byte_enable);
+    }
+
+    Fault
+    writeMem(uint8_t *data, unsigned int size, Addr addr,
+             Request::Flags flags, uint64_t *res,
+             const std::vector<bool> &byte_enable) override
+    {
+        std::vector<uint8_t> zeros;
+        if (!data) {
+            assert(flags & Request::STORE_NO_DATA);
+            zeros.assign(size, 0);
+            data = zeros.data();
+        }
+        return access(addr, data, size, flags, BaseMMU::Write, res,
+                      nullptr, byte_enable);
+    }
+
+    Fault
+    amoMem(Addr addr, uint8_t *data, unsigned int size,
+           Request::Flags flags, AtomicOpFunctorPtr amo_op) override
+    {
+        return access(addr, data, size, flags, BaseMMU::Write, nullptr,
+                      std::move(amo_op), std::vector<bool>(size, true));
+    }
+
+    Fault
+    initiateMemMgmtCmd(Request::Flags flags) override
+    {
+        panic("ExecContext::initiateMemMgmtCmd() not implemented "
+              "on functional checkers\n");
+        return NoFault;
+    }
+
+    RegVal
+    getRegOperand(const StaticInst *si, int idx) override
+    {
+        const RegId &reg = si->srcRegIdx(idx);
+        if (reg.is(InvalidRegClass))
+            return 0;
+        return tc->getReg(reg);
+    }
+
+    void
+    getRegOperand(const StaticInst *si, int idx, void *val) override
+    {
+        tc->getReg(si->srcRegIdx(idx), val);
+    }
+
+    void *
+    getWritableRegOperand(const StaticInst *si, int idx) override
+    {
+        return tc->getWritableReg(si->destRegIdx(idx));
+    }
+
+    void
+    setRegOperand(const StaticInst *si, int idx, RegVal val) override
+    {
+        const RegId &reg = si->destRegIdx(idx);
+        if (reg.is(InvalidRegClass))
+            return;
+        tc->setReg(reg, val);
+    }
+
+    void
+    setRegOperand(const StaticInst *si, int idx, const void *val) override
+    {
+        tc->setReg(si->destRegIdx(idx), val);
+    }
+
+    RegVal
+    readMiscRegOperand(const StaticInst *si, int idx) override
+    {
+        const RegId &reg = si->srcRegIdx(idx);
+        assert(reg.is(MiscRegClass));
+        return tc->readMiscReg(reg.index());
+    }
+
+    void
+    setMiscRegOperand(const StaticInst *si, int idx, RegVal val) override
+    {
+        const RegId &reg = si->destRegIdx(idx);
+        assert(reg.is(MiscRegClass));
+        tc->setMiscReg(reg.index(), val);
+    }
+
+    RegVal readMiscReg(int misc_reg) override
+    {
+        return tc->readMiscReg(misc_reg);
+    }
+
+    void
+    setMiscReg(int misc_reg, RegVal val) override
+    {
+        tc->setMiscReg(misc_reg, val);
+    }
+
+    const PCStateBase &pcState() const override { return tc->pcState(); }
+    void pcState(const PCStateBase &val) override { tc->pcState(val); }
+
+    /* As on a Minor checker */
+    unsigned int readStCondFailures() const override { return 0; }
+    void setStCondFailures(unsigned int st_cond_failures) override {}
+
+    ThreadContext *tcBase() const override { return tc; }
+
+    bool readPredicate() const override { return predicate; }
+    void setPredicate(bool val) override { predicate = val; }
+    bool readMemAccPredicate() const override { return memAccPredicate; }
+    void setMemAccPredicate(bool val) override { memAccPredicate = val; }
+
+    uint64_t
+    newHtmTransactionUid() const override
+    {
+        panic("ExecContext::newHtmTransactionUid() not implemented "
+              "on functional checkers\n");
+        return 0;
+    }
+
+    uint64_t
+    getHtmTransactionUid() const override
+    {
+        panic("ExecContext::getHtmTransactionUid() not implemented "
+              "on functional checkers\n");
+        return 0;
+    }
+
+    bool inHtmTransactionalState() const override { return false; }
+
+    uint64_t
+    getHtmTransactionalDepth() const override
+    {
+        panic("ExecContext::getHtmTransactionalDepth() not implemented "
+              "on functional checkers\n");
+        return 0;
+    }
+
+    void
+    demapPage(Addr vaddr, uint64_t asn) override
+    {
+        tc->getMMUPtr()->demapPage(vaddr, asn);
+    }
+
+    void armMonitor(Addr address) override { cpu->armMonitor(0, address); }
+    bool mwait(PacketPtr pkt) override { return cpu->mwait(0, pkt); }
+
+    void
+    mwaitAtomic(ThreadContext *tc) override
+    {
+        cpu->mwaitAtomic(0, tc, tc->getMMUPtr());
+    }
+
+    AddressMonitor *
+    getAddrMonitor() override
+    {
+        return cpu->getCpuAddrMonitor(0);
+    }
+
+  private:
+    /* An access of size at addr, split at cache lines as an
+     * AtomicSimpleCPU would, each part looked up in the loadstorelog under
+     * the op's sequence number */
+    Fault
+    access(Addr addr, uint8_t *data, unsigned size, Request::Flags flags,
+           BaseMMU::Mode mode, uint64_t *res, AtomicOpFunctorPtr amo_op,
+           const std::vector<bool> &byte_enable)
+    {
+        bool is_load = mode == BaseMMU::Read;
+        unsigned line = cpu->cacheLineSize();
+
+        // Hard errors in the address, as the Minor LSQ injects them
+        if (injectFUdestError(id) &&
+            (errorinjection::hardErrStructId % OpClass::Num_OpClass) ==
+                inst->opClass()) {
+            uint64_t stuck = addr;
+            bool injected = stuckAt_addr(stuck, errorinjection::hardErrBit,
+                                         errorinjection::hardErrorStuckAt1);
+            if (!(transferNeedsBurst(stuck, size, line) &&
+                  inst->isAtomic())) {
+                if (injected)
+                    addr = stuck;
+                stuckAt_stats(id, injected);
+            }
+        }
+        panic_if(amo_op && transferNeedsBurst(addr, size, line),
+                 "Do not expect cross-cache-line atomic memory request\n");
+
+        effAddr = addr;
+        effSize = size;
+        if (!is_load) {
+            if (inst->isAtomic() || (flags & Request::STORE_NO_DATA))
+                memData.assign(size, 0);
+            else
+                memData.assign(data, data + size);
+        }
+
+        for (unsigned offset = 0; offset < size;) {
+            Addr frag_addr = addr + offset;
+            unsigned frag_size = std::min<unsigned>(
+                line - addrBlockOffset(frag_addr, line), size - offset);
+            uint8_t *frag_data = data + offset;
+            auto it_start = byte_enable.begin() + offset;
+            auto it_end = it_start + frag_size;
+            offset += frag_size;
+            if (!isAnyActiveElement(it_start, it_end))
+                continue;
+
+            RequestPtr req = std::make_shared<Request>();
+            req->setContext(tc->contextId());
+            req->setVirt(frag_addr, frag_size, flags,
+                         cpu->dataRequestorId(), tc->pcState().instAddr(),
+                         std::move(amo_op));
+            req->setByteEnable(std::vector<bool>(it_start, it_end));
+            req->setLdStLogSeqNum(cpu->getLdstlogSeq());
+
+            Fault fault = tc->getMMUPtr()->translateAtomic(req, tc, mode);
+            if (fault != NoFault)
+                return req->isPrefetch() ? NoFault : fault;
+            if (req->getFlags().isSet(Request::NO_ACCESS))
+                continue;
+
+            // A Minor checker sends every store conditional to its cache
+            if (is_load && req->isLLSC())
+                tc->getIsaPtr()->handleLockedRead(this, req);
+            else if (req->isCondSwap())
+                req->setExtraData(*res);
+
+            Packet pkt(req, is_load ? Packet::makeReadCmd(req) :
+                                      Packet::makeWriteCmd(req));
+            pkt.dataStatic(frag_data);
+            if (req->isLocalAccess()) {
+                req->localAccessor(tc, &pkt);
+            } else if (!lookup(&pkt)) {
+                // The op stops the segment, whatever it reads
+                return NoFault;
+            }
+
+            if (res && req->isSwap())
+                std::memcpy(res, pkt.getConstPtr<uint8_t>(), frag_size);
+            else if (res)
+                *res = req->getExtraData();
+        }
+        return NoFault;
+    }
+
+    /* Whether the loadstorelog matches pkt, filling in the data it reads */
+    bool
+    lookup(PacketPtr pkt)
+    {
+        if (loadstorelogentry::do_read(pkt, tc) &&
+            !pkt->req->isLdStLogAccErr())
+            return true;
+        mismatch = true;
+        mismatchMsg = pkt->req->getLdStLogAccErrMsg();
+        return false;
+    }
+
+    BaseCPU *cpu;
+    ThreadContext *tc;
+    // Index into checkerCPUMeta
+    int id;
+    StaticInstPtr inst;
+    bool predicate = true;
+    bool memAccPredicate = true;
+};
+
+} // anonymous namespace
+
+functionalchecker::functionalchecker(statistics::Group *parent,
+                                     double _ipc, Cycles wakeup,
+                                     int checkers)
+    : statistics::Group(parent, "functionalCheckers"),
+      ipc(_ipc),
+      wakeupCycles(wakeup),
+      runs(checkers),
+      ADD_STAT(segments, statistics::units::Count::get(),
+               "Segments checked without the Minor pipeline"),
+      ADD_STAT(ops, statistics::units::Count::get(),
+               "Ops the functional checkers executed"),
+      ADD_STAT(mismatches, statistics::units::Count::get(),
+               "Segments stopped at an access the loadstorelog did not "
+               "match"),
+      ADD_STAT(chargedCycles, statistics::units::Cycle::get(),
+               "Checker cycles charged from wakeup to the last commit")
+{
+    fatal_if(ipc <= 0, "--functionalCheckerIPC must be positive\n");
+    for (int x = 0; x < checkers; x++) {
+        runs[x].startEvent = std::make_unique<EventFunctionWrapper>(
+            [this, x]() { start(x); }, "functionalCheckerStart");
+        runs[x].doneEvent = std::make_unique<EventFunctionWrapper>(
+            [this, x]() { done(x); }, "functionalCheckerDone");
+    }
+}
+
+void
+functionalchecker::wakeup(BaseCPU *checker)
+{
+    int x = checker->getContext(0)->contextId() - NUMBEROFMAINCORES;
+    loadstorelogentry::ShardGuard guard(loadstorelogentry::shardOfSegment(x));
+    const loadstorelogentry::CheckerCPUMeta &m =
+        loadstorelogentry::checkerCPUMeta[x];
+    checkrun &r = runs.at(x);
+    if (r.busy || !m.activeChecker || !m.expectedFinalContext.set ||
+        m.segment.validating())
+        return;
+    r.busy = true;
+    r.cpu = checker;
+    checker->schedule(*r.startEvent, checker->clockEdge(wakeupCycles));
+}
+
+void
+functionalchecker::start(int x)
+{
+    checkrun &r = runs[x];
+    BaseCPU *cpu = r.cpu;
+    {
+        loadstorelogentry::ShardGuard guard(
+            loadstorelogentry::shardOfSegment(x));
+        loadstorelogentry::CheckerCPUMeta &m =
+            loadstorelogentry::checkerCPUMeta[x];
+        // The whole segment is fetched as it starts
+        if (m.checkerStartFetchTick == 0) {
+            assert(m.checkerStartWakeupTick > 0);
+            m.checkerStartFetchTick = curTick();
+            loadstorelogentry::cptCheckerStartToFetchDelayTicks +=
+                m.checkerStartFetchTick - m.checkerStartWakeupTick;
+        }
+        execute(x, r);
+        // No more entries are coming for a finished segment
+        cpu->sleepGuardOn = false;
+    }
+    if (r.ops)
+        loadstorelogentry::recStartCommitStats(cpu);
+
+    Cycles busy(std::max<uint64_t>(1, std::ceil(r.ops / ipc)));
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ++segments;
+        ops += r.ops;
+        if (r.mismatch)
+            ++mismatches;
+        chargedCycles += wakeupCycles + busy;
+    }
+    cpu->schedule(*r.doneEvent, cpu->clockEdge(busy));
+}
+
+void
+functionalchecker::done(int x)
+{
+    checkrun &r = runs[x];
+    r.busy = false;
+    if (r.mismatch) {
+        loadstorelogentry::not_found_sleep(x);
+        return;
+    }
+    {
+        loadstorelogentry::ShardGuard guard(
+            loadstorelogentry::shardOfSegment(x));
+        loadstorelogentry::CheckerCPUMeta &m =
+            loadstorelogentry::checkerCPUMeta[x];
+        if (loadstorelogentry::useHash) {
+            loadstorelogentry l;
+            m.calcCheckedHash(l);
+        }
+        m.segment.beginValidate();
+        assert(m.checkerLastCommitTick == 0);
+        assert(m.checkerStartCommitTick > 0);
+        m.checkerLastCommitTick = curTick();
+        loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks +=
+            m.checkerLastCommitTick - m.checkerStartCommitTick;
+    }
+    // Compares the final state and drains the idle pipeline, which
+    // retires the segment
+    loadstorelogentry::checkerCheckIfShouldSleep(r.cpu);
+}
+
+void
+functionalchecker::execute(int x, checkrun &r)
+{
+    BaseCPU *cpu = r.cpu;
+    ThreadContext *tc = cpu->getContext(0);
+    loadstorelogentry::CheckerCPUMeta &m =
+        loadstorelogentry::checkerCPUMeta[x];
+    InstDecoder *decoder = tc->getDecoderPtr();
+    TranslatingPortProxy fetch(tc, Request::INST_FETCH);
+    functionalcontext xc(cpu, tc, x);
+    std::unique_ptr<PCStateBase> pc(tc->pcState().clone());
+    StaticInstPtr macro;
+
+    r.ops = 0;
+    r.mismatch = false;
+    decoder->reset();
+    while (true) {
+#ifdef TCSTATE_ERRORRATE
+        if (!m.hasSyscall)
+            compromise_thread_context_state(x, 2);
+#endif
+        set(pc, tc->pcState());
+        StaticInstPtr inst;
+        if (isRomMicroPC(pc->microPC())) {
+            inst = decoder->fetchRomMicroop(pc->microPC(), macro);
+        } else if (macro) {
+            inst = macro->fetchMicroop(pc->microPC());
+        } else {
+            StaticInstPtr decoded;
+            for (Addr offset = 0; !decoded;
+                 offset += decoder->moreBytesSize()) {
+                Addr fetch_pc = (pc->instAddr() & decoder->pcMask()) + offset;
+                if (!fetch.tryReadBlob(fetch_pc, decoder->moreBytesPtr(),
+                                       decoder->moreBytesSize()))
+                    break;
+                decoder->moreBytes(*pc, fetch_pc);
+                decoded = decoder->decode(*pc);
+            }
+            if (!decoded) {
+                // Where a Minor checker would take a fetch fault
+                std::cout << "Functional checker " << x
+                          << " cannot fetch at " << std::hex
+                          << pc->instAddr() << std::dec << std::endl;
+                r.mismatch = true;
+                return;
+            }
+            tc->pcState(*pc);
+            if (decoded->isMacroop()) {
+                macro = decoded;
+                inst = macro->fetchMicroop(pc->microPC());
+            } else {
+                inst = decoded;
+            }
+        }
+        // What Minor decode marks for the loadstorelog sequence number
+        StaticInstPtr parent = macro ? macro : inst;
+        bool last_op = !inst->isMicroop() || inst->isLastMicroop();
+
+        xc.begin(inst);
+#ifdef OPCLASS_ERRORRATE
+        regSafe before_instr;
+        if (!inst->isMemRef())
+            save_modified_regs(inst, tc, &before_instr);
+#endif
+        bool fu_error = !inst->isMemRef() && injectFUdestError(x) &&
+            (errorinjection::hardErrStructId % OpClass::Num_OpClass) ==
+                inst->opClass() &&
+            inst->numDestRegs() > 0;
+        regSafe before_fu;
+        if (fu_error)
+            save_modified_regs(inst, tc, &before_fu);
+        Fault fault = inst->execute(&xc, nullptr);
+        if (fu_error)
+            stuckAt_instruction_result(x, inst, tc, &before_fu,
+                                       errorinjection::hardErrBit,
+                                       errorinjection::hardErrorStuckAt1);
+        if (xc.mismatch) {
+            std::cout << xc.mismatchMsg;
+            r.mismatch = true;
+            return;
+        }
+
+        // Counted and hashed as Minor Execute commits them
+        if (inst->getName() != "isb")
+            cpu->committedInstrs++;
+        r.ops = cpu->committedInstrs;
+        if (inst->isMemRef())
+            parent->setHasMemRef();
+        if (loadstorelogentry::useHash && inst->isMemRef()) {
+            loadstorelogentry l(
+                inst->isLoad(), inst->isStoreConditional(), xc.effAddr,
+                xc.memData.empty() ? nullptr : xc.memData.data(),
+                xc.effSize, 0, curTick(), pc->instAddr(),
+                loadstorelogentry::internInstName(inst->getMnemonic()), 0,
+                pc->microPC(), cpu->getLdstlogSeq(), &m.checkedOverflow);
+            m.calcCheckedHash(l);
+        }
+        bool end = (cpu->committedInstrs >= m.committedInstructions ||
+                    m.interrupted) && last_op;
+
+#ifdef OPCLASS_ERRORRATE
+        if (!inst->isMemRef() && !m.hasSyscall)
+            compromise_instruction_result(x, inst, tc, &before_instr);
+#endif
+
+        if (fault != NoFault) {
+            macro = nullptr;
+            fault->invoke(tc, inst);
+            decoder->reset();
+        } else {
+            if (inst->isLastMicroop())
+                macro = nullptr;
+            inst->advancePC(tc);
+        }
+        if ((last_op || fault != NoFault) && parent->hasMemRef())
+            cpu->incrementLdstlogSeq();
+        if (end)
+            return;
+    }
+}
+
+}
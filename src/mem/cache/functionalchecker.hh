@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __FUNCTIONALCHECKER_HH__
+#define __FUNCTIONALCHECKER_HH__
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+class BaseCPU;
+
+/* Checkers with --functionalCheckers. A Minor checker told to wake up
+ * leaves its pipeline drained and instead executes its segment one op at a
+ * time, as an AtomicSimpleCPU would, against the loadstorelog, once the main
+ * core has finished the segment. The checker is charged wakeup cycles
+ * before its first commit, then one cycle per ipc ops until its last, after
+ * which the segment is compared and voted on as if the pipeline had
+ * committed it. Only the outcome of checking is kept, so this is for
+ * coverage and error detection studies; take ipc and wakeup from the
+ * functionalCheckerIPC line of the delays.txt of a run of the same workload
+ * with timing checkers. */
+class functionalchecker : public statistics::Group
+{
+  public:
+    functionalchecker(statistics::Group *parent, double ipc, Cycles wakeup,
+                      int checkers);
+
+    /* Wake the checker, which only starts on a segment the main core has
+     * finished; it is woken again when it does */
+    void wakeup(BaseCPU *checker);
+
+    const double ipc;
+    const Cycles wakeupCycles;
+
+  private:
+    /* Segment being checked by one checker */
+    struct checkrun
+    {
+        BaseCPU *cpu = nullptr;
+        bool busy = false;
+        // Ops the checker executed, and whether it stopped at an access
+        // the loadstorelog did not match
+        uint64_t ops = 0;
+        bool mismatch = false;
+        std::unique_ptr<EventFunctionWrapper> startEvent;
+        std::unique_ptr<EventFunctionWrapper> doneEvent;
+    };
+
+    /* First commit of checker x, wakeupCycles after it woke */
+    void start(int x);
+    /* Last commit of checker x */
+    void done(int x);
+    /* Executes the segment of checker x up to its last op, or to the first
+     * op the loadstorelog disagrees with */
+    void execute(int x, checkrun &r);
+
+    std::vector<checkrun> runs;
+
+    // Main cores on different event queues share the stats
+    std::mutex lock;
+
+    statistics::Scalar segments;
+    statistics::Scalar ops;
+    statistics::Scalar mismatches;
+    statistics::Scalar chargedCycles;
+};
+
+}
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LOADSTORELOGDATA_HH__
+#define __LOADSTORELOGDATA_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/* Data bytes kept inside a loadstorelog entry. Covers every scalar and NEON
+ * access as well as a whole cache line for dc zva; only merged micro-ops and
+ * wide vector stores spill over into the segment's overflow slab. */
+#define LSL_INLINE_DATA 64
+
+/* Size of one chunk of the overflow slab */
+#define LSL_SLAB_CHUNK 4096
+
+namespace gem5
+{
+
+/* Bump allocator backing the data of a loadstorelog segment that does not fit
+ * inline. Chunks are kept across segments, so once warmed up a segment never
+ * goes to the heap again; reset() simply rewinds the cursor when the segment
+ * is handed to a new checkpoint. Chunks never move, so pointers into the slab
+ * stay valid when the owning segment is swapped with another one.
+ */
+class lslslab
+{
+    std::vector<std::unique_ptr<uint8_t[]>> chunks;
+    std::vector<size_t> chunkSizes;
+    size_t chunk = 0;
+    size_t cursor = 0;
+
+  public:
+    uint8_t *
+    alloc(size_t size)
+    {
+        while (chunk < chunks.size() && cursor + size > chunkSizes[chunk]) {
+            chunk++;
+            cursor = 0;
+        }
+        if (chunk == chunks.size()) {
+            size_t chunkSize = std::max<size_t>(LSL_SLAB_CHUNK, size);
+            chunks.emplace_back(new uint8_t[chunkSize]);
+            chunkSizes.push_back(chunkSize);
+            cursor = 0;
+        }
+        uint8_t *ptr = chunks[chunk].get() + cursor;
+        cursor += size;
+        return ptr;
+    }
+
+    void reset() { chunk = 0; cursor = 0; }
+};
+
+/* Trivially copyable byte buffer holding the data or old data of a
+ * loadstorelog entry. Data lives inline unless it is larger than
+ * LSL_INLINE_DATA, in which case ext points into a lslslab.
+ */
+struct lsldata
+{
+    uint8_t *ext;
+    uint32_t len;
+    uint8_t inl[LSL_INLINE_DATA];
+
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    uint8_t *data() { return ext ? ext : inl; }
+    const uint8_t *data() const { return ext ? ext : inl; }
+    uint8_t &operator[](size_t i) { return data()[i]; }
+    const uint8_t &operator[](size_t i) const { return data()[i]; }
+
+    void clear() { ext = nullptr; len = 0; }
+
+    void
+    assign(const uint8_t *src, size_t size, lslslab *slab)
+    {
+        if (size <= LSL_INLINE_DATA) {
+            ext = nullptr;
+        } else {
+            assert(slab);
+            ext = slab->alloc(size);
+        }
+        if (size)
+            std::memcpy(data(), src, size);
+        len = size;
+    }
+
+    void
+    append(const uint8_t *src, size_t size, lslslab *slab)
+    {
+        if (!ext && len + size <= LSL_INLINE_DATA) {
+            std::memcpy(inl + len, src, size);
+        } else {
+            // Relocate to a contiguous region large enough for both parts,
+            // the previous copy is reclaimed when the slab is reset
+            assert(slab);
+            uint8_t *dst = slab->alloc(len + size);
+            std::memcpy(dst, data(), len);
+            std::memcpy(dst + len, src, size);
+            ext = dst;
+        }
+        len += size;
+    }
+};
+
+}
+#endif
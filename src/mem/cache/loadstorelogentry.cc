@@ -4,9 +4,12 @@
 
 #include "mem/cache/loadstorelogentry.hh"
 
+#include "base/intmath.hh"
 #include "base/output.hh"
+#include "cpu/dirty_regs.hh"
 #include "cpu/error_injection.hh"
 #include "cpu/o3/cpu.hh"
+#include "mem/cache/compressors/base.hh"
 #include "cpu/minor/cpu.hh"
 #include "debug/LoadStoreLogChecker.hh"
 #include "debug/LoadStoreLogDebugFlag.hh"
@@ -22,9 +25,10 @@
 
 namespace gem5 {
 
-void loadstorelogentry::initCacheSets(int sets) {
+void loadstorelogentry::initCacheSets(int sets, int cpuID, BaseCache *l1) {
 std::cout << "Number of cache sets: " << sets << "\n";
-   blocked_lines.resize(sets+1);
+   blockedLinesTracked = true;
+   blockingL1s[cpuID] = l1;
    actualstoresize=3;
    
 }
@@ -34,10 +38,32 @@ int loadstorelogentry::actualstoresize = 2;
 int loadstorelogentry::actualnumberofcheckercores = 0;
 bool loadstorelogentry::timeoutAIMD = true;
 int loadstorelogentry::cptTimeout = 5000;
+std::string loadstorelogentry::cptPolicyName = "aimd";
+std::vector<std::unique_ptr<cptlengthpolicy>> loadstorelogentry::cptPolicies;
 int loadstorelogentry::lslSize = 4096;
 bool loadstorelogentry::minorCommitBypass = false;
 bool loadstorelogentry::useHash = false;
+std::unique_ptr<segmentdigest> loadstorelogentry::digestEngine;
+std::atomic<uint64_t> loadstorelogentry::hashBlocksTotal(0);
+std::atomic<uint64_t> loadstorelogentry::hashExposedCycles(0);
+std::vector<std::unique_ptr<segmentring>> loadstorelogentry::segmentRings;
+std::unique_ptr<lsltransport> loadstorelogentry::transport;
+std::unique_ptr<lslcompressor> loadstorelogentry::compressor;
+std::unique_ptr<lslstreambuffer> loadstorelogentry::streamUnit;
+std::unique_ptr<samplepolicy> loadstorelogentry::sampler;
+std::unique_ptr<checkervote> loadstorelogentry::voting;
+std::unique_ptr<functionalchecker> loadstorelogentry::functional;
+std::unique_ptr<stealpolicy> loadstorelogentry::stealPool;
+std::vector<int> loadstorelogentry::checkerOwner;
+std::vector<std::vector<int>> loadstorelogentry::ownedCheckers;
+uint32_t loadstorelogentry::dcZvaInstId = 0;
+std::unordered_map<const char *, uint32_t> loadstorelogentry::instIdsByMnemonic;
+std::unordered_map<std::string, uint32_t> loadstorelogentry::instIdsByName;
+// Id 0 is the blank name of invalid entries
+std::vector<std::string> loadstorelogentry::instNames {""};
 int loadstorelogentry::num_checkSlot_per_checker = 1;
+std::vector<std::unique_ptr<std::recursive_mutex>> loadstorelogentry::shardLocks;
+std::recursive_mutex loadstorelogentry::globalLock;
 
 void loadstorelogentry::initCoreCount(int mains, int checkers, int extra_slot_per_checker, bool hashed, std::vector<double> errRates) {
 
@@ -54,19 +80,30 @@ void loadstorelogentry::initCoreCount(int mains, int checkers, int extra_slot_pe
    
    allCPUMeta.resize(mains+mains*checkers,AllCPUMeta());
    mainCPUMeta.resize(mains,MainCPUMeta());
-   checkerCPUMeta.resize(num_checkSlot_per_checker*mains*checkers,CheckerCPUMeta());
+   checkerCPUMeta.resize(num_checkSlot_per_checker*mains*checkers);
    last_macro_addrs.resize(checkerCPUMeta.size(),0);
-   mainStaticInstsChecked.resize(mains,
-                                 std::map<std::string, std::array<int, 2>>());
-   mainPCsChecked.resize(mains,
-                         std::map<uint64_t, std::array<int, 2>>());
+   mainStaticInstsChecked.resize(mains);
+   mainPCsChecked.resize(mains);
 
    assert(checkerCPUMeta.size() ==
           num_checkSlot_per_checker*NUMBEROFMAINCORES * NUMBEROFCHECKERCORESPERCORE);
+
+   shardLocks.clear();
+   for (int x = 0; x < mains; x++)
+      shardLocks.emplace_back(new std::recursive_mutex());
+
+   // Every checker starts out with its home main core
+   checkerOwner.resize(mains*checkers);
+   ownedCheckers.assign(mains, std::vector<int>());
+   for (int x = 0; x < mains*checkers; x++) {
+      checkerOwner[x] = x / checkers;
+      ownedCheckers[x / checkers].push_back(x);
+   }
    
-   errordetection::voltage_reset.resize(mains,false);
 
+   cptPolicies.clear();
    for(int x=0; x<mains; x++) {
+      cptPolicies.push_back(cptlengthpolicy::create(cptPolicyName, TIMEOUT, logsize));
       mainCPUMeta[x].current_segment_to_fill = x*checkers;
       mainCPUMeta[x].lastChecker = x*checkers;
       mainCPUMeta[x].should_cache_wait.resize(mains, 0);
@@ -78,26 +115,92 @@ void loadstorelogentry::initCoreCount(int mains, int checkers, int extra_slot_pe
    errorinjection::unchangedInjectedError.resize(mains*checkers, false);
    errorinjection::setErrRates(errRates);
   
-   for(int z=0; z<num_checkSlot_per_checker*mains*checkers;z++) {
-     checkerCPUMeta[z].entries.resize(logsize,loadstorelogentry());
-   }
+   sizeSegments();
+
+   dcZvaInstId = internInstName(std::string("dc zva"));
+}
+
+uint32_t
+loadstorelogentry::internInstName(const std::string &name)
+{
+    GlobalGuard guard;
+    auto it = instIdsByName.find(name);
+    if (it != instIdsByName.end())
+        return it->second;
+    uint32_t id = instNames.size();
+    instNames.push_back(name);
+    instIdsByName.emplace(name, id);
+    return id;
+}
+
+uint32_t
+loadstorelogentry::internInstName(const char *mnemonic)
+{
+    GlobalGuard guard;
+    auto it = instIdsByMnemonic.find(mnemonic);
+    if (it != instIdsByMnemonic.end())
+        return it->second;
+    uint32_t id = internInstName(std::string(mnemonic));
+    instIdsByMnemonic.emplace(mnemonic, id);
+    return id;
+}
+
+loadstorelogentry&
+loadstorelogentry::nextEntry(int cpuID)
+{
+    assert(cpuID < mainCPUMeta.size());
+    CheckerCPUMeta &segment =
+        checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill];
+    assert(mainCPUMeta[cpuID].current_entry < segment.entries.size());
+    return segment.entries[mainCPUMeta[cpuID].current_entry];
+}
+
+lslslab*
+loadstorelogentry::nextSlab(int cpuID)
+{
+    assert(cpuID < mainCPUMeta.size());
+    return &checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].overflow;
 }
 
 void 
-loadstorelogentry::initTimeout(bool AIMDoff, int in_cptTimeout, int in_lslSize) 
+loadstorelogentry::initTimeout(bool AIMDoff, int in_cptTimeout, int in_lslSize,
+                               const std::string &in_cptPolicy)
 {
     timeoutAIMD = !AIMDoff;
     cptTimeout = in_cptTimeout;
     lslSize = in_lslSize;
-    std::cout << "AIMD " << AIMD << ", TIMEOUT " << TIMEOUT << ", logsize " << logsize << std::endl;
-    aimdHistoentries.resize(NUMBEROFAIMDHISTOENTRIES+64,0);
-    cptLengthHistoentries.resize(NUMBEROFAIMDHISTOENTRIES+64,0);
-    lengthToFirstLSLHistoentries.resize(NUMBEROFAIMDHISTOENTRIES+64,0);
-    lengthFromLastLSLHistoentries.resize(NUMBEROFAIMDHISTOENTRIES+64,0);
-    histoEntries.resize(NUMBEROFHISTOENTRIES+64,histoEntry());
-    cptLenHistoEntries.resize(NUMBEROFHISTOENTRIES+64,histoEntry());
-    checkerCptLenHistoEntries.resize(NUMBEROFHISTOENTRIES+64,histoEntry());
-    cptFirstFetchToCommitDelayHistoEntries.resize(NUMBEROFHISTOENTRIES+64,histoEntry());
+    cptPolicyName = in_cptPolicy;
+    std::cout << "AIMD " << AIMD << ", TIMEOUT " << TIMEOUT << ", logsize " << logsize << ", cptPolicy " << cptPolicyName << std::endl;
+}
+
+void
+loadstorelogentry::retune(int in_cptTimeout, int in_lslSize)
+{
+    // Only valid before the first segment is filled, i.e. straight after a
+    // restore, so there is no log content or policy state worth keeping
+    for (auto &m : mainCPUMeta)
+        panic_if(m.current_entry != 0,
+                 "loadstorelog retuned with a segment in flight\n");
+    cptTimeout = in_cptTimeout;
+    lslSize = in_lslSize;
+    cptPolicies.clear();
+    for (auto &m : mainCPUMeta) {
+        m.timeout = TIMEOUT;
+        cptPolicies.push_back(
+            cptlengthpolicy::create(cptPolicyName, TIMEOUT, logsize));
+    }
+    sizeSegments();
+    std::cout << "Retuned TIMEOUT " << TIMEOUT << ", logsize " << logsize
+              << std::endl;
+}
+
+void
+loadstorelogentry::sizeSegments()
+{
+    for (auto &c : checkerCPUMeta) {
+        c.entries.resize(logentries, loadstorelogentry());
+        c.undo.reserve(logentries);
+    }
 }
 
 void
@@ -107,6 +210,223 @@ loadstorelogentry::initMinorCommitBypass(bool in_minorCommitBypass)
     std::cout << "minorCommitBypass " << minorCommitBypass << std::endl;
 }
 
+void
+loadstorelogentry::initHashEngine(const std::string &engine, int latency)
+{
+    digestEngine = segmentdigest::create(engine, latency);
+    std::cout << "hashEngine " << digestEngine->name() << ", hashLatency "
+              << digestEngine->cyclesPerBlock() << std::endl;
+}
+
+void
+loadstorelogentry::initCheckerPool(const std::string &pool,
+                                   const std::string &policy)
+{
+    if (pool == "static") {
+        stealPool.reset();
+    } else if (pool == "shared") {
+        stealPool = stealpolicy::create(policy);
+    } else {
+        fatal("Unknown checker pool %s (static or shared)\n", pool);
+    }
+    std::cout << "checkerPool " << pool;
+    if (stealPool)
+        std::cout << ", stealPolicy " << stealPool->name();
+    std::cout << std::endl;
+}
+
+void
+loadstorelogentry::initSegmentRings(statistics::Group *parent)
+{
+    // Must follow initCoreCount, checkerCPUMeta is not resized afterwards
+    segmentRings.clear();
+    int capacity = stealPool ? checkerCPUMeta.size() :
+        num_checkSlot_per_checker * NUMBEROFCHECKERCORESPERCORE;
+    for (int m = 0; m < NUMBEROFMAINCORES; m++) {
+        std::vector<segmentslot *> slots;
+        for (int slot = 0; slot < num_checkSlot_per_checker; slot++) {
+            for (int x : ownedCheckers.at(m)) {
+                x += slot * NUMBEROFMAINCORES * NUMBEROFCHECKERCORESPERCORE;
+                slots.push_back(&checkerCPUMeta.at(x).segment);
+            }
+        }
+        segmentRings.emplace_back(new segmentring(parent, m, slots, capacity));
+    }
+}
+
+void
+loadstorelogentry::initTransport(statistics::Group *parent,
+                                 const std::string &topology,
+                                 const lsltransport::config &cfg)
+{
+    transport = lsltransport::create(parent, topology, NUMBEROFMAINCORES,
+                                     NUMBEROFCHECKERCORESPERCORE, cfg);
+    std::cout << "lslNoC " << (transport ? transport->name() : "ideal")
+              << std::endl;
+}
+
+void
+loadstorelogentry::initCompressor(statistics::Group *parent,
+                                  compression::Base *dataCompressor,
+                                  unsigned blkSize)
+{
+    if (dataCompressor) {
+        compressor = std::make_unique<lslcompressor>(parent, dataCompressor,
+            NUMBEROFMAINCORES, blkSize);
+    } else {
+        compressor.reset();
+    }
+    sizeSegments();
+    std::cout << "lslCompressor " << (dataCompressor ? dataCompressor->name()
+                                                     : "none")
+              << std::endl;
+}
+
+void
+loadstorelogentry::initStreamBuffer(statistics::Group *parent,
+                                    unsigned depth, Cycles latency)
+{
+    if (depth) {
+        streamUnit = std::make_unique<lslstreambuffer>(parent, depth,
+                                                       latency);
+        std::cout << "lslStream depth " << depth << " latency "
+                  << latency << std::endl;
+    } else {
+        streamUnit.reset();
+        std::cout << "lslStream none" << std::endl;
+    }
+}
+
+void
+loadstorelogentry::initSampler(statistics::Group *parent,
+                               const std::string &policy,
+                               const samplepolicy::config &cfg)
+{
+    // Only sampled main cores consult it, see o3::CPU::shouldStartSample
+    sampler = cfg.interval ? samplepolicy::create(parent, policy,
+                                                  NUMBEROFMAINCORES, cfg)
+                           : nullptr;
+    std::cout << "samplePolicy " << (sampler ? sampler->name() : "periodic")
+              << std::endl;
+}
+
+void
+loadstorelogentry::initVoting(statistics::Group *parent, unsigned voters)
+{
+    // A disagreeing segment needs another checker of the same main core
+    fatal_if(voters > 1 && NUMBEROFCHECKERCORESPERCORE < 2 && !stealPool,
+             "--checkerVoters %d needs at least two checkers per main core "
+             "or --checkerPool=shared\n", voters);
+    voting = voters > 1 ? std::make_unique<checkervote>(parent, voters,
+        NUMBEROFMAINCORES * NUMBEROFCHECKERCORESPERCORE) : nullptr;
+    std::cout << "checkerVoters " << std::max(voters, 1u) << std::endl;
+}
+
+void
+loadstorelogentry::initFunctionalCheckers(statistics::Group *parent,
+                                          bool enable, double ipc,
+                                          Cycles wakeup)
+{
+    functional = enable ? std::make_unique<functionalchecker>(parent, ipc,
+        wakeup, NUMBEROFMAINCORES * NUMBEROFCHECKERCORESPERCORE) : nullptr;
+    std::cout << "functionalCheckers " << enable;
+    if (enable)
+        std::cout << " ipc " << ipc << " wakeup " << wakeup;
+    std::cout << std::endl;
+}
+
+void
+loadstorelogentry::checkFunctionalChecker(BaseCPU *cpu)
+{
+    fatal_if(functional && !dynamic_cast<MinorCPU *>(cpu),
+             "--functionalCheckers needs MinorCPU checkers, but %s is not "
+             "one (see --num-cpu1-checkers)\n", cpu->name());
+}
+
+uint64_t
+loadstorelogentry::deliveredCommitBound(int checker)
+{
+    ShardGuard guard(shardOfSegment(checker));
+    return transport->delivered(checkerCPUMeta[checker].noc, curTick());
+}
+
+int
+loadstorelogentry::shardOfCPU(int cpuID)
+{
+    return cpuID < NUMBEROFMAINCORES ? cpuID : getMainID(cpuID);
+}
+
+int
+loadstorelogentry::shardOfSegment(int segment)
+{
+    return checkerOwner.at(
+        segment % (NUMBEROFMAINCORES * NUMBEROFCHECKERCORESPERCORE));
+}
+
+void
+loadstorelogentry::handoff(int cpuID, std::function<void()> fn, Tick when)
+{
+    if (!inParallelMode && when <= curTick()) {
+        fn();
+        return;
+    }
+    int shard = shardOfCPU(cpuID);
+    EventQueue *eq = allCPUMeta[cpuID].baseCPU->eventQueue();
+    auto event = new EventFunctionWrapper([shard, fn]() {
+            ShardGuard guard(shard);
+            fn();
+        }, "loadstorelogentry.handoff", true);
+    if (eq == curEventQueue()) {
+        // Same host thread, run once the current event released its locks
+        eq->schedule(event, std::max(when, curTick()));
+    } else {
+        // Cross-queue events have to be at least one quantum in the future
+        eq->schedule(event, std::max(when, curTick() + simQuantum), true);
+    }
+}
+
+void
+loadstorelogentry::forceCheckerRetry(int checkerCPUID)
+{
+    auto O3DcachePort = dynamic_cast<o3::LSQ::DcachePort *>(
+        &(allCPUMeta[checkerCPUID].baseCPU->getDataPort()));
+    auto MinorDcachePort = dynamic_cast<MinorCPU::MinorCPUPort *>(
+        &(allCPUMeta[checkerCPUID].baseCPU->getDataPort()));
+    if (O3DcachePort) {
+        O3DcachePort->forceRetry();
+    } else if (MinorDcachePort) {
+        MinorDcachePort->forceRetry();
+    }
+    assert(O3DcachePort || MinorDcachePort);
+}
+
+void
+loadstorelogentry::streamWakeup(int x, Tick when)
+{
+    lslstreamwindow &w = checkerCPUMeta[x].stream;
+    if (when >= w.wakeAt)
+        return;
+    w.wakeAt = when;
+    int checkerCPUID = x + NUMBEROFMAINCORES;
+    handoff(checkerCPUID, [x, checkerCPUID]() {
+        lslstreamwindow &w = checkerCPUMeta[x].stream;
+        if (w.wakeAt > curTick())
+            return; // An earlier wakeup already ran
+        w.wakeAt = MaxTick;
+        BaseCPU *checker = allCPUMeta[checkerCPUID].baseCPU;
+        if (checkerCPUMeta[x].copyingRegister)
+            return;
+        if (checker->sleepGuardOn) {
+            checker->sleepGuardOn = false;
+            DPRINTF(LoadStoreLogSleepGuard,
+                    "streamWakeup sleepGuardOn unset for CPU %d\n",
+                    checkerCPUID);
+        }
+        checker->wakeup(0);
+        forceCheckerRetry(checkerCPUID);
+    }, when);
+}
+
 bool
 loadstorelogentry::isMainCore(int cpuID)
 {
@@ -122,135 +442,233 @@ loadstorelogentry::isCheckerCore(int cpuID)
 }
 
 bool
-loadstorelogentry::checkedMainStaticInst(
-    std::map<std::string, std::array<int, 2>>::iterator it)
+loadstorelogentry::checkedMainStaticInst(coveragecounts *c)
 {
-    bool newCheck = false;
-    newCheck = (it->second[1] == 0);
-    it->second[1]++;
-    return newCheck;
+    return c->checked++ == 0;
 }
-std::pair<std::map<std::string, std::array<int, 2>>::iterator, bool>
-loadstorelogentry::addMainStaticInst(int cpuID, std::string instName)
+std::pair<coveragecounts *, bool>
+loadstorelogentry::addMainStaticInst(int cpuID, const char *mnemonic)
 {
-    auto result = mainStaticInstsChecked[cpuID].insert(
-        std::make_pair(instName, std::array<int, 2>({0, 0})));
-    result.first->second[0]++;
-    return result;
+    bool inserted;
+    coveragecounts &c =
+        mainStaticInstsChecked[cpuID].lookup(mnemonic, inserted);
+    c.encountered++;
+    return {&c, inserted};
 }
 int
 loadstorelogentry::getNumCheckedStaticInsts(int cpuID)
 {
-    return std::count_if(mainStaticInstsChecked[cpuID].begin(),
-                         mainStaticInstsChecked[cpuID].end(),
-                         [](auto x) { return x.second[1] > 0; });
+    const auto &counts = mainStaticInstsChecked[cpuID].byId();
+    return std::count_if(counts.begin(), counts.end(),
+                         [](const coveragecounts &c) { return c.checked > 0; });
+}
+int
+loadstorelogentry::getNumStaticInsts(int cpuID)
+{
+    const auto &counts = mainStaticInstsChecked[cpuID].byId();
+    return std::count_if(counts.begin(), counts.end(),
+                         [](const coveragecounts &c) {
+                             return c.encountered > 0;
+                         });
 }
 std::string
 loadstorelogentry::printStaticInsts(int cpuID)
 {
+    const auto &counts = mainStaticInstsChecked[cpuID].byId();
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0; id < counts.size(); id++) {
+        if (counts[id].encountered)
+            ids.push_back(id);
+    }
+    // By name, as they used to be listed
+    std::sort(ids.begin(), ids.end(), [](uint32_t a, uint32_t b) {
+        return instName(a) < instName(b);
+    });
     std::stringstream ss;
     ss << "static inst,# encountered,# checked" << std::endl;
-    for (auto it : mainStaticInstsChecked[cpuID]) {
-     ss << it.first << "," << it.second[0] << "," << it.second[1] << std::endl;
+    for (uint32_t id : ids) {
+     ss << instName(id) << "," << counts[id].encountered << "," << counts[id].checked << std::endl;
     }
     return ss.str();
 }
 
 bool
-loadstorelogentry::checkedMainPC(
-    std::map<uint64_t, std::array<int, 2>>::iterator it)
+loadstorelogentry::checkedMainPC(coveragecounts *c)
 {
-    bool newCheck = false;
-    newCheck = (it->second[1] == 0);
-    it->second[1]++;
-    return newCheck;
+    return c->checked++ == 0;
 }
-std::pair<std::map<uint64_t, std::array<int, 2>>::iterator, bool>
-loadstorelogentry::addMainPC(int cpuID, uint64_t pc, std::string instName)
+std::pair<coveragecounts *, bool>
+loadstorelogentry::addMainPC(int cpuID, uint64_t pc, const char *mnemonic)
 {
-    auto result = mainPCsChecked[cpuID].insert(
-        std::make_pair(pc, std::array<int, 2>({0, 0})));
-    result.first->second[0]++;
-    auto check = mainPCStaticInstsMap.insert(std::make_pair(pc, instName));
-    assert(!check.second || check.first->second == instName);
-    return result;
+    bool inserted;
+    pccoverage::slot &s = mainPCsChecked[cpuID].lookup(pc, inserted);
+    if (inserted)
+        s.instId = mainStaticInstsChecked[cpuID].id(mnemonic);
+    s.counts.encountered++;
+    return {&s.counts, inserted};
 }
 std::string
 loadstorelogentry::printPCs(int cpuID)
 {
     std::stringstream ss;
     ss << "pc, static inst,# encountered,# checked" << std::endl;
-    for (auto it : mainPCsChecked[cpuID]) {
-     ss << it.first << "," << mainPCStaticInstsMap[it.first] << "," << it.second[0] << "," << it.second[1] << std::endl;
+    for (const pccoverage::slot *s : mainPCsChecked[cpuID].sorted()) {
+     ss << s->pc << "," << instName(s->instId) << "," << s->counts.encountered << "," << s->counts.checked << std::endl;
     }
     return ss.str();
 }
 
+namespace
+{
+
+/* Files of --coverageDump, see loadstorelogentry::dumpCoverage */
+struct coveragedump
+{
+    // Fixed size record of coverage.bin, key is a PC or an instruction id
+    struct record
+    {
+        uint32_t dump;
+        uint16_t core;
+        uint16_t isPC;
+        uint64_t key;
+        uint32_t instId;
+        uint32_t encountered;
+        uint32_t checked;
+        uint32_t reserved;
+    };
+
+    bool binary = false;
+    OutputStream *counts = nullptr;
+    OutputStream *names = nullptr;
+    uint32_t dumps = 0;
+    // Instruction names written to coverage_names.csv so far
+    uint32_t namesWritten = 0;
+
+    void
+    write(uint32_t core, bool isPC, uint64_t key, uint32_t instId,
+          coveragecounts &c)
+    {
+        uint32_t encountered = c.encountered - c.dumpedEncountered;
+        uint32_t checked = c.checked - c.dumpedChecked;
+        c.dumpedEncountered = c.encountered;
+        c.dumpedChecked = c.checked;
+        std::ostream &os = *counts->stream();
+        if (binary) {
+            record r{dumps, (uint16_t)core, isPC, key, instId, encountered,
+                     checked, 0};
+            os.write(reinterpret_cast<const char *>(&r), sizeof(r));
+        } else {
+            os << dumps << "," << core << "," << (isPC ? "pc" : "inst")
+               << ",0x" << std::hex << key << std::dec << ","
+               << loadstorelogentry::instName(instId) << "," << encountered
+               << "," << checked << "\n";
+        }
+    }
+};
+
+coveragedump coverageDump;
+
+} // anonymous namespace
+
+void
+loadstorelogentry::initCoverageDump(const std::string &format)
+{
+    if (format == "none")
+        return;
+    fatal_if(format != "csv" && format != "binary",
+             "Unknown coverage dump %s (none, csv or binary)\n", format);
+    coverageDump.binary = format == "binary";
+    if (coverageDump.binary) {
+        coverageDump.counts = simout.create("coverage.bin", true);
+        coverageDump.names = simout.create("coverage_names.csv");
+        *coverageDump.names->stream() << "id,name\n";
+    } else {
+        coverageDump.counts = simout.create("coverage.csv");
+        *coverageDump.counts->stream()
+            << "dump,core,kind,key,inst,encountered,checked\n";
+    }
+    statistics::registerDumpCallback([]() { dumpCoverage(); });
+    std::cout << "coverageDump " << format << std::endl;
+}
+
+void
+loadstorelogentry::dumpCoverage()
+{
+    if (!coverageDump.counts)
+        return;
+    for (int m = 0; m < mainPCsChecked.size(); m++) {
+        auto &counts = mainStaticInstsChecked[m].byId();
+        for (uint32_t id = 0; id < counts.size(); id++) {
+            if (counts[id].changed())
+                coverageDump.write(m, false, id, id, counts[id]);
+        }
+        for (pccoverage::slot *s : mainPCsChecked[m].changed())
+            coverageDump.write(m, true, s->pc, s->instId, s->counts);
+    }
+    if (coverageDump.names) {
+        GlobalGuard guard;
+        std::ostream &os = *coverageDump.names->stream();
+        for (; coverageDump.namesWritten < instNames.size();
+             coverageDump.namesWritten++) {
+            os << coverageDump.namesWritten << ","
+               << instNames[coverageDump.namesWritten] << "\n";
+        }
+        os.flush();
+    }
+    coverageDump.counts->stream()->flush();
+    coverageDump.dumps++;
+}
+
 uint64_t loadstorelogentry::meanTime=0;
 uint64_t loadstorelogentry::maxTime=0;
 uint64_t loadstorelogentry::minTime=(uint64_t)-1;
 uint64_t loadstorelogentry::times=0;
-uint64_t loadstorelogentry::totalCommittedInstructions = 0;
-uint64_t loadstorelogentry::checkedCommittedInstructions = 0;
-uint64_t loadstorelogentry::checkStartDelayInstructions = 0;
-uint64_t loadstorelogentry::checkDelayCommittedInstructions = 0;
-uint64_t loadstorelogentry::cptStartDelayTicks = 0;
-uint64_t loadstorelogentry::cptLenTicks = 0;
-uint64_t loadstorelogentry::cptCheckerStartToFetchDelayTicks = 0;
-uint64_t loadstorelogentry::cptCheckerFirstFetchTransAccDelayTicks = 0;
-uint64_t loadstorelogentry::cptCheckerFirstFetchToCommitDelayTicks = 0;
-uint64_t loadstorelogentry::cptCheckerStartToCommitDelayTicks = 0;
-uint64_t loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks = 0;
-uint64_t loadstorelogentry::cptCheckerLastCommitToDrainDoneDelayTicks = 0;
-uint64_t loadstorelogentry::cptCheckerDrainDoneToStartDelayTicks = 0;
-uint64_t loadstorelogentry::checkpointingCycles = 0;
-uint64_t loadstorelogentry::noCheckerCycles = 0;
-uint64_t loadstorelogentry::blockingWaitCycles = 0;
-
-
-std::vector<histoEntry> loadstorelogentry::histoEntries;
-std::vector<histoEntry> loadstorelogentry::cptLenHistoEntries;
-std::vector<histoEntry> loadstorelogentry::checkerCptLenHistoEntries;
-std::vector<histoEntry> loadstorelogentry::cptFirstFetchToCommitDelayHistoEntries;
-
-// uint64_t loadstorelogentry::aimdHistoentries[NUMBEROFAIMDHISTOENTRIES+64] = {0};
-std::vector<uint64_t> loadstorelogentry::aimdHistoentries;
-std::vector<uint64_t> loadstorelogentry::cptLengthHistoentries;
-std::vector<uint64_t> loadstorelogentry::lengthToFirstLSLHistoentries;
-std::vector<uint64_t> loadstorelogentry::lengthFromLastLSLHistoentries;
-
-uint64_t loadstorelogentry::maxHistoSize = 100000;
-uint64_t loadstorelogentry::cptLenMaxHistoSize = 10000;
-uint64_t loadstorelogentry::checkerCptLenMaxHistoSize = 100;
-uint64_t loadstorelogentry::cptFirstFetchToCommitDelayMaxHistoSize = NUMBEROFHISTOENTRIES;
-
-histoEntry loadstorelogentry::bigBucket = histoEntry();
-histoEntry loadstorelogentry::cptLenBigBucket = histoEntry();
-histoEntry loadstorelogentry::checkerCptLenBigBucket = histoEntry();
-histoEntry loadstorelogentry::cptFirstFetchToCommitDelayBigBucket = histoEntry();
+std::atomic<uint64_t> loadstorelogentry::totalCommittedInstructions = 0;
+std::atomic<uint64_t> loadstorelogentry::checkedCommittedInstructions = 0;
+std::atomic<uint64_t> loadstorelogentry::checkStartDelayInstructions = 0;
+std::atomic<uint64_t> loadstorelogentry::checkDelayCommittedInstructions = 0;
+std::atomic<uint64_t> loadstorelogentry::cptStartDelayTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::numCpts = 0;
+std::atomic<uint64_t> loadstorelogentry::cptLenTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::cptCheckerStartToFetchDelayTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::cptCheckerFirstFetchTransAccDelayTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::cptCheckerFirstFetchToCommitDelayTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::cptCheckerStartToCommitDelayTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::cptCheckerLastCommitToDrainDoneDelayTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::cptCheckerDrainDoneToStartDelayTicks = 0;
+std::atomic<uint64_t> loadstorelogentry::checkpointingCycles = 0;
+std::atomic<uint64_t> loadstorelogentry::noCheckerCycles = 0;
+std::atomic<uint64_t> loadstorelogentry::blockingWaitCycles = 0;
+
 
 std::vector<loadstorelogentry::MainCPUMeta> loadstorelogentry::mainCPUMeta;
 std::vector<loadstorelogentry::CheckerCPUMeta> loadstorelogentry::checkerCPUMeta;
 std::vector<loadstorelogentry::AllCPUMeta> loadstorelogentry::allCPUMeta;
 
-std::vector<uint64_t> loadstorelogentry::blocked_lines(513,0);
+bool loadstorelogentry::blockedLinesTracked = false;
+std::map<int, BaseCache *> loadstorelogentry::blockingL1s;
 
 bool loadstorelogentry::debugFlag = false;
 std::vector<Addr> loadstorelogentry::last_macro_addrs;
-std::vector<std::map<std::string, std::array<int, 2>>>
-    loadstorelogentry::mainStaticInstsChecked;
-std::vector<std::map<uint64_t, std::array<int, 2>>>
-    loadstorelogentry::mainPCsChecked;
-std::map<uint64_t, std::string> loadstorelogentry::mainPCStaticInstsMap;
+std::vector<instcoverage> loadstorelogentry::mainStaticInstsChecked;
+std::vector<pccoverage> loadstorelogentry::mainPCsChecked;
 
 
 using namespace TheISA;
-miniContext
-m_serialize(ThreadContext *tc)
-{
 
-    miniContext m;
+/* Re-read one vector register along with its element view. */
+static void
+m_readVec(ThreadContext *tc, miniContext &m, int i)
+{
+    tc->getRegFlat(RegId(VecRegClass, i), &(m.vc[i]));
+    for (int e = i * NumVecElemPerVecReg; e < (i + 1) * NumVecElemPerVecReg; e++)
+        m.vecRegs.at(e) = tc->getRegFlat(RegId(VecElemClass, e));
+}
 
+static void
+m_readAll(ThreadContext *tc, miniContext &m)
+{
  for (int i = 0; i < int_reg::NumRegs; i++) {
         RegId reg(IntRegClass, i);
         m.intRegs.at(i) = tc->getRegFlat(reg);
@@ -273,6 +691,133 @@ m_serialize(ThreadContext *tc)
         RegId reg(VecElemClass, i);
         m.vecRegs.at(i) = tc->getRegFlat(reg);
     }
+}
+
+/* Bring the shadow snapshot of tc up to date and return it, or return
+ * nullptr if tc's CPU model doesn't track dirty registers. */
+static miniContext *
+m_sync(ThreadContext *tc)
+{
+    DirtyRegs *dirty = tc->getDirtyRegs();
+    ContextID id = tc->contextId();
+    if (!dirty || id < 0 || id >= loadstorelogentry::allCPUMeta.size())
+        return nullptr;
+
+    miniContext &m = loadstorelogentry::allCPUMeta[id].shadow;
+    DirtyRegs &drift = loadstorelogentry::allCPUMeta[id].drift;
+
+    if (dirty->allDirty() || !m.initialized) {
+        m_readAll(tc, m);
+        drift.markAll();
+    } else {
+        for (RegIndex i : dirty->dirty(IntRegClass))
+            m.intRegs.at(i) = tc->getRegFlat(RegId(IntRegClass, i));
+
+        for (RegIndex i : dirty->dirty(CCRegClass))
+            m.ccRegs.at(i) = tc->getReg(RegId(CCRegClass, i));
+
+        // Vector registers and their elements alias, refresh both views
+        for (RegIndex i : dirty->dirty(VecRegClass)) {
+            m_readVec(tc, m, i);
+            drift.mark(VecRegClass, i);
+        }
+        for (RegIndex i : dirty->dirty(VecElemClass)) {
+            m_readVec(tc, m, i / NumVecElemPerVecReg);
+            drift.mark(VecRegClass, i / NumVecElemPerVecReg);
+        }
+
+        // The ISA marks every banked and aliased view of a misc register
+        // it writes, so the dirty set already covers them
+        for (RegIndex i : dirty->dirty(MiscRegClass))
+            m.miscRegs.at(i) = tc->readMiscRegNoEffect(i);
+
+        drift.mark(IntRegClass, dirty->dirty(IntRegClass));
+        drift.mark(CCRegClass, dirty->dirty(CCRegClass));
+        drift.mark(MiscRegClass, dirty->dirty(MiscRegClass));
+    }
+    dirty->clear();
+
+    // setMiscReg "with effect" will set the misc register mapping correctly.
+    // e.g. updateRegMap(val)
+    m.CPSR = tc->readMiscRegNoEffect(MISCREG_CPSR);
+
+    m.pcState = tc->pcState().as<TheISA::PCState>();
+    m.initialized = true;
+    m.checked = false;
+    m.set = false;
+
+    return &m;
+}
+
+/* Give the synced shadow of context id the identity of a new snapshot,
+ * recording which registers changed since the previous one. */
+static void
+m_export(ContextID id, miniContext &shadow)
+{
+    loadstorelogentry::AllCPUMeta &meta = loadstorelogentry::allCPUMeta[id];
+    loadstorelogentry::AllCPUMeta::ExportRecord r;
+    r.known = meta.baseOwner == id && meta.baseSeq == meta.exports &&
+              !meta.drift.allDirty();
+    if (r.known) {
+        for (RegClassType cls : {IntRegClass, CCRegClass, VecRegClass,
+                                 MiscRegClass}) {
+            for (RegIndex i : meta.drift.dirty(cls))
+                r.changed.emplace_back(cls, i);
+        }
+    }
+    meta.history.push_back(std::move(r));
+    if (meta.history.size() > meta.exportHistory)
+        meta.history.pop_front();
+
+    shadow.owner = id;
+    shadow.seq = ++meta.exports;
+    meta.baseOwner = id;
+    meta.baseSeq = shadow.seq;
+    meta.drift.clear();
+}
+
+/* The registers in which context id, once synced, may differ from m: the
+ * ones m's owner changed since the snapshot id last held, and the ones id
+ * changed since. nullptr if that is not known. */
+static const DirtyRegs *
+m_candidates(ContextID id, const miniContext &m)
+{
+    loadstorelogentry::AllCPUMeta &meta = loadstorelogentry::allCPUMeta[id];
+    if (m.owner < 0 || meta.baseOwner != m.owner || meta.baseSeq > m.seq ||
+        meta.drift.allDirty())
+        return nullptr;
+    const loadstorelogentry::AllCPUMeta &owner =
+        loadstorelogentry::allCPUMeta[m.owner];
+    uint64_t first = owner.exports + 1 - owner.history.size();
+    if (m.seq > owner.exports || meta.baseSeq + 1 < first)
+        return nullptr;
+
+    DirtyRegs &c = meta.candidates;
+    c.clear();
+    for (uint64_t s = meta.baseSeq + 1; s <= m.seq; s++) {
+        const auto &r = owner.history[s - first];
+        if (!r.known)
+            return nullptr;
+        for (const RegId &reg : r.changed)
+            c.mark(reg);
+    }
+    for (RegClassType cls : {IntRegClass, CCRegClass, VecRegClass,
+                             MiscRegClass})
+        c.mark(cls, meta.drift.dirty(cls));
+    return &c;
+}
+
+miniContext
+m_serialize(ThreadContext *tc)
+{
+    if (miniContext *shadow = m_sync(tc)) {
+        m_export(tc->contextId(), *shadow);
+        return *shadow;
+    }
+
+    miniContext m;
+
+    m_readAll(tc, m);
 
     // setMiscReg "with effect" will set the misc register mapping correctly.
     // e.g. updateRegMap(val)
@@ -286,87 +831,179 @@ m_serialize(ThreadContext *tc)
     return m;
 }
 
-bool m_identical(ThreadContext *tc, const miniContext m)
+bool m_identical(ThreadContext *tc, const miniContext &m)
 {
     assert(m.initialized);
     assert(!m.checked);
 
+    // Compare against an up to date snapshot rather than going back to the
+    // thread context for every register
+    miniContext full;
+    const miniContext *cur = m_sync(tc);
+    const DirtyRegs *cand = nullptr;
+    if (!cur) {
+        full = m_serialize(tc);
+        cur = &full;
+    } else {
+        cand = m_candidates(tc->contextId(), m);
+    }
+
     bool ret = true;
 
-     for (int i = 0; i < int_reg::NumRegs; i++) {
-             if (i==34) continue;//TODO: from old codebase. Needed here too?
-        RegId reg(IntRegClass, i);
-        ret &= m.intRegs.at(i) == tc->getRegFlat(reg);
-        if(m.intRegs.at(i) != tc->getRegFlat(reg)) {std::cout << "int " << i << " " << m.intRegs.at(i) << " vs " << tc->getRegFlat(reg) << " \n";}
-    }
+    if (cand) {
+        // Only registers either side wrote since they last agreed
+        for (RegIndex i : cand->dirty(IntRegClass)) {
+            if (i == 34) continue;
+            ret &= m.intRegs.at(i) == cur->intRegs.at(i);
+            if(m.intRegs.at(i) != cur->intRegs.at(i)) {std::cout << "int " << i << " " << m.intRegs.at(i) << " vs " << cur->intRegs.at(i) << " \n";}
+        }
+        for (RegIndex v : cand->dirty(VecRegClass)) {
+            for (int i = v * NumVecElemPerVecReg;
+                 i < (v + 1) * NumVecElemPerVecReg; i++) {
+                ret &= m.vecRegs.at(i) == cur->vecRegs.at(i);
+                if(m.vecRegs.at(i) != cur->vecRegs.at(i)) {std::cout << "vec " << i << "\n";}
+            }
+        }
+#ifdef ISA_HAS_CC_REGS
+        for (RegIndex i : cand->dirty(CCRegClass))
+            ret &= m.ccRegs[i] == cur->ccRegs[i];
+#endif
+        for (RegIndex i : cand->dirty(MiscRegClass)) {
+            if (i == 19) continue; // Load locked address, see below
+            ret &= m.miscRegs.at(i) == cur->miscRegs.at(i);
+            if(m.miscRegs.at(i) != cur->miscRegs.at(i)) {std::cout << "misc " << i << "\n";}
+        }
+    } else {
+        for (int i = 0; i < int_reg::NumRegs; i++) {
+            if (i==34) continue;//TODO: from old codebase. Needed here too?
+            ret &= m.intRegs.at(i) == cur->intRegs.at(i);
+            if(m.intRegs.at(i) != cur->intRegs.at(i)) {std::cout << "int " << i << " " << m.intRegs.at(i) << " vs " << cur->intRegs.at(i) << " \n";}
+        }
 
-//check FloatRegs
-    for (int i = 0; i < NumVecRegs * NumVecElemPerVecReg; i++) {
-        RegId reg(VecElemClass, i);
-        ret &= m.vecRegs.at(i) == tc->getRegFlat(reg);
-        if(m.vecRegs.at(i) != tc->getRegFlat(reg)) {std::cout << "vec " << i << "\n";}
-    }
+        //check FloatRegs
+        for (int i = 0; i < NumVecRegs * NumVecElemPerVecReg; i++) {
+            ret &= m.vecRegs.at(i) == cur->vecRegs.at(i);
+            if(m.vecRegs.at(i) != cur->vecRegs.at(i)) {std::cout << "vec " << i << "\n";}
+        }
 
 
 #ifdef ISA_HAS_CC_REGS
-    for (int i = 0; i < NumCCRegs; ++i) {
-         RegId reg(CCRegClass, i);
-        ret &= m.ccRegs[i] == tc->getReg(reg);
-    }
-    // if (!ret) {
-    //     std::cout << "/!\\ Different CC registers. ";
-    //     for (int i = 0; i < NumCCRegs; ++i)
-    //         if (m.ccRegs[i] != tc->readCCReg(i)) {
-    //             std::cout << "(" << i << " ie " << TheISA::ccRegName[i] << ") " << m.ccRegs[i] << " != " << tc->readCCReg(i) << " ; ";
-    //         }
-    //     return ret;
-    // }
+        for (int i = 0; i < NumCCRegs; ++i) {
+            ret &= m.ccRegs[i] == cur->ccRegs[i];
+        }
 #endif
 
-    for (int i=0; i< NUM_MISCREGS; ++i) {
-        if (i==19/* && (m.miscRegs[19] != tc->readMiscRegNoEffect(19))*/) { //TODO: from old codebase. Still needed?
-            // miscRegs[19] contains the Load locked address. The main core
-            // stores the physical address of the memory location, but checker
-            // core doesn't get the proper physical address, so the value will
-            // not match.
-            continue;
-        } else {
-            ret &= m.miscRegs.at(i) == tc->readMiscRegNoEffect(i);
-            if(m.miscRegs.at(i) != tc->readMiscRegNoEffect(i)) {std::cout << "misc " << i << "\n";}
+        for (int i=0; i< NUM_MISCREGS; ++i) {
+            if (i==19/* && (m.miscRegs[19] != tc->readMiscRegNoEffect(19))*/) { //TODO: from old codebase. Still needed?
+                // miscRegs[19] contains the Load locked address. The main core
+                // stores the physical address of the memory location, but checker
+                // core doesn't get the proper physical address, so the value will
+                // not match.
+                continue;
+            } else {
+                ret &= m.miscRegs.at(i) == cur->miscRegs.at(i);
+                if(m.miscRegs.at(i) != cur->miscRegs.at(i)) {std::cout << "misc " << i << "\n";}
+            }
         }
     }
 
-    ret &= m.CPSR == tc->readMiscRegNoEffect(MISCREG_CPSR);
+    ret &= m.CPSR == cur->CPSR;
 
 
     // For PCState, the equality is overloaded in src/arch/*THEISA*/types.hh
     ret &= m.pcState == tc->pcState();
 
+    if (ret && cur != &full && m.owner >= 0) {
+        // tc now holds m, but for the registers the compare ignores
+        loadstorelogentry::AllCPUMeta &meta =
+            loadstorelogentry::allCPUMeta[tc->contextId()];
+        meta.baseOwner = m.owner;
+        meta.baseSeq = m.seq;
+        meta.drift.clear();
+        meta.drift.mark(IntRegClass, 34);
+        meta.drift.mark(MiscRegClass, 19);
+    }
+
     return ret;
 }
 
-void m_copyRegs(ThreadContext *tc, miniContext m)
+void m_copyRegs(ThreadContext *tc, const miniContext &m)
 {
+    // Only registers that differ from the current state need writing
+    miniContext *shadow = m_sync(tc);
+    const DirtyRegs *cand = shadow ? m_candidates(tc->contextId(), m)
+                                   : nullptr;
+
+    if (cand) {
+        // and only those either side wrote since they last agreed can
+        for (RegIndex i : cand->dirty(IntRegClass)) {
+            if (shadow->intRegs.at(i) != m.intRegs.at(i))
+                tc->setRegFlat(RegId(IntRegClass, i), m.intRegs.at(i));
+        }
+        for (RegIndex i : cand->dirty(CCRegClass)) {
+            if (shadow->ccRegs[i] != m.ccRegs[i])
+                tc->setReg(RegId(CCRegClass, i), m.ccRegs[i]);
+        }
+        for (RegIndex i : cand->dirty(MiscRegClass)) {
+            if (shadow->miscRegs.at(i) == m.miscRegs.at(i)) continue;
+            // As below, a full in-order copy once any of them differs
+            for (int j = 0; j < NUM_MISCREGS; j++)
+                tc->setMiscRegNoEffect(j, m.miscRegs.at(j));
+            break;
+        }
+        for (RegIndex i : cand->dirty(VecRegClass)) {
+            if (!(shadow->vc[i] == m.vc[i]))
+                tc->setRegFlat(RegId(VecRegClass, i), &(m.vc[i]));
+            for (int e = i * NumVecElemPerVecReg;
+                 e < (i + 1) * NumVecElemPerVecReg; e++) {
+                if (shadow->vecRegs.at(e) != m.vecRegs.at(e))
+                    tc->setRegFlat(RegId(VecElemClass, e), m.vecRegs.at(e));
+            }
+        }
+    } else {
+        for (int i = 0; i < int_reg::NumRegs; i++) {
+            if (shadow && shadow->intRegs.at(i) == m.intRegs.at(i)) continue;
+            RegId reg(IntRegClass, i);
+            tc->setRegFlat(reg, m.intRegs.at(i));
+        }
+        for (int i = 0; i < cc_reg::NumRegs; i++) {
+            if (shadow && shadow->ccRegs[i] == m.ccRegs[i]) continue;
+            RegId reg(CCRegClass, i);
+            tc->setReg(reg,  m.ccRegs[i]);
+        }
 
-    for (int i = 0; i < int_reg::NumRegs; i++) {
-        RegId reg(IntRegClass, i);
-        tc->setRegFlat(reg, m.intRegs.at(i));
-    }
-    for (int i = 0; i < cc_reg::NumRegs; i++) {
-        RegId reg(CCRegClass, i);
-        tc->setReg(reg,  m.ccRegs[i]);
-    }
-
-    for (int i = 0; i < NUM_MISCREGS; i++)
-        tc->setMiscRegNoEffect(i, m.miscRegs.at(i));
+        // Misc registers alias each other, so keep the original full in-order
+        // copy whenever any of them differs
+        if (!shadow || shadow->miscRegs != m.miscRegs) {
+            for (int i = 0; i < NUM_MISCREGS; i++)
+                tc->setMiscRegNoEffect(i, m.miscRegs.at(i));
+        }
 
-    for (int i = 0; i < NumVecRegs; i++) {
-        RegId reg(VecRegClass, i);
-        tc->setRegFlat(reg, &(m.vc[i]));
+        for (int i = 0; i < NumVecRegs; i++) {
+            if (shadow && shadow->vc[i] == m.vc[i]) continue;
+            RegId reg(VecRegClass, i);
+            tc->setRegFlat(reg, &(m.vc[i]));
+        }
+        for (int i = 0; i < NumVecRegs * NumVecElemPerVecReg; i++) {
+            if (shadow && shadow->vecRegs.at(i) == m.vecRegs.at(i)) continue;
+            RegId reg(VecElemClass, i);
+            tc->setRegFlat(reg, m.vecRegs.at(i));
+        }
     }
-    for (int i = 0; i < NumVecRegs * NumVecElemPerVecReg; i++) {
-        RegId reg(VecElemClass, i);
-        tc->setRegFlat(reg, m.vecRegs.at(i));
+
+    if (shadow) {
+        // The thread context now holds m, except for what the CPSR write
+        // below marks dirty again
+        *shadow = m;
+        tc->getDirtyRegs()->clear();
+        loadstorelogentry::AllCPUMeta &meta =
+            loadstorelogentry::allCPUMeta[tc->contextId()];
+        meta.baseOwner = m.owner;
+        meta.baseSeq = m.seq;
+        if (m.owner >= 0)
+            meta.drift.clear();
+        else
+            meta.drift.markAll();
     }
 
     //not clear this really does anything, but it's from the version in src/arch/arm/utility.cc
@@ -381,6 +1018,165 @@ void m_copyRegs(ThreadContext *tc, miniContext m)
     // thread_num and cpu_id are deterministic from the config
 }
 
+/* m_identical doesn't hold these against the checker either */
+static bool
+m_ignored(RegClassType cls, RegIndex idx)
+{
+    return (cls == IntRegClass && idx == 34) ||
+           (cls == MiscRegClass && idx == 19);
+}
+
+static void
+m_diffAll(const miniContext &base, const miniContext &cur, regDelta &d)
+{
+    auto diff = [&](RegClassType cls, const std::vector<RegVal> &b,
+                    const std::vector<RegVal> &c) {
+        for (int i = 0; i < c.size(); i++) {
+            if (!base.initialized || b.at(i) != c.at(i))
+                d.regs.push_back({cls, (RegIndex)i, b.at(i), c.at(i)});
+        }
+    };
+    diff(IntRegClass, base.intRegs, cur.intRegs);
+    diff(CCRegClass, base.ccRegs, cur.ccRegs);
+    diff(MiscRegClass, base.miscRegs, cur.miscRegs);
+
+    for (int i = 0; i < NumVecRegs; i++) {
+        if (base.initialized && base.vc[i] == cur.vc[i])
+            continue;
+        regDelta::vecReg v{(RegIndex)i, base.vc[i], cur.vc[i], {}};
+        for (int e = i * NumVecElemPerVecReg;
+             e < (i + 1) * NumVecElemPerVecReg; e++)
+            v.elems.push_back(cur.vecRegs.at(e));
+        d.vecs.push_back(std::move(v));
+    }
+}
+
+void
+m_deltaBegin(ThreadContext *tc)
+{
+    // With dirty tracking the shadow is the baseline, and the dirty set
+    // collects whatever is written from here on
+    if (m_sync(tc))
+        return;
+    loadstorelogentry::allCPUMeta.at(tc->contextId()).shadow =
+        m_serialize(tc);
+}
+
+regDelta
+m_deltaEnd(ThreadContext *tc)
+{
+    regDelta d;
+    miniContext &base = loadstorelogentry::allCPUMeta.at(tc->contextId()).shadow;
+    DirtyRegs &drift = loadstorelogentry::allCPUMeta.at(tc->contextId()).drift;
+    DirtyRegs *dirty = tc->getDirtyRegs();
+
+    if (!dirty || dirty->allDirty() || !base.initialized) {
+        drift.markAll();
+        miniContext cur;
+        m_readAll(tc, cur);
+        m_diffAll(base, cur, d);
+        base.intRegs.swap(cur.intRegs);
+        base.ccRegs.swap(cur.ccRegs);
+        base.miscRegs.swap(cur.miscRegs);
+        base.vc.swap(cur.vc);
+        base.vecRegs.swap(cur.vecRegs);
+    } else {
+        for (RegIndex i : dirty->dirty(IntRegClass)) {
+            RegVal v = tc->getRegFlat(RegId(IntRegClass, i));
+            d.regs.push_back({IntRegClass, i, base.intRegs.at(i), v});
+            base.intRegs.at(i) = v;
+            drift.mark(IntRegClass, i);
+        }
+        for (RegIndex i : dirty->dirty(CCRegClass)) {
+            RegVal v = tc->getReg(RegId(CCRegClass, i));
+            d.regs.push_back({CCRegClass, i, base.ccRegs.at(i), v});
+            base.ccRegs.at(i) = v;
+            drift.mark(CCRegClass, i);
+        }
+
+        std::vector<RegIndex> vecs(dirty->dirty(VecRegClass));
+        for (RegIndex e : dirty->dirty(VecElemClass))
+            vecs.push_back(e / NumVecElemPerVecReg);
+        std::sort(vecs.begin(), vecs.end());
+        vecs.erase(std::unique(vecs.begin(), vecs.end()), vecs.end());
+        for (RegIndex i : vecs) {
+            regDelta::vecReg v{i, base.vc[i], {}, {}};
+            m_readVec(tc, base, i);
+            drift.mark(VecRegClass, i);
+            v.after = base.vc[i];
+            v.elems.assign(base.vecRegs.begin() + i * NumVecElemPerVecReg,
+                base.vecRegs.begin() + (i + 1) * NumVecElemPerVecReg);
+            d.vecs.push_back(std::move(v));
+        }
+
+        // As in m_sync, the dirty set includes the aliased views
+        for (RegIndex i : dirty->dirty(MiscRegClass)) {
+            RegVal v = tc->readMiscRegNoEffect(i);
+            if (v != base.miscRegs.at(i)) {
+                d.regs.push_back({MiscRegClass, i, base.miscRegs.at(i), v});
+                base.miscRegs.at(i) = v;
+                drift.mark(MiscRegClass, i);
+            }
+        }
+    }
+    if (dirty)
+        dirty->clear();
+
+    d.CPSR = base.CPSR = tc->readMiscRegNoEffect(MISCREG_CPSR);
+    d.pcState = base.pcState = tc->pcState().as<TheISA::PCState>();
+    base.initialized = true;
+
+    return d;
+}
+
+bool
+m_applyDelta(ThreadContext *tc, const regDelta &d)
+{
+    for (const regDelta::reg &r : d.regs) {
+        if (m_ignored(r.cls, r.idx))
+            continue;
+        RegVal cur;
+        if (r.cls == MiscRegClass)
+            cur = tc->readMiscRegNoEffect(r.idx);
+        else if (r.cls == CCRegClass)
+            cur = tc->getReg(RegId(r.cls, r.idx));
+        else
+            cur = tc->getRegFlat(RegId(r.cls, r.idx));
+        if (cur != r.before)
+            return false;
+    }
+    for (const regDelta::vecReg &v : d.vecs) {
+        TheISA::VecRegContainer cur;
+        tc->getRegFlat(RegId(VecRegClass, v.idx), &cur);
+        if (!(cur == v.before))
+            return false;
+    }
+
+    for (const regDelta::reg &r : d.regs) {
+        if (r.cls == MiscRegClass)
+            tc->setMiscRegNoEffect(r.idx, r.after);
+        else if (r.cls == CCRegClass)
+            tc->setReg(RegId(r.cls, r.idx), r.after);
+        else
+            tc->setRegFlat(RegId(r.cls, r.idx), r.after);
+    }
+    for (const regDelta::vecReg &v : d.vecs) {
+        tc->setRegFlat(RegId(VecRegClass, v.idx), &v.after);
+        for (int e = 0; e < NumVecElemPerVecReg; e++) {
+            tc->setRegFlat(RegId(VecElemClass,
+                                 v.idx * NumVecElemPerVecReg + e),
+                           v.elems[e]);
+        }
+    }
+
+    // Same tail as m_copyRegs
+    tc->setMiscReg(MISCREG_CPSR, d.CPSR);
+    tc->pcState(d.pcState);
+    static_cast<MMU *>(tc->getMMUPtr())->invalidateMiscReg();
+
+    return true;
+}
+
 namespace errordetection {
 #if LOGERRORS
 
@@ -389,6 +1185,7 @@ std::vector<uint64_t> detectionPoints = std::vector<uint64_t>();
 std::vector<double> detectionVoltage = std::vector<double>();
 
 std::vector<uint64_t> memoryRecoveryTime = std::vector<uint64_t>();
+std::vector<uint64_t> memoryRecoveryCycles = std::vector<uint64_t>();
 std::vector<uint64_t> voltageSwitchTime = std::vector<uint64_t>();
 std::vector<double> voltageSwitchPoints = std::vector<double>();
 
@@ -400,6 +1197,9 @@ uint64_t total_memory_recoveries = 0;
 
 uint64_t min_memory_recoveries = 0;
 uint64_t max_memory_recoveries = 0;
+uint64_t total_memory_recovery_cycles = 0;
+uint64_t min_memory_recovery_cycles = 0;
+uint64_t max_memory_recovery_cycles = 0;
 
 uint64_t total_rollback_recovery = 0;
 
@@ -407,14 +1207,13 @@ uint64_t min_rollback_recovery = 0;
 uint64_t max_rollback_recovery = 0;
 
 
-std::vector<bool> voltage_reset{false};//[NUMBEROFMAINCORES]=  {false};
 
 
 
-uint64_t numberOfDetectedErroneousWrites = 0;
-uint64_t numberOfDetectedErroneousReads = 0;
-uint64_t numberOfDetectedErroneousArchStates = 0;
-uint64_t numberOfCorrectCheckpoints = 0;
+std::atomic<uint64_t> numberOfDetectedErroneousWrites = 0;
+std::atomic<uint64_t> numberOfDetectedErroneousReads = 0;
+std::atomic<uint64_t> numberOfDetectedErroneousArchStates = 0;
+std::atomic<uint64_t> numberOfCorrectCheckpoints = 0;
 }
 
 void errordetection::detectError(int id) {
@@ -425,7 +1224,7 @@ void errordetection::detectError(int id) {
               << (errorinjection::hasInjectedError[id] ? "" : " (false positive!)")
               << " for checker " << id << " at local time "
               << loadstorelogentry::checkerCPUMeta.at(id).timestamps << " (global time: "
-              << loadstorelogentry::mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp
+              << loadstorelogentry::mainCPUMeta[checkerOwner.at(id)].timestamp
               << ") insts " << loadstorelogentry::allCPUMeta[id+NUMBEROFMAINCORES].baseCPU->committedInstrs << std::endl;
 #endif
 
@@ -463,15 +1262,17 @@ void errordetection::detectErrorCommit(int id) {
     std::cout << ">>> Detecting errorcommit"
              << " for checker " << id << " at local time "
               << loadstorelogentry::checkerCPUMeta.at(id).timestamps << " (global time: "
-              << loadstorelogentry::mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp
+              << loadstorelogentry::mainCPUMeta[checkerOwner.at(id)].timestamp
               << ")" << std::endl;
 #endif
-    int mainCPUID = id/NUMBEROFCHECKERCORESPERCORE;
+    int mainCPUID = checkerOwner.at(id);
     uint64_t lastCorrectTick = loadstorelogentry::checkerCPUMeta.at(id).startingTick;
 
     uint64_t detectionTime = curTick() - lastCorrectTick;
 
     loadstorelogentry::mainCPUMeta[mainCPUID].errorTick = lastCorrectTick;
+    {
+    loadstorelogentry::GlobalGuard guard;
     errordetection::detected_errors++;
 #if LOGERRORS
     errordetection::detectionTime.push_back(detectionTime);
@@ -481,6 +1282,7 @@ void errordetection::detectErrorCommit(int id) {
     errordetection::min_rollback_recovery = std::min(detectionTime,errordetection::min_rollback_recovery);
     errordetection::min_rollback_recovery = errordetection::min_rollback_recovery==0?  detectionTime: errordetection::min_rollback_recovery;
     errordetection::max_rollback_recovery = std::max(detectionTime,errordetection::max_rollback_recovery);
+    }
 
 
 #if PARAGLIDER
@@ -503,7 +1305,6 @@ void errordetection::detectErrorCommit(int id) {
     errordetection::detectionVoltage.push_back(loadstorelogentry::mainCPUMeta[mainCPUID].voltage);
     std::cout << "New Voltage: " << loadstorelogentry::mainCPUMeta[mainCPUID].voltage;
 #endif
-    errordetection::voltage_reset[mainCPUID] = true;
 
 #endif
 #endif
@@ -517,35 +1318,31 @@ void errordetection::print_times() {
 
     outfile.open(simout.resolve("staticInsts.txt"), std::ios::trunc);
     outfile << "Checked," << loadstorelogentry::getNumCheckedStaticInsts(0) << std::endl;
-    outfile << "Total," << loadstorelogentry::mainStaticInstsChecked[0].size() << std::endl;
+    outfile << "Total," << loadstorelogentry::getNumStaticInsts(0) << std::endl;
     outfile << loadstorelogentry::printStaticInsts(0);
     outfile << loadstorelogentry::printPCs(0);
     outfile.close();
 
     outfile.open(simout.resolve("delays.txt"), std::ios::trunc);
     outfile << "Delays: mean " << loadstorelogentry::meanTime/loadstorelogentry::times << " max " << loadstorelogentry::maxTime << " min " << loadstorelogentry::minTime << " ps\n";
-    loadstorelogentry::printHisto(&outfile);
-    outfile << "Histogram of cpt length in ticks" << std::endl;
-    loadstorelogentry::printHisto(&outfile, loadstorelogentry::cptLenMaxHistoSize, loadstorelogentry::cptLenHistoEntries, loadstorelogentry::cptLenBigBucket);
-    outfile << "Histogram of checker cpt length in cycles" << std::endl;
-    loadstorelogentry::printHisto(&outfile, loadstorelogentry::checkerCptLenMaxHistoSize, loadstorelogentry::checkerCptLenHistoEntries, loadstorelogentry::checkerCptLenBigBucket);
-    outfile << "Histogram for checkpoints' first fetch to commit delay in cycles" << std::endl;
-    loadstorelogentry::printHisto(&outfile, loadstorelogentry::cptFirstFetchToCommitDelayMaxHistoSize, loadstorelogentry::cptFirstFetchToCommitDelayHistoEntries, loadstorelogentry::cptFirstFetchToCommitDelayBigBucket);
-    if (AIMD)
-      loadstorelogentry::printAimdHisto(&outfile);
-    loadstorelogentry::printCptLengthHisto(&outfile);
     outfile << "checkedCommittedInstructions " << loadstorelogentry::checkedCommittedInstructions << ", totalCommittedInstructions " << loadstorelogentry::totalCommittedInstructions << ", checkDelayCommittedInstructions " << loadstorelogentry::checkDelayCommittedInstructions << ", checkStartDelayInstructions " << loadstorelogentry::checkStartDelayInstructions << std::endl;
     outfile << "cptLenTicks " << loadstorelogentry::cptLenTicks << ", cptStartDelayTicks " << loadstorelogentry::cptStartDelayTicks << ", cptCheckerStartToFetchDelayTicks " << loadstorelogentry::cptCheckerStartToFetchDelayTicks << ", cptCheckerFirstFetchTransAccDelayTicks " << loadstorelogentry::cptCheckerFirstFetchTransAccDelayTicks << ", cptCheckerFirstFetchToCommitDelayTicks " << loadstorelogentry::cptCheckerFirstFetchToCommitDelayTicks << ", cptCheckerStartToCommitDelayTicks " << loadstorelogentry::cptCheckerStartToCommitDelayTicks << ", cptCheckerFirstToLastCommitDelayTicks " << loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks << ", cptCheckerLastCommitToDrainDoneDelayTicks " << loadstorelogentry::cptCheckerLastCommitToDrainDoneDelayTicks << ", cptCheckerDrainDoneToStartDelayTicks " << loadstorelogentry::cptCheckerDrainDoneToStartDelayTicks << ", cptCheckerStartToDrainDoneDelayTicks " << (loadstorelogentry::cptCheckerStartToCommitDelayTicks + loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks + loadstorelogentry::cptCheckerLastCommitToDrainDoneDelayTicks) << std::endl;
-    uint64_t numCpts = loadstorelogentry::cptLenBigBucket.number;
-    for (auto entry: loadstorelogentry::cptLenHistoEntries) {
-        numCpts += entry.number;
-    }
+    uint64_t numCpts = loadstorelogentry::numCpts;
     outfile << "numCpts " << numCpts << std::endl;
     if (numCpts > 0 && loadstorelogentry::allCPUMeta.size() > 0) { // At least 1 cpt and 1 main core
         outfile << "cptLen/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptLenTicks/numCpts) << ", cptStartDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptStartDelayTicks/numCpts) << ", cptCheckerStartToFetchDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerStartToFetchDelayTicks/numCpts) << ", cptCheckerFirstFetchTransAccDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerFirstFetchTransAccDelayTicks/numCpts) << ", cptCheckerFirstFetchToCommitDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerFirstFetchToCommitDelayTicks/numCpts) << ", cptCheckerStartToCommitDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerStartToCommitDelayTicks/numCpts) << ", cptCheckerFirstToLastCommitDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks/numCpts) << ", cptCheckerLastCommitToDrainDoneDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerLastCommitToDrainDoneDelayTicks/numCpts) << ", cptCheckerDrainDoneToStartDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerDrainDoneToStartDelayTicks/numCpts) << ", cptCheckerStartToDrainDoneDelay/cpt (main cycles) " << loadstorelogentry::allCPUMeta[0].baseCPU->ticksToCycles((loadstorelogentry::cptCheckerStartToCommitDelayTicks + loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks + loadstorelogentry::cptCheckerLastCommitToDrainDoneDelayTicks)/numCpts) << std::endl;
     }
     if (numCpts > 0 && loadstorelogentry::allCPUMeta.size() > NUMBEROFMAINCORES) { // At least 1 cpt and checkers exist
         outfile << "cptLen/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptLenTicks/numCpts) << ", cptStartDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptStartDelayTicks/numCpts) << ", cptCheckerStartToFetchDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerStartToFetchDelayTicks/numCpts) << ", cptCheckerFirstFetchTransAccDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerFirstFetchTransAccDelayTicks/numCpts) << ", cptCheckerFirstFetchToCommitDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerFirstFetchToCommitDelayTicks/numCpts) << ", cptCheckerStartToCommitDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerStartToCommitDelayTicks/numCpts) << ", cptCheckerFirstToLastCommitDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks/numCpts) << ", cptCheckerLastCommitToDrainDoneDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerLastCommitToDrainDoneDelayTicks/numCpts) << ", cptCheckerDrainDoneToStartDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerDrainDoneToStartDelayTicks/numCpts) << ", cptCheckerStartToDrainDoneDelay/cpt (checker cycles) " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles((loadstorelogentry::cptCheckerStartToCommitDelayTicks + loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks + loadstorelogentry::cptCheckerLastCommitToDrainDoneDelayTicks)/numCpts) << std::endl;
+        // What --functionalCheckerIPC and --functionalCheckerWakeup model
+        Cycles lastCommit = loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerFirstToLastCommitDelayTicks);
+        outfile << "functionalCheckerIPC " << (lastCommit ? (double)loadstorelogentry::checkedCommittedInstructions / lastCommit : 0.0) << ", functionalCheckerWakeup " << loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU->ticksToCycles(loadstorelogentry::cptCheckerStartToCommitDelayTicks/numCpts) << std::endl;
+    }
+    if (loadstorelogentry::useHash) {
+        outfile << "hashEngine " << loadstorelogentry::digestEngine->name() << ", hashBlocks " << loadstorelogentry::hashBlocksTotal << ", hashExposedCycles (checker cycles) " << loadstorelogentry::hashExposedCycles;
+        if (numCpts > 0)
+            outfile << ", hashExposedCycles/cpt " << loadstorelogentry::hashExposedCycles/numCpts;
+        outfile << std::endl;
     }
     outfile << "checkpointingCycles " << loadstorelogentry::checkpointingCycles << ", noCheckerCycles " << loadstorelogentry::noCheckerCycles << ", blockingWaitCycles " << loadstorelogentry::blockingWaitCycles << std::endl;
     outfile << "checkerLSLStallCycles ";
@@ -583,8 +1380,9 @@ void errordetection::print_times() {
 
 
     outfile << "injection_lapses: ";
-    for (int i = 0; i < errorinjection::lapses.size(); i++) {
-        outfile << errorinjection::lapses[i] << ", ";
+    for (const auto &stream : errorinjection::lapses) {
+        for (uint64_t lapse : stream)
+            outfile << lapse << ", ";
     }
 
 
@@ -626,6 +1424,10 @@ void errordetection::print_times() {
         mempenalty +=313*errordetection::memoryRecoveryTime[i];
         outfile << errordetection::memoryRecoveryTime[i] << ", ";
     }
+    outfile << "\nmemory_recovery_cycles: ";
+    for (int i = 0; i < errordetection::memoryRecoveryCycles.size(); i++) {
+        outfile << errordetection::memoryRecoveryCycles[i] << ", ";
+    }
     outfile << "\ntotal_recovery_penalty: " << penalty << std::endl;
     outfile << "\nrerun_penalty: " << rerunpenalty << std::endl;
 
@@ -639,6 +1441,9 @@ void errordetection::print_times() {
     outfile << "\nmemory_recovery_penalty: " << errordetection::total_memory_recoveries*313ul << std::endl;
     outfile << "\nmin_memory_recovery_penalty: " << errordetection::min_memory_recoveries*313ul << std::endl;
     outfile << "\nmax_memory_recovery_penalty: " << errordetection::max_memory_recoveries*313ul << std::endl;
+    outfile << "\nmodeled_memory_recovery_cycles: " << errordetection::total_memory_recovery_cycles << std::endl;
+    outfile << "\nmin_modeled_memory_recovery_cycles: " << errordetection::min_memory_recovery_cycles << std::endl;
+    outfile << "\nmax_modeled_memory_recovery_cycles: " << errordetection::max_memory_recovery_cycles << std::endl;
 
     outfile << "missed_errors: " << errorinjection::undetectedErrors << std::endl;
     outfile << "false_positives: " << errorinjection::falsePositives << std::endl;
@@ -675,7 +1480,16 @@ void errordetection::print_times() {
 
     outfile.close();
 
-    assert(errorinjection::lapses.size() ==
+    if (!errorinjection::schedule.empty()) {
+        outfile.open(simout.resolve("injection_plan.txt"), std::ios::trunc);
+        errorinjection::schedule.dumpPlan(outfile);
+        outfile.close();
+    }
+
+    [[maybe_unused]] size_t numLapses = 0;
+    for (const auto &stream : errorinjection::lapses)
+        numLapses += stream.size();
+    assert(numLapses ==
            errorinjection::numberOfErroneousWrites
            + errorinjection::numberOfErroneousReads
            + errorinjection::numberOfErroneousArchStates
@@ -735,13 +1549,13 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
                  } else if (load != pkt->isRead() && !(pkt->isRead() && pkt->isWrite())) { // swap is both read and write
                    ss << "=====> Mismatching status (log is a " << (load?'r':'w') << ")";
                  } else {
-                   std::cout << "=====> Unknown mismatch at time " << mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp << std::endl;
+                   std::cout << "=====> Unknown mismatch at time " << mainCPUMeta[checkerOwner.at(id)].timestamp << std::endl;
                    std::cout << "  Addresses --> log: " << addr << " ; pkt: " << pkt->req->getVaddr();
                    std::cout << "  Status    --> log is a " << (load?'r':'w') << " ; pkt->isRead() is " << pkt->isRead() << " ; pkt->isWrite() is " << pkt->isWrite() << "\n" << std::endl;
                    dumpLocalLogState(id);
                    assert(false);
                  }
-                 ss << " at time " << mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp << ", seqNum " << pkt->req->getLdStLogSeqNum() << std::endl;
+                 ss << " at time " << mainCPUMeta[checkerOwner.at(id)].timestamp << ", seqNum " << pkt->req->getLdStLogSeqNum() << std::endl;
                  pkt->req->setLdStLogAccErrMsg(ss.str());
                  if (debugFlag) {
                    std::cout << ss.str();
@@ -753,13 +1567,16 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
 
             uint64_t newTime = curTick() - time;
 
-            minTime = std::min(minTime,newTime);
-            maxTime = std::max(maxTime,newTime);
+            {
+                GlobalGuard guard;
+                minTime = std::min(minTime,newTime);
+                maxTime = std::max(maxTime,newTime);
 
-            addToHisto(newTime);
+                allCPUMeta[id+NUMBEROFMAINCORES].baseCPU->lslStats.lslDelay.sample(newTime);
 
-            meanTime += newTime;
-            times++;
+                meanTime += newTime;
+                times++;
+            }
 
             if (pkt->isRead() && pkt->isWrite()) { // Swap commands are both read and write
                 if (debug::LoadStoreLogSwap) {
@@ -831,7 +1648,7 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
                     // Check write content first
                     if (!compare_data(pkt, id)) {
                         if (debugFlag) {
-                            std::cout << "Different writes at address " << addr << " and time " << mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp << std::endl;
+                            std::cout << "Different writes at address " << addr << " and time " << mainCPUMeta[checkerOwner.at(id)].timestamp << std::endl;
                             std::cout << "    Packet: (" << pkt->req->getSize() << ") [";
                             for (int i=0; i<pkt->req->getSize(); ++i) {
                             std::cout << (uint64_t)pkt->getPtr<uint8_t>()[i] << (i==pkt->req->getSize()-1?"]":", ");
@@ -877,7 +1694,7 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
             if (pkt->isWrite() && !pkt->isRead()) {
               if (!compare_data(pkt, id)) {
                 if (debugFlag) {
-                    std::cout << "Different writes at address " << addr << " and time " << mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp << std::endl;
+                    std::cout << "Different writes at address " << addr << " and time " << mainCPUMeta[checkerOwner.at(id)].timestamp << std::endl;
                     std::cout << "    Packet: (" << pkt->req->getSize() << ") [";
                     for (int i=0; i<pkt->req->getSize(); ++i) {
                     std::cout << (uint64_t)pkt->getPtr<uint8_t>()[i] << (i==pkt->req->getSize()-1?"]":", ");
@@ -913,7 +1730,8 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
 
         bool loadstorelogentry::do_read(PacketPtr pkt, ThreadContext* tc) {
 
-            int size_of_segment = logsize;
+            ShardGuard guard(shardOfCPU(tc->contextId()));
+            int size_of_segment = logentries;
 
             int id = tc->contextId()-NUMBEROFMAINCORES;
             assert(id < NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
@@ -927,13 +1745,14 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
                 checkerCPUMeta.at(id).startingSeqNum + 
                     checkerCPUMeta.at(id).entryIndices);
 
-            int mainCPUID = id/NUMBEROFCHECKERCORESPERCORE;
+            int mainCPUID = checkerOwner.at(id);
 
             mainCPUMeta[mainCPUID].numberOfReads++;
 
             auto minorCPU =
                 dynamic_cast<MinorCPU *>(allCPUMeta[tc->contextId()].baseCPU);
-            if (minorCPU &&
+            // Functional checkers execute with their thread suspended
+            if (minorCPU && !functional &&
                 (allCPUMeta[tc->contextId()]
                          .baseCPU->getContext(0)
                          ->status() == ThreadContext::Status::Suspended ||
@@ -975,6 +1794,11 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
                 checkerCPUMeta.at(id).entryIndices = 
                     pkt->req->getLdStLogSeqNum() - 
                     checkerCPUMeta.at(id).startingSeqNum;
+                if (streamUnit && checkerCPUMeta.at(id).entryIndices >= 0) {
+                    streamUnit->consume(checkerCPUMeta.at(id).stream,
+                        checkerCPUMeta.at(id).entryIndices, curTick(),
+                        allCPUMeta[tc->contextId()].baseCPU->clockPeriod());
+                }
             }
 
             bool accessed = false;
@@ -1086,45 +1910,54 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
 
 
 
-        bool loadstorelogentry::do_write(loadstorelogentry l, int cpuID, bool newline, bool mayMergeMicroop, uint64_t currentCommittedInstructions) {
-            int size_of_segment = logsize;
+        bool loadstorelogentry::do_write(int cpuID, bool newline, bool mayMergeMicroop, uint64_t currentCommittedInstructions) {
+            int size_of_segment = logentries;
             bool merged = false;
 
             assert(cpuID < mainCPUMeta.size());
+            ShardGuard guard(cpuID);
             assert(mainCPUMeta[cpuID].current_entry < size_of_segment);
+            // The entry has already been filled in place by the caller, see nextEntry
+            CheckerCPUMeta& segment = checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill];
+            loadstorelogentry& l = segment.entries[mainCPUMeta[cpuID].current_entry];
             // If writing first entry of the segment, record number of committed instructions
             if (checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].currentCommittedInstructions == 0) {
                 if (currentCommittedInstructions == std::numeric_limits<uint64_t>::max()) {
                     // Reached mainDoCheckpoint without any LSL entry
-                    addToLengthToFirstLSLHisto(checkerCPUMeta.at(mainCPUMeta[cpuID].current_segment_to_fill).committedInstructions);
+                    allCPUMeta[cpuID].baseCPU->lslStats.lengthToFirstLSL.sample(checkerCPUMeta.at(mainCPUMeta[cpuID].current_segment_to_fill).committedInstructions);
                 } else {
-                    addToLengthToFirstLSLHisto(currentCommittedInstructions);
+                    allCPUMeta[cpuID].baseCPU->lslStats.lengthToFirstLSL.sample(currentCommittedInstructions);
                 }
             }
             checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].currentCommittedInstructions = currentCommittedInstructions;
+            if (!l.load && !l.oldData.empty()) {
+                segment.undo.record(l.addr, l.oldData.data(), l.oldData.size(),
+                                    allCPUMeta[cpuID].baseCPU->cacheLineSize());
+            }
             if (mayMergeMicroop && mainCPUMeta[cpuID].current_entry > 0) {
-                loadstorelogentry& last_entry = checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].entries[mainCPUMeta[cpuID].current_entry -1 ];
-                if (debugFlag) std::cerr << "load " << last_entry.load << " " << l.load << ", isSC" << last_entry.isSC << " " << l.isSC << ", PC " << last_entry.pc << "/" << last_entry.microPC << " " << l.pc << "/" << l.microPC << ", Addr " << last_entry.addr << " " << l.addr << ", size " << last_entry.data.size() << " " << l.data.size() << ", name " << last_entry.inst_name << " " << l.inst_name << std::endl;
+                loadstorelogentry& last_entry = segment.entries[mainCPUMeta[cpuID].current_entry -1 ];
+                if (debugFlag) std::cerr << "load " << last_entry.load << " " << l.load << ", isSC" << last_entry.isSC << " " << l.isSC << ", PC " << last_entry.pc << "/" << last_entry.microPC << " " << l.pc << "/" << l.microPC << ", Addr " << last_entry.addr << " " << l.addr << ", size " << last_entry.data.size() << " " << l.data.size() << ", name " << instName(last_entry.instId) << " " << instName(l.instId) << std::endl;
                 if(last_entry.pc == l.pc && last_entry.microPC < l.microPC) {
                     assert(last_entry.load == l.load);
                     assert(last_entry.isSC == l.isSC);
-                    // assert(last_entry.inst_name == l.inst_name); inst_name may differ for micro-ops, using pc to identify the same instruction
+                    // assert(last_entry.instId == l.instId); inst_name may differ for micro-ops, using pc to identify the same instruction
                     assert(last_macro_addrs[mainCPUMeta[cpuID].current_segment_to_fill] == l.addr); // Assumption: micro op load/store accesses consecutive addresses in order
                     last_entry.microPC = l.microPC; // Update microPC for next comparison
                     last_macro_addrs[mainCPUMeta[cpuID].current_segment_to_fill] += l.data.size();
-                    last_entry.data.insert( last_entry.data.end(), l.data.begin(), l.data.end() );
+                    last_entry.data.append(l.data.data(), l.data.size(), &segment.overflow);
                     if (last_entry.oldData.size() > 0 || l.oldData.size() > 0) { // Assumption: oldData is consecutive where existent
-                        last_entry.oldData.insert( last_entry.oldData.end(), l.oldData.begin(), l.oldData.end() );
+                        last_entry.oldData.append(l.oldData.data(), l.oldData.size(), &segment.overflow);
                     }
+                    // The staged entry is reused by the next access
+                    l.valid = false;
                     merged = true;
                 }
             } else {
-                if (debugFlag) std::cerr << "load " << l.load << ", isSC " << l.isSC << ", PC " << l.pc << ", Addr " << l.addr << ", size "  << l.data.size() << ", name " << l.inst_name << std::endl;
+                if (debugFlag) std::cerr << "load " << l.load << ", isSC " << l.isSC << ", PC " << l.pc << ", Addr " << l.addr << ", size "  << l.data.size() << ", name " << instName(l.instId) << std::endl;
             }
             if (!merged) {
                 last_macro_addrs[mainCPUMeta[cpuID].current_segment_to_fill] = l.addr + l.data.size();
 
-                checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].entries[mainCPUMeta[cpuID].current_entry ] = l;
                 if (useHash) {
                     /* calculate hash */
                     auto checkerID = mainCPUMeta[cpuID].current_segment_to_fill;
@@ -1135,7 +1968,51 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
 
                 checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].checkpoint_entries++;
             }
-            if (mainCPUMeta[cpuID].current_segment_to_fill+NUMBEROFMAINCORES < allCPUMeta.size() &&
+            const bool segmentEnd = currentCommittedInstructions ==
+                std::numeric_limits<uint64_t>::max();
+            // Address and size, plus the data unless it is hashed
+            unsigned bits = (merged ? 0 : lslcompressor::rawHeaderBits) +
+                            (useHash ? 0 : 8 * l.data.size());
+            if (compressor) {
+                if (segmentEnd) {
+                    unsigned n = compressor->flush(cpuID);
+                    bits = useHash ? 0 : n;
+                } else {
+                    lslcompressor::bits b = compressor->entry(cpuID, l.addr,
+                        merged, l.data.data(), l.data.size(),
+                        l.oldData.data(), l.oldData.size());
+                    bits = b.header + (useHash ? 0 : b.data);
+                }
+            }
+            if (transport) {
+                int x = mainCPUMeta[cpuID].current_segment_to_fill;
+                transport->push(checkerCPUMeta[x].noc, cpuID,
+                    x % (NUMBEROFMAINCORES * NUMBEROFCHECKERCORESPERCORE),
+                    bits, currentCommittedInstructions, segmentEnd,
+                    curTick());
+            }
+            // A checker blocked on its stream buffer is only woken once
+            // the entry it waits for has arrived
+            bool streamWaiting = false;
+            if (streamUnit) {
+                int x = mainCPUMeta[cpuID].current_segment_to_fill;
+                lslstreamwindow &w = checkerCPUMeta[x].stream;
+                int checkerCPUID = x % (NUMBEROFMAINCORES *
+                    NUMBEROFCHECKERCORESPERCORE) + NUMBEROFMAINCORES;
+                streamWaiting = w.waitFor >= 0 || w.wakeAt != MaxTick;
+                // The last entry may still be merged with the next one
+                Tick ready = streamUnit->append(w,
+                    checkerCPUMeta[x].checkpoint_entries - 1, curTick(),
+                    allCPUMeta[checkerCPUID].baseCPU->clockPeriod());
+                if (ready != MaxTick && x < NUMBEROFMAINCORES *
+                        NUMBEROFCHECKERCORESPERCORE) {
+                    streamWakeup(x, ready);
+                } else if (streamWaiting) {
+                    streamUnit->suppressed();
+                }
+            }
+            if (!streamWaiting &&
+                mainCPUMeta[cpuID].current_segment_to_fill+NUMBEROFMAINCORES < allCPUMeta.size() &&
                 !checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].copyingRegister &&
                 allCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill+NUMBEROFMAINCORES].baseCPU->sleepGuardOn){
                 //std::cout << "Desleepguarding " << current_segment_to_fill[cpuID] << " at " << checkpoint_entries[current_segment_to_fill[cpuID]] << std::endl;
@@ -1145,7 +2022,12 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
                         cpuID,
                         mainCPUMeta[cpuID].current_segment_to_fill +
                             NUMBEROFMAINCORES);
-                allCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill+NUMBEROFMAINCORES].baseCPU->wakeup(0);
+                // Publishing the new entries to the checker, which may be
+                // simulated on another event queue
+                int checkerCPUID = mainCPUMeta[cpuID].current_segment_to_fill+NUMBEROFMAINCORES;
+                handoff(checkerCPUID, [checkerCPUID]() {
+                    allCPUMeta[checkerCPUID].baseCPU->wakeup(0);
+                });
                 if (checkerCPUMeta.at(mainCPUMeta[cpuID]
                     .current_segment_to_fill).checkerStartWakeupTick == 0) 
                 { // First time wakeup
@@ -1171,21 +2053,9 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
                     }
                 }
                 if (!debug::MinorStrictLdStOrder) {
-                    auto O3DcachePort = dynamic_cast<o3::LSQ::DcachePort *>(&(
-                        allCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill +
-                                   NUMBEROFMAINCORES]
-                            .baseCPU->getDataPort()));
-                    auto MinorDcachePort = dynamic_cast<
-                        MinorCPU::MinorCPUPort *>(&(
-                        allCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill +
-                                   NUMBEROFMAINCORES]
-                            .baseCPU->getDataPort()));
-                    if (O3DcachePort) {
-                        O3DcachePort->forceRetry();
-                    } else if (MinorDcachePort) {
-                        MinorDcachePort->forceRetry();
-                    }
-                    assert(O3DcachePort || MinorDcachePort);
+                    handoff(checkerCPUID, [checkerCPUID]() {
+                        forceCheckerRetry(checkerCPUID);
+                    });
                 }
                 checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].activeChecker = true;
             }
@@ -1193,17 +2063,28 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
             //std::cout << "Segment " <<  current_segment_to_fill[cpuID] << " ents " <<  checkpoint_entries[current_segment_to_fill[cpuID]] << std::endl;
             //if (loadstorelogentry::segmentFree[current_segment_to_fill[cpuID]]) std::cout<<"Free!"<<std::endl;
 #if !PARAGLIDER
-            mainCPUMeta[cpuID].current_size+= l.load? 2 : STORESIZE;
+            if (compressor) {
+                // In the 64-bit words current_size counts
+                mainCPUMeta[cpuID].current_size =
+                    divCeil(compressor->logBits(cpuID), 64);
+            } else {
+                mainCPUMeta[cpuID].current_size+= l.load? 2 : STORESIZE;
+            }
 #else
             mainCPUMeta[cpuID].current_size+= l.load? 2 : 2 + newline? 9 : 0; //make conditional based on timestamp.
                         checkerCPUMeta[mainCPUMeta[cpuID].current_segment_to_fill].checkpoint_cachelines+= newline? 1 : 0;
 
 #endif
 
+            // Compressed entries can be far smaller than the 2 words the
+            // size limit assumes, see segmentEntries. Leave the last slot
+            // of entries[] for the blank entry that ends the segment.
+            if (mainCPUMeta[cpuID].current_entry >= logentries-1)
+                return true;
 #if !PARAGLIDER
-            if (mainCPUMeta[cpuID].current_size >= size_of_segment-2 ) { //for maximal size fit.
+            if (mainCPUMeta[cpuID].current_size >= logsize-2 ) { //for maximal size fit.
 #else
-            if (mainCPUMeta[cpuID].current_size >= size_of_segment-10 ) { //for maximal size fit of cacheline plus write.
+            if (mainCPUMeta[cpuID].current_size >= logsize-10 ) { //for maximal size fit of cacheline plus write.
 #endif
                 return true;
             }
@@ -1214,6 +2095,7 @@ void add_cpu(BaseCPU* cpu, int cpuID) {
 bool
 loadstorelogentry::try_read(PacketPtr pkt, ThreadContext *tc)
 {
+    ShardGuard guard(shardOfCPU(tc->contextId()));
     int id = tc->contextId() - NUMBEROFMAINCORES;
     assert(id < NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
     // Current loadstorelog segment has been filled completely or
@@ -1223,6 +2105,19 @@ loadstorelogentry::try_read(PacketPtr pkt, ThreadContext *tc)
         (pkt->req->getLdStLogSeqNum() - checkerCPUMeta.at(id).startingSeqNum +
              1 < // +1 because last entry could be incomplete
          checkerCPUMeta.at(id).checkpoint_entries);
+    int64_t entry =
+        pkt->req->getLdStLogSeqNum() - checkerCPUMeta.at(id).startingSeqNum;
+    // Accesses past the end of a finished segment fail in do_read as before
+    if (streamUnit && entry >= 0 &&
+        (!checkerCPUMeta.at(id).expectedFinalContext.set ||
+         entry + 1 < checkerCPUMeta.at(id).checkpoint_entries)) {
+        Tick ready;
+        should_read = streamUnit->read(checkerCPUMeta.at(id).stream, entry,
+            curTick(), allCPUMeta[tc->contextId()].baseCPU->clockPeriod(),
+            ready);
+        if (ready != MaxTick && !should_read)
+            streamWakeup(id, ready);
+    }
     assert(allCPUMeta[getMainID(tc->contextId())].baseCPU->isSleepGuarded ||
            (!allCPUMeta[getMainID(tc->contextId())].baseCPU->isSleepGuarded &&
             checkerCPUMeta.at(id).expectedFinalContext.set));
@@ -1239,11 +2134,11 @@ void
 loadstorelogentry::CheckerCPUMeta::calcExpectedHash(int current_entry)
 {
     if (current_entry > 0) {
-        auto const latest = entries[current_entry - 1]; // latest entry that just got confirmed that it was completely written
+        auto const &latest = entries[current_entry - 1]; // latest entry that just got confirmed that it was completely written
         int data_size = 0; // load only hashes in address and size, no data
         if (!latest.load) { // either store or swap, need to add in stored data
             if (latest.data.size() > 32) {
-                std::cout << "Large data found, size " << latest.data.size() << "B" << " from inst " << latest.inst_name << std::endl;
+                std::cout << "Large data found, size " << latest.data.size() << "B" << " from inst " << instName(latest.instId) << std::endl;
             } else {
                 // assert(latest.data.size() <= 32); // data size should be below 256 bits
                 if (latest.data.size() > 0) { // atomic swap probably does not have data yet, the write data is difficult to get
@@ -1289,7 +2184,7 @@ loadstorelogentry::CheckerCPUMeta::calcExpectedHash(int current_entry)
 }
 
 void 
-loadstorelogentry::CheckerCPUMeta::calcCheckedHash(loadstorelogentry const l) {
+loadstorelogentry::CheckerCPUMeta::calcCheckedHash(const loadstorelogentry &l) {
     if (last_entry) { // Check if the current commit should merge into the last entry
         // if (last_entry->seqNum == l.seqNum) { // Merging entry
             // assert(last_entry->pc == l.pc);
@@ -1298,11 +2193,11 @@ loadstorelogentry::CheckerCPUMeta::calcCheckedHash(loadstorelogentry const l) {
             assert(last_entry->load == l.load);
             assert(last_entry->isSC == l.isSC);
             if (last_entry->addr + last_entry->data.size() != l.addr) {
-                std::cerr << "Last addr " << std::hex << last_entry->addr << " + size " << std::dec << last_entry->data.size() << " (" << std::hex << last_entry->addr + last_entry->data.size() << ") not equal to current addr " << l.addr << " insts " << last_entry->inst_name << ", " << l.inst_name << ", load " << l.load << std::endl;
+                std::cerr << "Last addr " << std::hex << last_entry->addr << " + size " << std::dec << last_entry->data.size() << " (" << std::hex << last_entry->addr + last_entry->data.size() << ") not equal to current addr " << l.addr << " insts " << instName(last_entry->instId) << ", " << instName(l.instId) << ", load " << l.load << std::endl;
             }
             assert(last_entry->addr + last_entry->data.size() == l.addr);
             // last_entry->microPC = l.microPC; // microPC not accessible on minor
-            last_entry->data.insert( last_entry->data.end(), l.data.begin(), l.data.end() );
+            last_entry->data.append(l.data.data(), l.data.size(), &checkedOverflow);
         } else { // Not merging entries, load last_entry into hash_chunk
             assert(last_entry->valid);
             int data_size = 0; // load only hashes in address and size, no data
@@ -1341,7 +2236,7 @@ loadstorelogentry::CheckerCPUMeta::calcCheckedHash(loadstorelogentry const l) {
             *last_entry = l;
         }
     } else { // Allocate a new last_entry (Should only happen on a new checkpoint)
-        last_entry = new loadstorelogentry();
+        last_entry.reset(new loadstorelogentry());
         // Copy the incoming loadstorelogentry to last_entry
         *last_entry = l;
     }
@@ -1355,93 +2250,21 @@ loadstorelogentry::CheckerCPUMeta::calcCheckedHash(loadstorelogentry const l) {
         hash_chunk[hash_chunk_index] = hash_chunk[hash_chunk_index] << 63;
         hash_chunk[7] = hash_message_size;
         calcHash(hash); // calculate for the final chunk
-        delete last_entry;
-        last_entry = nullptr;
+        last_entry.reset();
+        checkedOverflow.reset();
     } 
 }
 
 void 
 loadstorelogentry::CheckerCPUMeta::calcHash(std::array<uint64_t, 8>& in_hash) {
-    uint64_t mask = 0x0FFFFFFFF; // mask for lower 32 bits
-    // copied from pseudo code for each chunk from https://en.wikipedia.org/wiki/SHA-2#Implementations
-    // copy chunk into first 16 words w[0..15] of the message schedule array
-
-    // if (&in_hash == &hash) {
-    //     for (auto i : hash_chunk) {
-    //         std::cerr << std::hex << i << ",";
-    //     }
-    //     std::cerr << std::endl;
-    // } else {
-    //     for (auto i : expectedHash_chunk) {
-    //         std::cout << std::hex << i << ",";
-    //     }
-    //     std::cout << std::endl;
-    // }
-
-    std::array<uint64_t, 64> w;
-    for (int i = 0; i < 16; ++i) {
-        if (&in_hash == &hash) {
-            w[i] = (i%2 == 1)? (hash_chunk[i/2] & mask) : // lower 32 bits 
-                               (hash_chunk[i/2] >> 32); // higher 32 bits
-        } else {
-            w[i] = (i%2 == 1)? (expectedHash_chunk[i/2] & mask) : // lower 32 bits 
-                               (expectedHash_chunk[i/2] >> 32); // higher 32 bits
-        }
-    }
-    // Extend the first 16 words into the remaining 48 words w[16..63] of the message schedule array:
-    for (int i = 16; i < 64; ++i) {
-        uint64_t s0 = ((((w[i-15] << 32) | w[i-15]) >> 7) & mask) ^ // (w[i-15] rightrotate  7) xor
-                      ((((w[i-15] << 32) | w[i-15]) >> 18) & mask) ^ // (w[i-15] rightrotate 18) xor 
-                      (w[i-15] >> 3); // (w[i-15] rightshift  3)
-        uint64_t s1 = ((((w[i-2] << 32) | w[i-2]) >> 17) & mask) ^ // (w[i-2] rightrotate 17) xor 
-                      ((((w[i-2] << 32) | w[i-2]) >> 19) & mask) ^ // (w[i-2] rightrotate 19) xor
-                      (w[i-2] >> 10); // (w[i-2] rightshift 10)
-        w[i] = (w[i-16] + s0 + w[i-7] + s1) & mask;
-    }
-    // Initialize working variables to current hash value:
-    uint64_t a = in_hash[0];
-    uint64_t b = in_hash[1];
-    uint64_t c = in_hash[2];
-    uint64_t d = in_hash[3];
-    uint64_t e = in_hash[4];
-    uint64_t f = in_hash[5];
-    uint64_t g = in_hash[6];
-    uint64_t h = in_hash[7];
-    for (int i = 0; i < 64; ++i) {
-        uint64_t S1 = ((((e << 32) | e) >> 6) & mask) ^ // (e rightrotate 6) xor 
-                      ((((e << 32) | e) >> 11) & mask) ^ // (e rightrotate 11) xor 
-                      ((((e << 32) | e) >> 25) & mask); // (e rightrotate 25)
-        uint64_t ch = (e & f) ^ ((~e & mask) & g); // (e and f) xor ((not e) and g)
-        uint64_t temp1 = (h + S1 + ch + hash_k[i] + w[i]) & mask;
-        uint64_t S0 = ((((a << 32) | a) >> 2) & mask) ^ // (a rightrotate 2) xor 
-                      ((((a << 32) | a) >> 13) & mask) ^ // (a rightrotate 13) xor 
-                      ((((a << 32) | a) >> 22) & mask); // (a rightrotate 22)
-        uint64_t maj = (a & b) ^ (a & c) ^ (b & c); // (a and b) xor (a and c) xor (b and c)
-        uint64_t temp2 = (S0 + maj) & mask;
-        h = g;
-        g = f;
-        f = e;
-        e = (d + temp1) & mask;
-        d = c;
-        c = b;
-        b = a;
-        a = (temp1 + temp2) & mask;
-    }
-    in_hash[0] = (in_hash[0] + a) & mask;
-    in_hash[1] = (in_hash[1] + b) & mask;
-    in_hash[2] = (in_hash[2] + c) & mask;
-    in_hash[3] = (in_hash[3] + d) & mask;
-    in_hash[4] = (in_hash[4] + e) & mask;
-    in_hash[5] = (in_hash[5] + f) & mask;
-    in_hash[6] = (in_hash[6] + g) & mask;
-    in_hash[7] = (in_hash[7] + h) & mask;
-    // Reset hash_chunk for the next chunck
+    // Absorb the current chunk, then reset it for the next one
     if (&in_hash == &hash) {
+        digestEngine->compress(hash, hash_chunk);
+        hashBlocks++;
         initHashCalc();
-        // std::cerr << "checker chunk of size " << hash_message_size << std::endl;
     } else {
+        digestEngine->compress(expectedHash, expectedHash_chunk);
         initExpectedHashCalc();
-        // std::cout << "main chunk of size " << expectedHash_message_size << std::endl;
     }
 }
 
@@ -1461,11 +2284,42 @@ void
 loadstorelogentry::CheckerCPUMeta::initHash() {
     // std::cout << "init hash" << std::endl;
     // std::cerr << "init hash" << std::endl;
-    expectedHash = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
-    hash = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    digestEngine->init(expectedHash);
+    digestEngine->init(hash);
+    hashBlocks = 0;
     hash_message_size = 0;
     expectedHash_message_size = 0;
     initExpectedHashCalc();
     initHashCalc();
 }
+
+void
+loadstorelogentry::CheckerCPUMeta::restartCheck()
+{
+    entryIndices = 0;
+    interrupted = false;
+    activeChecker = false;
+    dataAddressOffset = 0;
+    midopEntryIndex = 0;
+    checkerStartWakeupTick = 0;
+    checkerStartFetchTick = 0;
+    checkerStartFetchAccCompleteTick = 0;
+    checkerStartCommitTick = 0;
+    checkerLastCommitTick = 0;
+    expectedFinalContext.checked = false;
+    // The entries are fetched again into the new checker's stream buffer
+    std::fill(stream.arrival.begin(), stream.arrival.end(), MaxTick);
+    stream.head = 0;
+    stream.waitFor = -1;
+    stream.wakeAt = MaxTick;
+    // Only the checker's side of the digest starts over
+    if (useHash) {
+        digestEngine->init(hash);
+        hashBlocks = 0;
+        hash_message_size = 0;
+        initHashCalc();
+        last_entry.reset();
+        checkedOverflow.reset();
+    }
+}
 }
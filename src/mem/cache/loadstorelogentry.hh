@@ -7,20 +7,44 @@
 #define __LOADSTORELOGENTRY_HH__
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "arch/isa.hh"
 #include "cpu/base.hh"
+#include "cpu/dirty_regs.hh"
 #include "cpu/minor/cpu.hh"
 #include "cpu/o3/regfile.hh"
 #include "cpu/thread_context.hh"
 #include "mem/cache/base.hh"
+#include "mem/cache/checkervote.hh"
+#include "mem/cache/coveragemap.hh"
+#include "mem/cache/cptpolicy.hh"
+#include "mem/cache/functionalchecker.hh"
+#include "mem/cache/loadstorelogdata.hh"
+#include "mem/cache/lslcompressor.hh"
+#include "mem/cache/lslstreambuffer.hh"
+#include "mem/cache/lsltransport.hh"
+#include "mem/cache/samplepolicy.hh"
+#include "mem/cache/segmentdigest.hh"
+#include "mem/cache/segmentring.hh"
+#include "mem/cache/stealpolicy.hh"
+#include "mem/cache/undolog.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
+#include "sim/eventq.hh"
 
 #define logsize (loadstorelogentry::lslSize) // 4096 for paraverser, 384 for paradox size
+#define logentries (loadstorelogentry::segmentEntries())
 #define TIMEOUT (loadstorelogentry::cptTimeout) // 5000 for paraverser, static timeout or initial and max timeout with AIMD
 #define AIMD (loadstorelogentry::timeoutAIMD) // true for additive increase multiplicative decrease auto adjustment of dynamic timeout
 #define STORESIZE loadstorelogentry::actualstoresize  //3 for recovery.
@@ -37,12 +61,6 @@
 #define SIZEOFLOCKEDMEMSEGMENT 100
 #define LOCKEDMEMLOGSIZE (NUMBEROFCHECKERCORESPERCORE*SIZEOFLOCKEDMEMSEGMENT)
 
-#define NUMBEROFHISTOENTRIES 500
-
-#define NUMBEROFAIMDHISTOENTRIES ((TIMEOUT/10))
-
-#define BIGBUCKETLIMIT 20480000
-
 #ifndef PARAGLIDER
 #define PARAGLIDER 0
 #define PARADVFS 0
@@ -72,39 +90,6 @@ struct lockAddressBufferEntry
     lockAddressBufferEntry() : requestPC(0), address(0), visited(true) {}
 };
 
-struct histoEntry
-{
-    uint64_t number;
-    uint64_t mean;
-    uint64_t minimum;
-    uint64_t maximum;
-
-    void add_entry(uint64_t time) {
-        mean += time;
-        number++;
-
-        if (time<minimum) minimum = time;
-        if (time>maximum) maximum = time;
-
-    }
-
-    static histoEntry merge (histoEntry entry1, histoEntry entry2) {
-        histoEntry nh;
-        nh.number = entry1.number + entry2.number;
-        nh.maximum = (entry2.maximum > entry1.maximum) ? entry2.maximum : entry1.maximum;
-        nh.minimum = (entry2.minimum > entry1.minimum) ? entry1.minimum : entry2.minimum;
-        nh.mean = entry1.mean + entry2.mean;
-
-        return nh;
-    }
-
-    histoEntry() {
-        number = mean = maximum = 0;
-        minimum = (uint64_t)-1;
-    }
-};
-
-
 struct miniContext
 {
 
@@ -126,6 +111,12 @@ struct miniContext
     bool checked;
     bool set;
 
+    /* Set by m_serialize on contexts that track dirty registers: the
+     * context it was taken on and its number among that context's
+     * snapshots. owner is -1 for a snapshot with no such identity. */
+    ContextID owner = -1;
+    uint64_t seq = 0;
+
     miniContext() : vecRegs(NumVecRegs * NumVecElemPerVecReg), intRegs(int_reg::NumRegs), ccRegs(cc_reg::NumRegs),miscRegs(NUM_MISCREGS), vc(NumVecRegs,TheISA::VecRegContainer()){
         initialized = false;
         checked = true;
@@ -137,11 +128,55 @@ struct miniContext
 
 };
 
+/* Snapshot, compare against and restore architectural state. For thread
+ * contexts that track dirty registers, each context keeps a shadow
+ * snapshot in allCPUMeta that is brought up to date by re-reading only the
+ * registers written since the previous call, so the ThreadContext is only
+ * consulted O(dirty registers) times. Snapshots also remember which
+ * registers changed since the previous snapshot of the same context, so
+ * comparing against or copying a snapshot onto a context that last held
+ * an earlier one only visits the registers either of them wrote since. */
 miniContext m_serialize(ThreadContext *tc);
 
-bool m_identical(ThreadContext *tc, miniContext m);
+bool m_identical(ThreadContext *tc, const miniContext &m);
 
-void m_copyRegs(ThreadContext *tc, miniContext m);
+void m_copyRegs(ThreadContext *tc, const miniContext &m);
+
+/* The registers one context wrote between m_deltaBegin and m_deltaEnd, with
+ * their old and new values, so the same update can be checked against and
+ * replayed onto another context without copying whole miniContexts. */
+struct regDelta
+{
+    struct reg
+    {
+        RegClassType cls;
+        RegIndex idx;
+        RegVal before;
+        RegVal after;
+    };
+
+    struct vecReg
+    {
+        RegIndex idx;
+        TheISA::VecRegContainer before;
+        TheISA::VecRegContainer after;
+        std::vector<RegVal> elems;
+    };
+
+    std::vector<reg> regs;
+    std::vector<vecReg> vecs;
+
+    TheISA::PCState pcState;
+    RegVal CPSR;
+};
+
+void m_deltaBegin(ThreadContext *tc);
+
+regDelta m_deltaEnd(ThreadContext *tc);
+
+/* Returns false, leaving tc untouched, if tc didn't hold the before values,
+ * i.e. it had already diverged from the context the delta was taken on. */
+bool m_applyDelta(ThreadContext *tc, const regDelta &d);
 
 
 namespace errordetection {
@@ -149,12 +184,13 @@ namespace errordetection {
     void detectError(int id);
     void detectErrorCommit(int id);
 
-    extern uint64_t numberOfDetectedErroneousWrites;
-        extern uint64_t numberOfDetectedErroneousReads;
-        extern uint64_t numberOfDetectedErroneousArchStates;
-        extern uint64_t numberOfCorrectCheckpoints;
+    extern std::atomic<uint64_t> numberOfDetectedErroneousWrites;
+        extern std::atomic<uint64_t> numberOfDetectedErroneousReads;
+        extern std::atomic<uint64_t> numberOfDetectedErroneousArchStates;
+        extern std::atomic<uint64_t> numberOfCorrectCheckpoints;
 #if LOGERRORS
         extern std::vector<uint64_t> memoryRecoveryTime;
+        extern std::vector<uint64_t> memoryRecoveryCycles;
         extern std::vector<uint64_t> voltageSwitchTime;
         extern std::vector<double> voltageSwitchPoints;
 
@@ -164,13 +200,16 @@ namespace errordetection {
 
         extern uint64_t min_memory_recoveries;
         extern uint64_t max_memory_recoveries;
+        // Modeled cycles to restore memory, see undolog::recoveryCycles
+        extern uint64_t total_memory_recovery_cycles;
+        extern uint64_t min_memory_recovery_cycles;
+        extern uint64_t max_memory_recovery_cycles;
 
         extern uint64_t total_rollback_recovery;
 
         extern uint64_t min_rollback_recovery;
         extern uint64_t max_rollback_recovery;
 
-        extern std::vector<bool> voltage_reset;//[NUMBEROFMAINCORES];
 }
 
 
@@ -183,6 +222,30 @@ class loadstorelogentry
     struct AllCPUMeta
     {
             BaseCPU* baseCPU;
+            // Architectural state as of the last m_serialize/m_identical/
+            // m_copyRegs on this core, see m_sync
+            miniContext shadow;
+
+            // Registers one snapshot of this core changed since the one
+            // before, unknown after anything but a plain m_sync
+            struct ExportRecord
+            {
+                bool known;
+                std::vector<RegId> changed;
+            };
+            // The last exportHistory snapshots taken, oldest first
+            static const int exportHistory = 32;
+            std::deque<ExportRecord> history;
+            uint64_t exports = 0;
+
+            // The snapshot (baseOwner, baseSeq) this core last held
+            // exactly, and the registers it may have changed since. With
+            // the history of baseOwner this bounds which registers a
+            // compare or copy against a later snapshot of it must visit.
+            ContextID baseOwner = -1;
+            uint64_t baseSeq = 0;
+            DirtyRegs drift;
+            DirtyRegs candidates;
     };
     
     struct MainCPUMeta
@@ -191,7 +254,6 @@ class loadstorelogentry
         int current_segment_to_fill;//[NUMBEROFMAINCORES];
         int current_entry = 0;//[NUMBEROFMAINCORES];
         int current_size = 0;//[NUMBEROFMAINCORES];
-	bool waiting_to_checkpoint = false;//[NUMBEROFMAINCORES];
 	bool ready = false;//[NUMBEROFMAINCORES];
         uint64_t timestamp = 1;//[NUMBEROFMAINCORES];
         uint64_t committed_timestamp = 0;//[NUMBEROFMAINCORES];
@@ -253,14 +315,13 @@ class loadstorelogentry
         // the value for the previous checkpoint segment before the first wake 
         // up, then reset to 0
         uint64_t checkerDrainDoneTick = 0; // Set with first signalDrainDone
-        bool segmentFree = true;
-        bool readyToCommit = false;
+        /* Where this segment is in its main core's segmentring */
+        segmentslot segment;
         bool interrupted = false;
         bool erroneous = false;
         
         bool copyingRegister = false; // Whether the checker core is switching to a checkpoint already stored in the extra slots 
         bool activeChecker = false;//[NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE];
-        bool aboutToValidate = false;//[NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE];
         bool hasSyscall = false;//[NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE];
         uint64_t checkpoint_cachelines = 0;//[NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE];
         uint64_t checkpoint_entries = 0;//[NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE];
@@ -277,6 +338,17 @@ class loadstorelogentry
         miniContext expectedFinalContext= miniContext();
         
         std::vector<loadstorelogentry> entries;
+        /* Backing store for entry data that does not fit inline, rewound
+         * every time the segment is allocated to a new checkpoint */
+        lslslab overflow;
+        /* What the segment's stores overwrote, for mainCPURollback */
+        undolog undo;
+        /* Entries on their way to the checker with --lslNoC */
+        lslstream noc;
+        /* Entries in the checker's stream buffer with --lslStreamDepth */
+        lslstreamwindow stream;
+        /* How its checkers voted with --checkerVoters */
+        segmentvote vote;
         
          /* When the data size requested by the checker is different from that
          * logged, it means an instruction from the main core has been split
@@ -299,23 +371,21 @@ class loadstorelogentry
         /* Index for the next 8-byte word to fill in the chunk of data used for next iteration of hash */
         uint64_t expectedHash_chunk_index = 0;
         uint64_t hash_chunk_index = 0;
-        /* Constants used in the SHA-256 hash */
-        std::array<uint64_t,64> hash_k = {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+        /* Blocks absorbed into hash during the current segment, used to
+         * charge the checker for the digest (segmentdigest::exposedCycles) */
+        uint64_t hashBlocks = 0;
+        /* Tick the digest unit finishes the segment, the checkpoint is not
+         * committed before it */
+        Tick digestDoneTick = 0;
         /* Temporary entry used for the checker to merge micro-ops */
-        loadstorelogentry * last_entry = nullptr;
+        std::unique_ptr<loadstorelogentry> last_entry;
+        /* Backing store for checker-side entries that do not fit inline */
+        lslslab checkedOverflow;
         /* The total size of the hashed message in number of bits */
         int expectedHash_message_size = 0;
         int hash_message_size = 0;
         
-        CheckerCPUMeta() : entries(logsize) {}
+        CheckerCPUMeta() : entries(logentries) {}
         /** Calculate the expected hash from the main core execution
          *  Input is the index to LSL entry that is being written
          */
@@ -323,7 +393,7 @@ class loadstorelogentry
         /** Calculate the hash from the checker core execution
          *  Input is the content of the committed instruction in form of loadstorelog entry
         */
-        void calcCheckedHash(loadstorelogentry l);
+        void calcCheckedHash(const loadstorelogentry &l);
         /** Calculate the hash
          *  Input is either the "expectedHash" for main core execution, or 
          *  "hash" for the checker core execution
@@ -339,6 +409,10 @@ class loadstorelogentry
         void initHashCalc();
         /** Initialize all hash structures, prepare for next segment of hash */
         void initHash();
+        /** Forget how far the last checker got through the segment, so
+         *  that another checker can execute it again from the start
+         */
+        void restartCheck();
         
     };
     
@@ -348,11 +422,69 @@ class loadstorelogentry
         // Keep track of the end address of the last access in a macro op
         // Next micro op access should start at this address if accesses are consecutive
         static std::vector<Addr> last_macro_addrs; 
-        static std::vector<std::map<std::string, std::array<int,2>>> mainStaticInstsChecked;
-        static std::vector<std::map<uint64_t, std::array<int,2>>> mainPCsChecked;
-        static std::map<uint64_t, std::string> mainPCStaticInstsMap;
+        static std::vector<instcoverage> mainStaticInstsChecked;
+        static std::vector<pccoverage> mainPCsChecked;
         
-        static std::vector<uint64_t> blocked_lines;//[513];  //number of l1 cache lines + 1
+        static bool blockedLinesTracked; //set once a blocking L1 registers itself
+        // Blocking L1 of each main core, by cpu_id
+        static std::map<int, BaseCache *> blockingL1s;
+
+        /* With several event queues (sim_quantum) main and checker cores may
+         * be simulated on different host threads. The state of a main core
+         * together with the segments, syscall log and error flags of its
+         * checkers forms a shard with its own lock. State shared by all
+         * shards (delay totals, interned names, error detection totals) is
+         * guarded by globalLock, which is never held while taking a shard
+         * lock. Neither lock is taken in the default single queue mode. */
+        static std::vector<std::unique_ptr<std::recursive_mutex>> shardLocks;
+        static std::recursive_mutex globalLock;
+
+        class ShardGuard
+        {
+            std::recursive_mutex *lock;
+
+          public:
+            explicit ShardGuard(int mainCPUID)
+                : lock(inParallelMode ? shardLocks.at(mainCPUID).get() : nullptr)
+            {
+                if (lock)
+                    lock->lock();
+            }
+            ~ShardGuard() { if (lock) lock->unlock(); }
+            ShardGuard(const ShardGuard &) = delete;
+            ShardGuard &operator=(const ShardGuard &) = delete;
+        };
+
+        class GlobalGuard
+        {
+            bool locked;
+
+          public:
+            GlobalGuard() : locked(inParallelMode)
+            {
+                if (locked)
+                    globalLock.lock();
+            }
+            ~GlobalGuard() { if (locked) globalLock.unlock(); }
+            GlobalGuard(const GlobalGuard &) = delete;
+            GlobalGuard &operator=(const GlobalGuard &) = delete;
+        };
+
+        /* Shard owning a core (main or checker context id) */
+        static int shardOfCPU(int cpuID);
+        /* Shard owning a loadstorelog segment, extra slots included */
+        static int shardOfSegment(int segment);
+        /* Run fn on behalf of core cpuID, no earlier than when. In the
+         * single queue mode this happens immediately if when has passed.
+         * Otherwise fn is handed over to the event queue of that core and
+         * runs there under its shard lock, at least one sim_quantum later
+         * if the queue belongs to another host thread. */
+        static void handoff(int cpuID, std::function<void()> fn,
+                            Tick when = 0);
+        /* Segment ring of a main core, and of the main core owning a
+         * loadstorelog segment */
+        static segmentring &ring(int mainCPUID) { return *segmentRings[mainCPUID]; }
+        static segmentring &ringOfSegment(int segment) { return ring(shardOfSegment(segment)); }
 private:
         static int actualnumberofcheckercores;
 public:
@@ -362,273 +494,231 @@ public:
 
         static bool timeoutAIMD;
         static int cptTimeout;
+        /* --cptPolicy, and one instance of it per main core */
+        static std::string cptPolicyName;
+        static std::vector<std::unique_ptr<cptlengthpolicy>> cptPolicies;
         static int lslSize;
         static bool minorCommitBypass;
         static int num_checkSlot_per_checker;
         static bool useHash;
+        /* Digest used by --hashed, and what it cost the checkers */
+        static std::unique_ptr<segmentdigest> digestEngine;
+        static std::atomic<uint64_t> hashBlocksTotal;
+        static std::atomic<uint64_t> hashExposedCycles;
+        static std::vector<std::unique_ptr<segmentring>> segmentRings;
+        /* --lslNoC, null when entries reach the checker immediately */
+        static std::unique_ptr<lsltransport> transport;
+        /* --lslCompressor, null when entries are logged uncompressed */
+        static std::unique_ptr<lslcompressor> compressor;
+        /* --lslStreamDepth, null when checker loads read the log directly */
+        static std::unique_ptr<lslstreambuffer> streamUnit;
+        /* --samplePolicy, null for periodic sampling */
+        static std::unique_ptr<samplepolicy> sampler;
+        /* --checkerVoters, null when a single checker decides */
+        static std::unique_ptr<checkervote> voting;
+        /* --functionalCheckers, null when checkers run their Minor pipeline */
+        static std::unique_ptr<functionalchecker> functional;
+        /* --checkerPool=shared lets a main core with no free slot take over
+         * an idle checker of another one, picked by stealPool (null with
+         * the default static pool). checkerOwner is the main core each
+         * checker core (index into the first NUMBEROFMAINCORES *
+         * NUMBEROFCHECKERCORESPERCORE checkerCPUMeta) is checking for, and
+         * ownedCheckers the checker cores of each main core in the order
+         * they were acquired. Both only change while the checker is idle
+         * and suspended, under the shard locks of both main cores. */
+        static std::unique_ptr<stealpolicy> stealPool;
+        static std::vector<int> checkerOwner;
+        static std::vector<std::vector<int>> ownedCheckers;
+        // Interned instruction id of "dc zva"
+        static uint32_t dcZvaInstId;
         
         static int numCheckers() {
          return actualnumberofcheckercores;
         }
+
+        /* lslSize bounds a segment in 64-bit words, which is also its
+         * entry count uncompressed, as an entry takes at least two. A
+         * compressed entry can take as little as 7 bits, so entries[] is
+         * then only a hard limit, sized for 16 bits per entry. */
+        static const int compressedEntriesPerWord = 4;
+        static int segmentEntries() {
+            return compressor ? logsize * compressedEntriesPerWord : logsize;
+        }
+        /* Resize every checker's entries[] to segmentEntries() */
+        static void sizeSegments();
     
     	static void initCoreCount(int mains, int checkers, int extra_slot_per_checker, bool hashed, std::vector<double> errRates);
-        static void initTimeout(bool AIMDoff, int in_cptTimeout, int in_lslSize);
+        static void initTimeout(bool AIMDoff, int in_cptTimeout, int in_lslSize,
+                                const std::string &in_cptPolicy);
+        /* Change cptTimeout and lslSize of an instantiated system that has
+         * not filled a segment yet, for a --forkSweep child */
+        static void retune(int in_cptTimeout, int in_lslSize);
         static void initMinorCommitBypass(bool in_minorCommitBypass);
-    	static void initCacheSets(int l1sets);
+        static void initHashEngine(const std::string &engine, int latency);
+        static void initCheckerPool(const std::string &pool,
+                                    const std::string &policy);
+        static void initSegmentRings(statistics::Group *parent);
+        static void initTransport(statistics::Group *parent,
+                                  const std::string &topology,
+                                  const lsltransport::config &cfg);
+        static void initCompressor(statistics::Group *parent,
+                                   compression::Base *dataCompressor,
+                                   unsigned blkSize);
+        static void initStreamBuffer(statistics::Group *parent,
+                                     unsigned depth, Cycles latency);
+        static void initSampler(statistics::Group *parent,
+                                const std::string &policy,
+                                const samplepolicy::config &cfg);
+        static void initVoting(statistics::Group *parent, unsigned voters);
+        static void initFunctionalCheckers(statistics::Group *parent,
+                                           bool enable, double ipc,
+                                           Cycles wakeup);
+        /* Functional checkers stand in for the Minor pipeline only, so
+         * fail if checker cpu is another model. Called from BaseCPU::init,
+         * once the CPUs exist */
+        static void checkFunctionalChecker(BaseCPU *cpu);
+        /* Instructions the checker of checkerCPUMeta[checker] may commit:
+         * those covered by the entries that have reached it */
+        static uint64_t
+        checkerCommitBound(int checker)
+        {
+            if (!transport)
+                return checkerCPUMeta[checker].currentCommittedInstructions;
+            return deliveredCommitBound(checker);
+        }
+        static uint64_t deliveredCommitBound(int checker);
+    	static void initCacheSets(int l1sets, int cpuID, BaseCache *l1);
         bool load;
         bool isSC;
+        bool valid;
+        // Interned instruction name, see internInstName
+        uint32_t instId;
         Addr addr;
-        std::vector<uint8_t> data;
-        std::vector<uint8_t> oldData;
+        lsldata data;
+        lsldata oldData;
         uint64_t flags;
         uint64_t extra_data;
-        bool valid;
         uint64_t time;
         uint64_t pc;
         uint64_t microPC;
-        std::string inst_name;
         // Unique sequence number for each macro-op accessing the loadstorelog,
         // -1 is invalid
         int64_t seqNum;
 
-        static std::vector<histoEntry> histoEntries;
-        static histoEntry bigBucket;
-
-        static uint64_t maxHistoSize;
-        // Histogram for checkpoint length in ticks
-        static std::vector<histoEntry> cptLenHistoEntries;
-        static histoEntry cptLenBigBucket;
-        static uint64_t cptLenMaxHistoSize;
-        // Histogram for checker checkpoint length in cycles
-        static std::vector<histoEntry> checkerCptLenHistoEntries;
-        static histoEntry checkerCptLenBigBucket;
-        static uint64_t checkerCptLenMaxHistoSize;
-        // Histogram for checkpoints' first fetch to commit delay in cycles
-        static std::vector<histoEntry> cptFirstFetchToCommitDelayHistoEntries;
-        static histoEntry cptFirstFetchToCommitDelayBigBucket;
-        static uint64_t cptFirstFetchToCommitDelayMaxHistoSize;
-
-        static std::vector<uint64_t> aimdHistoentries;
-        // Histogram of the checkpoint size in number of committed instructions
-        static std::vector<uint64_t> cptLengthHistoentries;
-        // Histogram of number of committed instructions before the first LSL
-        // entry in each checkpointing segment
-        static std::vector<uint64_t> lengthToFirstLSLHistoentries;
-        // Histogram of number of committed instructions after the last LSL 
-        // entry in each checkpointing segment
-        static std::vector<uint64_t> lengthFromLastLSLHistoentries;
+        /* Instruction names are interned once so that entries stay
+         * trivially copyable. Lookups on the hot path are keyed by the
+         * StaticInst mnemonic pointer and only fall back to a string lookup
+         * the first time a mnemonic is seen. */
+        static std::unordered_map<const char *, uint32_t> instIdsByMnemonic;
+        static std::unordered_map<std::string, uint32_t> instIdsByName;
+        static std::vector<std::string> instNames;
+        static uint32_t internInstName(const char *mnemonic);
+        static uint32_t internInstName(const std::string &name);
+        static const std::string &
+        instName(uint32_t id)
+        {
+            assert(id < instNames.size());
+            return instNames[id];
+        }
+
         
+        // Accumulators below are updated by main and checker cores alike,
+        // meanTime to times are only touched under GlobalGuard
         static uint64_t meanTime;
         static uint64_t maxTime;
         static uint64_t minTime;
         static uint64_t times;
-        static uint64_t totalCommittedInstructions;
-        static uint64_t checkedCommittedInstructions;
+        static std::atomic<uint64_t> totalCommittedInstructions;
+        static std::atomic<uint64_t> checkedCommittedInstructions;
         // The number of instructions main core committed when the checker core
         // starts to check
-        static uint64_t checkStartDelayInstructions;
+        static std::atomic<uint64_t> checkStartDelayInstructions;
         // The number of instructions on checker cores that still needs to be 
         // checked when the main core sets the final context
-        static uint64_t checkDelayCommittedInstructions;
+        static std::atomic<uint64_t> checkDelayCommittedInstructions;
         // The number of ticks between the main starting to fill the new 
         // segement and the checker first wakes up in the new segment
-        static uint64_t cptStartDelayTicks;
+        static std::atomic<uint64_t> cptStartDelayTicks;
         // The number of ticks between the main starting to fill the new 
         // segement and the main core takes the checkpoint
-        static uint64_t cptLenTicks;
+        static std::atomic<uint64_t> cptLenTicks;
+        // Checkpoints taken by all main cores, the per-checkpoint averages
+        // above are over this
+        static std::atomic<uint64_t> numCpts;
         // The number of ticks between the checker first wakes up in the new 
         // segement and the checker starting to fetch new instructions
-        static uint64_t cptCheckerStartToFetchDelayTicks;
+        static std::atomic<uint64_t> cptCheckerStartToFetchDelayTicks;
         // The number of ticks between the checker starting to fetch new 
         // instructions and the checker finishes icache access in fetch
-        static uint64_t cptCheckerFirstFetchTransAccDelayTicks;
+        static std::atomic<uint64_t> cptCheckerFirstFetchTransAccDelayTicks;
         // The number of ticks between the checker starting to fetch new 
         // instructions and the checker starting to commit new instructions
-        static uint64_t cptCheckerFirstFetchToCommitDelayTicks;
+        static std::atomic<uint64_t> cptCheckerFirstFetchToCommitDelayTicks;
         // The number of ticks between the checker first wakes up in the new 
         // segement and the checker starting to commit new instructions
-        static uint64_t cptCheckerStartToCommitDelayTicks;
+        static std::atomic<uint64_t> cptCheckerStartToCommitDelayTicks;
         // The number of ticks between the checker starting to commit new 
         // instructions and the checker commits the last instruction
-        static uint64_t cptCheckerFirstToLastCommitDelayTicks;
+        static std::atomic<uint64_t> cptCheckerFirstToLastCommitDelayTicks;
         // The number of ticks between the checker commits the last instruction
         // and the checker finishes draining
-        static uint64_t cptCheckerLastCommitToDrainDoneDelayTicks;
+        static std::atomic<uint64_t> cptCheckerLastCommitToDrainDoneDelayTicks;
         // The number of ticks between the checker finishes draining and
         // starting to check on the next segment (idle waiting for work)
-        static uint64_t cptCheckerDrainDoneToStartDelayTicks;
+        static std::atomic<uint64_t> cptCheckerDrainDoneToStartDelayTicks;
         // The number of cycles that the main core stalls due to taking a 
         // checkpoint
-        static uint64_t checkpointingCycles;
+        static std::atomic<uint64_t> checkpointingCycles;
         // The number of cycles that the main core stalls due to no checker 
         // core available
-        static uint64_t noCheckerCycles;
+        static std::atomic<uint64_t> noCheckerCycles;
         // The number of cycles that the main core stalls due to dirty data 
         // eviction from L1 data cache
-        static uint64_t blockingWaitCycles;
+        static std::atomic<uint64_t> blockingWaitCycles;
 
         static bool debugFlag;
 
-        static void printHisto(std::ofstream * outfile, 
-            uint64_t& maxHistoSize = loadstorelogentry::maxHistoSize, 
-            std::vector<histoEntry>& histoEntries = loadstorelogentry::histoEntries, 
-            histoEntry& bigBucket = loadstorelogentry::bigBucket) {
-            std::cout << "size : number : min : max : mean" << std::endl;
-            *outfile << "size : number : min : max : mean" << std::endl;
-            for (int x=0; x<NUMBEROFHISTOENTRIES; x++) {
-                histoEntry h = histoEntries[x];
-                std::cout << (x*maxHistoSize) / NUMBEROFHISTOENTRIES << " : " << h.number << " : " << ((h.minimum == (uint64_t) -1)? 0ul : h.minimum) << " : " << h.maximum << " : " << (h.number==0? 0ul : h.mean/h.number) << std::endl;
-            }
-            for (int x=0; x<NUMBEROFHISTOENTRIES; x++) {
-                histoEntry h = histoEntries[x];
-                *outfile << (x*maxHistoSize) / NUMBEROFHISTOENTRIES << " : " << h.number << " : " << ((h.minimum == (uint64_t) -1)? 0ul : h.minimum) << " : " << h.maximum << " : " << (h.number==0? 0ul : h.mean/h.number) << std::endl;
-            }
-                              histoEntry h = bigBucket;
-                     std::cout << "bigbucket : " << h.number << " : " << ((h.minimum == (uint64_t) -1)? 0ul : h.minimum) << " : " << h.maximum << " : " << (h.number==0? 0ul : h.mean/h.number) << std::endl;
-                    *outfile << "bigbucket : " << h.number << " : " << ((h.minimum == (uint64_t) -1)? 0ul : h.minimum) << " : " << h.maximum << " : " << (h.number==0? 0ul : h.mean/h.number) << std::endl;
-
-
-            std::cout << "blocked lines" << std::endl << "number : frequency" << std::endl;
-            *outfile << "blocked lines" << std::endl << "number : frequency" << std::endl;
-
-            for (int x=0; x<513; x++) {
-                    std::cout << x << " : " << blocked_lines[x] << std::endl;
-                    *outfile << x << " : " << blocked_lines[x] << std::endl;
-            }
-
-        }
-
-        static void addToHisto (uint64_t time, 
-            uint64_t& maxHistoSize = loadstorelogentry::maxHistoSize, 
-            std::vector<histoEntry>& histoEntries = loadstorelogentry::histoEntries, 
-            histoEntry& bigBucket = loadstorelogentry::bigBucket) 
-        {
-
-            if (time > BIGBUCKETLIMIT) {
-                //std::cout << "bigbucket" << time << " at cycle " << curTick() << "\n";
-                bigBucket.add_entry(time);
-                return;
-            }
-
-            while (maxHistoSize <= time) {
-                maxHistoSize *=2;
-                for (int x=0; x<(NUMBEROFHISTOENTRIES); x+=2) {
-                    histoEntries[x/2] = histoEntry::merge(histoEntries[x],histoEntries[x+1]);
-                }
-                for (int x=NUMBEROFHISTOENTRIES/2; x<NUMBEROFHISTOENTRIES; x++) {
-                    histoEntries[x] = histoEntry();
-                }
-
-
-            }
-
-	    assert(time < maxHistoSize);
-            uint64_t index = (NUMBEROFHISTOENTRIES*time) / maxHistoSize;
-	    assert(index < NUMBEROFHISTOENTRIES);
-            histoEntries[index].add_entry(time);
-        }
-
-
-        static void printAimdHisto(std::ofstream* outfile) {
-
-            std::cout << "AIMD Histogram" << std::endl;
-            std::cout << "size : number" << std::endl;
-            *outfile << "AIMD Histogram" << std::endl;
-            *outfile << "size : number" << std::endl;
-
-
-            for (int x=0; x<NUMBEROFAIMDHISTOENTRIES+1; x++) {
-                uint64_t i = aimdHistoentries[x];
-                std::cout << (x*TIMEOUT) / NUMBEROFAIMDHISTOENTRIES << " : " << i  << std::endl;
-                *outfile << (x*TIMEOUT) / NUMBEROFAIMDHISTOENTRIES << " : " << i  << std::endl;
-
-            }
-        }
-        static void printCptLengthHisto(std::ofstream* outfile) {
-            *outfile << "cpt length Histogram" << std::endl;
-            *outfile << "size : number" << std::endl;
-            for (int x=0; x<NUMBEROFAIMDHISTOENTRIES+1; x++) {
-                uint64_t i = cptLengthHistoentries[x];
-                *outfile << (x*TIMEOUT) / NUMBEROFAIMDHISTOENTRIES << " : " << i  << std::endl;
-
-            }
-            for (int x = NUMBEROFAIMDHISTOENTRIES+1; x < cptLengthHistoentries.size(); x++) {
-                uint64_t i = cptLengthHistoentries[x];
-                if (i > 0) {
-                    *outfile << (x*TIMEOUT) / NUMBEROFAIMDHISTOENTRIES << " : " << i  << std::endl;
-                }
-            }
-            *outfile << "length to first LSL entry Histogram" << std::endl;
-            *outfile << "size : number" << std::endl;
-            for (int x=0; x<NUMBEROFAIMDHISTOENTRIES+1; x++) {
-                uint64_t i = lengthToFirstLSLHistoentries[x];
-                *outfile << (x*TIMEOUT) / NUMBEROFAIMDHISTOENTRIES << " : " << i  << std::endl;
-
-            }
-            for (int x = NUMBEROFAIMDHISTOENTRIES+1; x < lengthToFirstLSLHistoentries.size(); x++) {
-                uint64_t i = lengthToFirstLSLHistoentries[x];
-                if (i > 0) {
-                    *outfile << (x*TIMEOUT) / NUMBEROFAIMDHISTOENTRIES << " : " << i  << std::endl;
-                }
-            }
-            *outfile << "length from last LSL entry Histogram" << std::endl;
-            *outfile << "size : number" << std::endl;
-            for (int x=0; x<NUMBEROFAIMDHISTOENTRIES+1; x++) {
-                uint64_t i = lengthFromLastLSLHistoentries[x];
-                *outfile << (x*TIMEOUT) / NUMBEROFAIMDHISTOENTRIES << " : " << i  << std::endl;
-
-            }
-            for (int x = NUMBEROFAIMDHISTOENTRIES+1; x < lengthFromLastLSLHistoentries.size(); x++) {
-                uint64_t i = lengthFromLastLSLHistoentries[x];
-                if (i > 0) {
-                    *outfile << (x*TIMEOUT) / NUMBEROFAIMDHISTOENTRIES << " : " << i  << std::endl;
-                }
-            }
-        }
-
-
-        static void addToAIMDHisto (uint64_t histo) {
-            assert(histo <= TIMEOUT);
-            assert(((histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT) <= NUMBEROFAIMDHISTOENTRIES);
-            aimdHistoentries[(histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT]++;
-        }
-
-        static void addToCptLengthHisto (uint64_t histo) {
-            if (histo <= TIMEOUT) {
-                assert(((histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT) <= NUMBEROFAIMDHISTOENTRIES);
-            } else {
-                assert(((histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT) <= cptLengthHistoentries.size());
-            }
-            // cptLengthSequence.push_back(histo);
-            cptLengthHistoentries[(histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT]++;
-        }
-
-        static void addToLengthToFirstLSLHisto (uint64_t histo) {
-            if (histo <= TIMEOUT) {
-                assert(((histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT) <= NUMBEROFAIMDHISTOENTRIES);
-            } else {
-                assert(((histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT) <= lengthToFirstLSLHistoentries.size());
-            }
-            lengthToFirstLSLHistoentries[(histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT]++;
-        }
-
-        static void addToLengthFromLastLSLHisto (uint64_t histo) {
-            if (histo <= TIMEOUT) {
-                assert(((histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT) <= NUMBEROFAIMDHISTOENTRIES);
-            } else {
-                assert(((histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT) <= lengthFromLastLSLHistoentries.size());
-            }
-            lengthFromLastLSLHistoentries[(histo*NUMBEROFAIMDHISTOENTRIES) / TIMEOUT]++;
-        }
-
         static bool allocate_little_for_big(int mainCPUID);
+        /* Main core a checker core (index into checkerCPUMeta) sits next to */
+        static int homeOf(int checker) { return checker / NUMBEROFCHECKERCORESPERCORE; }
+        /* First free segment among the first slots slots of a main core's
+         * checkers, -1 if none */
+        static int freeSegment(int mainCPUID, int slots);
+        /* Whether another main core could take the checker core over */
+        static bool checkerIdle(int checker);
+        /* Take over an idle checker core for thief as stealPool prefers,
+         * returning its index or -1 */
+        static int stealChecker(int thief);
         static void commit_minor_checkpoint(BaseCPU* cpu);
+        /* Move the segment cached in the extra slots of checker x, if any,
+         * to its first slot once that is free, and start checking it */
+        static void pullCachedSegment(int x, int mainCPUID);
+        static void startCachedSegment(int x, int mainCPUID);
+        /* Checker id finished its segment, agreeing with the main core or
+         * not. Returns whether that decides the segment; if not it waits in
+         * checkerCPUMeta[id] for rerunSegment to pass it to another
+         * checker. Always true without --checkerVoters. */
+        static bool vote(int id, bool agrees);
+        /* Whether checker core d could take over the segment voted on by
+         * v, and move an undecided segment x to the checker that suits it
+         * best, returning false if none can */
+        static bool voterReady(int d, const segmentvote &v);
+        static bool rerunSegment(int x, int mainCPUID);
         static void copy_main_registers_to_checker(BaseCPU* cpu, int checkerCoreId);
         static void updateMainComparisonContexts(BaseCPU* cpu);
         static void updateMainContexts(BaseCPU* cpu);
+        static void recordBlockedLines(BaseCPU* cpu);
+        /* Feed the checkpoint length policy of a main core */
+        static void cptTaken(BaseCPU* cpu, bool lslFull);
+        static void cptEvictionBlock(int mainCPUID);
         static int mainCPURollback(BaseCPU* cpu);
         static bool checkerCheckIfShouldSleep(BaseCPU* cpu);
         static void checkerWakeup(int x);
+        /* Resend the data port request a checker core's cache turned down
+         * while its loadstorelog entry was missing */
+        static void forceCheckerRetry(int checkerCPUID);
+        /* Wake checker x, blocked on its stream buffer, at when */
+        static void streamWakeup(int x, Tick when);
         static void mainDoCheckpoint(BaseCPU* cpu, bool wasSyscall);
         static bool mainShouldBlock(BaseCPU* cpu, bool should_wait, bool should_commit);
         static bool isMainReady(int checkerCPUID);
@@ -636,31 +726,46 @@ public:
         static int getMainID(int checkerCPUID);
         static bool isMainCore(int cpuID);
         static bool isCheckerCore(int cpuID);
-        static bool checkedMainStaticInst(
-            std::map<std::string, std::array<int, 2>>::iterator it);
-        static std::pair<std::map<std::string, std::array<int, 2>>::iterator,
-                         bool>
-        addMainStaticInst(int cpuID, std::string instName);
+        /* Coverage of the static instructions and PCs main cores commit.
+         * The add functions count one commit and return its counts, and
+         * whether it is the first one; the checked functions count it as
+         * checked, returning whether that is the first check. */
+        static bool checkedMainStaticInst(coveragecounts *c);
+        static std::pair<coveragecounts *, bool>
+        addMainStaticInst(int cpuID, const char *mnemonic);
         static int getNumCheckedStaticInsts(int cpuID);
+        static int getNumStaticInsts(int cpuID);
         static std::string printStaticInsts(int cpuID);
-        static std::pair<std::map<uint64_t, std::array<int, 2>>::iterator,
-                         bool>
-        addMainPC(int cpuID, uint64_t pc, std::string instName);
-        static bool checkedMainPC(
-            std::map<uint64_t, std::array<int, 2>>::iterator it);
+        static std::pair<coveragecounts *, bool>
+        addMainPC(int cpuID, uint64_t pc, const char *mnemonic);
+        static bool checkedMainPC(coveragecounts *c);
         static std::string printPCs(int cpuID);
+        /* With --coverageDump, write what the counts gained since the last
+         * stats dump, for every main core */
+        static void initCoverageDump(const std::string &format);
+        static void dumpCoverage();
 
         static void not_found_sleep(int id); 
 
 
-        loadstorelogentry (bool isLoad, bool isStoreConditional, Addr address, uint8_t* ld_data, uint8_t size, uint64_t secondary_data, uint64_t t, uint64_t progc, std::string name, unsigned flagz, uint64_t uprogc, int64_t loadstorelogSeqNum) {
+        loadstorelogentry (bool isLoad, bool isStoreConditional, Addr address, const uint8_t* ld_data, unsigned size, uint64_t secondary_data, uint64_t t, uint64_t progc, uint32_t inst, unsigned flagz, uint64_t uprogc, int64_t loadstorelogSeqNum, lslslab* slab) {
+            set(isLoad, isStoreConditional, address, ld_data, size, secondary_data, t, progc, inst, flagz, uprogc, loadstorelogSeqNum, slab);
+        }
+
+        loadstorelogentry () {
+            reset();
+        }
+
+        void set(bool isLoad, bool isStoreConditional, Addr address, const uint8_t* ld_data, unsigned size, uint64_t secondary_data, uint64_t t, uint64_t progc, uint32_t inst, unsigned flagz, uint64_t uprogc, int64_t loadstorelogSeqNum, lslslab* slab) {
             load = isLoad;
             flags = flagz;
             isSC = isStoreConditional;
 
+            data.clear();
+            oldData.clear();
             if (ld_data) {
               assert(size!=0);
-              data.assign(ld_data, &ld_data[size]);
+              data.assign(ld_data, size, slab);
             }
             addr = address;
             extra_data = secondary_data;
@@ -668,30 +773,39 @@ public:
             time = t;
             pc = progc;
             microPC = uprogc;
-            inst_name = name;
+            instId = inst;
             assert(loadstorelogSeqNum > 0); // Was initialized to 1 and should increase
             seqNum = loadstorelogSeqNum;
         }
 
-        loadstorelogentry () {
+        void reset() {
             load = false;
             isSC = false;
             addr = 0;
             valid = false;
+            data.clear();
+            oldData.clear();
+            flags = 0;
             extra_data = 0;
             time = 0;
             pc = 0;
             microPC = 0;
-            inst_name = "";
+            instId = 0;
             seqNum = -1;
         }
 
+        /* The entry of the segment currently being filled by the main core
+         * that the next committed memory access is written into. It only
+         * becomes part of the log once do_write accepts it. */
+        static loadstorelogentry& nextEntry(int cpuID);
+        static lslslab* nextSlab(int cpuID);
+
             static void dumpLocalLogState(int id) {
                // Used for debugging
                std::cout << "\nLocal state of the loadstorelog:" << std::endl;
                for (int diff = (checkerCPUMeta.at(id).entryIndices > 2 ? -3 : -checkerCPUMeta.at(id).entryIndices); 
-                                           diff <= 3 && checkerCPUMeta.at(id).entryIndices+diff < logsize; diff++) {
-                  loadstorelogentry l = checkerCPUMeta.at(id).entries[checkerCPUMeta.at(id).entryIndices+diff];
+                                           diff <= 3 && checkerCPUMeta.at(id).entryIndices+diff < logentries; diff++) {
+                  const loadstorelogentry &l = checkerCPUMeta.at(id).entries[checkerCPUMeta.at(id).entryIndices+diff];
                   std::cout << "\tAt " << diff << "(+ " << checkerCPUMeta.at(id).entryIndices <<  "): "
                                  << (l.valid?"":"[Invalid]") << " address = " << std::hex << l.addr
                                  << ", status = " << (l.load?'r':'w')
@@ -716,14 +830,12 @@ public:
           /* dczva implementation on the main core does not actually zero the
            * entire cache line as it should so we add a special case here.
            */
-          if (inst_name[0]=='d' && inst_name[1]=='c') {
-            if (debugFlag) std::cout << inst_name << " instruction encountered" << std::endl;
-            if (inst_name=="dc zva") {
-              for (int i=0; i<pkt->req->getSize(); ++i) {
-                if (pkt->getPtr<uint8_t>()[i] != 0) return false;
-              }
-              return true;
+          if (instId == dcZvaInstId) {
+            if (debugFlag) std::cout << instName(instId) << " instruction encountered" << std::endl;
+            for (int i=0; i<pkt->req->getSize(); ++i) {
+              if (pkt->getPtr<uint8_t>()[i] != 0) return false;
             }
+            return true;
           }
 
           // Compare the data stored and the one written by the checker core.
@@ -737,12 +849,15 @@ public:
           return true;
         }
 
-  static bool do_write(loadstorelogentry l, int cpuID, bool newline, bool mayMergeMicroop, uint64_t currentCommittedInstructions);
+  static bool do_write(int cpuID, bool newline, bool mayMergeMicroop, uint64_t currentCommittedInstructions);
   static bool do_read(PacketPtr pkt, ThreadContext* tc);
   bool do_read(PacketPtr pkt, int id);
   static bool try_read(PacketPtr pkt, ThreadContext* tc);
 };
 
+static_assert(std::is_trivially_copyable<loadstorelogentry>::value,
+              "loadstorelog entries are copied in place into the log");
+
 void add_cpu(BaseCPU* cpu, int cpuID);
 
 
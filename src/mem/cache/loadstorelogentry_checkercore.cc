@@ -10,6 +10,7 @@
 #include "debug/LoadStoreLogSleepGuard.hh"
 //#include "sim/syscall_emul.hh"
 #include <iostream>
+#include <typeinfo>
 
 #include "sim/syscalllog.hh"
 
@@ -20,8 +21,10 @@ void loadstorelogentry::not_found_sleep(int id) {
               assert(id < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
               checkerCPUMeta.at(id).entryIndices = 0;
               checkerCPUMeta.at(id).activeChecker = false;
-              errordetection::detectError(id);
-              assert(allCPUMeta[id+NUMBEROFMAINCORES].baseCPU->getContext(0)->status() !=  ThreadContext::Suspended);
+              if (vote(id, false))
+                  errordetection::detectError(id);
+              // Functional checkers are never activated
+              assert(functional || allCPUMeta[id+NUMBEROFMAINCORES].baseCPU->getContext(0)->status() !=  ThreadContext::Suspended);
               allCPUMeta[id+NUMBEROFMAINCORES].baseCPU->drain();
 }
 
@@ -29,41 +32,67 @@ void loadstorelogentry::not_found_sleep(int id) {
 void loadstorelogentry::commit_minor_checkpoint(BaseCPU* cpu) {
 
     int checkerID = cpu->getContext(0)->contextId()-NUMBEROFMAINCORES;
-    int mainCPUID = checkerID/NUMBEROFCHECKERCORESPERCORE;
+    int mainCPUID = checkerOwner.at(checkerID);
     assert(checkerID < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
     assert(checkerID >= 0);
     assert(mainCPUID < NUMBEROFMAINCORES);
+    ShardGuard guard(mainCPUID);
+
+    // The segment is only validated once the digest unit is done with it.
+    // Later calls wait as well, so they still run in order.
+    Tick digestDone = checkerCPUMeta.at(checkerID).digestDoneTick;
+    if (digestDone > curTick()) {
+        handoff(checkerID + NUMBEROFMAINCORES,
+                [cpu]() { commit_minor_checkpoint(cpu); }, digestDone);
+        return;
+    }
+    checkerCPUMeta.at(checkerID).digestDoneTick = 0;
 
     if ((checkerID % NUMBEROFCHECKERCORESPERCORE) == 0 && !mainCPUMeta.at(mainCPUID).ready) {
         printf("getting cpu %d ready\n", mainCPUID);
         mainCPUMeta.at(mainCPUID).ready = true;
     } else {
 
-        if (checkerCPUMeta.at(checkerID).segmentFree) {
+        if (checkerCPUMeta.at(checkerID).segment.free()) {
             printf("suspending not ready context %d\n",checkerID);
         }
 
-        if (checkerCPUMeta.at(checkerID).expectedFinalContext.set || checkerCPUMeta.at(checkerID).segmentFree)checkerCPUMeta.at(checkerID).readyToCommit= true;
-        else printf("not yet ready to commit %ld on %d\n", checkerCPUMeta.at(checkerID).timestamps, checkerID);
+        // An undecided vote keeps the segment for the next checker
+        bool revote = checkerCPUMeta.at(checkerID).vote.rerun;
+        if (!revote) {
+            if (checkerCPUMeta.at(checkerID).expectedFinalContext.set || checkerCPUMeta.at(checkerID).segment.free()) ringOfSegment(checkerID).consume(checkerCPUMeta.at(checkerID).segment);
+            else printf("not yet ready to commit %ld on %d\n", checkerCPUMeta.at(checkerID).timestamps, checkerID);
+        }
         if (checkerCPUMeta.at(checkerID).expectedFinalContext.set) {
-            checkDelayCommittedInstructions += (checkerCPUMeta.at(checkerID).committedInstructions - checkerCPUMeta.at(checkerID).expectedSetCommittedInsts);
+            uint64_t lag = checkerCPUMeta.at(checkerID).committedInstructions - checkerCPUMeta.at(checkerID).expectedSetCommittedInsts;
+            checkDelayCommittedInstructions += lag;
+            cptPolicies.at(mainCPUID)->onValidate(lag);
             assert(checkerCPUMeta.at(checkerID).checkerStartWakeupTick > 0 && checkerCPUMeta.at(checkerID).checkerStartWakeupTick < curTick());
-            addToHisto(cpu->ticksToCycles(curTick() - checkerCPUMeta.at(checkerID).checkerStartWakeupTick), 
-                checkerCptLenMaxHistoSize, checkerCptLenHistoEntries, checkerCptLenBigBucket);
+            Cycles busy = cpu->ticksToCycles(curTick() - checkerCPUMeta.at(checkerID).checkerStartWakeupTick);
+            cpu->lslStats.checkerCptLen.sample(busy);
+            cpu->lslStats.checkerBusyCycles += busy;
+            ++cpu->lslStats.segmentsChecked;
+            if (mainCPUID != homeOf(checkerID))
+                ++cpu->lslStats.foreignSegments;
         }
         //printf("ready to commit %ld on %d\n", checkerCPUMeta.at(checkerID).timestamps, checkerID);
-        checkerCPUMeta.at(checkerID).aboutToValidate = false;
-        checkerCPUMeta.at(checkerID).startingContext.initialized = false;
+        checkerCPUMeta.at(checkerID).segment.endValidate();
         checkerCPUMeta.at(checkerID).dataAddressOffset= 0;
         checkerCPUMeta.at(checkerID).midopEntryIndex= 0;
-        syscalllogentry::reset_index(checkerID+NUMBEROFMAINCORES);
-        if (errorinjection::hasInjectedError[checkerID]) {
-            errorinjection::hasInjectedError[checkerID] = false;
-            errorinjection::undetectedErrors++;
-        }
-        if (errorinjection::unchangedInjectedError[checkerID]) {
-            errorinjection::unchangedInjectedError[checkerID] = false;
-            errorinjection::cptOnlyUnchangedInjections++;
+        if (revote) {
+            // Its syscalls and injected errors go with it, see rerunSegment
+            syscalllogentry::rewind_index(checkerID);
+        } else {
+            checkerCPUMeta.at(checkerID).startingContext.initialized = false;
+            syscalllogentry::reset_index(checkerID+NUMBEROFMAINCORES);
+            if (errorinjection::hasInjectedError[checkerID]) {
+                errorinjection::hasInjectedError[checkerID] = false;
+                errorinjection::undetectedErrors++;
+            }
+            if (errorinjection::unchangedInjectedError[checkerID]) {
+                errorinjection::unchangedInjectedError[checkerID] = false;
+                errorinjection::cptOnlyUnchangedInjections++;
+            }
         }
 
     }
@@ -74,12 +103,11 @@ void loadstorelogentry::commit_minor_checkpoint(BaseCPU* cpu) {
     do {
         finishedThisRound = false;
         uint64_t minCurrentTimestamp = 0;
-        for (int y=0; y<NUMBEROFCHECKERCORESPERCORE; y++) {
-            int x = y + NUMBEROFCHECKERCORESPERCORE * mainCPUID;
-            if (minCurrentTimestamp == 0 && !checkerCPUMeta[x].segmentFree) {
+        for (int x : ownedCheckers.at(mainCPUID)) {
+            if (minCurrentTimestamp == 0 && !checkerCPUMeta[x].segment.free()) {
                 minCurrentTimestamp = checkerCPUMeta[x].timestamps;
             }
-            if (minCurrentTimestamp > 0 && !checkerCPUMeta[x].segmentFree && checkerCPUMeta[x].timestamps < minCurrentTimestamp) {
+            if (minCurrentTimestamp > 0 && !checkerCPUMeta[x].segment.free() && checkerCPUMeta[x].timestamps < minCurrentTimestamp) {
                 minCurrentTimestamp = checkerCPUMeta[x].timestamps;
             }
         }
@@ -91,26 +119,23 @@ void loadstorelogentry::commit_minor_checkpoint(BaseCPU* cpu) {
             }
             std::cout << std::endl;
         }
-        for (int y=0; y<NUMBEROFCHECKERCORESPERCORE; y++) {
-            int x = y + NUMBEROFCHECKERCORESPERCORE * mainCPUID;
+        for (int x : ownedCheckers.at(mainCPUID)) {
             assert(x < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
             if(checkerCPUMeta.size() != num_checkSlot_per_checker*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE) std::cout << checkerCPUMeta.size()<< " "  <<  NUMBEROFMAINCORES << " " << NUMBEROFCHECKERCORESPERCORE << "\n";
             assert(checkerCPUMeta.size() == num_checkSlot_per_checker*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
-            if (checkerCPUMeta[x].readyToCommit && 
+            if (checkerCPUMeta[x].segment.retirable() && 
             (checkerCPUMeta[x].timestamps<=mainCPUMeta.at(mainCPUID).committed_timestamp+1 
             || AUTOCOMMIT || minorCommitBypass)) {
 
                 if (checkerCPUMeta[x].erroneous  && checkerCPUMeta[x].timestamps > mainCPUMeta.at(mainCPUID).committed_timestamp && !checkerCPUMeta[x].hasSyscall) {
+                    // The rollback discards this segment and every younger
+                    // one, youngest first
                     if(mainCPUMeta.at(mainCPUID).mainCoreErroneous) {
-                    	checkerCPUMeta[x].readyToCommit = false;
-                    	checkerCPUMeta[x].segmentFree = true;
                     	return;
                     }
                     std::cout << curTick() << " Trigger rollback at " << checkerCPUMeta[x].timestamps  << " from " << mainCPUMeta.at(mainCPUID).timestamp << std::endl;
                     errordetection::detectErrorCommit(x);
                     mainCPUMeta.at(mainCPUID).mainCoreErroneous = true;
-                    checkerCPUMeta[x].readyToCommit = false;
-                    checkerCPUMeta[x].segmentFree = true;
                     return;
                 }
 
@@ -135,7 +160,6 @@ void loadstorelogentry::commit_minor_checkpoint(BaseCPU* cpu) {
                     }
 #endif
                     mainCPUMeta.at(mainCPUID).voltage -= (mainCPUMeta.at(mainCPUID).voltage < mainCPUMeta.at(mainCPUID).highestRecentVoltageError)? AIMDDIFF / 8.0 : AIMDDIFF;
-                    errordetection::voltage_reset[mainCPUID] = true;
 #endif
                     mainCPUMeta.at(mainCPUID).committed_timestamp = checkerCPUMeta.at(x).timestamps;
                     mainCPUMeta.at(mainCPUID).committed_context = checkerCPUMeta.at(x).expectedFinalContext;
@@ -147,104 +171,216 @@ void loadstorelogentry::commit_minor_checkpoint(BaseCPU* cpu) {
                     }
                 }
                 assert(x < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
-                checkerCPUMeta[x].segmentFree = true;
-                checkerCPUMeta[x].readyToCommit = false;
-
-
-                // Checkpoints cached in the extra checkerCPUMeta should be ordered leaving no gap
-                for (int slot = 1; slot < num_checkSlot_per_checker; slot++) {
-                    int prev_id = x + (slot-1)*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
-                    int this_id = x + slot*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
-                    assert(slot == 1 || checkerCPUMeta[this_id].segmentFree || (!checkerCPUMeta[this_id].segmentFree && !checkerCPUMeta[prev_id].segmentFree));
-                }
-                // Keep stats for later
-                uint64_t tmp_drainDoneTick = checkerCPUMeta[x].checkerDrainDoneTick;
-                // If there is a checkpoint cached in the extra checkerCPUMeta, pull it over to the core
-                for (int slot = 1; slot < num_checkSlot_per_checker; slot++) {
-                    int prev_id = x + (slot-1)*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
-                    int this_id = x + slot*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
-                    if (!checkerCPUMeta[this_id].segmentFree) {
-                        assert(checkerCPUMeta[prev_id].segmentFree);
-                        CheckerCPUMeta tmp = checkerCPUMeta[prev_id];
-                        checkerCPUMeta[prev_id] = checkerCPUMeta[this_id];
-                        checkerCPUMeta[this_id] = tmp;
-                        syscalllogentry::move_segment(this_id, prev_id);
-                        // Make sure that the main core still track the correct checkerCPUMeta
-                        if (mainCPUMeta[mainCPUID].lastChecker == this_id) {
-                            mainCPUMeta[mainCPUID].lastChecker = prev_id;
-                        }
-                        if (mainCPUMeta[mainCPUID].current_segment_to_fill == this_id) {
-                            mainCPUMeta[mainCPUID].current_segment_to_fill = prev_id;
-                            last_macro_addrs[prev_id] = last_macro_addrs[this_id];
-                        }
-                    }
-                }
-                // If a cached checkpoint have been pulled to the core, prepare for checking
-                if (!checkerCPUMeta[x].segmentFree) {
-                    // Update the drainDoneTick according to the previous checkpoint
-                    checkerCPUMeta[x].checkerDrainDoneTick = tmp_drainDoneTick;
-                    // Set the starting context
-                    assert(checkerCPUMeta[x].startingContext.initialized);
-                    assert(allCPUMeta[x+NUMBEROFMAINCORES].baseCPU);
-                    assert(allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->getContext(0)->status() ==  ThreadContext::Suspended);
-                    assert(!checkerCPUMeta[x].activeChecker);
-                    m_copyRegs(allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->getContext(0), checkerCPUMeta[x].startingContext);
-                    // Set checker core loadstorelog starting sequence number before checking
-                    allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->setLoadstorelogSeqNum(
-                        checkerCPUMeta[x].startingSeqNum);
-                    allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->loadstorelogLastCommitSeqNum =
-                        checkerCPUMeta[x].startingSeqNum;
-                    DPRINTF(LoadStoreLogSeqNum,
-                            "copy_main_registers_to_checker set startingSeqNum %d\n",
-                            allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->getLdstlogSeq());
-                    allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->committedInstrs = 0;
-                    if (allCPUMeta[mainCPUID].baseCPU->isSleepGuarded) {
-                        assert(checkerCPUMeta[x].timestamps!=1);
-                        //printf("early wake\n");
-                        //dirty hack: calling wakeup here can cause issues when it's from the minorCPU's suspend path, so we actually
-                        //wake on the deSleepguard path in loadstorelogentry.
-                        if (!checkerCPUMeta[x].expectedFinalContext.set) {
-                            // Only set this if it hasn't been set yet
-                            checkerCPUMeta[x].committedInstructions=-1;
-                        }
-                        if (!checkerCPUMeta[x].expectedFinalContext.set &&
-                            checkerCPUMeta[x].checkpoint_entries == 0) { // Only sleep if needed
-                            allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->sleepGuardOn=true;
-                            DPRINTF(LoadStoreLogSleepGuard,
-                                    "commit_minor_checkpoint CPU %d sleepGuardOn set for "
-                                    "CPU %d\n",
-                                    mainCPUID, x+NUMBEROFMAINCORES);
-                        }
-                        checkerCPUMeta[x].startingCheckTick = curTick();
-                    }
-                    // Wake up the core if the final context was set or the LSL is not empty
-                    if (checkerCPUMeta[x].expectedFinalContext.set ||
-                        checkerCPUMeta[x].checkpoint_entries > 0) {
-                        // Attempt to avoid suspending and waking up the core
-                        // on the same tick by scheduling wakeup for later
-                        checkerCPUMeta[x].copyingRegister = true;
-                        allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->schedule(
-                            allCPUMeta[x+NUMBEROFMAINCORES].baseCPU
-                                ->checkerWakeupEvent, 
-                            allCPUMeta[x+NUMBEROFMAINCORES].baseCPU
-                                ->clockEdge(Cycles(1)));
-                    }
-                }
+                ring(mainCPUID).retire(checkerCPUMeta[x].segment);
+                pullCachedSegment(x, mainCPUID);
             }
         }
     } while (finishedThisRound);
 
+    if (voting) {
+        // rerunSegment may take over another main core's checker
+        const std::vector<int> owned = ownedCheckers.at(mainCPUID);
+        for (int x : owned) {
+            if (checkerCPUMeta[x].vote.rerun &&
+                checkerCPUMeta[x].expectedFinalContext.set &&
+                !checkerCPUMeta[x].segment.validating() &&
+                allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->getContext(0)
+                    ->status() == ThreadContext::Suspended)
+                rerunSegment(x, mainCPUID);
+        }
+    }
+
     for (int z = 0; z < NUMBEROFMAINCORES; z++) {
-        if (!((allCPUMeta[z].baseCPU->canContinueUnchecked() || allCPUMeta[z].baseCPU->sampledCheck()) &&
-              !allCPUMeta[z].baseCPU->isMain()) &&
-            allCPUMeta[z].baseCPU->havingASleep &&
-            !mainCPUMeta[z].mainCoreErroneous)
-            allocate_little_for_big(z);
+        // Other main cores may live on another event queue
+        handoff(z, [z]() {
+            if (!((allCPUMeta[z].baseCPU->canContinueUnchecked() || allCPUMeta[z].baseCPU->sampledCheck()) &&
+                  !allCPUMeta[z].baseCPU->isMain()) &&
+                allCPUMeta[z].baseCPU->havingASleep &&
+                !mainCPUMeta[z].mainCoreErroneous)
+                allocate_little_for_big(z);
+        });
+    }
+
+}
+
+void loadstorelogentry::pullCachedSegment(int x, int mainCPUID) {
+    // Checkpoints cached in the extra checkerCPUMeta should be ordered leaving no gap
+    for (int slot = 1; slot < num_checkSlot_per_checker; slot++) {
+        int prev_id = x + (slot-1)*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
+        int this_id = x + slot*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
+        assert(slot == 1 || checkerCPUMeta[this_id].segment.free() || (!checkerCPUMeta[this_id].segment.free() && !checkerCPUMeta[prev_id].segment.free()));
+    }
+    // Keep stats for later
+    uint64_t tmp_drainDoneTick = checkerCPUMeta[x].checkerDrainDoneTick;
+    // If there is a checkpoint cached in the extra checkerCPUMeta, pull it over to the core
+    for (int slot = 1; slot < num_checkSlot_per_checker; slot++) {
+        int prev_id = x + (slot-1)*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
+        int this_id = x + slot*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
+        if (!checkerCPUMeta[this_id].segment.free()) {
+            assert(checkerCPUMeta[prev_id].segment.free());
+            // Swap rather than copy to avoid rebuilding the log
+            std::swap(checkerCPUMeta[prev_id], checkerCPUMeta[this_id]);
+            syscalllogentry::move_segment(this_id, prev_id);
+            // Make sure that the main core still track the correct checkerCPUMeta
+            if (mainCPUMeta[mainCPUID].lastChecker == this_id) {
+                mainCPUMeta[mainCPUID].lastChecker = prev_id;
+            }
+            if (mainCPUMeta[mainCPUID].current_segment_to_fill == this_id) {
+                mainCPUMeta[mainCPUID].current_segment_to_fill = prev_id;
+                last_macro_addrs[prev_id] = last_macro_addrs[this_id];
+            }
+        }
+    }
+    // If a cached checkpoint have been pulled to the core, prepare for checking
+    if (!checkerCPUMeta[x].segment.free()) {
+        // Update the drainDoneTick according to the previous checkpoint
+        checkerCPUMeta[x].checkerDrainDoneTick = tmp_drainDoneTick;
+        startCachedSegment(x, mainCPUID);
+    }
+}
+
+void loadstorelogentry::startCachedSegment(int x, int mainCPUID) {
+    // Set the starting context
+    assert(checkerCPUMeta[x].startingContext.initialized);
+    assert(allCPUMeta[x+NUMBEROFMAINCORES].baseCPU);
+    assert(allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->getContext(0)->status() ==  ThreadContext::Suspended);
+    assert(!checkerCPUMeta[x].activeChecker);
+    m_copyRegs(allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->getContext(0), checkerCPUMeta[x].startingContext);
+    // Set checker core loadstorelog starting sequence number before checking
+    allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->setLoadstorelogSeqNum(
+        checkerCPUMeta[x].startingSeqNum);
+    allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->loadstorelogLastCommitSeqNum =
+        checkerCPUMeta[x].startingSeqNum;
+    DPRINTF(LoadStoreLogSeqNum,
+            "copy_main_registers_to_checker set startingSeqNum %d\n",
+            allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->getLdstlogSeq());
+    allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->committedInstrs = 0;
+    if (allCPUMeta[mainCPUID].baseCPU->isSleepGuarded) {
+        assert(checkerCPUMeta[x].timestamps!=1);
+        //printf("early wake\n");
+        //dirty hack: calling wakeup here can cause issues when it's from the minorCPU's suspend path, so we actually
+        //wake on the deSleepguard path in loadstorelogentry.
+        if (!checkerCPUMeta[x].expectedFinalContext.set) {
+            // Only set this if it hasn't been set yet
+            checkerCPUMeta[x].committedInstructions=-1;
+        }
+        if (!checkerCPUMeta[x].expectedFinalContext.set &&
+            checkerCPUMeta[x].checkpoint_entries == 0) { // Only sleep if needed
+            allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->sleepGuardOn=true;
+            DPRINTF(LoadStoreLogSleepGuard,
+                    "commit_minor_checkpoint CPU %d sleepGuardOn set for "
+                    "CPU %d\n",
+                    mainCPUID, x+NUMBEROFMAINCORES);
+        }
+        checkerCPUMeta[x].startingCheckTick = curTick();
+    }
+    // Wake up the core if the final context was set or the LSL is not empty
+    if (checkerCPUMeta[x].expectedFinalContext.set ||
+        checkerCPUMeta[x].checkpoint_entries > 0) {
+        // Attempt to avoid suspending and waking up the core
+        // on the same tick by scheduling wakeup for later
+        checkerCPUMeta[x].copyingRegister = true;
+        BaseCPU *checker = allCPUMeta[x+NUMBEROFMAINCORES].baseCPU;
+        handoff(x+NUMBEROFMAINCORES, [checker]() {
+            checker->schedule(checker->checkerWakeupEvent,
+                              checker->clockEdge(Cycles(1)));
+        });
+    }
+}
+
+bool loadstorelogentry::vote(int id, bool agrees) {
+    if (!voting)
+        return true;
+    segmentvote &v = checkerCPUMeta.at(id).vote;
+    checkervote::verdict r = voting->cast(v, id, agrees, curTick());
+    if (r == checkervote::Pending) {
+        // Finished with it, as far as mainDoCheckpoint is concerned
+        checkerCPUMeta.at(id).expectedFinalContext.checked = true;
+        v.rerun = true;
+        return false;
     }
+    if (r == checkervote::Commit && v.disagree) {
+        // The injected error, if any, was outvoted
+        errorinjection::hasInjectedError[id] = false;
+        errorinjection::unchangedInjectedError[id] = false;
+    }
+    return true;
+}
 
+bool loadstorelogentry::voterReady(int d, const segmentvote &v) {
+    if (v.voted(d))
+        return false;
+    // Free, or holding a checked segment that waits for an older one
+    const CheckerCPUMeta &m = checkerCPUMeta[d];
+    if (!m.segment.free() && !m.segment.retirable())
+        return false;
+    BaseCPU *cpu = allCPUMeta[d+NUMBEROFMAINCORES].baseCPU;
+    return !m.activeChecker && !m.copyingRegister && !cpu->sleepGuardOn &&
+           cpu->getContext(0)->status() == ThreadContext::Suspended;
+}
+
+bool loadstorelogentry::rerunSegment(int x, int mainCPUID) {
+    segmentvote &v = checkerCPUMeta[x].vote;
+    // Same model and clock as a checker that already voted
+    auto seen = [&v](int d) {
+        BaseCPU *cpu = allCPUMeta[d+NUMBEROFMAINCORES].baseCPU;
+        for (const auto &p : v.voters) {
+            BaseCPU *other = allCPUMeta[p.first+NUMBEROFMAINCORES].baseCPU;
+            if (typeid(*cpu) == typeid(*other) &&
+                cpu->clockPeriod() == other->clockPeriod())
+                return true;
+        }
+        return false;
+    };
+
+    int d = -1;
+    bool differs = false;
+    for (int c : ownedCheckers.at(mainCPUID)) {
+        if (!voterReady(c, v))
+            continue;
+        if (d < 0 || (!differs && !seen(c))) {
+            d = c;
+            differs = !seen(c);
+        }
+    }
+    if (d < 0 && stealPool) {
+        d = stealChecker(mainCPUID);
+        differs = d >= 0 && !seen(d);
+    }
+    if (d < 0)
+        return false;
+
+    // Only the segment moves, the drain stats stay with the cores
+    Tick drainedX = checkerCPUMeta[x].checkerDrainDoneTick;
+    Tick drainedD = checkerCPUMeta[d].checkerDrainDoneTick;
+    std::swap(checkerCPUMeta[x], checkerCPUMeta[d]);
+    checkerCPUMeta[x].checkerDrainDoneTick = drainedX;
+    checkerCPUMeta[d].checkerDrainDoneTick = drainedD;
+    syscalllogentry::swap_segments(x, d);
+    std::swap(errorinjection::hasInjectedError[x],
+              errorinjection::hasInjectedError[d]);
+    std::swap(errorinjection::unchangedInjectedError[x],
+              errorinjection::unchangedInjectedError[d]);
+    if (mainCPUMeta[mainCPUID].lastChecker == x)
+        mainCPUMeta[mainCPUID].lastChecker = d;
+    else if (mainCPUMeta[mainCPUID].lastChecker == d)
+        mainCPUMeta[mainCPUID].lastChecker = x;
+
+    checkerCPUMeta[d].vote.rerun = false;
+    checkerCPUMeta[d].restartCheck();
+    voting->reran(checkerCPUMeta[d].committedInstructions, differs);
+    std::cout << curTick() << " Re-executing " << checkerCPUMeta[d].timestamps
+              << " of cpu " << mainCPUID << " on checker " << d
+              << " after checker " << x << std::endl;
+    startCachedSegment(d, mainCPUID);
+    // A checked segment taken from d waits to retire where it is
+    if (checkerCPUMeta[x].segment.free())
+        pullCachedSegment(x, mainCPUID);
+    return true;
 }
 
 void loadstorelogentry::checkerWakeup(int x) {
+    ShardGuard guard(shardOfSegment(x));
     checkerCPUMeta[x].copyingRegister = false;
     checkerCPUMeta[x].activeChecker = true;
     assert(allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->getContext(0)->status() ==  ThreadContext::Suspended);
@@ -266,36 +402,51 @@ void loadstorelogentry::checkerWakeup(int x) {
 }
 
 bool loadstorelogentry::checkerCheckIfShouldSleep(BaseCPU* cpu) {
+    ShardGuard guard(shardOfCPU(cpu->getContext(0)->contextId()));
     int id = cpu->getContext(0)->contextId()-NUMBEROFMAINCORES;
     assert(id < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
-    if (checkerCPUMeta.at(id).aboutToValidate) {
+    if (checkerCPUMeta.at(id).segment.validating()) {
 
         if (checkerCPUMeta.at(id).activeChecker) {
 
-            //std::cout << "Checker " << id<<(id>=10?"":" ") << " validating after " << cpu->committedInstrs << " committed instructions at time " <<  loadstorelogentry::mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp << "... ";
+            //std::cout << "Checker " << id<<(id>=10?"":" ") << " validating after " << cpu->committedInstrs << " committed instructions at time " <<  loadstorelogentry::mainCPUMeta[checkerOwner.at(id)].timestamp << "... ";
             DPRINTF(LoadStoreLogChecker,
                     "checkerCheckIfShouldSleep checker %d "
                     "committedInstrs(cpu/log): %ld/%ld\n",
                     id, cpu->committedInstrs,
                     checkerCPUMeta[id].committedInstructions);
             if (cpu->committedInstrs==1 && checkerCPUMeta.at(id).committedInstructions>1) {
-                std::cout << "Initialization: skipping " << id << " at time " << mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp << std::endl;
+                std::cout << "Initialization: skipping " << id << " at time " << mainCPUMeta[checkerOwner.at(id)].timestamp << std::endl;
                 checkerCPUMeta.at(id).expectedFinalContext.checked = true;
                 if (useHash) {
                     checkerCPUMeta.at(id).initHash();
                 }
             } else {
+                bool agrees = checkerCPUMeta.at(id).expectedFinalContext.set && m_identical(cpu->getContext(0), checkerCPUMeta.at(id).expectedFinalContext);
                 if (useHash) {
                     loadstorelogentry l;
                     checkerCPUMeta.at(id).calcCheckedHash(l);
+                    // Charge the digest unit for whatever it could not hide
+                    // behind the checker's execution of the segment
+                    Tick start = checkerCPUMeta.at(id).checkerStartCommitTick;
+                    Tick last = checkerCPUMeta.at(id).checkerLastCommitTick;
+                    Cycles window = cpu->ticksToCycles(last > start ? last - start : 0);
+                    Cycles exposed = digestEngine->exposedCycles(
+                        checkerCPUMeta.at(id).hashBlocks, window);
+                    hashBlocksTotal += checkerCPUMeta.at(id).hashBlocks;
+                    hashExposedCycles += exposed;
+                    checkerCPUMeta.at(id).digestDoneTick =
+                        cpu->clockEdge(exposed);
                     std::cerr << "checker " << id << "finishing timestamp " << checkerCPUMeta[id].timestamps << std::endl;
-                    if (checkerCPUMeta.at(id).expectedFinalContext.set && m_identical(cpu->getContext(0), checkerCPUMeta.at(id).expectedFinalContext)) {
+                    if (agrees) {
                         assert(checkerCPUMeta.at(id).expectedHash == checkerCPUMeta.at(id).hash);
                     } else {
                         assert(checkerCPUMeta.at(id).expectedHash != checkerCPUMeta.at(id).hash);
                     }
                 }
-                if (checkerCPUMeta.at(id).expectedFinalContext.set && m_identical(cpu->getContext(0), checkerCPUMeta.at(id).expectedFinalContext)) {
+                if (!vote(id, agrees)) {
+                    // Another checker has to execute the segment first
+                } else if (agrees) {
                     checkerCPUMeta.at(id).expectedFinalContext.checked = true;
                     //std::cout << "Same architectural state for checker " << id << std::endl;
                     errordetection::numberOfCorrectCheckpoints++;
@@ -303,12 +454,12 @@ bool loadstorelogentry::checkerCheckIfShouldSleep(BaseCPU* cpu) {
                             "checkerCheckIfShouldSleep matching architectural "
                             "state for checker %d at time %d\n",
                             id,
-                            mainCPUMeta[id / NUMBEROFCHECKERCORESPERCORE]
+                            mainCPUMeta[checkerOwner.at(id)]
                                 .timestamp);
                 } else {
                     errordetection::numberOfDetectedErroneousArchStates++;
                     errordetection::detectError(id);
-                    //std::cout << "Error for checker " << id << " at time " << loadstorelogentry::mainCPUMeta[id/NUMBEROFCHECKERCORESPERCORE].timestamp << " insts" << cpu->committedInstrs << std::endl;
+                    //std::cout << "Error for checker " << id << " at time " << loadstorelogentry::mainCPUMeta[checkerOwner.at(id)].timestamp << " insts" << cpu->committedInstrs << std::endl;
                 }
             }
 
@@ -330,11 +481,12 @@ bool loadstorelogentry::checkerCheckIfShouldSleep(BaseCPU* cpu) {
 void
 loadstorelogentry::recStartCommitStats(BaseCPU* cpu) {
     int checkerID = cpu->getContext(0)->contextId()-NUMBEROFMAINCORES;
-    int mainCPUID = checkerID/NUMBEROFCHECKERCORESPERCORE;
+    int mainCPUID = checkerOwner.at(checkerID);
     assert(checkerID < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
     assert(checkerID >= 0);
     assert(mainCPUID < NUMBEROFMAINCORES);
-    if (!checkerCPUMeta.at(checkerID).segmentFree) { // Checker core checking
+    ShardGuard guard(mainCPUID);
+    if (!checkerCPUMeta.at(checkerID).segment.free()) { // Checker core checking
         // Should happen only once
         assert(checkerCPUMeta.at(checkerID).checkerStartCommitTick == 0);
         // Should have started
@@ -353,13 +505,10 @@ loadstorelogentry::recStartCommitStats(BaseCPU* cpu) {
             checkerCPUMeta.at(checkerID).checkerStartCommitTick 
             - checkerCPUMeta.at(checkerID).checkerStartFetchTick;
         // Transform tick to cycles and collect histogram
-        addToHisto(
+        cpu->lslStats.firstFetchToCommit.sample(
             cpu->ticksToCycles(
                 checkerCPUMeta.at(checkerID).checkerStartCommitTick 
-                - checkerCPUMeta.at(checkerID).checkerStartFetchTick), 
-            cptFirstFetchToCommitDelayMaxHistoSize, 
-            cptFirstFetchToCommitDelayHistoEntries, 
-            cptFirstFetchToCommitDelayBigBucket);    
+                - checkerCPUMeta.at(checkerID).checkerStartFetchTick));
         // If main core has already set the final context
         if (checkerCPUMeta.at(checkerID).expectedFinalContext.set) {
             checkStartDelayInstructions += checkerCPUMeta.at(checkerID)
@@ -384,6 +533,6 @@ loadstorelogentry::getMainID(int checkerCPUID)
 {
     assert(checkerCPUID < allCPUMeta.size());
     assert(checkerCPUID >= mainCPUMeta.size());
-    return (checkerCPUID - NUMBEROFMAINCORES) / NUMBEROFCHECKERCORESPERCORE;
+    return checkerOwner.at(checkerCPUID - NUMBEROFMAINCORES);
 }
 }
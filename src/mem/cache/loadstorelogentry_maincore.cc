@@ -18,98 +18,187 @@
 namespace gem5 {
 
 
-bool loadstorelogentry::allocate_little_for_big(int mainCPUID) {
-    assert(mainCPUID < mainCPUMeta.size());
-
+int loadstorelogentry::freeSegment(int mainCPUID, int slots) {
+    for (int y : ownedCheckers.at(mainCPUID)) {
+        assert(y < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
+        for (int slot = 0; slot < slots; ++slot) {
+            int x = y + slot*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
+            assert(x < checkerCPUMeta.size());
+            if (checkerCPUMeta[x].segment.free())
+                return x;
+        }
+    }
+    return -1;
+}
 
-    for (int y=0; y<NUMBEROFCHECKERCORESPERCORE; y++) {
-        int x = y + NUMBEROFCHECKERCORESPERCORE * mainCPUID;
-        assert(x < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
+bool loadstorelogentry::checkerIdle(int checker) {
+    int owner = checkerOwner.at(checker);
+    // The owner's first segment and the one it is filling stay put: the
+    // former is how it gets ready, the latter is still referenced by it
+    // (and by its lastChecker) when it is asleep waiting for a checker.
+    if (!mainCPUMeta.at(owner).ready ||
+        mainCPUMeta.at(owner).current_segment_to_fill %
+            (NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE) == checker ||
+        mainCPUMeta.at(owner).lastChecker %
+            (NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE) == checker)
+        return false;
+    for (int slot = 0; slot < num_checkSlot_per_checker; ++slot) {
+        if (!checkerCPUMeta[checker +
+                slot*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE].segment.free())
+            return false;
+    }
+    BaseCPU *cpu = allCPUMeta[checker+NUMBEROFMAINCORES].baseCPU;
+    return !checkerCPUMeta[checker].activeChecker &&
+           !checkerCPUMeta[checker].copyingRegister &&
+           !cpu->sleepGuardOn &&
+           cpu->getContext(0)->status() == ThreadContext::Suspended;
+}
 
+int loadstorelogentry::stealChecker(int thief) {
+    assert(stealPool);
+    // A stolen checker stays on its home main core's event queue, and
+    // would translate through its new owner's Process from that thread
+    fatal_if(numMainEventQueues > 1, "--checkerPool=shared cannot be used "
+             "with several event queues\n");
+    std::vector<int> idle(NUMBEROFMAINCORES, 0);
+    std::vector<stealcandidate> candidates;
+    // With a single event queue nothing changes under this pass, and
+    // every candidate is checked again below once its owner is locked
+    for (int c = 0; c < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE; c++) {
+        int owner = checkerOwner[c];
+        if (owner == thief || !checkerIdle(c))
+            continue;
+        idle[owner]++;
+        candidates.push_back({c, homeOf(c), owner, 0});
+    }
+    for (stealcandidate &c : candidates)
+        c.ownerIdle = idle[c.owner];
+    stealPool->rank(thief, candidates);
+
+    for (const stealcandidate &c : candidates) {
+        // The thief's shard is already held, so never wait for another one
+        // or two main cores stealing from each other would deadlock
+        std::unique_lock<std::recursive_mutex> lock(
+            *shardLocks.at(c.owner), std::defer_lock);
+        if (inParallelMode && !lock.try_lock())
+            continue;
+        if (checkerOwner[c.checker] != c.owner || !checkerIdle(c.checker))
+            continue;
+
+        std::vector<segmentslot *> slots;
         for (int slot = 0; slot < num_checkSlot_per_checker; ++slot) {
-            if (slot > 0) {
-                x = x + NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE;
-            }
-            assert(x < checkerCPUMeta.size());
-
-        if (checkerCPUMeta[x].segmentFree) {
-            // printf("starting main cpu at %ld\n", curTick());
-            mainCPUMeta[mainCPUID].current_segment_to_fill = x;
-            if ((allCPUMeta[mainCPUID].baseCPU->canContinueUnchecked() ||
-                 allCPUMeta[mainCPUID].baseCPU->sampledCheck()) &&
-                !allCPUMeta[mainCPUID].baseCPU->isMain())
-            {
-                // Re-starting to take checkpoints, need to copy the initial
-                // register files
-                auto o3cpu =
-                    dynamic_cast<o3::CPU *>(allCPUMeta[mainCPUID].baseCPU);
-                assert(o3cpu);
-                o3cpu->_isChecked = o3cpu->_wasChecked;
-                o3cpu->_isStored = true;
-                updateMainContexts(allCPUMeta[mainCPUID].baseCPU);
-                if (allCPUMeta[mainCPUID].baseCPU->sampledCheck()) {
-                    o3cpu->updateLastSample(o3cpu->cpuStats.committedInsts[0].value()); // in our experiments, there's only 1 thread per core
-                }
-                DPRINTF(LoadStoreLogMainContUnchecked,
-                        "CPU %d continueing checked\n", mainCPUID);
-            }
-            //std::cout << "Reinitialising current_entry of " << mainCPUID << " to " << x << std::endl;
-            checkerCPUMeta[x].segmentFree = false;
-            checkerCPUMeta[x].erroneous = false;
-            checkerCPUMeta[x].timestamps = ++mainCPUMeta[mainCPUID].timestamp;
-            checkerCPUMeta[x].hasSyscall= false;
-            //printf("allocating %d at timestamp %ld\n",x, checkerCPUMeta[x].timestamps);
-
-            checkerCPUMeta[x].committedInstructions=0;
-            checkerCPUMeta[x].currentCommittedInstructions=0;
-            if (slot == 0) // Only set the core's committedInstrs if this is not a spare slot
-            allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->committedInstrs = 0;
-            mainCPUMeta[mainCPUID].current_entry = 0;
-            mainCPUMeta[mainCPUID].current_size = 0;
-            checkerCPUMeta[x].checkpoint_entries = 0;
-            checkerCPUMeta[x].checkpoint_cachelines = 0;
-            checkerCPUMeta[x].entryIndices = 0;
-            checkerCPUMeta[x].startingTick = mainCPUMeta[mainCPUID].startingTickTmp;
-            checkerCPUMeta[x].mainStartingTick = curTick();
-            checkerCPUMeta[x].checkerStartWakeupTick = 0;
-            checkerCPUMeta[x].checkerStartFetchTick = 0;
-            checkerCPUMeta[x].checkerStartFetchAccCompleteTick = 0;
-            checkerCPUMeta[x].checkerStartCommitTick = 0;
-            checkerCPUMeta[x].checkerLastCommitTick = 0;
-            if (useHash) {
-                checkerCPUMeta[x].initHash();
-            }
-            // Copy starting loadstorelog sequence number to allocated checker
-            checkerCPUMeta[x].startingSeqNum = 
-                mainCPUMeta[mainCPUID].startingSeqNum;
-            DPRINTF(LoadStoreLogSeqNum,
-                    "allocate_little_for_big checker startingSeqNum %d\n",
-                    checkerCPUMeta[x].startingSeqNum);
-            assert(mainCPUMeta[mainCPUID].startingSeqNum ==
-                allCPUMeta[mainCPUID].baseCPU->loadstorelogLastCommitSeqNum +
-                    1);
-
-            allCPUMeta[mainCPUID].baseCPU->committedInstrs = 0;
-            syscalllogentry::reset_index(mainCPUID);
-
-
-            allCPUMeta[mainCPUID].baseCPU->havingASleep = false;
-            mainCPUMeta[mainCPUID].startingTickTmp = curTick();
-            if (slot == 0) {
-            copy_main_registers_to_checker(allCPUMeta[mainCPUID].baseCPU,x+NUMBEROFMAINCORES);
-            } else {
-                mainCPUMeta[mainCPUID].lastChecker = x;
-                checkerCPUMeta[x].startingContext = miniContext(mainCPUMeta[mainCPUID].previousThreadContext);
-                assert(checkerCPUMeta[x].startingContext.initialized);
-                checkerCPUMeta[x].expectedFinalContext.set = false;
-                checkerCPUMeta[x].expectedFinalContext.checked = false;
-            }
-            return true;
+            slots.push_back(&checkerCPUMeta[c.checker +
+                slot*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE].segment);
         }
+        std::vector<int> &from = ownedCheckers.at(c.owner);
+        from.erase(std::find(from.begin(), from.end(), c.checker));
+        ownedCheckers.at(thief).push_back(c.checker);
+        ring(c.owner).release(slots);
+        ring(thief).adopt(slots);
+        checkerOwner[c.checker] = thief;
+        return c.checker;
+    }
+    return -1;
+}
+
+bool loadstorelogentry::allocate_little_for_big(int mainCPUID) {
+    assert(mainCPUID < mainCPUMeta.size());
+    ShardGuard guard(mainCPUID);
+
+    int x = -1;
+    if (stealPool && stealPool->beforeExtraSlots()) {
+        x = freeSegment(mainCPUID, 1);
+        if (x < 0)
+            x = stealChecker(mainCPUID);
+    }
+    if (x < 0)
+        x = freeSegment(mainCPUID, num_checkSlot_per_checker);
+    if (x < 0 && stealPool)
+        x = stealChecker(mainCPUID);
+
+    if (x < 0)
+        return false;
+
+    int slot = x / (NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
+    // printf("starting main cpu at %ld\n", curTick());
+    mainCPUMeta[mainCPUID].current_segment_to_fill = x;
+    if ((allCPUMeta[mainCPUID].baseCPU->canContinueUnchecked() ||
+         allCPUMeta[mainCPUID].baseCPU->sampledCheck()) &&
+        !allCPUMeta[mainCPUID].baseCPU->isMain())
+    {
+        // Re-starting to take checkpoints, need to copy the initial
+        // register files
+        auto o3cpu =
+            dynamic_cast<o3::CPU *>(allCPUMeta[mainCPUID].baseCPU);
+        assert(o3cpu);
+        o3cpu->_isChecked = o3cpu->_wasChecked;
+        o3cpu->_isStored = true;
+        updateMainContexts(allCPUMeta[mainCPUID].baseCPU);
+        if (allCPUMeta[mainCPUID].baseCPU->sampledCheck()) {
+            o3cpu->updateLastSample(o3cpu->cpuStats.committedInsts[0].value()); // in our experiments, there's only 1 thread per core
         }
+        DPRINTF(LoadStoreLogMainContUnchecked,
+                "CPU %d continueing checked\n", mainCPUID);
+    }
+    //std::cout << "Reinitialising current_entry of " << mainCPUID << " to " << x << std::endl;
+    checkerCPUMeta[x].erroneous = false;
+    checkerCPUMeta[x].timestamps = ++mainCPUMeta[mainCPUID].timestamp;
+    ring(mainCPUID).produce(checkerCPUMeta[x].segment, checkerCPUMeta[x].timestamps);
+    checkerCPUMeta[x].hasSyscall= false;
+    //printf("allocating %d at timestamp %ld\n",x, checkerCPUMeta[x].timestamps);
+
+    checkerCPUMeta[x].committedInstructions=0;
+    checkerCPUMeta[x].currentCommittedInstructions=0;
+    checkerCPUMeta[x].noc.reset();
+    checkerCPUMeta[x].stream.reset();
+    checkerCPUMeta[x].vote.reset();
+    if (slot == 0) // Only set the core's committedInstrs if this is not a spare slot
+        allCPUMeta[x+NUMBEROFMAINCORES].baseCPU->committedInstrs = 0;
+    mainCPUMeta[mainCPUID].current_entry = 0;
+    mainCPUMeta[mainCPUID].current_size = 0;
+    if (compressor)
+        compressor->reset(mainCPUID);
+    checkerCPUMeta[x].checkpoint_entries = 0;
+    checkerCPUMeta[x].checkpoint_cachelines = 0;
+    checkerCPUMeta[x].entryIndices = 0;
+    checkerCPUMeta[x].overflow.reset();
+    checkerCPUMeta[x].undo.clear();
+    checkerCPUMeta[x].startingTick = mainCPUMeta[mainCPUID].startingTickTmp;
+    checkerCPUMeta[x].mainStartingTick = curTick();
+    checkerCPUMeta[x].checkerStartWakeupTick = 0;
+    checkerCPUMeta[x].checkerStartFetchTick = 0;
+    checkerCPUMeta[x].checkerStartFetchAccCompleteTick = 0;
+    checkerCPUMeta[x].checkerStartCommitTick = 0;
+    checkerCPUMeta[x].checkerLastCommitTick = 0;
+    if (useHash) {
+        checkerCPUMeta[x].initHash();
+    }
+    // Copy starting loadstorelog sequence number to allocated checker
+    checkerCPUMeta[x].startingSeqNum = 
+        mainCPUMeta[mainCPUID].startingSeqNum;
+    DPRINTF(LoadStoreLogSeqNum,
+            "allocate_little_for_big checker startingSeqNum %d\n",
+            checkerCPUMeta[x].startingSeqNum);
+    assert(mainCPUMeta[mainCPUID].startingSeqNum ==
+        allCPUMeta[mainCPUID].baseCPU->loadstorelogLastCommitSeqNum +
+            1);
 
+    allCPUMeta[mainCPUID].baseCPU->committedInstrs = 0;
+    syscalllogentry::reset_index(mainCPUID);
+
+
+    allCPUMeta[mainCPUID].baseCPU->havingASleep = false;
+    mainCPUMeta[mainCPUID].startingTickTmp = curTick();
+    if (slot == 0) {
+        copy_main_registers_to_checker(allCPUMeta[mainCPUID].baseCPU,x+NUMBEROFMAINCORES);
+    } else {
+        mainCPUMeta[mainCPUID].lastChecker = x;
+        checkerCPUMeta[x].startingContext = miniContext(mainCPUMeta[mainCPUID].previousThreadContext);
+        assert(checkerCPUMeta[x].startingContext.initialized);
+        checkerCPUMeta[x].expectedFinalContext.set = false;
+        checkerCPUMeta[x].expectedFinalContext.checked = false;
     }
-    return false;
+    return true;
 }
 
 
@@ -120,10 +209,11 @@ void loadstorelogentry::copy_main_registers_to_checker(BaseCPU* cpu, int checker
     //input: actual cpuID of checker core
     int cpuID = cpu->getContext(0)->contextId();
     assert(cpuID < mainCPUMeta.size());
+    ShardGuard guard(cpuID);
     mainCPUMeta.at(cpuID).lastChecker = checkerCoreId-NUMBEROFMAINCORES;
     assert(checkerCoreId-NUMBEROFMAINCORES < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
     assert(mainCPUMeta.at(cpuID).current_segment_to_fill < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
-    assert(!checkerCPUMeta[mainCPUMeta.at(cpuID).current_segment_to_fill].segmentFree);
+    assert(!checkerCPUMeta[mainCPUMeta.at(cpuID).current_segment_to_fill].segment.free());
     assert(checkerCPUMeta[mainCPUMeta.at(cpuID).current_segment_to_fill].entryIndices == 0);
     assert(!checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).startingContext.initialized);
 
@@ -183,6 +273,7 @@ int loadstorelogentry::mainCPURollback(BaseCPU* cpu) {
     std::cout << "have drained - store roll\n";
 #endif
     int cpuID = cpu->getContext(0)->contextId();
+    ShardGuard guard(cpuID);
 
     uint64_t committed = mainCPUMeta.at(cpuID).committed_timestamp;
     uint64_t current = mainCPUMeta.at(cpuID).timestamp;
@@ -190,50 +281,67 @@ int loadstorelogentry::mainCPURollback(BaseCPU* cpu) {
     if (mainCPUMeta.at(cpuID).mainCoreErroneous) {
 
         uint64_t num_writebacks = 0;
-
-        for (int segment = mainCPUMeta.at(cpuID).current_segment_to_fill; current != committed; segment = (segment==cpuID*NUMBEROFCHECKERCORESPERCORE)?
-            (cpuID+1)*NUMBEROFCHECKERCORESPERCORE - 1 : segment -1) {
+        uint64_t partial_lines = 0;
+        auto o3cpu = dynamic_cast<o3::CPU *>(cpu);
+        assert(o3cpu);
+        unsigned lineSize = cpu->cacheLineSize();
+        uint8_t line[undolog::maxLineSize];
+
+        // Segments in flight cannot change owner, so they are all among the
+        // main core's checkers; walk those until each timestamp is found
+        const std::vector<int> &owned = ownedCheckers.at(cpuID);
+        for (size_t i = 0; current != committed; i = (i + 1) % owned.size()) {
+            int segment = owned[i];
             assert(segment < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
             if (current != checkerCPUMeta.at(segment).timestamps) continue;
 
 #ifdef ROLLBACK_DEBUG
             std::cout << current << "\n";
 #endif
-            if (checkerCPUMeta.at(segment).readyToCommit) {
-                checkerCPUMeta.at(segment).readyToCommit = false;
-                checkerCPUMeta.at(segment).segmentFree = true;
+            if (checkerCPUMeta.at(segment).segment.retirable()) {
+                ring(cpuID).discard(checkerCPUMeta.at(segment).segment);
             }
-#if PARAGLIDER
-
-            uint64_t toadd =  checkerCPUMeta.at(segment).checkpoint_cachelines;
-#else
-            uint64_t toadd =  checkerCPUMeta.at(segment).checkpoint_entries;
-
-#endif
-            num_writebacks += toadd;
+            const undolog &undo = checkerCPUMeta.at(segment).undo;
+            num_writebacks += undo.lines();
+            partial_lines += undo.partialLines();
 
             toRemove  = allCPUMeta[segment+NUMBEROFMAINCORES].baseCPU->committedInstrs;
 
-            int size_of_segment = logsize;
-            for (int x = size_of_segment -1; x>=0; x--) {
-                if (checkerCPUMeta.at(segment).entries[x].valid && !checkerCPUMeta.at(segment).entries[x].load) {
-                    cpu->writeMem(checkerCPUMeta.at(segment).entries[x].addr, &(checkerCPUMeta.at(segment).entries[x].oldData[0]), checkerCPUMeta.at(segment).entries[x].oldData.size(), checkerCPUMeta.at(segment).entries[x].pc,checkerCPUMeta.at(segment).entries[x].flags /*TODO: proper flags?*/);
+            // Restore each line the segment wrote in one access, reading
+            // back the bytes it did not write first
+            undo.forEachLine([&](const undolog::line &l) {
+                if (l.partial) {
+                    bool newline;
+                    Fault read = o3cpu->readMem(l.addr, line, lineSize, 0,
+                                                Request::Flags(), newline);
+                    assert(read == NoFault);
+                }
+                for (unsigned b = 0; b < lineSize; b++) {
+                    if (l.saved[b])
+                        line[b] = l.data[b];
+                }
+                cpu->writeMem(l.addr, line, lineSize, 0, Request::Flags());
 #ifdef ROLLBACK_DEBUG
-                    std::cout<< "Undoing" << checkerCPUMeta.at(segment).entries[x].addr << " data ";
-                    for (auto i: checkerCPUMeta.at(segment).entries[x].oldData)
-                        std::cout << i << ' ';
+                std::cout<< "Undoing" << l.addr << " data ";
+                for (unsigned b = 0; b < lineSize; b++)
+                    std::cout << (int)line[b] << ' ';
 
-                    std::cout << "\n";
+                std::cout << "\n";
 #endif
-                }
-            }
+            });
 
             current--;
         }
 
+        uint64_t recovery_cycles =
+            undolog::recoveryCycles(num_writebacks, partial_lines);
+
+        {
+        GlobalGuard global;
 #if LOGERRORS
 
         errordetection::memoryRecoveryTime.push_back(num_writebacks);
+        errordetection::memoryRecoveryCycles.push_back(recovery_cycles);
 #endif
         errordetection::total_memory_recoveries += num_writebacks;
 
@@ -241,6 +349,12 @@ int loadstorelogentry::mainCPURollback(BaseCPU* cpu) {
         errordetection::min_memory_recoveries = errordetection::min_memory_recoveries==0?  num_writebacks : errordetection::min_memory_recoveries;
         errordetection::max_memory_recoveries = std::max( num_writebacks ,errordetection::max_memory_recoveries);
 
+        errordetection::total_memory_recovery_cycles += recovery_cycles;
+        errordetection::min_memory_recovery_cycles = errordetection::min_memory_recovery_cycles==0?
+            recovery_cycles : std::min(recovery_cycles, errordetection::min_memory_recovery_cycles);
+        errordetection::max_memory_recovery_cycles = std::max(recovery_cycles, errordetection::max_memory_recovery_cycles);
+        }
+
 
         mainCPUMeta.at(cpuID).committed_timestamp = mainCPUMeta.at(cpuID).timestamp;
 
@@ -257,7 +371,13 @@ int loadstorelogentry::mainCPURollback(BaseCPU* cpu) {
 
 
         for (int z=0; z<NUMBEROFMAINCORES; z++) {
-            if (allCPUMeta[z].baseCPU->havingASleep && ! mainCPUMeta[z].mainCoreErroneous) loadstorelogentry::allocate_little_for_big(z);
+            if (z == cpuID) {
+                if (allCPUMeta[z].baseCPU->havingASleep && ! mainCPUMeta[z].mainCoreErroneous) loadstorelogentry::allocate_little_for_big(z);
+                continue;
+            }
+            handoff(z, [z]() {
+                if (allCPUMeta[z].baseCPU->havingASleep && ! mainCPUMeta[z].mainCoreErroneous) loadstorelogentry::allocate_little_for_big(z);
+            });
         }
         cpu->drainResume();
         assert(!allCPUMeta[cpuID].baseCPU->havingASleep);
@@ -271,6 +391,7 @@ void loadstorelogentry::updateMainComparisonContexts(BaseCPU* cpu)
 {
     int cpuID = cpu->getContext(0)->contextId();
     assert(cpuID < mainCPUMeta.size());
+    ShardGuard guard(cpuID);
     int checkerID = mainCPUMeta.at(cpuID).lastChecker;
     assert(checkerID < num_checkSlot_per_checker*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
     // Set the expected final register state for the checker core
@@ -284,29 +405,27 @@ void loadstorelogentry::updateMainComparisonContexts(BaseCPU* cpu)
 
     checkerCPUMeta[checkerID].expectedFinalContext = mainCPUMeta.at(cpuID).previousThreadContext;
     checkerCPUMeta[checkerID].expectedFinalContext.set = true;
+    ring(cpuID).publish(checkerCPUMeta[checkerID].segment);
     if (checkerID < NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE) {
         checkerCPUMeta[checkerID].expectedSetCommittedInsts = allCPUMeta[checkerID + NUMBEROFMAINCORES].baseCPU->committedInstrs;
     } else {
         checkerCPUMeta[checkerID].expectedSetCommittedInsts = 0;
     }
 
-    mainCPUMeta.at(cpuID).waiting_to_checkpoint = false;
+    ring(cpuID).setPublishing(false);
 
     if (!cpu->commitBlocked) {
         cpu->commitBlocked = true;
         cpu->schedule(cpu->finUnblock, cpu->clockEdge(Cycles(8))); //Changed. Was 16 cycles on 4-port reg file. Now 8 cycles on 8-port regfile.
     }
-    /*
-    int blocked = cpu->getDataPort().blockedEntries(cpuID);
-    if(blocked > loadstorelogentry::blocked_lines.size()) loadstorelogentry::blocked_lines.resize(blocked);
-    loadstorelogentry::blocked_lines.at(blocked)++;
-    */
+    recordBlockedLines(cpu);
 }
 
 void loadstorelogentry::updateMainContexts(BaseCPU* cpu)
 {
     int cpuID = cpu->getContext(0)->contextId();
     assert(cpuID < mainCPUMeta.size());
+    ShardGuard guard(cpuID);
     // Set the expected final register state for the checker core
     mainCPUMeta.at(cpuID).previousThreadContext = m_serialize(cpu->getContext(0));
     // Record starting loadstorelog sequence number for the current segment
@@ -316,32 +435,63 @@ void loadstorelogentry::updateMainContexts(BaseCPU* cpu)
             "updateMainContexts main startingSeqNum %d\n",
             mainCPUMeta.at(cpuID).startingSeqNum);
 
-    mainCPUMeta.at(cpuID).waiting_to_checkpoint = false;
+    ring(cpuID).setPublishing(false);
 
     if (!cpu->commitBlocked) {
         cpu->commitBlocked = true;
         cpu->schedule(cpu->finUnblock, cpu->clockEdge(Cycles(8)));
     }
-    /*
-    int blocked = cpu->getDataPort().blockedEntries(cpuID);
-    if(blocked > loadstorelogentry::blocked_lines.size()) loadstorelogentry::blocked_lines.resize(blocked);
-    loadstorelogentry::blocked_lines.at(blocked)++;
-    */
+    recordBlockedLines(cpu);
+}
+
+void loadstorelogentry::recordBlockedLines(BaseCPU* cpu)
+{
+    // The L1 keeps a per-timestamp count of its uncommitted lines, so this is
+    // cheap enough to sample at every checkpoint. It is asked directly, as
+    // the data port may lead to a CommMonitor (--memchecker) instead.
+    if (!blockedLinesTracked) return;
+    int cpuID = cpu->getContext(0)->contextId();
+    auto l1 = blockingL1s.find(cpuID);
+    if (l1 == blockingL1s.end()) return;
+    cpu->lslStats.blockedLines.sample(l1->second->blockedEntries(cpuID));
 }
 
 
+void loadstorelogentry::cptTaken(BaseCPU* cpu, bool lslFull)
+{
+    int cpuID = cpu->getContext(0)->contextId();
+    assert(cpuID < mainCPUMeta.size());
+    ShardGuard guard(cpuID);
+    cptsample s;
+    s.insts = cpu->committedInstrs;
+    s.entries = mainCPUMeta.at(cpuID).current_entry;
+    s.lslFull = lslFull;
+    s.timedOut = cpu->committedInstrs >= mainCPUMeta.at(cpuID).timeout;
+    mainCPUMeta.at(cpuID).timeout =
+        cptPolicies.at(cpuID)->onCheckpoint(mainCPUMeta.at(cpuID).timeout, s);
+    if (AIMD) cpu->lslStats.cptTimeout.sample(mainCPUMeta.at(cpuID).timeout);
+}
+
+void loadstorelogentry::cptEvictionBlock(int mainCPUID)
+{
+    ShardGuard guard(mainCPUID);
+    mainCPUMeta.at(mainCPUID).timeout =
+        cptPolicies.at(mainCPUID)->onEvictionBlock(mainCPUMeta.at(mainCPUID).timeout);
+}
+
 void loadstorelogentry::mainDoCheckpoint(BaseCPU* cpu, bool wasSyscall) {
 
     int cpuID = cpu->getContext(0)->contextId();
     assert(cpuID < mainCPUMeta.size());
+    ShardGuard guard(cpuID);
     int checkerCoreId = mainCPUMeta.at(cpuID).current_segment_to_fill + NUMBEROFMAINCORES;
     assert(checkerCoreId-NUMBEROFMAINCORES < num_checkSlot_per_checker*NUMBEROFMAINCORES*NUMBEROFCHECKERCORESPERCORE);
     assert(cpuID < NUMBEROFMAINCORES);
-    mainCPUMeta.at(cpuID).waiting_to_checkpoint = true;
+    ring(cpuID).setPublishing(true);
     checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).committedInstructions = cpu->committedInstrs;
     totalCommittedInstructions += cpu->committedInstrs;
 
-    int size_of_segment = logsize;
+    int size_of_segment = logentries;
 
 
     for (int x= mainCPUMeta.at(cpuID).current_entry; x< size_of_segment; x++) {
@@ -350,11 +500,11 @@ void loadstorelogentry::mainDoCheckpoint(BaseCPU* cpu, bool wasSyscall) {
 
     //std::cout << "segment: " << loadstorelogentry::current_segment_to_fill[cpuID] << " free " << loadstorelogentry::segmentFree[loadstorelogentry::current_segment_to_fill[cpuID]] << std::endl;
 
-    if (mainCPUMeta.at(cpuID).previousThreadContext.initialized && !checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).segmentFree) {
+    if (mainCPUMeta.at(cpuID).previousThreadContext.initialized && !checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).segment.free()) {
 
-        addToCptLengthHisto(cpu->committedInstrs);
-        addToHisto(curTick() - checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).mainStartingTick, 
-            cptLenMaxHistoSize, cptLenHistoEntries, cptLenBigBucket);
+        cpu->lslStats.cptLenInsts.sample(cpu->committedInstrs);
+        cpu->lslStats.cptLenTicks.sample(curTick() - checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).mainStartingTick);
+        numCpts++;
         cptLenTicks += curTick() - checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).mainStartingTick;
         if (loadstorelogentry::debugFlag) {
             std::cout << "*  *  *  *  *  *  *  *  *  *  *  *  *  *  *  *  *  *  *  *  *  *"
@@ -366,10 +516,10 @@ void loadstorelogentry::mainDoCheckpoint(BaseCPU* cpu, bool wasSyscall) {
 
 	bool was_already_checked = checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).expectedFinalContext.checked;
         updateMainComparisonContexts(cpu);
-        addToLengthFromLastLSLHisto(checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).committedInstructions - checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).currentCommittedInstructions);
-        loadstorelogentry l; // uninitialised blank field in to signal the end.
+        cpu->lslStats.lengthFromLastLSL.sample(checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).committedInstructions - checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).currentCommittedInstructions);
+        nextEntry(cpuID).reset(); // uninitialised blank field in to signal the end.
         do_write(
-            l, cpuID, false, false,
+            cpuID, false, false,
             std::numeric_limits<uint64_t>::
                 max()); // Set currentCommittedInstructions to max to make sure
                         // that checker continues to commit new instructions
@@ -381,12 +531,17 @@ void loadstorelogentry::mainDoCheckpoint(BaseCPU* cpu, bool wasSyscall) {
 
             if (was_already_checked) {
                 printf("core %d ready to commit before checkpoint created.\n", checkerCoreId-NUMBEROFMAINCORES);
-                commit_minor_checkpoint(allCPUMeta[checkerCoreId].baseCPU);
+                // Suspends the checker, so it has to run on its event queue
+                handoff(checkerCoreId, [checkerCoreId]() {
+                    commit_minor_checkpoint(allCPUMeta[checkerCoreId].baseCPU);
+                });
             } else {
                 //printf("late wake\n");
                 assert(checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).startingContext.initialized);
                 checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).activeChecker = true;
-                allCPUMeta[checkerCoreId].baseCPU->wakeup(0);
+                handoff(checkerCoreId, [checkerCoreId]() {
+                    allCPUMeta[checkerCoreId].baseCPU->wakeup(0);
+                });
                 if (checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).checkerStartWakeupTick == 0) {
                     // First time wakeup
                     checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).checkerStartWakeupTick = curTick();
@@ -460,32 +615,46 @@ void loadstorelogentry::mainDoCheckpoint(BaseCPU* cpu, bool wasSyscall) {
         assert(mainCPUMeta.at(cpuID).timestamp==1);
         cpu->committedInstrs = 0;
         checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).currentCommittedInstructions = 0;
+        checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).noc.reset();
+        checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).stream.reset();
+        checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).vote.reset();
         checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).checkerLSLStallCycles = 0;
-        checkerCPUMeta[cpuID*NUMBEROFCHECKERCORESPERCORE].segmentFree = false;
+        if (checkerCPUMeta[cpuID*NUMBEROFCHECKERCORESPERCORE].segment.free()) {
+            ring(cpuID).produce(checkerCPUMeta[cpuID*NUMBEROFCHECKERCORESPERCORE].segment,
+                                checkerCPUMeta[cpuID*NUMBEROFCHECKERCORESPERCORE].timestamps);
+        }
         checkerCPUMeta[checkerCoreId-NUMBEROFMAINCORES].mainStartingTick = curTick();
         checkerCPUMeta[checkerCoreId-NUMBEROFMAINCORES].initHash();
         mainCPUMeta.at(cpuID).current_entry = 0;
         mainCPUMeta.at(cpuID).current_size = 0;
+        if (compressor)
+            compressor->reset(cpuID);
+        checkerCPUMeta[checkerCoreId-NUMBEROFMAINCORES].overflow.reset();
+        checkerCPUMeta[checkerCoreId-NUMBEROFMAINCORES].undo.clear();
         std::cout << "\n\nSeed: " << errorinjection::seed << "\n\n" << std::endl;
         // We're outputing the seed here since it only occurs once and the seed is useful for debugging.
         assert(checkerCPUMeta.at(checkerCoreId-NUMBEROFMAINCORES).expectedFinalContext.checked);
         loadstorelogentry::updateMainComparisonContexts(cpu);
         assert(mainCPUMeta.at(cpuID).previousThreadContext.initialized);
         loadstorelogentry::copy_main_registers_to_checker(cpu,checkerCoreId);
-        assert(!checkerCPUMeta[mainCPUMeta.at(cpuID).current_segment_to_fill].segmentFree);
+        assert(!checkerCPUMeta[mainCPUMeta.at(cpuID).current_segment_to_fill].segment.free());
     }
 
 }
 
 bool loadstorelogentry::mainShouldBlock(BaseCPU* cpu, bool should_wait, bool should_commit) {
     assert(cpu->getContext(0)->contextId() < mainCPUMeta.size());
+    ShardGuard guard(cpu->getContext(0)->contextId());
+    // The log entries already written cannot leave the core fast enough
+    bool nocFull = transport &&
+        transport->backpressured(cpu->getContext(0)->contextId(), curTick());
     if (!mainCPUMeta[cpu->getContext(0)->contextId()].mainCoreErroneous) {
         if (cpu->commitBlocked) {
             checkpointingCycles++;
             int cpuID = cpu->getContext(0)->contextId();
             if (// Checker was allocated
                 !checkerCPUMeta[mainCPUMeta.at(cpuID).current_segment_to_fill]
-                    .segmentFree && 
+                    .segment.free() && 
                 // The current segment is empty, checkpointing before starting
                 cpu->committedInstrs == 0 &&
                 // Stat was set before checkpointing finished
@@ -496,17 +665,28 @@ bool loadstorelogentry::mainShouldBlock(BaseCPU* cpu, bool should_wait, bool sho
                 checkerCPUMeta[mainCPUMeta.at(cpu->getContext(0)->contextId())
                     .current_segment_to_fill].mainStartingTick = curTick();
             }
+            ring(cpuID).sample(curTick(), true, segmentring::Checkpointing);
         } else if (cpu->havingASleep &&
             (!cpu->canContinueUnchecked() || cpu->isMain())) {
             noCheckerCycles++;
+            ring(cpu->getContext(0)->contextId())
+                .sample(curTick(), true, segmentring::NoChecker);
         } else if (should_wait && !should_commit) {
             blockingWaitCycles++;
+            ring(cpu->getContext(0)->contextId())
+                .sample(curTick(), true, segmentring::BlockingWait);
+        } else if (nocFull) {
+            ring(cpu->getContext(0)->contextId())
+                .sample(curTick(), true, segmentring::NoCBackpressure);
+        } else {
+            ring(cpu->getContext(0)->contextId())
+                .sample(curTick(), false, segmentring::NumStallCauses);
         }
     }
     if ((cpu->commitBlocked) ||
         (cpu->havingASleep &&
          (!cpu->canContinueUnchecked() || cpu->isMain())) ||
-        (should_wait && !should_commit))
+        (should_wait && !should_commit) || nocFull)
     {
         if (!mainCPUMeta[cpu->getContext(0)->contextId()].mainCoreErroneous) return true;
     }
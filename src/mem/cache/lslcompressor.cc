@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/lslcompressor.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/cache/compressors/base.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+/* Selector and payload of an address delta */
+unsigned
+addrDeltaBits(bool first, Addr addr, Addr last)
+{
+    if (first)
+        return 2 + 64;
+    int64_t d = (int64_t)(addr - last);
+    if (d == 0)
+        return 2;
+    for (unsigned w : {8, 16, 32}) {
+        int64_t lim = (int64_t)1 << (w - 1);
+        if (d >= -lim && d < lim)
+            return 2 + w;
+    }
+    return 2 + 64;
+}
+
+} // anonymous namespace
+
+lslcompressor::lslcompressor(statistics::Group *parent,
+                             compression::Base *_compressor, int mains,
+                             unsigned _blkSize)
+    : statistics::Group(parent, "lslCompression"),
+      compressor(_compressor), blkSize(_blkSize), streams(mains),
+      ADD_STAT(rawBits, statistics::units::Bit::get(),
+               "Bits the loadstorelog entries take uncompressed"),
+      ADD_STAT(headerBits, statistics::units::Bit::get(),
+               "Bits of compressed entry headers and zero flags"),
+      ADD_STAT(dataBits, statistics::units::Bit::get(),
+               "Bits of compressed data blocks"),
+      ADD_STAT(zeroElided, statistics::units::Count::get(),
+               "Data and old data fields elided as all zero"),
+      ADD_STAT(ratio, statistics::units::Ratio::get(),
+               "Uncompressed over compressed loadstorelog size",
+               rawBits / (headerBits + dataBits)),
+      ADD_STAT(segmentBytes, statistics::units::Byte::get(),
+               "Compressed size of each segment")
+{
+    fatal_if(!compressor, "LSL compression needs a compressor\n");
+    fatal_if(blkSize % sizeof(uint64_t), "LSL compression blocks of %d "
+             "bytes are not a whole number of words\n", blkSize);
+    for (auto &s : streams)
+        s.block.resize(blkSize / sizeof(uint64_t), 0);
+    segmentBytes.init(0, 65535, 1024).flags(statistics::pdf |
+                                           statistics::nozero);
+}
+
+lslcompressor::bits
+lslcompressor::entry(int main, Addr addr, bool merged,
+                     const uint8_t *data, unsigned size,
+                     const uint8_t *oldData, unsigned oldSize)
+{
+    stream &s = streams.at(main);
+    bits b{0, 0};
+    unsigned raw = 0;
+    unsigned elided = 0;
+
+    if (!merged) {
+        // Load or store and log2 of the access size, then the address
+        b.header = 4 + addrDeltaBits(s.first, addr, s.lastAddr);
+        raw += rawHeaderBits;
+    }
+    s.lastAddr = addr;
+    s.first = false;
+
+    const uint8_t *fields[] = {data, oldData};
+    const unsigned sizes[] = {size, oldSize};
+    for (int f = 0; f < 2; f++) {
+        if (!sizes[f])
+            continue;
+        raw += 8 * sizes[f];
+        b.header++;
+        if (std::all_of(fields[f], fields[f] + sizes[f],
+                        [](uint8_t c) { return c == 0; })) {
+            elided++;
+            continue;
+        }
+        add(s, fields[f], sizes[f], b.data);
+    }
+
+    s.finalBits += b.header + b.data;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        rawBits += raw;
+        zeroElided += elided;
+        headerBits += b.header;
+    }
+    return b;
+}
+
+void
+lslcompressor::add(stream &s, const uint8_t *data, unsigned size,
+                   unsigned &out)
+{
+    uint8_t *block = reinterpret_cast<uint8_t *>(s.block.data());
+    while (size > 0) {
+        unsigned chunk = std::min(size, blkSize - s.fill);
+        std::memcpy(block + s.fill, data, chunk);
+        s.fill += chunk;
+        data += chunk;
+        size -= chunk;
+        if (s.fill == blkSize)
+            out += compressBlock(s);
+    }
+}
+
+unsigned
+lslcompressor::compressBlock(stream &s)
+{
+    unsigned n;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        Cycles comp_lat, decomp_lat;
+        n = compressor->compress(s.block.data(), comp_lat, decomp_lat)
+                ->getSizeBits();
+        dataBits += n;
+    }
+    std::fill(s.block.begin(), s.block.end(), 0);
+    s.fill = 0;
+    return n;
+}
+
+unsigned
+lslcompressor::flush(int main)
+{
+    stream &s = streams.at(main);
+    unsigned n = s.fill ? compressBlock(s) : 0;
+    s.finalBits += n;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        segmentBytes.sample(divCeil(s.finalBits, 8));
+    }
+    reset(main);
+    return n;
+}
+
+void
+lslcompressor::reset(int main)
+{
+    stream &s = streams.at(main);
+    std::fill(s.block.begin(), s.block.end(), 0);
+    s.fill = 0;
+    s.first = true;
+    s.finalBits = 0;
+}
+
+uint64_t
+lslcompressor::logBits(int main) const
+{
+    const stream &s = streams.at(main);
+    return s.finalBits + 8 * s.fill;
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LSLCOMPRESSOR_HH__
+#define __LSLCOMPRESSOR_HH__
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace compression
+{
+class Base;
+}
+
+/* Size the loadstorelog entries of each main core would take if the main
+ * core compressed them before they go into the log and onto the NoC, with
+ * --lslCompressor. Nothing is actually compressed in the log, only its
+ * size is modelled:
+ *  - the address is sent as a delta against the previous entry of the
+ *    segment, in the narrowest of 0, 8, 16 or 32 bits that holds it, or in
+ *    full;
+ *  - data and old data that are all zero are elided, leaving only a flag;
+ *  - the remaining data and old data are packed into blocks of the
+ *    compressor's block size, which are compressed as a whole by one of
+ *    the cache compressors (BDI, FPC, C-Pack, ...).
+ * Bytes waiting for their block to fill are counted uncompressed, so the
+ * log size is never underestimated. The last block of a segment is padded
+ * with zeroes when the segment ends. Every call is made under the main
+ * core's loadstorelog shard lock.
+ */
+class lslcompressor : public statistics::Group
+{
+  public:
+    /* Bits of one entry that are final once it has been pushed */
+    struct bits
+    {
+        unsigned header;
+        // Compressed blocks completed by this entry
+        unsigned data;
+    };
+
+    lslcompressor(statistics::Group *parent, compression::Base *compressor,
+                  int mains, unsigned blkSize);
+
+    /* merged entries continue the previous entry's micro-op, so they
+     * add data but no header */
+    bits entry(int main, Addr addr, bool merged,
+               const uint8_t *data, unsigned size,
+               const uint8_t *oldData, unsigned oldSize);
+
+    /* The segment of main ends: compress what is left of its block and
+     * start the next segment from scratch */
+    unsigned flush(int main);
+    void reset(int main);
+
+    /* Log bits used by the current segment of main */
+    uint64_t logBits(int main) const;
+
+    // Uncompressed size of an entry, as the NoC model assumes without one
+    static const unsigned rawHeaderBits = 64;
+
+  private:
+    struct stream
+    {
+        Addr lastAddr = 0;
+        bool first = true;
+        std::vector<uint64_t> block;
+        unsigned fill = 0;
+        uint64_t finalBits = 0;
+    };
+
+    void add(stream &s, const uint8_t *data, unsigned size, unsigned &out);
+    unsigned compressBlock(stream &s);
+
+    compression::Base *const compressor;
+    const unsigned blkSize;
+    std::vector<stream> streams;
+    // The compressor and its stats are shared by every main core
+    std::mutex lock;
+
+    statistics::Scalar rawBits;
+    statistics::Scalar headerBits;
+    statistics::Scalar dataBits;
+    statistics::Scalar zeroElided;
+    statistics::Formula ratio;
+    statistics::Distribution segmentBytes;
+};
+
+}
+#endif
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/lslstreambuffer.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+lslstreambuffer::lslstreambuffer(statistics::Group *parent, unsigned _depth,
+                                 Cycles _latency)
+    : statistics::Group(parent, "lslStream"),
+      depth(_depth), latency(_latency),
+      ADD_STAT(hits, statistics::units::Count::get(),
+               "Checker loads whose entry was already in the stream buffer"),
+      ADD_STAT(inFlight, statistics::units::Count::get(),
+               "Checker loads blocked on an entry on its way to the buffer"),
+      ADD_STAT(notAppended, statistics::units::Count::get(),
+               "Checker loads blocked on an entry not appended yet"),
+      ADD_STAT(demandFetches, statistics::units::Count::get(),
+               "Entries fetched on demand from outside the window"),
+      ADD_STAT(suppressedWakeups, statistics::units::Count::get(),
+               "Appends a blocked checker was not woken and retried for"),
+      ADD_STAT(waitTicks, statistics::units::Tick::get(),
+               "Ticks a blocked checker load waited for its entry")
+{
+    fatal_if(!depth, "The LSL stream buffer needs a non-zero depth\n");
+    waitTicks.init(0, 99999, 1000).flags(statistics::pdf |
+                                         statistics::nozero);
+}
+
+void
+lslstreambuffer::fetch(lslstreamwindow &w, unsigned entry, Tick now,
+                       Tick period)
+{
+    w.arrival[entry] = now + latency * period;
+}
+
+void
+lslstreambuffer::admit(lslstreamwindow &w, Tick now, Tick period)
+{
+    const unsigned end = std::min<size_t>(w.arrival.size(), w.head + depth);
+    for (unsigned i = w.head; i < end; i++) {
+        if (w.arrival[i] == MaxTick)
+            fetch(w, i, now, period);
+    }
+}
+
+Tick
+lslstreambuffer::append(lslstreamwindow &w, unsigned complete, Tick now,
+                        Tick period)
+{
+    if (complete > w.arrival.size())
+        w.arrival.resize(complete, MaxTick);
+    admit(w, now, period);
+
+    if (w.waitFor < 0 || w.waitFor >= (int)w.arrival.size())
+        return MaxTick;
+    if (w.arrival[w.waitFor] == MaxTick) {
+        ++demandFetches;
+        fetch(w, w.waitFor, now, period);
+    }
+    Tick ready = w.arrival[w.waitFor];
+    waitTicks.sample(ready - w.waitSince);
+    w.waitFor = -1;
+    return ready;
+}
+
+bool
+lslstreambuffer::read(lslstreamwindow &w, unsigned entry, Tick now,
+                      Tick period, Tick &ready)
+{
+    if (entry >= w.arrival.size()) {
+        ++notAppended;
+        ready = MaxTick;
+        if (w.waitFor < 0) {
+            w.waitFor = entry;
+            w.waitSince = now;
+        } else {
+            // Out of order loads, wait for the oldest
+            w.waitFor = std::min<int>(w.waitFor, entry);
+        }
+        return false;
+    }
+    if (w.arrival[entry] == MaxTick) {
+        ++demandFetches;
+        fetch(w, entry, now, period);
+    }
+    ready = w.arrival[entry];
+    if (ready <= now) {
+        ++hits;
+        return true;
+    }
+    ++inFlight;
+    waitTicks.sample(ready - now);
+    return false;
+}
+
+void
+lslstreambuffer::consume(lslstreamwindow &w, unsigned entry, Tick now,
+                         Tick period)
+{
+    w.head = std::max(w.head, entry + 1);
+    admit(w, now, period);
+}
+
+}
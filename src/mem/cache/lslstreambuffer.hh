@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LSLSTREAMBUFFER_HH__
+#define __LSLSTREAMBUFFER_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/* What the stream buffer of a checker holds of one segment. It lives in the
+ * segment's CheckerCPUMeta so it follows the segment when a spare slot is
+ * swapped in. */
+struct lslstreamwindow
+{
+    // Tick each complete entry reaches the buffer, MaxTick until fetched
+    std::vector<Tick> arrival;
+    // Entries before head have been read past and are no longer fetched
+    unsigned head = 0;
+    // Entry the checker is blocked on until it is appended, -1 for none
+    int waitFor = -1;
+    Tick waitSince = 0;
+    // Earliest wakeup of the checker already scheduled
+    Tick wakeAt = MaxTick;
+
+    void
+    reset()
+    {
+        arrival.clear();
+        head = 0;
+        waitFor = -1;
+        waitSince = 0;
+        wakeAt = MaxTick;
+    }
+};
+
+/* Checker-side stream unit in front of the loadstorelog, with
+ * --lslStreamDepth. It fetches the depth entries after the last one the
+ * checker read as soon as the main core completes them, each taking
+ * latency checker cycles to reach the buffer, and a checker load is only
+ * let through once its entry is in the buffer. An entry outside the window
+ * is fetched on demand. A checker whose entry has not been appended yet
+ * waits for the append that completes it rather than being woken and
+ * retried on every append of its segment, and one whose entry is on its way
+ * is woken when it arrives. Every call is made under the shard lock of the
+ * segment's main core. */
+class lslstreambuffer : public statistics::Group
+{
+  public:
+    lslstreambuffer(statistics::Group *parent, unsigned depth,
+                    Cycles latency);
+
+    /* The first complete entries of w have been appended by now. Returns
+     * the tick the entry the checker waits for arrives, MaxTick if it
+     * still has not been appended or nothing waits. */
+    Tick append(lslstreamwindow &w, unsigned complete, Tick now,
+                Tick period);
+
+    /* The checker reads entry. Returns whether it is in the buffer by now;
+     * if not, the tick it will be, MaxTick if it has not been appended
+     * yet, in which case the checker waits for it. */
+    bool read(lslstreamwindow &w, unsigned entry, Tick now, Tick period,
+              Tick &ready);
+
+    /* The checker has read entry, so the window moves past it */
+    void consume(lslstreamwindow &w, unsigned entry, Tick now, Tick period);
+
+    /* An append was not passed on to the checker waiting on w */
+    void suppressed() { ++suppressedWakeups; }
+
+    const unsigned depth;
+    const Cycles latency;
+
+  private:
+    void fetch(lslstreamwindow &w, unsigned entry, Tick now, Tick period);
+    void admit(lslstreamwindow &w, Tick now, Tick period);
+
+    statistics::Scalar hits;
+    statistics::Scalar inFlight;
+    statistics::Scalar notAppended;
+    statistics::Scalar demandFetches;
+    statistics::Scalar suppressedWakeups;
+    statistics::Distribution waitTicks;
+};
+
+}
+#endif
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/lsltransport.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+class crossbar : public lsltransport
+{
+  public:
+    crossbar(statistics::Group *parent, int mains, int checkersPerMain,
+             const config &cfg)
+        : lsltransport(parent, mains, checkersPerMain, cfg)
+    {
+        initLinks(2 * nodes);
+    }
+
+    const char *name() const override { return "crossbar"; }
+
+  protected:
+    void
+    route(int src, int dst, std::vector<int> &links) const override
+    {
+        links.push_back(injectionLink(src));
+        links.push_back(ejectionLink(dst));
+    }
+};
+
+class mesh : public lsltransport
+{
+  public:
+    mesh(statistics::Group *parent, int mains, int checkersPerMain,
+         const config &cfg)
+        : lsltransport(parent, mains, checkersPerMain, cfg),
+          cols(cfg.meshCols ? cfg.meshCols :
+               (int)std::ceil(std::sqrt((double)nodes)))
+    {
+        fatal_if(cols > nodes, "--lslNoCMeshCols %d is wider than the %d "
+                 "nodes\n", cols, nodes);
+        // Ports, then one outgoing link per direction per router
+        initLinks(2 * nodes + NumDirs * nodes);
+    }
+
+    const char *name() const override { return "mesh"; }
+
+  protected:
+    void
+    route(int src, int dst, std::vector<int> &links) const override
+    {
+        links.push_back(injectionLink(src));
+        int x = src % cols, y = src / cols;
+        const int dx = dst % cols, dy = dst / cols;
+        while (x != dx) {
+            Dir d = x < dx ? East : West;
+            links.push_back(dirLink(y * cols + x, d));
+            x += d == East ? 1 : -1;
+        }
+        while (y != dy) {
+            Dir d = y < dy ? South : North;
+            links.push_back(dirLink(y * cols + x, d));
+            y += d == South ? 1 : -1;
+        }
+        links.push_back(ejectionLink(dst));
+    }
+
+  private:
+    enum Dir { East, West, North, South, NumDirs };
+
+    int
+    dirLink(int node, Dir d) const
+    {
+        return 2 * nodes + node * NumDirs + d;
+    }
+
+    const int cols;
+};
+
+} // anonymous namespace
+
+lsltransport::lsltransport(statistics::Group *parent, int mains,
+                           int _checkersPerMain, const config &_cfg)
+    : statistics::Group(parent, "lslNoC"),
+      checkersPerMain(_checkersPerMain),
+      nodes(mains * (_checkersPerMain + 1)),
+      cfg(_cfg),
+      packetFlits(divCeil(_cfg.packetBits, _cfg.width)),
+      paths(mains),
+      ADD_STAT(packets, statistics::units::Count::get(),
+               "Packets of loadstorelog entries sent to checkers"),
+      ADD_STAT(flits, statistics::units::Count::get(),
+               "Flits of those packets"),
+      ADD_STAT(payloadBits, statistics::units::Bit::get(),
+               "Bits of loadstorelog entries carried"),
+      ADD_STAT(contentionCycles, statistics::units::Cycle::get(),
+               "NoC cycles packets waited for busy links"),
+      ADD_STAT(latency, statistics::units::Cycle::get(),
+               "NoC cycles from sending a packet to its tail arriving"),
+      ADD_STAT(hops, statistics::units::Count::get(),
+               "Links on the route of each packet, ports included")
+{
+    fatal_if(!cfg.clockPeriod || !cfg.width || !cfg.packetBits,
+             "--lslNoC needs a non-zero clock, width and packet size\n");
+    packets.init(mains).flags(statistics::total);
+    flits.init(mains).flags(statistics::total);
+    payloadBits.init(mains).flags(statistics::total);
+    contentionCycles.init(mains).flags(statistics::total);
+    latency.init(mains, 0, 255, 8).flags(statistics::pdf |
+                                         statistics::nozero);
+    hops.init(mains, 0, 31, 1).flags(statistics::pdf | statistics::nozero);
+}
+
+void
+lsltransport::initLinks(int links)
+{
+    busyUntil.reset(new std::atomic<Tick>[links]);
+    for (int l = 0; l < links; l++)
+        busyUntil[l].store(0, std::memory_order_relaxed);
+}
+
+std::unique_ptr<lsltransport>
+lsltransport::create(statistics::Group *parent, const std::string &topology,
+                     int mains, int checkersPerMain, const config &cfg)
+{
+    if (topology == "ideal")
+        return nullptr;
+    if (topology == "crossbar")
+        return std::make_unique<crossbar>(parent, mains, checkersPerMain,
+                                          cfg);
+    if (topology == "mesh")
+        return std::make_unique<mesh>(parent, mains, checkersPerMain, cfg);
+    fatal("Unknown LSL NoC %s (ideal, crossbar or mesh)\n", topology);
+}
+
+void
+lsltransport::push(lslstream &s, int main, int checker, unsigned bits,
+                   uint64_t bound, bool flush, Tick now)
+{
+    s.openBits += bits;
+    while (s.openBits >= cfg.packetBits) {
+        send(s, main, checker, cfg.packetBits, bound, now);
+        s.openBits -= cfg.packetBits;
+    }
+    // The last packet of a segment goes even if it is empty, as it is what
+    // lets the checker run to the end
+    if (flush) {
+        send(s, main, checker, std::max(s.openBits, 1u), bound, now);
+        s.openBits = 0;
+    }
+}
+
+Tick
+lsltransport::claim(int link, Tick t, unsigned flits)
+{
+    Tick busy = busyUntil[link].load(std::memory_order_relaxed);
+    Tick start;
+    do {
+        start = std::max(t, busy);
+    } while (!busyUntil[link].compare_exchange_weak(
+                 busy, start + flits * cfg.clockPeriod,
+                 std::memory_order_relaxed));
+    return start;
+}
+
+void
+lsltransport::send(lslstream &s, int main, int checker, unsigned bits,
+                   uint64_t bound, Tick now)
+{
+    const Tick period = cfg.clockPeriod;
+    const unsigned n = divCeil(bits, cfg.width);
+
+    std::vector<int> &path = paths[main];
+    path.clear();
+    route(mainNode(main), checkerNode(checker), path);
+
+    // Each link is held from the head arriving until the tail has left
+    Tick t = now;
+    for (int link : path) {
+        Tick start = claim(link, t, n);
+        contentionCycles[main] += (start - t) / period;
+        t = start + cfg.hopCycles * period;
+    }
+    Tick arrival = t + (n - 1) * period;
+
+    // A later packet can never overtake an earlier one of the same stream
+    if (!s.inFlight.empty())
+        arrival = std::max(arrival, s.inFlight.back().arrival);
+    s.inFlight.push_back({arrival, bound});
+
+    ++packets[main];
+    flits[main] += n;
+    payloadBits[main] += bits;
+    latency[main].sample((arrival - now) / period);
+    hops[main].sample(path.size());
+}
+
+uint64_t
+lsltransport::delivered(lslstream &s, Tick now)
+{
+    while (!s.inFlight.empty() && s.inFlight.front().arrival <= now) {
+        s.delivered = s.inFlight.front().bound;
+        s.inFlight.pop_front();
+    }
+    return s.delivered;
+}
+
+bool
+lsltransport::backpressured(int main, Tick now)
+{
+    Tick queued = busyUntil[injectionLink(mainNode(main))].load(
+        std::memory_order_relaxed);
+    return queued > now + cfg.queuePackets * packetFlits * cfg.clockPeriod;
+}
+
+}
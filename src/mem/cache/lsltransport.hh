@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LSLTRANSPORT_HH__
+#define __LSLTRANSPORT_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/* Packets of loadstorelog entries on their way from a main core to the
+ * checker of one segment. It lives in the segment's CheckerCPUMeta so it
+ * follows the segment when a spare slot is swapped in. */
+struct lslstream
+{
+    struct packet
+    {
+        Tick arrival;
+        // Instructions the checker may commit once this has arrived
+        uint64_t bound;
+    };
+
+    // Entry bits pushed since the last packet left
+    unsigned openBits = 0;
+    std::deque<packet> inFlight;
+    uint64_t delivered = 0;
+
+    void
+    reset()
+    {
+        openBits = 0;
+        inFlight.clear();
+        delivered = 0;
+    }
+};
+
+/* Moves loadstorelog entries from the main cores to their checkers over a
+ * modelled on-chip network, instead of making them visible to the checker
+ * as soon as they are written. Entries are packed into packets of
+ * packetBits, which are cut into flits of the link width. Every link can
+ * carry one flit per NoC cycle and a packet holds each link on its route
+ * until its tail has left it, so packets from different main cores contend
+ * for shared links. The checker-side buffer is the log itself, so there is
+ * no extra credit loop at the checker; a main core is held back once more
+ * than queuePackets packets wait at its injection port.
+ * A main core only sends under its own loadstorelog shard lock, so all
+ * other state is kept per main core, and links shared between main cores
+ * are claimed atomically without any lock of their own.
+ * Main core m sits at node m * (C + 1) followed by its C checkers, in id
+ * order. Selected with --lslNoC:
+ *  ideal    - no model, entries are visible as soon as they are written.
+ *  crossbar - every node has an injection and an ejection port into one
+ *             crossbar, so packets only contend at the ports.
+ *  mesh     - nodes in row-major order on a mesh of meshCols columns with
+ *             XY routing, one hop per router.
+ * Packets are timed when they are sent, so with several event queues the
+ * order they claim links in follows the host threads within a quantum.
+ */
+class lsltransport : public statistics::Group
+{
+  public:
+    struct config
+    {
+        Tick clockPeriod;
+        unsigned width;
+        unsigned packetBits;
+        unsigned hopCycles;
+        unsigned queuePackets;
+        unsigned meshCols;
+    };
+
+    virtual ~lsltransport() = default;
+
+    virtual const char *name() const = 0;
+
+    /* Null for ideal */
+    static std::unique_ptr<lsltransport> create(
+        statistics::Group *parent, const std::string &topology,
+        int mains, int checkersPerMain, const config &cfg);
+
+    /* Main core main wrote bits of log entries to s, which checker checks;
+     * bound is how far the checker may then commit. flush sends a partly
+     * filled packet, at the end of the segment. */
+    void push(lslstream &s, int main, int checker, unsigned bits,
+              uint64_t bound, bool flush, Tick now);
+
+    /* Bound of the last packet of s to have arrived by now */
+    uint64_t delivered(lslstream &s, Tick now);
+
+    /* The injection queue of main is full */
+    bool backpressured(int main, Tick now);
+
+  protected:
+    lsltransport(statistics::Group *parent, int mains, int checkersPerMain,
+                 const config &cfg);
+
+    int mainNode(int main) const { return main * (checkersPerMain + 1); }
+    int
+    checkerNode(int checker) const
+    {
+        return mainNode(checker / checkersPerMain) + 1 +
+               checker % checkersPerMain;
+    }
+
+    /* Links from node src to node dst, injection and ejection included */
+    virtual void route(int src, int dst, std::vector<int> &links) const = 0;
+
+    // Every node's injection port is link node, its ejection port link
+    // nodes + node; topologies number their own links after those
+    int injectionLink(int node) const { return node; }
+    int ejectionLink(int node) const { return nodes + node; }
+
+    /* Called once by each topology with the number of links it uses */
+    void initLinks(int links);
+
+    const int checkersPerMain;
+    const int nodes;
+    const config cfg;
+    const unsigned packetFlits;
+
+  private:
+    void send(lslstream &s, int main, int checker, unsigned bits,
+              uint64_t bound, Tick now);
+
+    /* Hold link for flits NoC cycles from the head arriving at t, and
+     * return when the head got it */
+    Tick claim(int link, Tick t, unsigned flits);
+
+    // Tick each link is free from
+    std::unique_ptr<std::atomic<Tick>[]> busyUntil;
+    // Route being claimed, by main core
+    std::vector<std::vector<int>> paths;
+
+    // By main core
+    statistics::Vector packets;
+    statistics::Vector flits;
+    statistics::Vector payloadBits;
+    statistics::Vector contentionCycles;
+    statistics::VectorDistribution latency;
+    statistics::VectorDistribution hops;
+};
+
+}
+#endif
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/samplepolicy.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+class randompolicy : public samplepolicy
+{
+  public:
+    randompolicy(statistics::Group *parent, int mains, const config &cfg)
+        : samplepolicy(parent, mains, cfg)
+    {}
+
+    const char *name() const override { return "random"; }
+
+  protected:
+    reason
+    decide(const summary &s, std::mt19937_64 &rng) override
+    {
+        std::uniform_real_distribution<double> roll(0, 1);
+        return roll(rng) < cfg.budget ? Explore : None;
+    }
+};
+
+class coveragepolicy : public samplepolicy
+{
+  public:
+    coveragepolicy(statistics::Group *parent, int mains, const config &cfg)
+        : samplepolicy(parent, mains, cfg)
+    {}
+
+    const char *name() const override { return "coverage"; }
+
+  protected:
+    reason
+    decide(const summary &s, std::mt19937_64 &rng) override
+    {
+        if (s.checkedFraction >= cfg.budget)
+            return None;
+        if (s.coverage < cfg.coverageTarget)
+            return Coverage;
+        if (s.phaseDistance > cfg.phaseThreshold)
+            return Phase;
+        std::uniform_real_distribution<double> roll(0, 1);
+        return roll(rng) < cfg.exploreRate ? Explore : None;
+    }
+};
+
+} // anonymous namespace
+
+samplepolicy::samplepolicy(statistics::Group *parent, int mains,
+                           const config &_cfg)
+    : statistics::Group(parent, "sampling"),
+      cfg(_cfg), cores(mains),
+      ADD_STAT(intervals, statistics::units::Count::get(),
+               "Sampling intervals completed by the main cores"),
+      ADD_STAT(checkedIntervals, statistics::units::Count::get(),
+               "Of those, intervals that were mostly checked"),
+      ADD_STAT(coverageTriggers, statistics::units::Count::get(),
+               "Samples started for instructions at unverified PCs"),
+      ADD_STAT(phaseTriggers, statistics::units::Count::get(),
+               "Samples started for a phase no checked one resembles"),
+      ADD_STAT(exploreTriggers, statistics::units::Count::get(),
+               "Samples started at random"),
+      ADD_STAT(newPhases, statistics::units::Count::get(),
+               "Checked intervals recorded as a new phase"),
+      ADD_STAT(observedInsts, statistics::units::Count::get(),
+               "Instructions committed by the main cores while sampling"),
+      ADD_STAT(checkedInsts, statistics::units::Count::get(),
+               "Of those, instructions that were checked"),
+      ADD_STAT(checkedFraction, statistics::units::Ratio::get(),
+               "Fraction of the instructions checked",
+               checkedInsts / observedInsts),
+      ADD_STAT(uncheckedCoverage, statistics::units::Ratio::get(),
+               "Mean fraction of the instructions of an unchecked interval "
+               "at PCs verified by then"),
+      ADD_STAT(uncheckedCoverageCI, statistics::units::Ratio::get(),
+               "Half width of the 95% confidence interval of "
+               "uncheckedCoverage"),
+      ADD_STAT(phaseDistance, statistics::units::Count::get(),
+               "Distance of unchecked intervals to the nearest checked "
+               "phase, in hundredths")
+{
+    fatal_if(!cfg.interval,
+             "--samplePolicy needs a non-zero --samplePeriod\n");
+    fatal_if(cfg.budget <= 0 || cfg.budget > 1,
+             "--sampleBudget %f is not a fraction\n", cfg.budget);
+    for (int m = 0; m < mains; m++)
+        cores[m].rng.seed(m);
+    uncheckedCoverage.functor([this]() {
+        return covN ? covSum / covN : 0.0;
+    });
+    uncheckedCoverageCI.functor([this]() {
+        if (covN < 2)
+            return 0.0;
+        double mean = covSum / covN;
+        double var = std::max(0.0, (covSumSq - covN * mean * mean) /
+                                   (covN - 1));
+        return 1.96 * std::sqrt(var / covN);
+    });
+    phaseDistance.init(0, 199, 10).flags(statistics::pdf |
+                                         statistics::nozero);
+}
+
+std::unique_ptr<samplepolicy>
+samplepolicy::create(statistics::Group *parent, const std::string &name,
+                     int mains, const config &cfg)
+{
+    if (name == "periodic")
+        return nullptr;
+    if (name == "random")
+        return std::make_unique<randompolicy>(parent, mains, cfg);
+    if (name == "coverage")
+        return std::make_unique<coveragepolicy>(parent, mains, cfg);
+    fatal("Unknown sample policy %s (periodic, random or coverage)\n", name);
+}
+
+void
+samplepolicy::observe(int main, Addr pc, bool covered, bool checked)
+{
+    core &c = cores[main];
+    c.insts++;
+    c.uncovered += !covered;
+    c.checkedInsts += checked;
+    // Fibonacci hashing of the instruction address
+    c.sig[((pc >> 2) * 0x9e3779b97f4a7c15ULL) >> 59]++;
+    if (c.insts == cfg.interval)
+        close(c);
+}
+
+double
+samplepolicy::distance(const signature &a, const signature &b)
+{
+    double d = 0;
+    for (int i = 0; i < SigBuckets; i++)
+        d += std::abs(a[i] - b[i]);
+    return d;
+}
+
+void
+samplepolicy::close(core &c)
+{
+    static_assert(SigBuckets == 32, "the signature hash keeps 5 bits");
+
+    signature sig;
+    for (int i = 0; i < SigBuckets; i++)
+        sig[i] = (double)c.sig[i] / c.insts;
+    double nearest = 2;
+    for (const signature &p : c.phases)
+        nearest = std::min(nearest, distance(sig, p));
+
+    c.totalInsts += c.insts;
+    c.totalChecked += c.checkedInsts;
+    const bool wasChecked = 2 * c.checkedInsts >= c.insts;
+    const double coverage = 1.0 - (double)c.uncovered / c.insts;
+    reason r = None;
+
+    if (wasChecked) {
+        if (nearest > cfg.phaseThreshold) {
+            if (c.phases.size() == MaxPhases)
+                c.phases.pop_front();
+            c.phases.push_back(sig);
+        }
+    } else if (!c.pending) {
+        summary s{coverage, nearest,
+                  (double)c.totalChecked / c.totalInsts};
+        r = decide(s, c.rng);
+        c.pending = r != None;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ++intervals;
+        observedInsts += c.insts;
+        checkedInsts += c.checkedInsts;
+        if (wasChecked) {
+            ++checkedIntervals;
+            if (nearest > cfg.phaseThreshold)
+                ++newPhases;
+        } else {
+            covSum += coverage;
+            covSumSq += coverage * coverage;
+            covN++;
+            phaseDistance.sample(std::lround(100 * nearest));
+        }
+        if (r == Coverage)
+            ++coverageTriggers;
+        else if (r == Phase)
+            ++phaseTriggers;
+        else if (r == Explore)
+            ++exploreTriggers;
+    }
+
+    c.insts = 0;
+    c.uncovered = 0;
+    c.checkedInsts = 0;
+    c.sig.fill(0);
+}
+
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SAMPLEPOLICY_HH__
+#define __SAMPLEPOLICY_HH__
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/* With --samplePeriod, decides which stretches of a main core's execution
+ * are checked, instead of checking one segment every period. The main
+ * core's commits are cut into intervals of --samplePeriod instructions.
+ * For each one it records how many instructions ran at PCs no checker has
+ * verified yet, using mainPCsChecked, and a basic block vector signature:
+ * committed PCs hashed into a few buckets. At the end of an unchecked
+ * interval the policy says whether checking restarts for the next segment.
+ * Selected with --samplePolicy:
+ *  periodic - no engine, one segment every --samplePeriod instructions.
+ *  random   - each interval with probability --sampleBudget.
+ *  coverage - while under --sampleBudget of the instructions checked, when
+ *             less than --sampleCoverage of the interval ran at verified
+ *             PCs, when its signature is further than
+ *             --samplePhaseThreshold from every checked phase, and
+ *             otherwise with probability --sampleExplore.
+ * The coverage of unchecked intervals, the fraction of their instructions
+ * at PCs verified by then, is reported with a 95% confidence interval
+ * over intervals. Each main core is only observed from its own event
+ * queue; the shared stats are updated under a lock once per interval.
+ */
+class samplepolicy : public statistics::Group
+{
+  public:
+    struct config
+    {
+        uint64_t interval;
+        double budget;
+        double coverageTarget;
+        double phaseThreshold;
+        double exploreRate;
+    };
+
+    virtual ~samplepolicy() = default;
+
+    virtual const char *name() const = 0;
+
+    /* Null for periodic */
+    static std::unique_ptr<samplepolicy> create(
+        statistics::Group *parent, const std::string &name, int mains,
+        const config &cfg);
+
+    /* Main core main committed the instruction at pc. covered if a checker
+     * has verified that pc, checked if this instance is being checked. */
+    void observe(int main, Addr pc, bool covered, bool checked);
+
+    /* main should restart checking at its next chance */
+    bool pending(int main) const { return cores[main].pending; }
+    void started(int main) { cores[main].pending = false; }
+
+    static const int SigBuckets = 32;
+    static const int MaxPhases = 16;
+
+  protected:
+    samplepolicy(statistics::Group *parent, int mains, const config &cfg);
+
+    enum reason { None, Coverage, Phase, Explore };
+
+    struct summary
+    {
+        // Fraction of the interval at verified PCs
+        double coverage;
+        // Manhattan distance of the normalised signature to the nearest
+        // checked phase, 2 if there is none
+        double phaseDistance;
+        // Fraction of the main core's instructions checked so far
+        double checkedFraction;
+    };
+
+    virtual reason decide(const summary &s, std::mt19937_64 &rng) = 0;
+
+    const config cfg;
+
+  private:
+    typedef std::array<double, SigBuckets> signature;
+
+    struct core
+    {
+        uint64_t insts = 0;
+        uint64_t uncovered = 0;
+        uint64_t checkedInsts = 0;
+        std::array<uint32_t, SigBuckets> sig{};
+        uint64_t totalInsts = 0;
+        uint64_t totalChecked = 0;
+        // Signatures of the phases checked so far, oldest first
+        std::deque<signature> phases;
+        bool pending = false;
+        std::mt19937_64 rng;
+    };
+
+    void close(core &c);
+    static double distance(const signature &a, const signature &b);
+
+    std::vector<core> cores;
+    std::mutex lock;
+
+    // For the confidence interval over unchecked intervals
+    double covSum = 0;
+    double covSumSq = 0;
+    uint64_t covN = 0;
+
+    statistics::Scalar intervals;
+    statistics::Scalar checkedIntervals;
+    statistics::Scalar coverageTriggers;
+    statistics::Scalar phaseTriggers;
+    statistics::Scalar exploreTriggers;
+    statistics::Scalar newPhases;
+    statistics::Scalar observedInsts;
+    statistics::Scalar checkedInsts;
+    statistics::Formula checkedFraction;
+    statistics::Value uncheckedCoverage;
+    statistics::Value uncheckedCoverageCI;
+    statistics::Distribution phaseDistance;
+};
+
+}
+#endif
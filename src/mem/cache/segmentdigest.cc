@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/segmentdigest.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SEGMENTDIGEST_SHA_X86 1
+#elif defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+#include <arm_neon.h>
+#define SEGMENTDIGEST_SHA_ARM 1
+#endif
+
+namespace gem5
+{
+
+Cycles
+segmentdigest::exposedCycles(uint64_t blocks, Cycles segmentCycles) const
+{
+    if (blocks == 0)
+        return Cycles(0);
+    uint64_t busy = blocks * latency;
+    uint64_t backlog = busy > segmentCycles + latency ?
+        busy - segmentCycles - latency : 0;
+    return Cycles(latency + backlog);
+}
+
+namespace
+{
+
+const uint32_t sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+inline uint32_t rotr32(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+inline uint64_t rotl64(uint64_t x, int n) { return (x << n) | (x >> (64 - n)); }
+
+/* The 16 message words of a block: each 64-bit word is split high half
+ * first, as the original checker hash did. */
+inline void
+sha256Words(const digestblock &block, uint32_t *w)
+{
+    for (int i = 0; i < 8; i++) {
+        w[2 * i] = block[i] >> 32;
+        w[2 * i + 1] = (uint32_t)block[i];
+    }
+}
+
+void
+sha256Portable(uint32_t *s, const digestblock &block)
+{
+    uint32_t w[64];
+    sha256Words(block, w);
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i-15], 7) ^ rotr32(w[i-15], 18) ^ (w[i-15] >> 3);
+        uint32_t s1 = rotr32(w[i-2], 17) ^ rotr32(w[i-2], 19) ^ (w[i-2] >> 10);
+        w[i] = w[i-16] + s0 + w[i-7] + s1;
+    }
+    uint32_t a = s[0], b = s[1], c = s[2], d = s[3];
+    uint32_t e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t S1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t temp1 = h + S1 + ch + sha256K[i] + w[i];
+        uint32_t S0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t temp2 = S0 + maj;
+        h = g; g = f; f = e; e = d + temp1;
+        d = c; c = b; b = a; a = temp1 + temp2;
+    }
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+
+#if SEGMENTDIGEST_SHA_X86
+__attribute__((target("sha,sse4.1"))) void
+sha256Accelerated(uint32_t *s, const digestblock &block)
+{
+    uint32_t w[16];
+    sha256Words(block, w);
+
+    __m128i tmp = _mm_loadu_si128((const __m128i *)&s[0]);
+    __m128i state1 = _mm_loadu_si128((const __m128i *)&s[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);          // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);    // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);    // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);         // CDGH
+    const __m128i abef = state0, cdgh = state1;
+
+    // Message schedule in groups of four words
+    __m128i msg[16];
+    for (int i = 0; i < 16; i++) {
+        if (i < 4) {
+            msg[i] = _mm_set_epi32(w[4*i+3], w[4*i+2], w[4*i+1], w[4*i]);
+        } else {
+            __m128i m = _mm_sha256msg1_epu32(msg[i-4], msg[i-3]);
+            m = _mm_add_epi32(m, _mm_alignr_epi8(msg[i-1], msg[i-2], 4));
+            msg[i] = _mm_sha256msg2_epu32(m, msg[i-1]);
+        }
+        __m128i k = _mm_loadu_si128((const __m128i *)&sha256K[4 * i]);
+        __m128i wk = _mm_add_epi32(msg[i], k);
+        state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+        wk = _mm_shuffle_epi32(wk, 0x0E);
+        state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+    }
+
+    state0 = _mm_add_epi32(state0, abef);
+    state1 = _mm_add_epi32(state1, cdgh);
+    tmp = _mm_shuffle_epi32(state0, 0x1B);       // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);    // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);    // ABEF
+    _mm_storeu_si128((__m128i *)&s[0], state0);
+    _mm_storeu_si128((__m128i *)&s[4], state1);
+}
+
+bool
+sha256HostAccelerated()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+}
+#elif SEGMENTDIGEST_SHA_ARM
+void
+sha256Accelerated(uint32_t *s, const digestblock &block)
+{
+    uint32_t w[16];
+    sha256Words(block, w);
+
+    uint32x4_t state0 = vld1q_u32(&s[0]);
+    uint32x4_t state1 = vld1q_u32(&s[4]);
+    const uint32x4_t abcd = state0, efgh = state1;
+
+    // Message schedule in groups of four words
+    uint32x4_t msg[16];
+    for (int i = 0; i < 16; i++) {
+        if (i < 4) {
+            msg[i] = vld1q_u32(&w[4 * i]);
+        } else {
+            msg[i] = vsha256su1q_u32(vsha256su0q_u32(msg[i-4], msg[i-3]),
+                                     msg[i-2], msg[i-1]);
+        }
+        uint32x4_t wk = vaddq_u32(msg[i], vld1q_u32(&sha256K[4 * i]));
+        uint32x4_t prev0 = state0;
+        state0 = vsha256hq_u32(state0, state1, wk);
+        state1 = vsha256h2q_u32(state1, prev0, wk);
+    }
+
+    vst1q_u32(&s[0], vaddq_u32(state0, abcd));
+    vst1q_u32(&s[4], vaddq_u32(state1, efgh));
+}
+
+bool sha256HostAccelerated() { return true; }
+#endif
+
+class sha256digest : public segmentdigest
+{
+    bool accelerated = false;
+
+  public:
+    explicit sha256digest(Cycles latency) : segmentdigest(latency)
+    {
+#if SEGMENTDIGEST_SHA_X86 || SEGMENTDIGEST_SHA_ARM
+        accelerated = sha256HostAccelerated();
+#endif
+    }
+
+    const char *name() const override { return "sha256"; }
+
+    void
+    init(digeststate &state) const override
+    {
+        state = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    }
+
+    void
+    compress(digeststate &state, const digestblock &block) const override
+    {
+        uint32_t s[8];
+        for (int i = 0; i < 8; i++)
+            s[i] = state[i];
+#if SEGMENTDIGEST_SHA_X86 || SEGMENTDIGEST_SHA_ARM
+        if (accelerated)
+            sha256Accelerated(s, block);
+        else
+#endif
+            sha256Portable(s, block);
+        for (int i = 0; i < 8; i++)
+            state[i] = s[i];
+    }
+};
+
+class crc64digest : public segmentdigest
+{
+    // Slicing-by-8 tables for the reflected ECMA-182 polynomial
+    uint64_t table[8][256];
+
+  public:
+    explicit crc64digest(Cycles latency) : segmentdigest(latency)
+    {
+        const uint64_t poly = 0xC96C5795D7870F42ULL;
+        for (int i = 0; i < 256; i++) {
+            uint64_t crc = i;
+            for (int j = 0; j < 8; j++)
+                crc = (crc >> 1) ^ ((crc & 1) ? poly : 0);
+            table[0][i] = crc;
+        }
+        for (int i = 0; i < 256; i++)
+            for (int t = 1; t < 8; t++)
+                table[t][i] = (table[t-1][i] >> 8) ^
+                              table[0][table[t-1][i] & 0xff];
+    }
+
+    const char *name() const override { return "crc64"; }
+
+    void
+    init(digeststate &state) const override
+    {
+        state.fill(0);
+        state[0] = ~0ULL;
+    }
+
+    void
+    compress(digeststate &state, const digestblock &block) const override
+    {
+        uint64_t crc = state[0];
+        for (uint64_t word : block) {
+            crc ^= word;
+            crc = table[7][crc & 0xff] ^ table[6][(crc >> 8) & 0xff] ^
+                  table[5][(crc >> 16) & 0xff] ^ table[4][(crc >> 24) & 0xff] ^
+                  table[3][(crc >> 32) & 0xff] ^ table[2][(crc >> 40) & 0xff] ^
+                  table[1][(crc >> 48) & 0xff] ^ table[0][crc >> 56];
+        }
+        state[0] = crc;
+    }
+};
+
+class xxh64digest : public segmentdigest
+{
+    static constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+
+  public:
+    explicit xxh64digest(Cycles latency) : segmentdigest(latency) {}
+
+    const char *name() const override { return "xxh64"; }
+
+    void
+    init(digeststate &state) const override
+    {
+        state.fill(0);
+        state[0] = P1 + P2;
+        state[1] = P2;
+        state[2] = 0;
+        state[3] = -P1;
+    }
+
+    void
+    compress(digeststate &state, const digestblock &block) const override
+    {
+        // Two 32-byte stripes per block, one word per lane each
+        for (int i = 0; i < 8; i++) {
+            uint64_t &acc = state[i & 3];
+            acc = rotl64(acc + block[i] * P2, 31) * P1;
+        }
+    }
+};
+
+}
+
+std::unique_ptr<segmentdigest>
+segmentdigest::create(const std::string &name, int latency)
+{
+    // Default latencies assume a dedicated unit next to the checker: about
+    // two SHA-256 rounds per cycle, and a word per cycle per lane otherwise.
+    if (name == "sha256")
+        return std::make_unique<sha256digest>(Cycles(latency ? latency : 32));
+    if (name == "crc64")
+        return std::make_unique<crc64digest>(Cycles(latency ? latency : 8));
+    if (name == "xxh64")
+        return std::make_unique<xxh64digest>(Cycles(latency ? latency : 2));
+    fatal("Unknown segment digest engine %s (sha256, crc64 or xxh64)\n",
+          name);
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SEGMENTDIGEST_HH__
+#define __SEGMENTDIGEST_HH__
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/* One 512-bit block of packed loadstorelog accesses, and the running digest
+ * state of a segment. Both sides (main and checker) pack their accesses into
+ * blocks identically, so only the compression function differs between
+ * engines; engines that need less than 8 words of state leave the rest 0.
+ */
+typedef std::array<uint64_t, 8> digestblock;
+typedef std::array<uint64_t, 8> digeststate;
+
+/* Digest engine for --hashed checking. Selected with --hashEngine:
+ *  sha256 - SHA-256 compression (what the hardware scheme assumes), using
+ *           SHA-NI or the ARMv8 crypto extensions on the host when present.
+ *  crc64  - CRC-64/XZ, catches all burst errors up to 64 bits but is not
+ *           collision resistant.
+ *  xxh64  - four independent xxHash64 lanes, 256 bits of state.
+ */
+class segmentdigest
+{
+  public:
+    virtual ~segmentdigest() = default;
+
+    virtual const char *name() const = 0;
+
+    virtual void init(digeststate &state) const = 0;
+
+    virtual void compress(digeststate &state,
+                          const digestblock &block) const = 0;
+
+    /* Checker cycles for the digest unit to absorb one block. Blocks are
+     * streamed while the checker runs, so only the final block and any
+     * backlog past the end of the segment are exposed (see exposedCycles). */
+    Cycles cyclesPerBlock() const { return latency; }
+
+    Cycles exposedCycles(uint64_t blocks, Cycles segmentCycles) const;
+
+    /* latency == 0 picks the engine's default */
+    static std::unique_ptr<segmentdigest> create(const std::string &name,
+                                                 int latency);
+
+  protected:
+    explicit segmentdigest(Cycles _latency) : latency(_latency) {}
+
+    Cycles latency;
+};
+
+}
+#endif
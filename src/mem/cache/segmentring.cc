@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/segmentring.hh"
+
+#include <algorithm>
+#include <string>
+
+namespace gem5
+{
+
+static const char *segstateNames[] = {
+    "free", "producing", "published", "consumed"
+};
+
+segmentring::segmentring(statistics::Group *parent, int mainID,
+                         std::vector<segmentslot *> _slots, int capacity)
+    : statistics::Group(parent,
+                        ("segmentRing" + std::to_string(mainID)).c_str()),
+      slots(std::move(_slots)),
+      ADD_STAT(produced, statistics::units::Count::get(),
+               "Segments allocated to the main core"),
+      ADD_STAT(published, statistics::units::Count::get(),
+               "Segments whose end checkpoint was taken"),
+      ADD_STAT(consumed, statistics::units::Count::get(),
+               "Segments validated by a checker"),
+      ADD_STAT(retired, statistics::units::Count::get(),
+               "Segments committed and freed"),
+      ADD_STAT(discarded, statistics::units::Count::get(),
+               "Segments freed without committing after a detected error"),
+      ADD_STAT(stolen, statistics::units::Count::get(),
+               "Idle checkers taken over from other main cores"),
+      ADD_STAT(lent, statistics::units::Count::get(),
+               "Checkers taken over by other main cores"),
+      ADD_STAT(occupancyDist, statistics::units::Count::get(),
+               "Number of segments in each state, sampled per cycle"),
+      ADD_STAT(stallCycles, statistics::units::Cycle::get(),
+               "Cycles the main core could not commit, by cause"),
+      ADD_STAT(noCheckerOldest, statistics::units::Cycle::get(),
+               "noChecker cycles by state of the oldest segment in flight")
+{
+    static_assert(sizeof(segstateNames) / sizeof(segstateNames[0]) ==
+                  (size_t)segstate::Num);
+
+    occupancyDist
+        .init((int)segstate::Num, 0, capacity, 1)
+        .flags(statistics::pdf | statistics::nozero);
+    for (int s = 0; s < (int)segstate::Num; s++)
+        occupancyDist.subname(s, segstateNames[s]);
+
+    stallCycles
+        .init(NumStallCauses)
+        .flags(statistics::total | statistics::nozero);
+    stallCycles.subname(Checkpointing, "checkpointing");
+    stallCycles.subname(NoChecker, "noChecker");
+    stallCycles.subname(BlockingWait, "blockingWait");
+    stallCycles.subname(NoCBackpressure, "nocBackpressure");
+
+    // Never Free, so index by state - 1
+    noCheckerOldest
+        .init((int)segstate::Num - 1)
+        .flags(statistics::total | statistics::nozero);
+    for (int s = 1; s < (int)segstate::Num; s++)
+        noCheckerOldest.subname(s - 1, segstateNames[s]);
+}
+
+void
+segmentring::produce(segmentslot &slot, uint64_t timestamp)
+{
+    assert(slot.free());
+    slot._state = segstate::Producing;
+    slot.timestamp = timestamp;
+    ++produced;
+}
+
+void
+segmentring::publish(segmentslot &slot)
+{
+    if (slot._state != segstate::Producing)
+        return;
+    slot._state = segstate::Published;
+    ++published;
+}
+
+void
+segmentring::consume(segmentslot &slot)
+{
+    // A checker that was woken with nothing to check has no segment to hand
+    // back, and one that is already waiting to retire stays that way.
+    if (slot.free() || slot.retirable())
+        return;
+    slot._state = segstate::Consumed;
+    ++consumed;
+}
+
+void
+segmentring::retire(segmentslot &slot)
+{
+    assert(!slot.free());
+    slot._state = segstate::Free;
+    ++retired;
+}
+
+void
+segmentring::discard(segmentslot &slot)
+{
+    assert(std::none_of(slots.begin(), slots.end(),
+        [&slot](const segmentslot *s) {
+            return s->retirable() && s->timestamp > slot.timestamp;
+        }));
+    slot._state = segstate::Free;
+    ++discarded;
+}
+
+void
+segmentring::adopt(const std::vector<segmentslot *> &checkerSlots)
+{
+    for (segmentslot *slot : checkerSlots) {
+        assert(slot->free());
+        slots.push_back(slot);
+    }
+    ++stolen;
+}
+
+void
+segmentring::release(const std::vector<segmentslot *> &checkerSlots)
+{
+    for (segmentslot *slot : checkerSlots) {
+        assert(slot->free());
+        slots.erase(std::find(slots.begin(), slots.end(), slot));
+    }
+    ++lent;
+}
+
+const segmentslot *
+segmentring::oldest() const
+{
+    const segmentslot *old = nullptr;
+    for (const segmentslot *slot : slots) {
+        if (!slot->free() && (!old || slot->timestamp < old->timestamp))
+            old = slot;
+    }
+    return old;
+}
+
+void
+segmentring::sample(Tick now, bool stalled, stallcause cause)
+{
+    if (now == lastSample)
+        return;
+    lastSample = now;
+
+    int count[(int)segstate::Num] = {};
+    for (const segmentslot *slot : slots)
+        count[(int)slot->_state]++;
+    for (int s = 0; s < (int)segstate::Num; s++)
+        occupancyDist[s].sample(count[s]);
+
+    if (!stalled)
+        return;
+    stallCycles[cause]++;
+    if (cause == NoChecker) {
+        // The ring is full; whatever the oldest segment is waiting for is
+        // what is holding the main core up.
+        const segmentslot *old = oldest();
+        if (old)
+            noCheckerOldest[(int)old->_state - 1]++;
+    }
+}
+
+}
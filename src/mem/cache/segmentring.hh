@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SEGMENTRING_HH__
+#define __SEGMENTRING_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/* Lifecycle of one loadstorelog segment. A main core is the only producer
+ * for its segments, and the checkers behind it are the consumers:
+ *  Free      - not allocated
+ *  Producing - allocated by allocate_little_for_big, the main core is
+ *              appending to the log
+ *  Published - the main core has taken the end checkpoint, so the expected
+ *              final context is there to compare against
+ *  Consumed  - the checker has validated the segment; it retires once every
+ *              older segment of the same main core has
+ * A checker may start on a segment while it is still being produced and can
+ * reach the end of it first, so "validating" is kept next to the state
+ * rather than being one of them.
+ */
+enum class segstate : uint8_t
+{
+    Free,
+    Producing,
+    Published,
+    Consumed,
+    Num
+};
+
+class segmentslot
+{
+    friend class segmentring;
+
+    segstate _state = segstate::Free;
+    bool _validating = false;
+    uint64_t timestamp = 0;
+
+  public:
+    segstate state() const { return _state; }
+    bool free() const { return _state == segstate::Free; }
+    bool retirable() const { return _state == segstate::Consumed; }
+
+    /* The checker has executed up to the end of the segment and waits in
+     * checkerCheckIfShouldSleep to compare its final context */
+    bool validating() const { return _validating; }
+    void beginValidate() { assert(!_validating); _validating = true; }
+    void endValidate() { _validating = false; }
+};
+
+/* The segments (checker slots, including the --extraSlot ones) of one main
+ * core. Every transition goes through here so the ring can account for
+ * them; all of them happen under the main core's loadstorelog shard lock.
+ * With --checkerPool=shared the slots of an idle checker move between
+ * rings, so capacity is the most the ring can ever hold.
+ */
+class segmentring : public statistics::Group
+{
+  public:
+    /* Why the main core could not commit this cycle (mainShouldBlock) */
+    enum stallcause
+    {
+        Checkpointing,
+        NoChecker,
+        BlockingWait,
+        NoCBackpressure,
+        NumStallCauses
+    };
+
+    segmentring(statistics::Group *parent, int mainID,
+                std::vector<segmentslot *> slots, int capacity);
+
+    void produce(segmentslot &slot, uint64_t timestamp);
+    void publish(segmentslot &slot);
+    void consume(segmentslot &slot);
+    void retire(segmentslot &slot);
+    /* Freed without committing, after the checker found an error. A
+     * rollback drops segments youngest first, so no younger one may still
+     * be waiting to retire */
+    void discard(segmentslot &slot);
+
+    /* Take over, or give up, the (free) slots of one checker core */
+    void adopt(const std::vector<segmentslot *> &checkerSlots);
+    void release(const std::vector<segmentslot *> &checkerSlots);
+
+    /* The main core has asked for a checkpoint but not taken it yet, so it
+     * stops appending to the segment */
+    bool publishing() const { return _publishing; }
+    void setPublishing(bool p) { _publishing = p; }
+
+    /* Called from mainShouldBlock, so at most once per cycle in which the
+     * main core has an instruction to commit; repeated calls within a tick
+     * are folded into the first. */
+    void sample(Tick now, bool stalled, stallcause cause);
+
+  private:
+    const segmentslot *oldest() const;
+
+    std::vector<segmentslot *> slots;
+    bool _publishing = false;
+    Tick lastSample = MaxTick;
+
+    statistics::Scalar produced;
+    statistics::Scalar published;
+    statistics::Scalar consumed;
+    statistics::Scalar retired;
+    statistics::Scalar discarded;
+    statistics::Scalar stolen;
+    statistics::Scalar lent;
+    statistics::VectorDistribution occupancyDist;
+    statistics::Vector stallCycles;
+    statistics::Vector noCheckerOldest;
+};
+
+}
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/stealpolicy.hh"
+
+#include <algorithm>
+#include <tuple>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+class nearestpolicy : public stealpolicy
+{
+  public:
+    const char *name() const override { return "nearest"; }
+
+    void
+    rank(int thief, std::vector<stealcandidate> &c) const override
+    {
+        std::sort(c.begin(), c.end(),
+                  [thief](const stealcandidate &a, const stealcandidate &b) {
+            return std::make_tuple(distance(thief, a), a.checker) <
+                   std::make_tuple(distance(thief, b), b.checker);
+        });
+    }
+};
+
+class eagerpolicy : public nearestpolicy
+{
+  public:
+    const char *name() const override { return "eager"; }
+
+    bool beforeExtraSlots() const override { return true; }
+};
+
+class richestpolicy : public stealpolicy
+{
+  public:
+    const char *name() const override { return "richest"; }
+
+    void
+    rank(int thief, std::vector<stealcandidate> &c) const override
+    {
+        std::sort(c.begin(), c.end(),
+                  [thief](const stealcandidate &a, const stealcandidate &b) {
+            return std::make_tuple(-a.ownerIdle, distance(thief, a),
+                                   a.checker) <
+                   std::make_tuple(-b.ownerIdle, distance(thief, b),
+                                   b.checker);
+        });
+    }
+};
+
+} // anonymous namespace
+
+std::unique_ptr<stealpolicy>
+stealpolicy::create(const std::string &name)
+{
+    if (name == "nearest")
+        return std::make_unique<nearestpolicy>();
+    if (name == "eager")
+        return std::make_unique<eagerpolicy>();
+    if (name == "richest")
+        return std::make_unique<richestpolicy>();
+    fatal("Unknown steal policy %s (nearest, eager or richest)\n", name);
+}
+
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __STEALPOLICY_HH__
+#define __STEALPOLICY_HH__
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gem5
+{
+
+/* A checker core a main core with no free slot could take over: all of its
+ * slots are free and it is suspended */
+struct stealcandidate
+{
+    // Index of the checker core into checkerCPUMeta
+    int checker;
+    // Main core it sits next to, the one it belongs to in a static pool
+    int home;
+    // Main core it is working for now
+    int owner;
+    // Idle checkers the owner has, this one included
+    int ownerIdle;
+};
+
+/* With --checkerPool=shared, decides which idle checker a main core takes
+ * when it has none of its own left. Selected with --stealPolicy:
+ *  nearest - only once every slot of the main core, --extraSlot ones
+ *            included, is in use; take the checker closest to it.
+ *  eager   - as nearest, but before queueing a segment in an extra slot
+ *            behind a checker that is still busy.
+ *  richest - as nearest, but take from the main core with the most idle
+ *            checkers, so lightly loaded cores give theirs up first.
+ * Every call is made under the stealing main core's loadstorelog shard lock.
+ */
+class stealpolicy
+{
+  public:
+    virtual ~stealpolicy() = default;
+
+    virtual const char *name() const = 0;
+
+    /* Steal before using the main core's own extra slots */
+    virtual bool beforeExtraSlots() const { return false; }
+
+    /* Order the candidates for main core thief, most preferred first */
+    virtual void rank(int thief, std::vector<stealcandidate> &c) const = 0;
+
+    static std::unique_ptr<stealpolicy> create(const std::string &name);
+
+    /* Affinity of a checker to a main core. Cores are assumed to be laid
+     * out in id order, so it is the distance between the main core and the
+     * checker's home; a checker going back home is always preferred. */
+    static int
+    distance(int thief, const stealcandidate &c)
+    {
+        return c.home == thief ? 0 : 1 + std::abs(c.home - thief);
+    }
+};
+
+}
+#endif
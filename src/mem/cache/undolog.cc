@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/undolog.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+void
+undolog::reserve(size_t log_entries)
+{
+    size_t size = std::max<size_t>(16, 4 * log_entries);
+    if (!isPowerOf2(size))
+        size = (size_t)1 << (floorLog2(size) + 1);
+    if (size <= table.size())
+        return;
+    assert(entries.empty());
+    table.assign(size, 0);
+    entries.reserve(size / 2);
+}
+
+void
+undolog::clear()
+{
+    // Keep the capacity for the next segment, and only free the slots used
+    _stores = 0;
+    for (const entry &e : entries)
+        table[e.slot] = 0;
+    entries.clear();
+}
+
+uint32_t
+undolog::find(Addr base)
+{
+    if (2 * (entries.size() + 1) > table.size())
+        grow();
+    const size_t mask = table.size() - 1;
+    size_t s = hash(base);
+    while (table[s] && entries[table[s] - 1].addr != base)
+        s = (s + 1) & mask;
+    if (table[s])
+        return table[s] - 1;
+
+    uint32_t i = entries.size();
+    entries.push_back({base, {}, s});
+    if (bytes.size() < entries.size() * lineSize)
+        bytes.resize(entries.size() * lineSize);
+    table[s] = i + 1;
+    return i;
+}
+
+void
+undolog::grow()
+{
+    table.assign(std::max<size_t>(16, 2 * table.size()), 0);
+    const size_t mask = table.size() - 1;
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        size_t s = hash(entries[i].addr);
+        while (table[s])
+            s = (s + 1) & mask;
+        table[s] = i + 1;
+        entries[i].slot = s;
+    }
+}
+
+void
+undolog::record(Addr addr, const uint8_t *old, unsigned size,
+                unsigned _lineSize)
+{
+    fatal_if(_lineSize > maxLineSize,
+             "Cache lines of %d bytes are too large for the undo log\n",
+             _lineSize);
+    lineSize = _lineSize;
+    _stores++;
+
+    while (size > 0) {
+        Addr base = roundDown(addr, lineSize);
+        unsigned offset = addr - base;
+        unsigned chunk = std::min(size, lineSize - offset);
+
+        uint32_t i = find(base);
+        entry &e = entries[i];
+        uint8_t *data = bytes.data() + i * lineSize;
+        for (unsigned b = 0; b < chunk; b++) {
+            if (!e.saved[offset + b]) {
+                e.saved[offset + b] = true;
+                data[offset + b] = old[b];
+            }
+        }
+
+        addr += chunk;
+        old += chunk;
+        size -= chunk;
+    }
+}
+
+void
+undolog::forEachLine(const std::function<void(const line &)> &fn) const
+{
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        const entry &e = entries[i];
+        fn({e.addr, e.saved, bytes.data() + i * lineSize,
+            e.saved.count() != lineSize});
+    }
+}
+
+uint64_t
+undolog::partialLines() const
+{
+    uint64_t n = 0;
+    for (const entry &e : entries)
+        n += e.saved.count() != lineSize;
+    return n;
+}
+
+uint64_t
+undolog::recoveryCycles(uint64_t lines, uint64_t partial)
+{
+    return (divCeil(partial, maxOutstanding) +
+            divCeil(lines, maxOutstanding)) * lineCycles;
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __UNDOLOG_HH__
+#define __UNDOLOG_HH__
+
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/* Values a loadstorelog segment's stores overwrote, kept per cache line so
+ * rolling the segment back is one functional write per line instead of a
+ * walk over every log entry. Only the first store to a byte records it,
+ * which is the value the byte had before the segment started. The storage
+ * is kept across segments, like the overflow slab, so it is bounded by the
+ * most lines a single segment ever touched.
+ */
+class undolog
+{
+  public:
+    static constexpr unsigned maxLineSize = 128;
+
+    /* A line whose bytes were only partly written has to be read back
+     * before it can be restored as a whole */
+    struct line
+    {
+        Addr addr;
+        std::bitset<maxLineSize> saved;
+        const uint8_t *data;
+        bool partial;
+    };
+
+    /* Sizes the line index for a segment of up to entries log entries,
+     * each of which touches at most two lines */
+    void reserve(size_t entries);
+
+    void clear();
+
+    /* A store of size bytes to addr is about to overwrite old */
+    void record(Addr addr, const uint8_t *old, unsigned size,
+                unsigned lineSize);
+
+    /* Calls fn for every line touched by the segment */
+    void forEachLine(const std::function<void(const line &)> &fn) const;
+
+    uint64_t stores() const { return _stores; }
+    uint64_t lines() const { return entries.size(); }
+    uint64_t partialLines() const;
+
+    /* Modeled cycles to restore lines lines, partial of which are read
+     * first. Lines are written back at memory latency with up to
+     * maxOutstanding in flight; the reads of partial lines go in an earlier
+     * round of their own. */
+    static uint64_t recoveryCycles(uint64_t lines, uint64_t partial);
+
+  private:
+    // Memory latency charged per write-back, as in print_times
+    static constexpr uint64_t lineCycles = 313;
+    static constexpr uint64_t maxOutstanding = 8;
+
+    struct entry
+    {
+        Addr addr;
+        std::bitset<maxLineSize> saved;
+        // Position in table, so clear() does not have to probe
+        size_t slot;
+    };
+
+    size_t
+    hash(Addr base) const
+    {
+        return ((base / lineSize) * 0x9e3779b97f4a7c15ULL) &
+            (table.size() - 1);
+    }
+
+    uint32_t find(Addr base);
+    void grow();
+
+    unsigned lineSize = 0;
+    uint64_t _stores = 0;
+    std::vector<entry> entries;
+    std::vector<uint8_t> bytes;
+    /* Open addressing with linear probing, as in pccoverage, kept at most
+     * half full. Holds 1 + the index into entries, 0 if the slot is free.
+     * A node based map would allocate for every new line of every
+     * segment. */
+    std::vector<uint32_t> table;
+};
+
+}
+#endif
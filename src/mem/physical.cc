@@ -55,6 +55,8 @@
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
 #include "mem/abstract_mem.hh"
+#include "mem/pmem_chunks.hh"
+#include "sim/eventq.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_exit.hh"
 
@@ -80,11 +82,18 @@ PhysicalMemory::PhysicalMemory(const std::string& _name,
                                const std::vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
                                const std::string& shared_backstore,
-                               bool auto_unlink_shared_backstore) :
+                               bool auto_unlink_shared_backstore,
+                               const std::string& cpt_format,
+                               unsigned cpt_threads, bool lazy_restore) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
     sharedBackstore(shared_backstore), sharedBackstoreSize(0),
-    pageSize(sysconf(_SC_PAGE_SIZE))
+    pageSize(sysconf(_SC_PAGE_SIZE)), chunkedCpt(cpt_format == "chunked"),
+    cptThreads(cpt_threads), lazyRestore(lazy_restore)
 {
+    fatal_if(cpt_format != "gzip" && cpt_format != "chunked",
+             "Unknown physical memory checkpoint format %s "
+             "(gzip or chunked)\n", cpt_format);
+
     // Register cleanup callback if requested.
     if (auto_unlink_shared_backstore && !sharedBackstore.empty()) {
         registerExitCallback([=]() { shm_unlink(shared_backstore.c_str()); });
@@ -347,6 +356,10 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     SERIALIZE_CONTAINER(lal_addr);
     SERIALIZE_CONTAINER(lal_cid);
 
+    // the stores are read wholesale from here on, possibly on several
+    // threads, so nothing can be left to fault in
+    finishLazyRestores();
+
     // serialize the backing stores
     unsigned int nbr_of_stores = backingStore.size();
     SERIALIZE_SCALAR(nbr_of_stores);
@@ -366,8 +379,10 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     // we cannot use the address range for the name as the
     // memories that are not part of the address map can overlap
     std::string filename =
-        name() + ".store" + std::to_string(store_id) + ".pmem";
+        name() + ".store" + std::to_string(store_id) +
+        (chunkedCpt ? ".pmemc" : ".pmem");
     long range_size = range.size();
+    std::string format = chunkedCpt ? "chunked" : "gzip";
 
     DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
             filename, range_size);
@@ -375,9 +390,14 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(format);
 
     // write memory file
     std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+    if (chunkedCpt) {
+        writeChunkedStore(filepath, pmem, range.size(), cptThreads);
+        return;
+    }
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
     if (compressed_mem == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
@@ -443,11 +463,6 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     std::string filepath = cp.getCptDir() + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
     AddrRange range = backingStore[store_id].range;
@@ -462,6 +477,25 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    // checkpoints from before the chunked format have no format entry
+    std::string format = "gzip";
+    optParamIn(cp, "format", format, false);
+    if (format == "chunked") {
+        // only fault chunks in when this thread is the only one touching
+        // the store
+        bool lazy = lazyRestore && numMainEventQueues == 1 &&
+            sharedBackstore.empty() && !backingStore[store_id].kvmMap;
+        readChunkedStore(filepath, pmem, range.size(), cptThreads, lazy);
+        return;
+    }
+    fatal_if(format != "gzip",
+             "Unknown physical memory checkpoint format %s\n", format);
+
+    // mmap memoryfile
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
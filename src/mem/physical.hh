@@ -158,6 +158,12 @@ class PhysicalMemory : public Serializable
 
     long pageSize;
 
+    // Write checkpoints in the chunked format (see pmem_chunks.hh), with
+    // this many host threads, and restore chunked ones on first touch
+    const bool chunkedCpt;
+    const unsigned cptThreads;
+    const bool lazyRestore;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -191,7 +197,9 @@ class PhysicalMemory : public Serializable
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
                    const std::string& shared_backstore,
-                   bool auto_unlink_shared_backstore);
+                   bool auto_unlink_shared_backstore,
+                   const std::string& cpt_format,
+                   unsigned cpt_threads, bool lazy_restore);
 
     /**
      * Unmap all the backing store we have used.
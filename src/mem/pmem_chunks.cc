@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/pmem_chunks.hh"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+namespace
+{
+
+const char chunkMagic[8] = {'g', 'e', 'm', '5', 'p', 'm', 'c', '1'};
+
+// Unit of compression and of lazy restore
+const uint32_t chunkSize = 1 << 20;
+// Unit of zero elision within a chunk
+const uint32_t zeroPageSize = 4096;
+
+struct ChunkHeader
+{
+    char magic[8];
+    uint32_t chunkSize;
+    uint32_t zeroPageSize;
+    uint64_t size;
+    uint64_t chunks;
+    uint64_t indexOffset;
+};
+
+/**
+ * Where a chunk is in the file and which of its pages are stored. Kept as
+ * a flat array of words per chunk: offset, compressed length, then the
+ * bitmap of non-zero pages.
+ */
+struct ChunkLayout
+{
+    uint64_t size;
+    uint32_t chunkSize;
+    uint32_t zeroPageSize;
+    uint64_t chunks;
+    uint64_t maskWords;
+
+    ChunkLayout(uint64_t _size, uint32_t chunk_size, uint32_t zero_page)
+        : size(_size), chunkSize(chunk_size), zeroPageSize(zero_page),
+          chunks(divCeil(_size, chunk_size)),
+          maskWords(divCeil(divCeil(chunk_size, zero_page), 64))
+    {}
+
+    uint64_t entryWords() const { return 2 + maskWords; }
+    uint64_t chunkStart(uint64_t c) const { return c * chunkSize; }
+    uint64_t
+    chunkLength(uint64_t c) const
+    {
+        return std::min<uint64_t>(chunkSize, size - chunkStart(c));
+    }
+};
+
+void
+writeAll(int fd, const void *buf, size_t len, off_t offset,
+         const std::string &path)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, offset);
+        if (n <= 0)
+            fatal("Write failed on physical memory checkpoint file '%s'\n",
+                  path);
+        p += n;
+        len -= n;
+        offset += n;
+    }
+}
+
+/** Only makes system calls, so it can be used in the fault handler */
+bool
+readFully(int fd, void *buf, size_t len, off_t offset)
+{
+    uint8_t *p = (uint8_t *)buf;
+    while (len > 0) {
+        ssize_t n = pread(fd, p, len, offset);
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= n;
+        offset += n;
+    }
+    return true;
+}
+
+void
+readAll(int fd, void *buf, size_t len, off_t offset,
+        const std::string &path)
+{
+    if (!readFully(fd, buf, len, offset))
+        fatal("Read failed on physical memory checkpoint file '%s'\n", path);
+}
+
+unsigned
+hostThreads(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    return std::max(threads, 1u);
+}
+
+/** Run fn(i, thread) for every i below n on up to threads host threads */
+void
+parallelFor(unsigned threads, uint64_t n,
+            const std::function<void(uint64_t, unsigned)> &fn)
+{
+    threads = std::min<uint64_t>(threads, n);
+    if (threads <= 1) {
+        for (uint64_t i = 0; i < n; i++)
+            fn(i, 0);
+        return;
+    }
+    std::atomic<uint64_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (uint64_t i = next++; i < n; i = next++)
+                fn(i, t);
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+}
+
+bool
+allZero(const uint8_t *p, uint64_t len)
+{
+    uint64_t word = 0;
+    uint64_t i = 0;
+    for (; i + sizeof(word) <= len; i += sizeof(word)) {
+        std::memcpy(&word, p + i, sizeof(word));
+        if (word)
+            return false;
+    }
+    for (; i < len; i++) {
+        if (p[i])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Gather the non-zero pages of chunk c and compress them into out, filling
+ * in its page bitmap. Leaves out empty if the chunk is all zero.
+ */
+void
+compressChunk(const ChunkLayout &layout, const uint8_t *pmem, uint64_t c,
+              std::vector<uint8_t> &pages, std::vector<uint8_t> &out,
+              uint64_t *mask)
+{
+    const uint8_t *chunk = pmem + layout.chunkStart(c);
+    uint64_t len = layout.chunkLength(c);
+
+    pages.clear();
+    std::fill(mask, mask + layout.maskWords, 0);
+    for (uint64_t off = 0, p = 0; off < len; off += layout.zeroPageSize, p++) {
+        uint64_t page_len = std::min<uint64_t>(layout.zeroPageSize, len - off);
+        if (allZero(chunk + off, page_len))
+            continue;
+        mask[p / 64] |= 1ULL << (p % 64);
+        pages.insert(pages.end(), chunk + off, chunk + off + page_len);
+    }
+
+    out.clear();
+    if (pages.empty())
+        return;
+    uLongf out_len = compressBound(pages.size());
+    out.resize(out_len);
+    if (compress2(out.data(), &out_len, pages.data(), pages.size(),
+                  Z_BEST_SPEED) != Z_OK)
+        panic("Failed to compress a physical memory chunk\n");
+    out.resize(out_len);
+}
+
+/** Bytes of chunk c that are stored, i.e. not elided as zero */
+uint64_t
+storedBytes(const ChunkLayout &layout, const uint64_t *mask, uint64_t c)
+{
+    uint64_t len = layout.chunkLength(c);
+    uint64_t stored = 0;
+    for (uint64_t off = 0, p = 0; off < len; off += layout.zeroPageSize, p++) {
+        if (mask[p / 64] & (1ULL << (p % 64)))
+            stored += std::min<uint64_t>(layout.zeroPageSize, len - off);
+    }
+    return stored;
+}
+
+/** Copy the stored pages of chunk c back to where they belong */
+void
+scatterPages(const ChunkLayout &layout, const uint64_t *mask, uint8_t *pmem,
+             uint64_t c, const uint8_t *src)
+{
+    uint8_t *chunk = pmem + layout.chunkStart(c);
+    uint64_t len = layout.chunkLength(c);
+    for (uint64_t off = 0, p = 0; off < len; off += layout.zeroPageSize, p++) {
+        if (!(mask[p / 64] & (1ULL << (p % 64))))
+            continue;
+        uint64_t page_len = std::min<uint64_t>(layout.zeroPageSize, len - off);
+        std::memcpy(chunk + off, src, page_len);
+        src += page_len;
+    }
+}
+
+/** Read chunk c back and scatter its pages into the backing store */
+void
+inflateChunk(const ChunkLayout &layout, const uint64_t *entry, int fd,
+             const std::string &path, uint8_t *pmem, uint64_t c,
+             std::vector<uint8_t> &in, std::vector<uint8_t> &pages)
+{
+    uint64_t offset = entry[0];
+    uint64_t length = entry[1];
+    const uint64_t *mask = entry + 2;
+    if (length == 0)
+        return;
+
+    uint64_t expected = storedBytes(layout, mask, c);
+    in.resize(length);
+    readAll(fd, in.data(), length, offset, path);
+    pages.resize(expected);
+    uLongf out_len = expected;
+    if (uncompress(pages.data(), &out_len, in.data(), length) != Z_OK ||
+        out_len != expected)
+        fatal("Corrupt chunk %d in physical memory checkpoint file '%s'\n",
+              c, path);
+    scatterPages(layout, mask, pmem, c, pages.data());
+}
+
+/**
+ * Report a failed lazy restore from the fault handler and abort. fatal()
+ * formats and allocates, so only write() is used.
+ */
+[[noreturn]] void
+lazyRestoreFailed(const char *what, const std::string &path)
+{
+    const char prefix[] = "fatal: ";
+    const char *file = path.c_str();
+    [[maybe_unused]] ssize_t ignored;
+    ignored = write(STDERR_FILENO, prefix, sizeof(prefix) - 1);
+    ignored = write(STDERR_FILENO, what, strlen(what));
+    ignored = write(STDERR_FILENO, file, strlen(file));
+    ignored = write(STDERR_FILENO, "\n", 1);
+    abort();
+}
+
+/**
+ * Bump allocator backing the inflate state of a lazy store. inflateInit
+ * takes the state from it before any chunk is protected, and inflate the
+ * window on the first chunk it needs one for; inflateReset keeps both, so
+ * the fault handler never calls malloc.
+ */
+struct InflateArena
+{
+    // inflate_state is about 7KB and the window 32KB
+    static const size_t capacity = 64 * 1024;
+    alignas(std::max_align_t) uint8_t bytes[capacity];
+    size_t used = 0;
+
+    static voidpf
+    alloc(voidpf opaque, uInt items, uInt size)
+    {
+        InflateArena *a = (InflateArena *)opaque;
+        size_t n = roundUp((size_t)items * size, alignof(std::max_align_t));
+        if (n > capacity - a->used)
+            return Z_NULL;
+        voidpf p = a->bytes + a->used;
+        a->used += n;
+        return p;
+    }
+
+    static void release(voidpf, voidpf) {}
+};
+
+/** A backing store restored lazily, and the file it is restored from */
+struct LazyStore
+{
+    std::string path;
+    int fd;
+    uint8_t *pmem;
+    ChunkLayout layout;
+    std::vector<uint64_t> index;
+    std::vector<bool> pending;
+    // Sized for the largest chunk before any chunk is protected
+    std::vector<uint8_t> in;
+    std::vector<uint8_t> pages;
+    InflateArena arena;
+    z_stream stream;
+
+    LazyStore(const std::string &_path, int _fd, uint8_t *_pmem,
+              const ChunkLayout &_layout, std::vector<uint64_t> &&_index)
+        : path(_path), fd(_fd), pmem(_pmem), layout(_layout),
+          index(std::move(_index)), pending(layout.chunks, false)
+    {
+        uint64_t longest = 0;
+        for (uint64_t c = 0; c < layout.chunks; c++)
+            longest = std::max(longest, index[c * layout.entryWords() + 1]);
+        in.resize(longest);
+        pages.resize(layout.chunkSize);
+
+        std::memset(&stream, 0, sizeof(stream));
+        stream.zalloc = InflateArena::alloc;
+        stream.zfree = InflateArena::release;
+        stream.opaque = &arena;
+        if (inflateInit(&stream) != Z_OK)
+            fatal("Failed to set up the lazy restore of '%s'\n", path);
+    }
+
+    ~LazyStore() { inflateEnd(&stream); }
+
+    bool
+    contains(const uint8_t *addr) const
+    {
+        return addr >= pmem && addr < pmem + layout.size;
+    }
+
+    /**
+     * Unprotect chunk c and inflate it into place. Called from the fault
+     * handler, so it only uses the buffers and inflate state set up in the
+     * constructor, and system calls.
+     */
+    void
+    load(uint64_t c)
+    {
+        const uint64_t *entry = &index[c * layout.entryWords()];
+        const uint64_t *mask = entry + 2;
+        pending[c] = false;
+        if (mprotect(pmem + layout.chunkStart(c), layout.chunkLength(c),
+                     PROT_READ | PROT_WRITE) != 0)
+            lazyRestoreFailed("Failed to unprotect a lazily restored "
+                              "memory chunk of ", path);
+        if (!readFully(fd, in.data(), entry[1], entry[0]))
+            lazyRestoreFailed("Read failed on physical memory checkpoint "
+                              "file ", path);
+
+        uint64_t expected = storedBytes(layout, mask, c);
+        inflateReset(&stream);
+        stream.next_in = in.data();
+        stream.avail_in = entry[1];
+        stream.next_out = pages.data();
+        stream.avail_out = expected;
+        if (inflate(&stream, Z_FINISH) != Z_STREAM_END ||
+            stream.total_out != expected)
+            lazyRestoreFailed("Corrupt chunk in physical memory checkpoint "
+                              "file ", path);
+        scatterPages(layout, mask, pmem, c, pages.data());
+    }
+};
+
+std::vector<std::unique_ptr<LazyStore>> lazyStores;
+struct sigaction previousSegv;
+struct sigaction previousBus;
+bool faultHandlerInstalled = false;
+
+void
+lazyFaultHandler(int sig, siginfo_t *info, void *ctx)
+{
+    const uint8_t *addr = (const uint8_t *)info->si_addr;
+    for (auto &s : lazyStores) {
+        if (!s->contains(addr))
+            continue;
+        uint64_t c = (addr - s->pmem) / s->layout.chunkSize;
+        if (s->pending[c]) {
+            // Retried once the handler returns
+            s->load(c);
+            return;
+        }
+    }
+    // Not a chunk waiting to be restored: hand the signal back to whoever
+    // had it before, which sees it when the access faults again
+    sigaction(sig, sig == SIGSEGV ? &previousSegv : &previousBus, nullptr);
+}
+
+void
+installFaultHandler()
+{
+    if (faultHandlerInstalled)
+        return;
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = lazyFaultHandler;
+    sa.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGSEGV, &sa, &previousSegv) != 0 ||
+        sigaction(SIGBUS, &sa, &previousBus) != 0)
+        fatal("Failed to install the lazy memory restore fault handler\n");
+    faultHandlerInstalled = true;
+}
+
+} // anonymous namespace
+
+void
+writeChunkedStore(const std::string &path, const uint8_t *pmem,
+                  uint64_t size, unsigned threads)
+{
+    threads = hostThreads(threads);
+    ChunkLayout layout(size, chunkSize, zeroPageSize);
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n", path);
+
+    ChunkHeader header;
+    std::memcpy(header.magic, chunkMagic, sizeof(header.magic));
+    header.chunkSize = layout.chunkSize;
+    header.zeroPageSize = layout.zeroPageSize;
+    header.size = size;
+    header.chunks = layout.chunks;
+    header.indexOffset = 0;
+
+    std::vector<uint64_t> index(layout.chunks * layout.entryWords(), 0);
+    uint64_t offset = sizeof(header);
+
+    // Compress a few chunks per thread at a time and write them out in
+    // order, so only that much compressed data is ever held
+    uint64_t batch = threads * 4;
+    std::vector<std::vector<uint8_t>> out(batch);
+    std::vector<std::vector<uint8_t>> scratch(threads);
+    for (uint64_t first = 0; first < layout.chunks; first += batch) {
+        uint64_t n = std::min(batch, layout.chunks - first);
+        parallelFor(threads, n, [&](uint64_t i, unsigned t) {
+            uint64_t c = first + i;
+            compressChunk(layout, pmem, c, scratch[t], out[i],
+                          &index[c * layout.entryWords() + 2]);
+        });
+        for (uint64_t i = 0; i < n; i++) {
+            uint64_t *entry = &index[(first + i) * layout.entryWords()];
+            if (out[i].empty())
+                continue;
+            entry[0] = offset;
+            entry[1] = out[i].size();
+            writeAll(fd, out[i].data(), out[i].size(), offset, path);
+            offset += out[i].size();
+        }
+    }
+
+    header.indexOffset = offset;
+    writeAll(fd, index.data(), index.size() * sizeof(uint64_t), offset, path);
+    writeAll(fd, &header, sizeof(header), 0, path);
+
+    if (close(fd) != 0)
+        fatal("Close failed on physical memory checkpoint file '%s'\n", path);
+}
+
+void
+readChunkedStore(const std::string &path, uint8_t *pmem, uint64_t size,
+                 unsigned threads, bool lazy)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n", path);
+
+    ChunkHeader header;
+    readAll(fd, &header, sizeof(header), 0, path);
+    if (std::memcmp(header.magic, chunkMagic, sizeof(header.magic)) != 0)
+        fatal("'%s' is not a chunked physical memory checkpoint\n", path);
+    if (header.size != size)
+        fatal("Memory range size has changed! Saw %lld, expected %lld\n",
+              header.size, size);
+
+    ChunkLayout layout(size, header.chunkSize, header.zeroPageSize);
+    fatal_if(layout.chunks != header.chunks,
+             "Chunk count mismatch in '%s'\n", path);
+    std::vector<uint64_t> index(layout.chunks * layout.entryWords());
+    readAll(fd, index.data(), index.size() * sizeof(uint64_t),
+            header.indexOffset, path);
+
+    if (lazy && layout.chunkSize % sysconf(_SC_PAGE_SIZE) != 0) {
+        warn("Chunks of '%s' are not host page aligned, restoring eagerly\n",
+             path);
+        lazy = false;
+    }
+
+    if (!lazy) {
+        threads = hostThreads(threads);
+        std::vector<std::vector<uint8_t>> in(threads), pages(threads);
+        parallelFor(threads, layout.chunks, [&](uint64_t c, unsigned t) {
+            inflateChunk(layout, &index[c * layout.entryWords()], fd, path,
+                         pmem, c, in[t], pages[t]);
+        });
+        if (close(fd) != 0)
+            fatal("Close failed on physical memory checkpoint file '%s'\n",
+                  path);
+        return;
+    }
+
+    auto store = std::make_unique<LazyStore>(path, fd, pmem, layout,
+                                             std::move(index));
+    // All-zero chunks are already there in a fresh mapping
+    for (uint64_t c = 0; c < layout.chunks; c++) {
+        if (store->index[c * layout.entryWords() + 1] == 0)
+            continue;
+        store->pending[c] = true;
+        if (mprotect(pmem + layout.chunkStart(c), layout.chunkLength(c),
+                     PROT_NONE) != 0)
+            fatal("Failed to protect physical memory for a lazy restore\n");
+    }
+    installFaultHandler();
+    lazyStores.push_back(std::move(store));
+}
+
+void
+finishLazyRestores()
+{
+    for (auto &s : lazyStores) {
+        for (uint64_t c = 0; c < s->layout.chunks; c++) {
+            if (s->pending[c])
+                s->load(c);
+        }
+        close(s->fd);
+    }
+    lazyStores.clear();
+}
+
+} // namespace memory
+} // namespace gem5
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 The ParaVerser authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_PMEM_CHUNKS_HH__
+#define __MEM_PMEM_CHUNKS_HH__
+
+#include <cstdint>
+#include <string>
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * Chunked physical memory checkpoints. The backing store is cut into
+ * fixed-size chunks that are compressed independently on several host
+ * threads. Pages that are all zero are left out of a chunk, and a chunk
+ * with no data left is not stored at all. An index at the end of the
+ * file records where every chunk is, so a restore can seek straight to
+ * any of them.
+ *
+ * A lazy restore only reads the index. Every chunk that holds data is
+ * protected until the simulator first touches it, and the resulting
+ * fault inflates that chunk into place. This relies on nothing else
+ * writing to the backing store concurrently. It is therefore only done
+ * when the simulation runs on a single host thread; otherwise the
+ * restore is eager but still parallel.
+ */
+
+/**
+ * Write a backing store to a chunked checkpoint file.
+ *
+ * @param path File to create
+ * @param pmem Host pointer to the backing store
+ * @param size Size of the backing store in bytes
+ * @param threads Host threads to compress with, 0 for all of them
+ */
+void writeChunkedStore(const std::string &path, const uint8_t *pmem,
+                       uint64_t size, unsigned threads);
+
+/**
+ * Restore a backing store from a chunked checkpoint file. The backing
+ * store must be freshly mapped, i.e. all zero.
+ *
+ * @param path File to read
+ * @param pmem Host pointer to the backing store
+ * @param size Size of the backing store in bytes
+ * @param threads Host threads to inflate with, 0 for all of them
+ * @param lazy Inflate each chunk on first touch instead
+ */
+void readChunkedStore(const std::string &path, uint8_t *pmem,
+                      uint64_t size, unsigned threads, bool lazy);
+
+/**
+ * Inflate every chunk a lazy restore has not faulted in yet, for
+ * anything about to read the backing stores wholesale.
+ */
+void finishLazyRestores();
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_PMEM_CHUNKS_HH__
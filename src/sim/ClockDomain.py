@@ -35,6 +35,7 @@
 
 from m5.params import *
 from m5.SimObject import SimObject
+from m5.util.pybind import PyBindMethod
 from m5.proxy import *
 
 # Abstract clock domain
@@ -51,6 +52,10 @@ class SrcClockDomain(ClockDomain):
     cxx_header = "sim/clock_domain.hh"
     cxx_class = 'gem5::SrcClockDomain'
 
+    cxx_exports = [
+        PyBindMethod("setPerfLevel"),
+    ]
+
     # Single clock frequency value, or list of frequencies for DVFS
     # Frequencies must be ordered in descending order
     # Note: Matching voltages should be defined in the voltage domain
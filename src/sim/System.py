@@ -58,6 +58,8 @@ class System(SimObject):
     cxx_exports = [
         PyBindMethod("getMemoryMode"),
         PyBindMethod("setMemoryMode"),
+        PyBindMethod("finishMemoryRestore"),
+        PyBindMethod("retuneChecking"),
     ]
 
     memories = VectorParam.AbstractMemory(Self.all,
@@ -75,6 +77,16 @@ class System(SimObject):
     mmap_using_noreserve = Param.Bool(False, "mmap the backing store " \
                                           "without reserving swap")
 
+    # The chunked format skips all-zero pages, compresses on several host
+    # threads and can be restored chunk by chunk on first touch. gzip
+    # checkpoints can always be restored regardless of this setting.
+    pmem_cpt_format = Param.String("gzip", "Format of physical memory "
+        "checkpoints: gzip or chunked")
+    pmem_cpt_threads = Param.Unsigned(1, "Host threads used to write and "
+        "restore chunked memory checkpoints (0 = all)")
+    pmem_lazy_restore = Param.Bool(True, "Restore chunked memory "
+        "checkpoints lazily, on first touch of each chunk")
+
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
     # I/O bridge or cache
@@ -97,6 +109,10 @@ class System(SimObject):
     num_checkers = Param.Unsigned(0,"num checkers");   
     extra_slot_per_checker = Param.Unsigned(0, "num slots of checking resources per checker");
     hashed = Param.Bool(False, "Use hashed results to verify LSL access correctness")
+    hashEngine = Param.String("sha256", "Segment digest used when hashed: "
+        "sha256, crc64 or xxh64")
+    hashLatency = Param.Unsigned(0, "Checker cycles to digest one 512-bit "
+        "block (0 = engine default)")
     hardErrorCore = Param.Unsigned(0, "Bitmap of which main core has induced error")
     hardErrorStuckAt = Param.Unsigned(0, "Whether the error is stuck at 1 or 0")
     hardErrorInjectionType = Param.String("", "What type of structure has a stuck at error. "
@@ -110,10 +126,61 @@ class System(SimObject):
     floatOpErrRate = Param.Float(0.0, "error rate of float ops")
     intOpErrRate = Param.Float(0.0, "error rate of int ops")
     ALUOpErrRate = Param.Float(0.0, "error rate of ALU ops")
+    injectionSeed = Param.Unsigned(258958529, "Seed of the per-core error "
+        "injection streams")
+    injectionPlan = Param.String("", "Replay the injections listed in this "
+        "plan (an injection_plan.txt from an earlier run) instead of drawing "
+        "them")
     AIMDoff = Param.Bool(False, "Whether to use the AIMD")
     cptTimeout = Param.Int(5000, "Timeout for taking checkpoint")
+    cptPolicy = Param.String("aimd", "How the timeout adapts when AIMD is "
+        "on: aimd or model")
     lslSize = Param.Int(4096, "Size of load store log")
     minorCommitBypass = Param.Bool(False, "Whether checker cores can commit out of order")
+    checkerPool = Param.String("static", "static: each checker only checks "
+        "its own main core; shared: idle checkers are taken over by main "
+        "cores that have none free")
+    stealPolicy = Param.String("nearest", "Which idle checker a main core "
+        "takes with a shared pool: nearest, eager or richest")
+    checkerVoters = Param.Unsigned(1, "Checkers that vote on each segment "
+        "with the main core, a segment is re-executed only while undecided")
+    functionalCheckers = Param.Bool(False, "Check segments functionally "
+        "against the loadstorelog instead of ticking the checker pipelines")
+    functionalCheckerIPC = Param.Float(1.0, "Ops a functional checker "
+        "commits per checker cycle")
+    functionalCheckerWakeup = Param.Cycles(0, "Checker cycles from a "
+        "functional checker waking to its first commit")
+    lslNoC = Param.String("ideal", "How loadstorelog entries reach the "
+        "checkers: ideal (immediately), crossbar or mesh")
+    lslNoCClock = Param.Clock("2GHz", "Clock of the loadstorelog NoC")
+    lslNoCWidth = Param.Unsigned(256, "Link width (flit size) in bits")
+    lslNoCPacketBits = Param.Unsigned(512, "Entry bits pushed per packet")
+    lslNoCHopCycles = Param.Unsigned(1, "NoC cycles per router and link")
+    lslNoCQueue = Param.Unsigned(4, "Packets a main core can queue for "
+        "injection before it stops committing")
+    lslNoCMeshCols = Param.Unsigned(0, "Columns of the mesh, 0 for the "
+        "smallest square that fits every core")
+    lslCompressor = Param.BaseCacheCompressor(NULL, "Compressor of the "
+        "data blocks of a compressed loadstorelog, NULL for none")
+    lslStreamDepth = Param.Unsigned(0, "Entries the checker-side stream "
+        "buffer fetches ahead of checker loads, 0 for none")
+    lslStreamLatency = Param.Cycles(2, "Checker cycles an entry takes to "
+        "reach the stream buffer")
+    samplePolicy = Param.String("periodic", "Which intervals sampled main "
+        "cores check: periodic, random or coverage")
+    sampleInterval = Param.Unsigned(0, "Instructions per sampling interval, "
+        "the samplePeriod of the main cores")
+    sampleBudget = Param.Float(0.1, "Fraction of the instructions the "
+        "random and coverage sample policies check")
+    sampleCoverage = Param.Float(0.99, "Fraction of an interval at verified "
+        "PCs below which the coverage policy checks the next one")
+    samplePhaseThreshold = Param.Float(0.5, "Signature distance from every "
+        "checked phase above which the coverage policy checks")
+    sampleExplore = Param.Float(0.02, "Chance the coverage policy checks an "
+        "interval it has no other reason to")
+    coverageDump = Param.String("none", "Write the PC and static "
+        "instruction coverage gained at every stats dump: none, csv or "
+        "binary")
 
     redirect_paths = VectorParam.RedirectPath([], "Path redirections")
 
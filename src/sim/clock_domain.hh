@@ -213,6 +213,20 @@ class SrcClockDomain : public ClockDomain
      */
     PerfLevel perfLevel() const { return _perfLevel; }
 
+    /**
+     * Sets the current performance level from Python, which cannot bind
+     * the overloaded perfLevel().
+     *
+     * @param perf_level the target performance level
+     */
+    void
+    setPerfLevel(PerfLevel perf_level)
+    {
+        fatal_if(!validPerfLevel(perf_level), "DVFS: Performance level %d "
+                 "is outside of list for %s\n", perf_level, name());
+        perfLevel(perf_level);
+    }
+
     /**
      * Get the number of available performance levels for this clock domain.
      *
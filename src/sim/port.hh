@@ -122,6 +122,7 @@ class Port
     }
         virtual     int blockedEntries(int cpuid){
                 assert(0);
+                return 0;
         }
     /** Dettach from a peer port. */
     virtual void
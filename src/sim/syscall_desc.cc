@@ -53,8 +53,7 @@ SyscallDesc::doSyscall(ThreadContext *tc)
 			    loadstorelogentry::checkerCPUMeta[loadstorelogentry::mainCPUMeta[tc->contextId()].current_segment_to_fill].hasSyscall=true;
             }
         retval = executor(this, tc); // Actual syscall
-                        bool syslogfull = syscalllogentry::do_write(retval, tc->contextId(), tc->pcState().instAddr());
-                        if (loadstorelogentry::allCPUMeta[NUMBEROFMAINCORES].baseCPU && loadstorelogentry::mainCPUMeta[tc->contextId()].timestamp>1) assert(!syslogfull);
+                        syscalllogentry::do_write(retval, tc->contextId(), tc->pcState().instAddr());
     } else {
         retval = syscalllogentry::do_read(tc->contextId(), tc->pcState().instAddr());
     }
@@ -1,8 +1,125 @@
 #include "sim/syscalllog.hh"
 
+#include <iostream>
+
 namespace gem5 {
-std::vector<syscalllogentry> syscalllogentry::entries {syscalllogentry()};
-std::vector<int> syscalllogentry::current_entry {0};
-std::vector<int> syscalllogentry::entryIndices{0};
-std::vector<int> syscalllogentry::maxIndices{0};
+std::vector<std::vector<syscalllogentry>> syscalllogentry::segments;
+std::vector<int> syscalllogentry::readIndices;
+std::vector<uint8_t> syscalllogentry::restart;
+
+void
+syscalllogentry::resizeLogs(int mains, int checkers)
+{
+    int slots = loadstorelogentry::num_checkSlot_per_checker*checkers*mains;
+    segments.resize(slots);
+    readIndices.resize(slots, 0);
+    restart.resize(mains, true);
+}
+
+void
+syscalllogentry::do_write(SyscallReturn r, int cpuID, Addr instAddr)
+{
+    assert(cpuID < loadstorelogentry::mainCPUMeta.size());
+    // Bypass write when there is no checker or the main CPU is not checked nor stored
+    if (NUMBEROFCHECKERCORESPERCORE == 0 || !loadstorelogentry::allCPUMeta[cpuID].baseCPU->isMain()) {
+        return;
+    }
+    loadstorelogentry::ShardGuard guard(cpuID);
+    auto &seg = segments.at(
+        loadstorelogentry::mainCPUMeta[cpuID].current_segment_to_fill);
+    if (restart.at(cpuID)) {
+        // clear() keeps the capacity, so a segment only allocates when it
+        // sees more syscalls than it has before
+        seg.clear();
+        restart.at(cpuID) = false;
+    }
+    seg.push_back(syscalllogentry(r, instAddr));
+    m_deltaBegin(loadstorelogentry::allCPUMeta[cpuID].baseCPU->getContext(0));
+}
+
+void
+syscalllogentry::update_context(int cpuID)
+{
+    assert(cpuID < loadstorelogentry::mainCPUMeta.size());
+    // Bypass update when there is no checker or the main CPU is not checked nor stored
+    if (NUMBEROFCHECKERCORESPERCORE == 0 || !loadstorelogentry::allCPUMeta[cpuID].baseCPU->isMain()) {
+        return;
+    }
+    loadstorelogentry::ShardGuard guard(cpuID);
+    auto &seg = segments.at(
+        loadstorelogentry::mainCPUMeta[cpuID].current_segment_to_fill);
+    assert(!restart.at(cpuID));
+    assert(!seg.empty());
+    assert(!seg.back().updated);
+    seg.back().delta =
+        m_deltaEnd(loadstorelogentry::allCPUMeta[cpuID].baseCPU->getContext(0));
+    seg.back().updated = true;
+}
+
+SyscallReturn
+syscalllogentry::do_read(int checkerID, Addr instAddr)
+{
+    assert(NUMBEROFCHECKERCORESPERCORE > 0); // Should not come here when there is no checker
+    int id = checkerID - NUMBEROFMAINCORES;
+    assert(id < NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
+    loadstorelogentry::ShardGuard guard(loadstorelogentry::shardOfCPU(checkerID));
+    const auto &seg = segments.at(id);
+    int pos = readIndices.at(id)++;
+
+    if (pos >= seg.size() || seg[pos].instAddr != instAddr) {
+        // This will trigger a graceful error detection at next commit.
+        if (loadstorelogentry::debugFlag) std::cout << "Checker " << id << " attempted to read an uninitialised syscalllogentry at position " << pos << std::endl;
+        loadstorelogentry::checkerCPUMeta[id].interrupted = true;
+        return 0;
+    }
+    assert(seg[pos].updated);
+
+    if (m_applyDelta(loadstorelogentry::allCPUMeta[checkerID].baseCPU->getContext(0), seg[pos].delta)) {
+        if (loadstorelogentry::debugFlag) std::cout << " --> Syscall modified state before, not an actual error" << std::endl;
+    } // Otherwise, an error occurred before the syscall, so it is propagated.
+
+    return seg[pos].result;
+}
+
+void
+syscalllogentry::reset_index(int id)
+{
+    if (id < NUMBEROFMAINCORES) {
+        restart.at(id) = true;
+    } else {
+        assert(NUMBEROFCHECKERCORESPERCORE > 0); // Should not come here when there is no checker
+        int checkerID = id - NUMBEROFMAINCORES;
+        assert(checkerID < NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
+        segments.at(checkerID).clear();
+        readIndices.at(checkerID) = 0;
+    }
+}
+
+void
+syscalllogentry::move_segment(int from_id, int to_id)
+{
+    assert(from_id >= NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
+    assert(from_id < loadstorelogentry::checkerCPUMeta.size());
+    assert(to_id == from_id - NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
+    // Swapping the vectors keeps both allocations around for reuse
+    segments.at(to_id).swap(segments.at(from_id));
+    std::swap(readIndices.at(to_id), readIndices.at(from_id));
+}
+
+void
+syscalllogentry::swap_segments(int a, int b)
+{
+    assert(a < NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
+    assert(b < NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
+    segments.at(a).swap(segments.at(b));
+    std::swap(readIndices.at(a), readIndices.at(b));
+}
+
+void
+syscalllogentry::rewind_index(int id)
+{
+    assert(id < NUMBEROFCHECKERCORESPERCORE*NUMBEROFMAINCORES);
+    readIndices.at(id) = 0;
+}
+
 }
@@ -59,6 +59,7 @@
 #include "debug/WorkItems.hh"
 #include "mem/abstract_mem.hh"
 #include "mem/physical.hh"
+#include "mem/pmem_chunks.hh"
 #include "params/System.hh"
 #include "sim/byteswap.hh"
 #include "sim/debug.hh"
@@ -184,7 +185,8 @@ System::System(const Params &p)
       physProxy(_systemPort, p.cache_line_size),
       workload(p.workload),
       physmem(name() + ".physmem", p.memories, p.mmap_using_noreserve,
-              p.shared_backstore, p.auto_unlink_shared_backstore),
+              p.shared_backstore, p.auto_unlink_shared_backstore,
+              p.pmem_cpt_format, p.pmem_cpt_threads, p.pmem_lazy_restore),
       ShadowRomRanges(p.shadow_rom_ranges.begin(),
                       p.shadow_rom_ranges.end()),
       memoryMode(p.mem_mode),
@@ -205,9 +207,28 @@ System::System(const Params &p)
         p.intOpErrRate, 
         p.ALUOpErrRate
     };
-    loadstorelogentry::initTimeout(p.AIMDoff,p.cptTimeout,p.lslSize);
+    loadstorelogentry::initTimeout(p.AIMDoff,p.cptTimeout,p.lslSize,p.cptPolicy);
     loadstorelogentry::initMinorCommitBypass(p.minorCommitBypass);
+    loadstorelogentry::initHashEngine(p.hashEngine, p.hashLatency);
     loadstorelogentry::initCoreCount(p.num_mains,p.num_checkers, p.extra_slot_per_checker, p.hashed, errRates);
+    loadstorelogentry::initCheckerPool(p.checkerPool, p.stealPolicy);
+    loadstorelogentry::initSegmentRings(this);
+    loadstorelogentry::initVoting(this, p.checkerVoters);
+    loadstorelogentry::initFunctionalCheckers(this, p.functionalCheckers,
+        p.functionalCheckerIPC, p.functionalCheckerWakeup);
+    loadstorelogentry::initTransport(this, p.lslNoC,
+        {p.lslNoCClock, p.lslNoCWidth, p.lslNoCPacketBits,
+         p.lslNoCHopCycles, p.lslNoCQueue, p.lslNoCMeshCols});
+    loadstorelogentry::initCompressor(this, p.lslCompressor,
+        p.cache_line_size);
+    loadstorelogentry::initStreamBuffer(this, p.lslStreamDepth,
+        p.lslStreamLatency);
+    loadstorelogentry::initSampler(this, p.samplePolicy,
+        {p.sampleInterval, p.sampleBudget, p.sampleCoverage,
+         p.samplePhaseThreshold, p.sampleExplore});
+    loadstorelogentry::initCoverageDump(p.coverageDump);
+    errorinjection::initSchedule(p.injectionSeed, p.injectionPlan,
+        p.num_mains + p.num_checkers);
     errorinjection::setHardErr(p.hardErrorBit, p.hardErrorInjectionPoint, 
         p.hardErrorInjectionType, p.hardErrorStuckAt, p.hardErrorCore, 
         p.num_mains, p.num_checkers/p.num_mains, p.exit_on_error);
@@ -286,6 +307,22 @@ System::setMemoryMode(enums::MemoryMode mode)
     memoryMode = mode;
 }
 
+void
+System::finishMemoryRestore()
+{
+    memory::finishLazyRestores();
+}
+
+void
+System::retuneChecking(int cpt_timeout, int lsl_size,
+                       const std::vector<double> &err_rates)
+{
+    fatal_if(err_rates.size() != 6, "Expected 6 error rates, got %d\n",
+             err_rates.size());
+    loadstorelogentry::retune(cpt_timeout, lsl_size);
+    errorinjection::setErrRates(err_rates);
+}
+
 void
 System::registerThreadContext(ThreadContext *tc)
 {
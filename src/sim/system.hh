@@ -312,6 +312,29 @@ class System : public SimObject, public PCEventScope
     void setMemoryMode(enums::MemoryMode mode);
     /** @} */
 
+    /** @{ */
+    /**
+     * Fault in whatever a lazy physical memory restore has not touched
+     * yet, so that processes forked afterwards share all of it.
+     *
+     * \warn This should only be called by the Python!
+     */
+    void finishMemoryRestore();
+
+    /**
+     * Apply the ParaVerser parameters of a --forkSweep child. Only valid
+     * between instantiation and the first simulate().
+     *
+     * \warn This should only be called by the Python!
+     *
+     * @param cpt_timeout New cptTimeout
+     * @param lsl_size New lslSize
+     * @param err_rates New error rates, in System.py order
+     */
+    void retuneChecking(int cpt_timeout, int lsl_size,
+                        const std::vector<double> &err_rates);
+    /** @} */
+
     /**
      * Get the cache line size of the system.
      */